@@ -50,6 +50,8 @@ Description:
 #define BUILD_PIGGEN   0
 // Generates code for all projects using piggen.exe (you can turn this off if you're not making changes to generated code and you've already generated it once)
 #define RUN_PIGGEN     0
+// Compiles res_packer/res_packer_main.c, a tool that packs a folder of resources into a .pack file (see file_fmt_res_pack.h)
+#define BUILD_RES_PACKER 0
 
 // Builds third_party/tracy/TracyClient.cpp in C++ mode into tracy.obj which will be linked into pig_core.dll
 #define BUILD_TRACY_DLL 0
@@ -24,6 +24,13 @@ Description:
 #define PIG_BUILD_INCLUDE_OPTIONAL_HEADERS 1
 #include "pig_build.h"
 
+#if !BUILDING_ON_WINDOWS
+#include <sys/wait.h> //waitpid for the build job runner
+#include <unistd.h>
+#endif
+#include <errno.h>
+#include <string.h>
+
 #define BUILD_CONFIG_PATH       "../build_config.h"
 
 #define FOLDERNAME_GENERATED_CODE  "gen"
@@ -33,8 +40,19 @@ Description:
 #define FOLDERNAME_ANDROID         "android"
 #define FOLDERNAME_ORCA            "orca"
 
+//When building for Linux on another OS (through WSL) the Linux outputs go in the linux folder, these are the build job folder and output prefix for that
+#if BUILDING_ON_LINUX
+#define LINUX_JOB_FOLDER  ""
+#define LINUX_JOB_PREFIX  ""
+#else
+#define LINUX_JOB_FOLDER  FOLDERNAME_LINUX
+#define LINUX_JOB_PREFIX  FOLDERNAME_LINUX "/"
+#endif
+
 #define FILENAME_PIGGEN_EXE            "piggen.exe"
 #define FILENAME_PIGGEN                "piggen"
+#define FILENAME_RES_PACKER_EXE        "res_packer.exe"
+#define FILENAME_RES_PACKER            "res_packer"
 #define FILENAME_TRACY_DLL             "tracy.dll"
 #define FILENAME_TRACY_LIB             "tracy.lib"
 #define FILENAME_TRACY_SO              "tracy.so"
@@ -65,6 +83,9 @@ Description:
 #define FILENAME_PDEX_DLL              "pdex.dll"
 #define FILENAME_TESTS_PDX             "tests.pdx"
 
+//NOTE: pig_build.h only knows about the tags for the targets it was written for, the res_packer tag lives here
+#define T_RES_PACKER "ResPacker"
+
 void PrintUsage()
 {
 	WriteLine_E("Usage: " BUILD_SCRIPT_EXE_NAME " [DEBUG_BUILD={1/0}] [BUILD_TESTS={1/0}] ...");
@@ -118,6 +139,397 @@ bool GetBoolConfig(const char* defineName, Str buildConfigContents, int argc, ch
 }
 //TODO: Add GetStrConfig to do ExtractStrDefine and check cmd-line args for config value
 
+// +--------------------------------------------------------------+
+// |                     Build Step Manifests                     |
+// +--------------------------------------------------------------+
+// Steps that are expensive and rarely change (shaders, tracy, imgui, physx) write a small "[output].manifest" file next to
+// their output holding a hash of everything that went into the step: the compiler exe, the tags (which carry every bool
+// option from build_config.h), the contents of build_config.h and build_script.c (which decide the rest of the command line)
+// and the contents of every input file, following #include "..." lines so the headers they pull in are covered as well.
+// When the output exists and the hash matches we skip the step, even if the BUILD_XYZ option asked for it.
+// NOTE: Changes to pig_build itself are not tracked, delete the .manifest files (or the outputs) to force a rebuild after updating it
+#define BUILD_MANIFEST_EXTENSION  ".manifest"
+#define BUILD_SCRIPT_SOURCE_PATH  "../build_script.c"
+#define MAX_INCLUDE_SCAN_DEPTH    32
+
+//NOTE: build_script.c can't #include PigCore's misc/misc_hash.h (it pulls in build_config.h and the base/ headers, which
+//      we deliberately don't compile this tool against) so this is misc_hash.h's FnvHashU64Ex with the same name and
+//      constants. Keep the two in sync, the manifests only stay valid as long as the hash doesn't change
+#define FNV_HASH_BASE_U64   0xcbf29ce484222325ULL //= DEC(14,695,981,039,346,656,037)
+#define FNV_HASH_PRIME_U64  0x00000100000001b3ULL //= DEC(1,099,511,628,211)
+u64 FnvHashU64Ex(const void* bufferPntr, u64 numBytes, u64 startingState)
+{
+	const u8* bytePntr = (const u8*)bufferPntr;
+	u64 result = startingState;
+	for (u64 bIndex = 0; bIndex < numBytes; bIndex++)
+	{
+		result = result ^ bytePntr[bIndex];
+		result = result * FNV_HASH_PRIME_U64;
+	}
+	return result;
+}
+
+FILE* OpenFileStr(Str path, const char* mode)
+{
+	char* pathNt = (char*)malloc(path.length+1);
+	memcpy(pathNt, path.chars, path.length);
+	pathNt[path.length] = '\0';
+	FILE* result = fopen(pathNt, mode);
+	free(pathNt);
+	return result;
+}
+
+//NOTE: We don't use ReadEntireFile here because a missing input should change the hash, not stop the build
+bool TryReadEntireFile(Str path, Str* contentsOut)
+{
+	FILE* fileHandle = OpenFileStr(path, "rb");
+	if (fileHandle == NULL) { return false; }
+	
+	fseek(fileHandle, 0, SEEK_END);
+	long fileSize = ftell(fileHandle);
+	fseek(fileHandle, 0, SEEK_SET);
+	if (fileSize < 0) { fclose(fileHandle); return false; }
+	
+	*contentsOut = Str_Empty;
+	contentsOut->chars = (char*)malloc((size_t)fileSize + 1);
+	size_t numBytesRead = fread(contentsOut->chars, 1, (size_t)fileSize, fileHandle);
+	fclose(fileHandle);
+	contentsOut->chars[numBytesRead] = '\0';
+	contentsOut->length = (u64)numBytesRead;
+	return true;
+}
+
+void HashBuildInputFile(u64* hash, StrArray* visitedPaths, Str path, const StrArray* includeDirs, u64 depth)
+{
+	for (u64 vIndex = 0; vIndex < visitedPaths->length; vIndex++)
+	{
+		Str visitedPath = visitedPaths->strings[vIndex];
+		if (visitedPath.length == path.length && memcmp(visitedPath.chars, path.chars, path.length) == 0) { return; }
+	}
+	AddStr(visitedPaths, path);
+	
+	*hash = FnvHashU64Ex(path.chars, path.length, *hash);
+	Str contents = Str_Empty;
+	if (!TryReadEntireFile(path, &contents)) { *hash = FnvHashU64Ex("[missing]", 9, *hash); return; }
+	*hash = FnvHashU64Ex(contents.chars, contents.length, *hash);
+	
+	if (depth < MAX_INCLUDE_SCAN_DEPTH)
+	{
+		Str fileDirectory = Str_Empty;
+		fileDirectory.chars = path.chars;
+		for (u64 cIndex = path.length; cIndex > 0; cIndex--)
+		{
+			if (path.chars[cIndex-1] == '/' || path.chars[cIndex-1] == '\\') { fileDirectory.length = cIndex; break; }
+		}
+		
+		u64 lineStart = 0;
+		while (lineStart < contents.length)
+		{
+			u64 cIndex = lineStart;
+			while (cIndex < contents.length && (contents.chars[cIndex] == ' ' || contents.chars[cIndex] == '\t')) { cIndex++; }
+			Str lineStr = Str_Empty;
+			lineStr.chars = &contents.chars[cIndex];
+			lineStr.length = contents.length - cIndex;
+			if (StrExactStartsWith(lineStr, StrLit("#include")))
+			{
+				cIndex += 8; //"#include"
+				while (cIndex < contents.length && (contents.chars[cIndex] == ' ' || contents.chars[cIndex] == '\t')) { cIndex++; }
+				if (cIndex < contents.length && contents.chars[cIndex] == '"')
+				{
+					u64 nameStart = cIndex+1;
+					u64 nameEnd = nameStart;
+					while (nameEnd < contents.length && contents.chars[nameEnd] != '"' && contents.chars[nameEnd] != '\n') { nameEnd++; }
+					if (nameEnd < contents.length && contents.chars[nameEnd] == '"')
+					{
+						Str includeName = Str_Empty;
+						includeName.chars = &contents.chars[nameStart];
+						includeName.length = nameEnd - nameStart;
+						
+						//Search next to the file first, then in the given include directories, then in [ROOT]/src and [ROOT] like the compiler would
+						Str includePath = JoinStrings2(fileDirectory, includeName);
+						for (u64 dIndex = 0; includeDirs != NULL && dIndex < includeDirs->length && !DoesFileExist(includePath); dIndex++)
+						{
+							free(includePath.chars);
+							includePath = JoinStrings2(includeDirs->strings[dIndex], includeName);
+						}
+						if (!DoesFileExist(includePath)) { free(includePath.chars); includePath = JoinStrings2(StrLit("../src/"), includeName); }
+						if (!DoesFileExist(includePath)) { free(includePath.chars); includePath = JoinStrings2(StrLit("../"), includeName); }
+						//NOTE: Includes we can't find are things like system headers or files found through compiler include paths we don't know about, we just skip those
+						if (DoesFileExist(includePath)) { HashBuildInputFile(hash, visitedPaths, includePath, includeDirs, depth+1); }
+						free(includePath.chars);
+					}
+				}
+			}
+			while (lineStart < contents.length && contents.chars[lineStart] != '\n') { lineStart++; }
+			lineStart++;
+		}
+	}
+	
+	free(contents.chars);
+}
+
+// inputPaths and includeDirs are relative to the _build folder (use ".." instead of [ROOT]), includeDirs can be NULL
+u64 GetBuildStepHash(Str exeName, const StrArray* tags, const StrArray* inputPaths, const StrArray* includeDirs)
+{
+	u64 hash = FNV_HASH_BASE_U64;
+	hash = FnvHashU64Ex(exeName.chars, exeName.length, hash);
+	for (u64 tIndex = 0; tIndex < tags->length; tIndex++)
+	{
+		hash = FnvHashU64Ex(tags->strings[tIndex].chars, tags->strings[tIndex].length, hash);
+		hash = FnvHashU64Ex("|", 1, hash);
+	}
+	
+	StrArray visitedPaths = EMPTY;
+	HashBuildInputFile(&hash, &visitedPaths, StrLit(BUILD_CONFIG_PATH), NULL, MAX_INCLUDE_SCAN_DEPTH);
+	HashBuildInputFile(&hash, &visitedPaths, StrLit(BUILD_SCRIPT_SOURCE_PATH), NULL, MAX_INCLUDE_SCAN_DEPTH);
+	for (u64 iIndex = 0; iIndex < inputPaths->length; iIndex++)
+	{
+		HashBuildInputFile(&hash, &visitedPaths, inputPaths->strings[iIndex], includeDirs, 0);
+	}
+	FreeStrArray(&visitedPaths);
+	return hash;
+}
+
+// outputPath is relative to the current working directory (so call this after any chdir for the step)
+bool IsBuildStepUpToDate(Str outputPath, u64 stepHash)
+{
+	if (!DoesFileExist(outputPath)) { return false; }
+	Str manifestPath = JoinStrings2(outputPath, StrLit(BUILD_MANIFEST_EXTENSION));
+	Str manifestContents = Str_Empty;
+	bool result = false;
+	if (TryReadEntireFile(manifestPath, &manifestContents))
+	{
+		char expectedStr[17];
+		snprintf(expectedStr, sizeof(expectedStr), "%016llX", (unsigned long long)stepHash);
+		result = (manifestContents.length == 16 && memcmp(manifestContents.chars, expectedStr, 16) == 0);
+		free(manifestContents.chars);
+	}
+	free(manifestPath.chars);
+	return result;
+}
+
+// Call with stepSucceeded=false before running the step so a failed or interrupted step never leaves a matching manifest behind
+void UpdateBuildStepManifest(Str outputPath, u64 stepHash, bool stepSucceeded)
+{
+	Str manifestPath = JoinStrings2(outputPath, StrLit(BUILD_MANIFEST_EXTENSION));
+	FILE* fileHandle = OpenFileStr(manifestPath, "wb");
+	if (fileHandle != NULL)
+	{
+		//An empty manifest never matches, so we truncate it before running the step and fill it in after it succeeds
+		if (stepSucceeded) { fprintf(fileHandle, "%016llX", (unsigned long long)stepHash); }
+		fclose(fileHandle);
+	}
+	free(manifestPath.chars);
+}
+
+// +--------------------------------------------------------------+
+// |                       Build Job Runner                       |
+// +--------------------------------------------------------------+
+// Steps that don't depend on each other are queued with QueueBuildJob and RunBuildJobs runs them all concurrently, never
+// more at once than we have cores. The command still goes through RunCliProgramAndExitOnFailure(Tags), the runner only
+// decides where and when. On Linux/OSX every job runs in a fork()ed child so it can chdir into its folder without affecting
+// the other jobs, and we collect the exit codes with waitpid. If a job fails we don't start any more jobs and exit once the
+// running ones finish. On Windows the jobs run one at a time on the main thread (in queue order, same as before the runner
+// existed) because there is no fork() and nothing guarantees pig_build's process and print helpers are safe to call from
+// multiple threads, so the only thing the runner does there is the manifest bookkeeping
+// NOTE: The compiler output from jobs that run at the same time can end up interleaved in the console
+#define MAX_BUILD_JOBS_AT_ONCE  64
+
+typedef struct BuildJob BuildJob;
+struct BuildJob
+{
+	Str exeName;
+	bool hasTags; //without tags the command runs through RunCliProgramAndExitOnFailure
+	StrArray tags;
+	CliArgs cmd;
+	Str errorMessage;
+	Str folderPath; //the job runs inside this folder (relative to _build), empty to run in _build
+	Str outputPath; //relative to _build, must exist after the job succeeds
+	bool hasManifest;
+	u64 stepHash; //written to outputPath's manifest when hasManifest is set
+	Str finishedMessage; //printed after the job succeeds, can be empty
+	#if !BUILDING_ON_WINDOWS
+	bool isRunning;
+	pid_t processId;
+	#endif
+};
+
+typedef struct BuildJobQueue BuildJobQueue;
+struct BuildJobQueue
+{
+	u64 length;
+	u64 allocLength;
+	BuildJob* jobs;
+};
+
+// tags can be NULL, the returned pointer is only valid until the next QueueBuildJob call (fill in hasManifest/stepHash/finishedMessage right away)
+BuildJob* QueueBuildJob(BuildJobQueue* queue, Str exeName, const StrArray* tags, const CliArgs* cmd, Str errorMessage, Str folderPath, Str outputPath)
+{
+	if (queue->length >= queue->allocLength)
+	{
+		queue->allocLength = (queue->allocLength > 0) ? queue->allocLength*2 : 16;
+		queue->jobs = (BuildJob*)realloc(queue->jobs, sizeof(BuildJob) * queue->allocLength);
+	}
+	BuildJob* job = &queue->jobs[queue->length];
+	queue->length++;
+	memset(job, 0x00, sizeof(BuildJob));
+	job->exeName = CopyStr(exeName);
+	job->hasTags = (tags != NULL);
+	if (tags != NULL) { AddStrArray(&job->tags, tags); }
+	job->cmd = *cmd;
+	job->errorMessage = CopyStr(errorMessage);
+	job->folderPath = CopyStr(folderPath);
+	job->outputPath = CopyStr(outputPath);
+	return job;
+}
+
+int ChangeDirectoryStr(Str path)
+{
+	char* pathNt = (char*)malloc(path.length+1);
+	memcpy(pathNt, path.chars, path.length);
+	pathNt[path.length] = '\0';
+	int result = chdir(pathNt);
+	free(pathNt);
+	return result;
+}
+
+int CreateFolderStr(Str path)
+{
+	char* pathNt = (char*)malloc(path.length+1);
+	memcpy(pathNt, path.chars, path.length);
+	pathNt[path.length] = '\0';
+	int result = mkdir(pathNt, FOLDER_PERMISSIONS);
+	free(pathNt);
+	return result;
+}
+
+u64 GetNumBuildJobSlots()
+{
+	u64 result = 1;
+	#if !BUILDING_ON_WINDOWS
+	long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	if (numProcessors > 0) { result = (u64)numProcessors; }
+	#endif
+	return (result < MAX_BUILD_JOBS_AT_ONCE) ? result : MAX_BUILD_JOBS_AT_ONCE;
+}
+
+// Runs in the child process (or on the main thread on Windows), RunCliProgramAndExitOnFailure(Tags) exits for us when the command fails
+void RunBuildJobCommand(BuildJob* job)
+{
+	if (job->hasTags) { RunCliProgramAndExitOnFailureTags(job->exeName, job->tags, &job->cmd, job->errorMessage); }
+	else { RunCliProgramAndExitOnFailure(job->exeName, &job->cmd, job->errorMessage); }
+}
+
+// Runs on the main thread after the job's command succeeded
+bool FinishBuildJob(BuildJob* job)
+{
+	if (job->outputPath.length > 0 && !DoesFileExist(job->outputPath))
+	{
+		PrintLine_E("\"%.*s\" is missing after running %.*s!", StrPrint(job->outputPath), StrPrint(job->exeName));
+		return false;
+	}
+	if (job->hasManifest) { UpdateBuildStepManifest(job->outputPath, job->stepHash, true); }
+	if (job->finishedMessage.length > 0) { PrintLine("%.*s", StrPrint(job->finishedMessage)); }
+	return true;
+}
+
+// Runs every queued job and empties the queue, exits the program if any job fails
+void RunBuildJobs(BuildJobQueue* queue)
+{
+	if (queue->length == 0) { return; }
+	u64 maxRunningJobs = GetNumBuildJobSlots();
+	if (maxRunningJobs > queue->length) { maxRunningJobs = queue->length; }
+	PrintLine("\n[Running %llu build step%s, up to %llu at a time...]", queue->length, (queue->length == 1) ? "" : "s", maxRunningJobs);
+	
+	u64 numStarted = 0;
+	u64 numRunning = 0;
+	int failureExitCode = 0;
+	while (numRunning > 0 || (numStarted < queue->length && failureExitCode == 0))
+	{
+		// +==============================+
+		// |      Start the Next Job      |
+		// +==============================+
+		if (numStarted < queue->length && numRunning < maxRunningJobs && failureExitCode == 0)
+		{
+			BuildJob* job = &queue->jobs[numStarted];
+			#if BUILDING_ON_WINDOWS
+			numStarted++;
+			if (job->hasManifest) { UpdateBuildStepManifest(job->outputPath, job->stepHash, false); }
+			char workingDir[1024];
+			if (job->folderPath.length > 0 && (getcwd(workingDir, sizeof(workingDir)) == NULL || ChangeDirectoryStr(job->folderPath) != 0))
+			{
+				PrintLine_E("Failed to enter \"%.*s\" for %.*s!", StrPrint(job->folderPath), StrPrint(job->exeName));
+				failureExitCode = 1;
+				continue;
+			}
+			RunBuildJobCommand(job);
+			if (job->folderPath.length > 0) { chdir(workingDir); }
+			if (!FinishBuildJob(job)) { failureExitCode = 1; }
+			continue;
+			#else
+			numStarted++;
+			if (job->hasManifest) { UpdateBuildStepManifest(job->outputPath, job->stepHash, false); }
+			fflush(stdout); //otherwise anything still buffered gets printed again by the child
+			fflush(stderr);
+			pid_t processId = fork();
+			if (processId == 0)
+			{
+				if (job->folderPath.length > 0 && ChangeDirectoryStr(job->folderPath) != 0)
+				{
+					PrintLine_E("Failed to enter \"%.*s\" for %.*s!", StrPrint(job->folderPath), StrPrint(job->exeName));
+					exit(1);
+				}
+				RunBuildJobCommand(job);
+				exit(0);
+			}
+			else if (processId < 0)
+			{
+				PrintLine_E("Failed to fork for %.*s! Error: %s", StrPrint(job->exeName), strerror(errno));
+				failureExitCode = 1;
+				continue;
+			}
+			job->processId = processId;
+			job->isRunning = true;
+			numRunning++;
+			continue;
+			#endif
+		}
+		
+		#if !BUILDING_ON_WINDOWS //jobs on Windows finish before we get here
+		// +==============================+
+		// |   Wait for a Job to Finish   |
+		// +==============================+
+		int waitStatus = 0;
+		pid_t finishedId = waitpid(-1, &waitStatus, 0);
+		if (finishedId < 0)
+		{
+			if (errno == EINTR) { continue; }
+			PrintLine_E("waitpid failed! Error: %s", strerror(errno));
+			exit(1);
+		}
+		BuildJob* finishedJob = NULL;
+		for (u64 jIndex = 0; jIndex < numStarted; jIndex++)
+		{
+			if (queue->jobs[jIndex].isRunning && queue->jobs[jIndex].processId == finishedId) { finishedJob = &queue->jobs[jIndex]; break; }
+		}
+		if (finishedJob == NULL) { continue; } //not one of ours
+		int jobExitCode = WIFEXITED(waitStatus) ? WEXITSTATUS(waitStatus) : 1;
+		
+		finishedJob->isRunning = false;
+		numRunning--;
+		if (jobExitCode != 0) { if (failureExitCode == 0) { failureExitCode = jobExitCode; } }
+		else if (!FinishBuildJob(finishedJob) && failureExitCode == 0) { failureExitCode = 1; }
+		#endif
+	}
+	
+	if (failureExitCode != 0)
+	{
+		if (numStarted < queue->length) { PrintLine_E("Skipped %llu build step%s because of the failure above", queue->length - numStarted, (queue->length - numStarted == 1) ? "" : "s"); }
+		exit(failureExitCode);
+	}
+	queue->length = 0;
+}
+
 int main(int argc, char* argv[])
 {
 	RecompileIfNeeded(StrArray_Empty);
@@ -140,6 +552,7 @@ int main(int argc, char* argv[])
 	bool BUILD_SHADERS                     = GetBoolConfig("BUILD_SHADERS",                     buildConfigContents, argc, argv, &buildConfigTags);
 	bool GENERATE_COMPILE_COMMANDS_FOR_LSP = GetBoolConfig("GENERATE_COMPILE_COMMANDS_FOR_LSP", buildConfigContents, argc, argv, &buildConfigTags);
 	bool RUN_PIGGEN                        = GetBoolConfig("RUN_PIGGEN",                        buildConfigContents, argc, argv, &buildConfigTags);
+	bool BUILD_RES_PACKER                  = GetBoolConfig("BUILD_RES_PACKER",                  buildConfigContents, argc, argv, &buildConfigTags);
 	bool BUILD_TRACY_DLL                   = GetBoolConfig("BUILD_TRACY_DLL",                   buildConfigContents, argc, argv, &buildConfigTags);
 	bool BUILD_IMGUI_OBJ                   = GetBoolConfig("BUILD_IMGUI_OBJ",                   buildConfigContents, argc, argv, &buildConfigTags);
 	bool BUILD_PHYSX_OBJ                   = GetBoolConfig("BUILD_PHYSX_OBJ",                   buildConfigContents, argc, argv, &buildConfigTags);
@@ -279,7 +692,11 @@ int main(int argc, char* argv[])
 	//We'll put shader objects, imgui.obj/o, tracy.dll/so, and physx_capi.obj/o into this list
 	CliArgs thingsToLink = EMPTY;
 	
+	//Independent steps get queued here and then run all at once with RunBuildJobs before anything that depends on them
+	BuildJobQueue buildJobs = EMPTY;
+	
 	AddTaggedArgNt(&pigCoreCompilerFlags, EXE_MSVC_CL "|Piggen|DUMP_ASSEMBLY",          CL_ASSEMB_LISTING_FILE, "piggen.asm");
+	AddTaggedArgNt(&pigCoreCompilerFlags, EXE_MSVC_CL "|ResPacker|DUMP_ASSEMBLY",       CL_ASSEMB_LISTING_FILE, "res_packer.asm");
 	AddTaggedArgNt(&pigCoreCompilerFlags, EXE_MSVC_CL "|PigCore|Library|DUMP_ASSEMBLY", CL_ASSEMB_LISTING_FILE, "pig_core.asm");
 	AddTaggedArgNt(&pigCoreCompilerFlags, EXE_MSVC_CL "|PigCoreTests|DUMP_ASSEMBLY",    CL_ASSEMB_LISTING_FILE, "tests.asm");
 	
@@ -371,9 +788,8 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_WINDOWS);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, StrLit("Failed to build " FILENAME_PIGGEN_EXE "!"));
-			AssertFileExist(StrLit(FILENAME_PIGGEN_EXE), true);
-			PrintLine("[Built %s for Windows!]", FILENAME_PIGGEN_EXE);
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_PIGGEN_EXE "!"), Str_Empty, StrLit(FILENAME_PIGGEN_EXE));
+			job->finishedMessage = StrLit("[Built " FILENAME_PIGGEN_EXE " for Windows!]");
 		}
 		if (BUILD_LINUX)
 		{
@@ -399,17 +815,11 @@ int main(int argc, char* argv[])
 			#else
 			Str clangExe = StrLit(EXE_WSL_CLANG);
 			mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
-			chdir(FOLDERNAME_LINUX);
 			cmd.rootDirPath = StrLit("../..");
 			#endif
 			
-			RunCliProgramAndExitOnFailureTags(clangExe, tags, &cmd, StrLit("Failed to build " FILENAME_PIGGEN "!"));
-			AssertFileExist(StrLit(FILENAME_PIGGEN), true);
-			PrintLine("[Built %s for Linux!]", FILENAME_PIGGEN);
-			
-			#if !BUILDING_ON_LINUX
-			chdir("..");
-			#endif
+			BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, StrLit("Failed to build " FILENAME_PIGGEN "!"), StrLit(LINUX_JOB_FOLDER), StrLit(LINUX_JOB_PREFIX FILENAME_PIGGEN));
+			job->finishedMessage = StrLit("[Built " FILENAME_PIGGEN " for Linux!]");
 		}
 		if (BUILD_OSX)
 		{
@@ -429,12 +839,13 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_UNIX);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_CLANG), tags, &cmd, StrLit("Failed to build " FILENAME_PIGGEN "!"));
-			AssertFileExist(StrLit(FILENAME_PIGGEN), true);
-			PrintLine("[Built %s for OSX!]", FILENAME_PIGGEN);
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_CLANG), &tags, &cmd, StrLit("Failed to build " FILENAME_PIGGEN "!"), Str_Empty, StrLit(FILENAME_PIGGEN));
+			job->finishedMessage = StrLit("[Built " FILENAME_PIGGEN " for OSX!]");
 		}
 	}
 	
+	RunBuildJobs(&buildJobs);
+	
 	// +--------------------------------------------------------------+
 	// |                        Run piggen.exe                        |
 	// +--------------------------------------------------------------+
@@ -462,6 +873,87 @@ int main(int argc, char* argv[])
 		RunCliProgramAndExitOnFailure(StrLit(EXEC_PROGRAM_IN_FOLDER_PREFIX RUNNABLE_FILENAME_PIGGEN), &cmd, StrLit(RUNNABLE_FILENAME_PIGGEN " Failed!"));
 	}
 	
+	// +--------------------------------------------------------------+
+	// |                     Build res_packer.exe                     |
+	// +--------------------------------------------------------------+
+	if (BUILD_RES_PACKER)
+	{
+		StrArray resPackerTags = EMPTY;
+		AddTag(&resPackerTags, T_RES_PACKER);
+		AddTag(&resPackerTags, BUILDING_ON_OSX ? T_LANG_OBJECTIVEC : T_LANG_C);
+		
+		if (BUILD_WINDOWS)
+		{
+			InitializeMsvcIf(pigBuildFolder, &isMsvcInitialized);
+			PrintLine("\n[Building %s for Windows...]", FILENAME_RES_PACKER_EXE);
+			
+			CliArgs cmd = EMPTY;
+			AddArgNt(&cmd, CLI_QUOTED_ARG, "[ROOT]/src/res_packer/res_packer_main.c");
+			AddArgNt(&cmd, CL_BINARY_FILE, FILENAME_RES_PACKER_EXE);
+			AddArgList(&cmd, &pigCoreCompilerFlags);
+			AddArg(&cmd, CL_LINK);
+			AddArgList(&cmd, &pigCoreLinkerFlags);
+			
+			StrArray tags = EMPTY;
+			AddStrArray(&tags, &resPackerTags);
+			AddTag(&tags, T_MSVC_CL);
+			AddTag(&tags, T_WINDOWS);
+			AddStrArray(&tags, &buildConfigTags);
+			
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_RES_PACKER_EXE "!"), Str_Empty, StrLit(FILENAME_RES_PACKER_EXE));
+			job->finishedMessage = StrLit("[Built " FILENAME_RES_PACKER_EXE " for Windows!]");
+		}
+		if (BUILD_LINUX)
+		{
+			PrintLine("\n[Building %s for Linux...]", FILENAME_RES_PACKER);
+			
+			CliArgs cmd = EMPTY;
+			cmd.pathSepChar = '/';
+			AddArgNt(&cmd, CLI_QUOTED_ARG, "[ROOT]/src/res_packer/res_packer_main.c");
+			AddArgNt(&cmd, CLANG_OUTPUT_FILE, FILENAME_RES_PACKER);
+			AddArgList(&cmd, &pigCoreCompilerFlags);
+			AddArgList(&cmd, &pigCoreLinkerFlags);
+			
+			StrArray tags = EMPTY;
+			AddStrArray(&tags, &resPackerTags);
+			AddTag(&tags, T_CLANG);
+			AddTag(&tags, T_LINUX);
+			AddTag(&tags, T_UNIX);
+			AddStrArray(&tags, &buildConfigTags);
+			
+			#if BUILDING_ON_LINUX
+			Str clangExe = StrLit(EXE_CLANG);
+			#else
+			Str clangExe = StrLit(EXE_WSL_CLANG);
+			mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
+			cmd.rootDirPath = StrLit("../..");
+			#endif
+			
+			BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, StrLit("Failed to build " FILENAME_RES_PACKER "!"), StrLit(LINUX_JOB_FOLDER), StrLit(LINUX_JOB_PREFIX FILENAME_RES_PACKER));
+			job->finishedMessage = StrLit("[Built " FILENAME_RES_PACKER " for Linux!]");
+		}
+		if (BUILD_OSX)
+		{
+			PrintLine("\n[Building %s for OSX...]", FILENAME_RES_PACKER);
+			
+			CliArgs cmd = EMPTY;
+			AddArgNt(&cmd, CLI_QUOTED_ARG, "[ROOT]/src/res_packer/res_packer_main.c");
+			AddArgNt(&cmd, CLANG_OUTPUT_FILE, FILENAME_RES_PACKER);
+			AddArgList(&cmd, &pigCoreCompilerFlags);
+			AddArgList(&cmd, &pigCoreLinkerFlags);
+			
+			StrArray tags = EMPTY;
+			AddStrArray(&tags, &resPackerTags);
+			AddTag(&tags, T_CLANG);
+			AddTag(&tags, T_OSX);
+			AddTag(&tags, T_UNIX);
+			AddStrArray(&tags, &buildConfigTags);
+			
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_CLANG), &tags, &cmd, StrLit("Failed to build " FILENAME_RES_PACKER "!"), Str_Empty, StrLit(FILENAME_RES_PACKER));
+			job->finishedMessage = StrLit("[Built " FILENAME_RES_PACKER " for OSX!]");
+		}
+	}
+	
 	// +--------------------------------------------------------------+
 	// |                        Build Shaders                         |
 	// +--------------------------------------------------------------+
@@ -551,6 +1043,8 @@ int main(int argc, char* argv[])
 		// }
 		
 		// First use shdc.exe to generate header files for each .glsl file
+		u64* shdcHashes = (u64*)calloc(findContext.shaderPaths.length + 1, sizeof(u64));
+		bool* shdcRegenerated = (bool*)calloc(findContext.shaderPaths.length + 1, sizeof(bool));
 		for (u64 sIndex = 0; sIndex < findContext.shaderPaths.length; sIndex++)
 		{
 			Str shaderPath = findContext.shaderPaths.strings[sIndex];
@@ -566,16 +1060,42 @@ int main(int argc, char* argv[])
 			AddArgStr(&cmd, SHDC_INPUT, shaderPath);
 			AddArgStr(&cmd, SHDC_OUTPUT, headerPath);
 			
-			PrintLine("Generating \"%.*s\"...", StrPrint(realHeaderPath));
 			Str shdcExe = JoinStrings2(StrLit("../"), StrLit(EXE_SHDC));
 			FixPathSlashes(shdcExe, PATH_SEP_CHAR);
-			RunCliProgramAndExitOnFailure(shdcExe, &cmd, StrLit(EXE_SHDC_NAME " failed on TODO:!"));
-			AssertFileExist(realHeaderPath, true);
 			
+			StrArray shdcTags = EMPTY;
+			StrArray shdcInputs = EMPTY;
+			AddStr(&shdcInputs, realShaderPath);
+			shdcHashes[sIndex] = GetBuildStepHash(shdcExe, &shdcTags, &shdcInputs, NULL);
+			FreeStrArray(&shdcInputs);
+			if (IsBuildStepUpToDate(realHeaderPath, shdcHashes[sIndex]))
+			{
+				PrintLine("\"%.*s\" is up to date", StrPrint(realHeaderPath));
+			}
+			else
+			{
+				PrintLine("Generating \"%.*s\"...", StrPrint(realHeaderPath));
+				//NOTE: The manifest is filled in below, after we scrape the generated header
+				UpdateBuildStepManifest(realHeaderPath, shdcHashes[sIndex], false);
+				QueueBuildJob(&buildJobs, shdcExe, NULL, &cmd, JoinStrings3(StrLit(EXE_SHDC_NAME " failed on "), realShaderPath, StrLit("!")), Str_Empty, realHeaderPath);
+				shdcRegenerated[sIndex] = true;
+			}
+			free(realHeaderPath.chars);
+			free(realShaderPath.chars);
+		}
+		RunBuildJobs(&buildJobs);
+		for (u64 sIndex = 0; sIndex < findContext.shaderPaths.length; sIndex++)
+		{
+			if (!shdcRegenerated[sIndex]) { continue; }
+			Str realHeaderPath = StrReplace(findContext.headerPaths.strings[sIndex], StrLit("[ROOT]"), StrLit(".."));
+			Str realShaderPath = StrReplace(findContext.shaderPaths.strings[sIndex], StrLit("[ROOT]"), StrLit(".."));
 			ScrapeShaderHeaderFileAndAddExtraInfo(realHeaderPath, realShaderPath);
+			UpdateBuildStepManifest(realHeaderPath, shdcHashes[sIndex], true);
 			free(realHeaderPath.chars);
 			free(realShaderPath.chars);
 		}
+		free(shdcHashes);
+		free(shdcRegenerated);
 		
 		//Then compile each header file to an .o/.obj file
 		for (u64 sIndex = 0; sIndex < findContext.shaderPaths.length; sIndex++)
@@ -595,6 +1115,12 @@ int main(int argc, char* argv[])
 			PrintLine("Generating \"%.*s\"...", StrPrint(realSourcePath));
 			CreateAndWriteFile(realSourcePath, sourceFileContents, true);
 			
+			//The generated .c file #includes the shader header (and through it, everything the shader header pulls in)
+			StrArray shaderInputs = EMPTY;
+			AddStr(&shaderInputs, realSourcePath);
+			StrArray shaderIncludeDirs = EMPTY;
+			AddStr(&shaderIncludeDirs, StrReplace(headerDirectory, StrLit("[ROOT]"), StrLit("..")));
+			
 			StrArray shaderTags = EMPTY;
 			AddTag(&shaderTags, T_SHADER);
 			AddTag(&shaderTags, BUILDING_ON_OSX ? T_LANG_OBJECTIVEC : T_LANG_C);
@@ -617,9 +1143,15 @@ int main(int argc, char* argv[])
 				AddTag(&tags, T_WINDOWS);
 				AddStrArray(&tags, &buildConfigTags);
 				
-				Str errorMessage = JoinStrings3(StrLit("Failed to build "), objPath, StrLit(" for Windows!"));
-				RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, errorMessage);
-				AssertFileExist(objPath, true);
+				u64 stepHash = GetBuildStepHash(StrLit(EXE_MSVC_CL), &tags, &shaderInputs, &shaderIncludeDirs);
+				if (IsBuildStepUpToDate(objPath, stepHash)) { PrintLine("\"%.*s\" is up to date", StrPrint(objPath)); }
+				else
+				{
+					Str errorMessage = JoinStrings3(StrLit("Failed to build "), objPath, StrLit(" for Windows!"));
+					BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, errorMessage, Str_Empty, objPath);
+					job->hasManifest = true;
+					job->stepHash = stepHash;
+				}
 			}
 			if (BUILD_LINUX)
 			{
@@ -644,18 +1176,23 @@ int main(int argc, char* argv[])
 				Str clangExe = StrLit(EXE_CLANG);
 				#else
 				Str clangExe = StrLit(EXE_WSL_CLANG);
+				#endif
+				u64 stepHash = GetBuildStepHash(clangExe, &tags, &shaderInputs, &shaderIncludeDirs);
+				#if !BUILDING_ON_LINUX
 				mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
-				chdir(FOLDERNAME_LINUX);
 				cmd.rootDirPath = StrLit("../..");
 				#endif
 				
-				Str errorMessage = JoinStrings3(StrLit("Failed to build "), oPath, StrLit(" for Linux!"));
-				RunCliProgramAndExitOnFailureTags(clangExe, tags, &cmd, errorMessage);
-				AssertFileExist(oPath, true);
-				
-				#if !BUILDING_ON_LINUX
-				chdir("..");
-				#endif
+				Str oPathInBuild = JoinStrings2(StrLit(LINUX_JOB_PREFIX), oPath);
+				if (IsBuildStepUpToDate(oPathInBuild, stepHash)) { PrintLine("\"%.*s\" is up to date", StrPrint(oPath)); }
+				else
+				{
+					Str errorMessage = JoinStrings3(StrLit("Failed to build "), oPath, StrLit(" for Linux!"));
+					BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, errorMessage, StrLit(LINUX_JOB_FOLDER), oPathInBuild);
+					job->hasManifest = true;
+					job->stepHash = stepHash;
+				}
+				free(oPathInBuild.chars);
 			}
 			if (BUILD_OSX)
 			{
@@ -677,25 +1214,44 @@ int main(int argc, char* argv[])
 				AddTag(&tags, T_UNIX);
 				AddStrArray(&tags, &buildConfigTags);
 				
-				Str errorMessage = JoinStrings3(StrLit("Failed to build "), oPath, StrLit(" for OSX!"));
-				RunCliProgramAndExitOnFailureTags(StrLit(EXE_CLANG), tags, &cmd, errorMessage);
-				AssertFileExist(oPath, true);
+				u64 stepHash = GetBuildStepHash(StrLit(EXE_CLANG), &tags, &shaderInputs, &shaderIncludeDirs);
+				if (IsBuildStepUpToDate(oPath, stepHash)) { PrintLine("\"%.*s\" is up to date", StrPrint(oPath)); }
+				else
+				{
+					Str errorMessage = JoinStrings3(StrLit("Failed to build "), oPath, StrLit(" for OSX!"));
+					BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_CLANG), &tags, &cmd, errorMessage, Str_Empty, oPath);
+					job->hasManifest = true;
+					job->stepHash = stepHash;
+				}
 			}
 			if (BUILD_ANDROID)
 			{
+				//NOTE: Each architecture's object is compiled inside android/lib/[arch], the job does the chdir so the paths we hash and check here stay relative to the _build folder
 				mkdir(FOLDERNAME_ANDROID, FOLDER_PERMISSIONS);
-				chdir(FOLDERNAME_ANDROID);
-				mkdir("lib", FOLDER_PERMISSIONS);
-				chdir("lib");
+				mkdir(FOLDERNAME_ANDROID "/lib", FOLDER_PERMISSIONS);
 				
 				for (u64 archIndex = 1; archIndex < AndroidTargetArchitecture_Count; archIndex++)
 				{
 					AndroidTargetArchitecture architecture = (AndroidTargetArchitecture)archIndex;
-					mkdir(GetAndroidTargetArchitectureFolderName(architecture), FOLDER_PERMISSIONS);
-					chdir(GetAndroidTargetArchitectureFolderName(architecture));
+					Str archFolderPath = JoinStrings2(StrLit(FOLDERNAME_ANDROID "/lib/"), MakeStrNt(GetAndroidTargetArchitectureFolderName(architecture)));
+					CreateFolderStr(archFolderPath);
 					Str architectureStr = MakeStrNt(GetAndroidTargetArchitectureTargetStr(architecture));
 					
+					StrArray tags = EMPTY;
+					AddStrArray(&tags, &shaderTags);
+					AddTag(&tags, T_CLANG);
+					AddTag(&tags, T_ANDROID);
+					AddStr(&tags, architectureStr);
+					AddStrArray(&tags, &buildConfigTags);
+					
 					Str oPath = findContext.oPaths.strings[sIndex];
+					Str oPathInBuild = JoinStrings3(archFolderPath, StrLit("/"), oPath);
+					u64 stepHash = GetBuildStepHash(StrLit(EXE_CLANG), &tags, &shaderInputs, &shaderIncludeDirs);
+					if (IsBuildStepUpToDate(oPathInBuild, stepHash))
+					{
+						PrintLine("\"%.*s\" is up to date for %.*s", StrPrint(oPath), StrPrint(architectureStr));
+						continue;
+					}
 					
 					CliArgs cmd = EMPTY;
 					cmd.pathSepChar = '/';
@@ -707,25 +1263,20 @@ int main(int argc, char* argv[])
 					AddArgStr(&cmd, CLANG_TARGET_ARCHITECTURE, architectureStr);
 					AddArgList(&cmd, &pigCoreCompilerFlags);
 					
-					StrArray tags = EMPTY;
-					AddStrArray(&tags, &shaderTags);
-					AddTag(&tags, T_CLANG);
-					AddTag(&tags, T_ANDROID);
-					AddStr(&tags, architectureStr);
-					AddStrArray(&tags, &buildConfigTags);
-					
 					Str errorMessage = JoinStrings3(StrLit("Failed to build "), oPath, StrLit(" for Android!"));
-					RunCliProgramAndExitOnFailureTags(StrLit(EXE_CLANG), tags, &cmd, errorMessage);
-					AssertFileExist(oPath, true);
-					
-					chdir("..");
+					BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_CLANG), &tags, &cmd, errorMessage, archFolderPath, oPathInBuild);
+					job->hasManifest = true;
+					job->stepHash = stepHash;
 				}
-				
-				chdir("..");
-				chdir("..");
 			}
+			
+			FreeStrArray(&shaderInputs);
+			FreeStrArray(&shaderIncludeDirs);
 		}
 		
+		//NOTE: The queued commands still point at strings in findContext so we have to run them before we free those
+		RunBuildJobs(&buildJobs);
+		
 		FreeStrArray(&findContext.shaderPaths);
 		FreeStrArray(&findContext.headerPaths);
 		FreeStrArray(&findContext.sourcePaths);
@@ -745,6 +1296,9 @@ int main(int argc, char* argv[])
 		AddTag(&tracyTags, T_LANG_CPP);
 		AddTag(&tracyTags, T_LIBRARY);
 		
+		StrArray tracyInputs = EMPTY;
+		AddStr(&tracyInputs, StrLit("../src/third_party/tracy/TracyClient.cpp"));
+		
 		if (BUILD_WINDOWS)
 		{
 			InitializeMsvcIf(pigBuildFolder, &isMsvcInitialized);
@@ -765,9 +1319,15 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_WINDOWS);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, StrLit("Failed to build " FILENAME_TRACY_DLL "!"));
-			AssertFileExist(StrLit(FILENAME_TRACY_DLL), true);
-			PrintLine("[Built %s for Windows!]", FILENAME_TRACY_DLL);
+			u64 stepHash = GetBuildStepHash(StrLit(EXE_MSVC_CL), &tags, &tracyInputs, NULL);
+			if (IsBuildStepUpToDate(StrLit(FILENAME_TRACY_DLL), stepHash)) { PrintLine("[%s is up to date]", FILENAME_TRACY_DLL); }
+			else
+			{
+				BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_TRACY_DLL "!"), Str_Empty, StrLit(FILENAME_TRACY_DLL));
+				job->hasManifest = true;
+				job->stepHash = stepHash;
+				job->finishedMessage = StrLit("[Built " FILENAME_TRACY_DLL " for Windows!]");
+			}
 		}
 		if (BUILD_LINUX)
 		{
@@ -794,19 +1354,24 @@ int main(int argc, char* argv[])
 			Str clangExe = StrLit(EXE_CLANG);
 			#else
 			Str clangExe = StrLit(EXE_WSL_CLANG);
+			#endif
+			u64 stepHash = GetBuildStepHash(clangExe, &tags, &tracyInputs, NULL);
+			#if !BUILDING_ON_LINUX
 			mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
-			chdir(FOLDERNAME_LINUX);
 			cmd.rootDirPath = StrLit("../..");
 			#endif
 			
-			RunCliProgramAndExitOnFailureTags(clangExe, tags, &cmd, StrLit("Failed to build " FILENAME_TRACY_SO "!"));
-			AssertFileExist(StrLit(FILENAME_TRACY_SO), true);
-			PrintLine("[Built %s for Linux!]", FILENAME_TRACY_SO);
-			
-			#if !BUILDING_ON_LINUX
-			chdir("..");
-			#endif
+			if (IsBuildStepUpToDate(StrLit(LINUX_JOB_PREFIX FILENAME_TRACY_SO), stepHash)) { PrintLine("[%s is up to date]", FILENAME_TRACY_SO); }
+			else
+			{
+				BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, StrLit("Failed to build " FILENAME_TRACY_SO "!"), StrLit(LINUX_JOB_FOLDER), StrLit(LINUX_JOB_PREFIX FILENAME_TRACY_SO));
+				job->hasManifest = true;
+				job->stepHash = stepHash;
+				job->finishedMessage = StrLit("[Built " FILENAME_TRACY_SO " for Linux!]");
+			}
 		}
+		
+		FreeStrArray(&tracyInputs);
 	}
 	AddTaggedArgNt(&thingsToLink, EXE_MSVC_CL "|Windows|Program|PROFILING_ENABLED", CLI_QUOTED_ARG, FILENAME_TRACY_LIB);
 	AddTaggedArgNt(&thingsToLink, EXE_CLANG "|Linux|Program|PROFILING_ENABLED", CLI_QUOTED_ARG, FILENAME_TRACY_SO);
@@ -824,6 +1389,11 @@ int main(int argc, char* argv[])
 		AddTag(&imguiTags, T_LANG_CPP);
 		AddTag(&imguiTags, T_OBJECT);
 		
+		StrArray imguiInputs = EMPTY;
+		AddStr(&imguiInputs, StrLit("../src/ui/ui_imgui_main.cpp"));
+		StrArray imguiIncludeDirs = EMPTY;
+		AddStr(&imguiIncludeDirs, StrLit("../src/third_party/imgui/"));
+		
 		if (BUILD_WINDOWS)
 		{
 			InitializeMsvcIf(pigBuildFolder, &isMsvcInitialized);
@@ -841,9 +1411,15 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_WINDOWS);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, StrLit("Failed to build " FILENAME_IMGUI_OBJ "!"));
-			AssertFileExist(StrLit(FILENAME_IMGUI_OBJ), true);
-			PrintLine("[Built %s for Windows!]", FILENAME_IMGUI_OBJ);
+			u64 stepHash = GetBuildStepHash(StrLit(EXE_MSVC_CL), &tags, &imguiInputs, &imguiIncludeDirs);
+			if (IsBuildStepUpToDate(StrLit(FILENAME_IMGUI_OBJ), stepHash)) { PrintLine("[%s is up to date]", FILENAME_IMGUI_OBJ); }
+			else
+			{
+				BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_IMGUI_OBJ "!"), Str_Empty, StrLit(FILENAME_IMGUI_OBJ));
+				job->hasManifest = true;
+				job->stepHash = stepHash;
+				job->finishedMessage = StrLit("[Built " FILENAME_IMGUI_OBJ " for Windows!]");
+			}
 		}
 		if (BUILD_LINUX)
 		{
@@ -867,23 +1443,32 @@ int main(int argc, char* argv[])
 			Str clangExe = StrLit(EXE_CLANG);
 			#else
 			Str clangExe = StrLit(EXE_WSL_CLANG);
+			#endif
+			u64 stepHash = GetBuildStepHash(clangExe, &tags, &imguiInputs, &imguiIncludeDirs);
+			#if !BUILDING_ON_LINUX
 			mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
-			chdir(FOLDERNAME_LINUX);
 			cmd.rootDirPath = StrLit("../..");
 			#endif
 			
-			RunCliProgramAndExitOnFailureTags(clangExe, tags, &cmd, StrLit("Failed to build " FILENAME_IMGUI_O "!"));
-			AssertFileExist(StrLit(FILENAME_IMGUI_O), true);
-			PrintLine("[Built %s for Linux!]", FILENAME_IMGUI_O);
-			
-			#if !BUILDING_ON_LINUX
-			chdir("..");
-			#endif
+			if (IsBuildStepUpToDate(StrLit(LINUX_JOB_PREFIX FILENAME_IMGUI_O), stepHash)) { PrintLine("[%s is up to date]", FILENAME_IMGUI_O); }
+			else
+			{
+				BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, StrLit("Failed to build " FILENAME_IMGUI_O "!"), StrLit(LINUX_JOB_FOLDER), StrLit(LINUX_JOB_PREFIX FILENAME_IMGUI_O));
+				job->hasManifest = true;
+				job->stepHash = stepHash;
+				job->finishedMessage = StrLit("[Built " FILENAME_IMGUI_O " for Linux!]");
+			}
 		}
+		
+		FreeStrArray(&imguiInputs);
+		FreeStrArray(&imguiIncludeDirs);
 	}
 	AddTaggedArgNt(&thingsToLink, EXE_MSVC_CL "|Windows|Program|BUILD_WITH_IMGUI", CLI_QUOTED_ARG, FILENAME_IMGUI_OBJ);
 	AddTaggedArgNt(&thingsToLink, EXE_CLANG "|LinuxOrOsx|Program|BUILD_WITH_IMGUI", CLI_QUOTED_ARG, FILENAME_IMGUI_O);
 	
+	//NOTE: physx_capi.obj links against thingsToLink, which now includes tracy.lib, so tracy has to finish first
+	RunBuildJobs(&buildJobs);
+	
 	// +--------------------------------------------------------------+
 	// |                     Build physx_capi.obj                     |
 	// +--------------------------------------------------------------+
@@ -896,6 +1481,9 @@ int main(int argc, char* argv[])
 		AddTag(&physxTags, T_LANG_CPP);
 		AddTag(&physxTags, T_OBJECT);
 		
+		StrArray physxInputs = EMPTY;
+		AddStr(&physxInputs, StrLit("../src/phys/phys_physx_capi_main.cpp"));
+		
 		if (BUILD_WINDOWS)
 		{
 			InitializeMsvcIf(pigBuildFolder, &isMsvcInitialized);
@@ -916,18 +1504,28 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_WINDOWS);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, StrLit("Failed to build " FILENAME_PHYSX_OBJ "!"));
-			AssertFileExist(StrLit(FILENAME_PHYSX_OBJ), true);
-			PrintLine("[Built %s for Windows!]", FILENAME_PHYSX_OBJ);
+			u64 stepHash = GetBuildStepHash(StrLit(EXE_MSVC_CL), &tags, &physxInputs, NULL);
+			if (IsBuildStepUpToDate(StrLit(FILENAME_PHYSX_OBJ), stepHash)) { PrintLine("[%s is up to date]", FILENAME_PHYSX_OBJ); }
+			else
+			{
+				BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_PHYSX_OBJ "!"), Str_Empty, StrLit(FILENAME_PHYSX_OBJ));
+				job->hasManifest = true;
+				job->stepHash = stepHash;
+				job->finishedMessage = StrLit("[Built " FILENAME_PHYSX_OBJ " for Windows!]");
+			}
 		}
 		if (BUILD_LINUX)
 		{
 			//TODO: Implement Linux version!
 		}
+		
+		FreeStrArray(&physxInputs);
 	}
 	AddTaggedArgNt(&thingsToLink, EXE_MSVC_CL "|Windows|Program|BUILD_WITH_PHYSX", CLI_QUOTED_ARG, FILENAME_PHYSX_OBJ);
 	// AddTaggedArgNt(&thingsToLink, EXE_MSVC_CL "|LinuxOrOsx|Program|BUILD_WITH_PHYSX", CLI_QUOTED_ARG, FILENAME_PHYSX_O); //TODO: Uncomment me once we actually build this on LinuxOrOsx!
 	
+	RunBuildJobs(&buildJobs);
+	
 	// +--------------------------------------------------------------+
 	// |                      Build pig_core.dll                      |
 	// +--------------------------------------------------------------+
@@ -958,9 +1556,8 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_WINDOWS);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, StrLit("Failed to build " FILENAME_PIG_CORE_DLL "!"));
-			AssertFileExist(StrLit(FILENAME_PIG_CORE_DLL), true);
-			PrintLine("[Built %s for Windows!]", FILENAME_PIG_CORE_DLL);
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_PIG_CORE_DLL "!"), Str_Empty, StrLit(FILENAME_PIG_CORE_DLL));
+			job->finishedMessage = StrLit("[Built " FILENAME_PIG_CORE_DLL " for Windows!]");
 		}
 		if (BUILD_LINUX)
 		{
@@ -988,17 +1585,11 @@ int main(int argc, char* argv[])
 			#else
 			Str clangExe = StrLit(EXE_WSL_CLANG);
 			mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
-			chdir(FOLDERNAME_LINUX);
 			cmd.rootDirPath = StrLit("../..");
 			#endif
 			
-			RunCliProgramAndExitOnFailureTags(clangExe, tags, &cmd, StrLit("Failed to build " FILENAME_PIG_CORE_SO "!"));
-			AssertFileExist(StrLit(FILENAME_PIG_CORE_SO), true);
-			PrintLine("[Built %s for Linux!]", FILENAME_PIG_CORE_SO);
-			
-			#if !BUILDING_ON_LINUX
-			chdir("..");
-			#endif
+			BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, StrLit("Failed to build " FILENAME_PIG_CORE_SO "!"), StrLit(LINUX_JOB_FOLDER), StrLit(LINUX_JOB_PREFIX FILENAME_PIG_CORE_SO));
+			job->finishedMessage = StrLit("[Built " FILENAME_PIG_CORE_SO " for Linux!]");
 		}
 	}
 	
@@ -1037,9 +1628,8 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_WINDOWS);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_MSVC_CL), tags, &cmd, StrLit("Failed to build " FILENAME_TESTS_EXE "!"));
-			AssertFileExist(StrLit(FILENAME_TESTS_EXE), true);
-			PrintLine("[Built %s for Windows!]", FILENAME_TESTS_EXE);
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_MSVC_CL), &tags, &cmd, StrLit("Failed to build " FILENAME_TESTS_EXE "!"), Str_Empty, StrLit(FILENAME_TESTS_EXE));
+			job->finishedMessage = StrLit("[Built " FILENAME_TESTS_EXE " for Windows!]");
 		}
 		
 		// +==============================+
@@ -1070,17 +1660,11 @@ int main(int argc, char* argv[])
 			#else
 			Str clangExe = StrLit(EXE_WSL_CLANG);
 			mkdir(FOLDERNAME_LINUX, FOLDER_PERMISSIONS);
-			chdir(FOLDERNAME_LINUX);
 			cmd.rootDirPath = StrLit("../..");
 			#endif
 			
-			RunCliProgramAndExitOnFailureTags(clangExe, tags, &cmd, StrLit("Failed to build " FILENAME_TESTS "!"));
-			AssertFileExist(StrLit(FILENAME_TESTS), true);
-			PrintLine("[Built %s for Linux!]", FILENAME_TESTS);
-			
-			#if !BUILDING_ON_LINUX
-			chdir("..");
-			#endif
+			BuildJob* job = QueueBuildJob(&buildJobs, clangExe, &tags, &cmd, StrLit("Failed to build " FILENAME_TESTS "!"), StrLit(LINUX_JOB_FOLDER), StrLit(LINUX_JOB_PREFIX FILENAME_TESTS));
+			job->finishedMessage = StrLit("[Built " FILENAME_TESTS " for Linux!]");
 		}
 		
 		// +==============================+
@@ -1104,11 +1688,13 @@ int main(int argc, char* argv[])
 			AddTag(&tags, T_UNIX);
 			AddStrArray(&tags, &buildConfigTags);
 			
-			RunCliProgramAndExitOnFailureTags(StrLit(EXE_CLANG), tags, &cmd, StrLit("Failed to build " FILENAME_TESTS "!"));
-			AssertFileExist(StrLit(FILENAME_TESTS), true);
-			PrintLine("[Built %s for OSX!]", FILENAME_TESTS);
+			BuildJob* job = QueueBuildJob(&buildJobs, StrLit(EXE_CLANG), &tags, &cmd, StrLit("Failed to build " FILENAME_TESTS "!"), Str_Empty, StrLit(FILENAME_TESTS));
+			job->finishedMessage = StrLit("[Built " FILENAME_TESTS " for OSX!]");
 		}
 		
+		//NOTE: The remaining platforms chdir into their folders and build serially, so we finish the queued jobs (including pig_core) before any of them run
+		RunBuildJobs(&buildJobs);
+		
 		// +==============================+
 		// |          Web tests           |
 		// +==============================+
@@ -1531,6 +2117,7 @@ int main(int argc, char* argv[])
 			PrintLine("[Packaged %s for Playdate!]", FILENAME_TESTS_PDX);
 		}
 	}
+	RunBuildJobs(&buildJobs); //NOTE: In case pig_core was queued without BUILD_TESTS
 	
 	// +--------------------------------------------------------------+
 	// |                Generate compile_commands.json                |
@@ -23,6 +23,7 @@ Description:
 #include "base/base_math.h"
 #include "base/base_notifications.h"
 #include "base/base_plex_is_struct.h"
+#include "base/base_simd.h"
 #include "base/base_typedefs.h"
 #include "base/base_unicode.h"
 #include "os/os_threading.h"
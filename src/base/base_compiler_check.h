@@ -171,6 +171,32 @@ Description:
 #define TARGET_HAS_ATOMICS 1
 #endif
 
+//NOTE: These only describe which 128-bit SIMD instruction set we are allowed to assume (see base_simd.h)
+//      Wasm SIMD is only enabled when compiling with -msimd128, NEON is only assumed on 64-bit ARM
+#if (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !TARGET_IS_WASM && !TARGET_IS_PLAYDATE_DEVICE
+#define TARGET_HAS_SSE2 1
+#else
+#define TARGET_HAS_SSE2 0
+#endif
+
+#if (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__ARM_NEON) || defined(_M_ARM64)) && !TARGET_HAS_SSE2
+#define TARGET_HAS_NEON 1
+#else
+#define TARGET_HAS_NEON 0
+#endif
+
+#if defined(__wasm_simd128__) && TARGET_IS_WASM
+#define TARGET_HAS_WASM_SIMD 1
+#else
+#define TARGET_HAS_WASM_SIMD 0
+#endif
+
+#if (TARGET_HAS_SSE2 || TARGET_HAS_NEON || TARGET_HAS_WASM_SIMD)
+#define TARGET_HAS_SIMD 1
+#else
+#define TARGET_HAS_SIMD 0
+#endif
+
 #if (TARGET_IS_WEB && !COMPILER_IS_EMSCRIPTEN)
 #define USING_CUSTOM_STDLIB 1
 #else
@@ -0,0 +1,168 @@
+/*
+File:   base_simd.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** Contains a very small abstraction over 128-bit SIMD instructions (SSE2, NEON or Wasm SIMD128)
+	** that is just big enough for the byte-scanning loops in the rest of the codebase (substring search,
+	** character set scanning, etc.). The vector operations are all macros so they get inlined at every usage site.
+	** When TARGET_HAS_SIMD is 0 the SimdU8x16 macros are not defined and usage code is expected to
+	** #if guard the vectorized path and fall back to a regular byte-by-byte loop
+	** NOTE: SimdU8x16_Mask returns a 16-bit mask with bit N set if the high bit of byte N is set.
+	** All the comparison macros produce 0xFF or 0x00 in each byte so they can be passed to SimdU8x16_Mask directly
+*/
+
+#ifndef _BASE_SIMD_H
+#define _BASE_SIMD_H
+
+#include "base/base_compiler_check.h"
+#include "base/base_defines_check.h"
+#include "base/base_typedefs.h"
+#include "std/std_includes.h"
+
+#define SIMD_U8X16_SIZE 16 //bytes
+
+#if TARGET_HAS_SSE2
+typedef __m128i SimdU8x16;
+#elif TARGET_HAS_NEON
+typedef uint8x16_t SimdU8x16;
+#elif TARGET_HAS_WASM_SIMD
+typedef v128_t SimdU8x16;
+#endif
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	PIG_CORE_INLINE u8 CountTrailingZerosU32(u32 value);
+	PIG_CORE_INLINE u8 CountTrailingZerosU64(u64 value);
+	PIG_CORE_INLINE u8 CountLeadingZerosU64(u64 value);
+	PIG_CORE_INLINE u8 CountBitsSetU32(u32 value);
+	#if TARGET_HAS_NEON
+	PIG_CORE_INLINE u32 SimdU8x16_MaskNeon(SimdU8x16 vector);
+	#endif
+#endif
+
+// +--------------------------------------------------------------+
+// |                            Macros                            |
+// +--------------------------------------------------------------+
+//NOTE: The U16 macros treat a SimdU8x16 as 8 little-endian u16 lanes, all our SIMD targets are little-endian
+//NOTE: Macros that take (vector) more than once evaluate it more than once, pass a variable, not an expression with side effects
+#if TARGET_HAS_SSE2
+#define SimdU8x16_Load(pntr)                _mm_loadu_si128((const __m128i*)(pntr))
+#define SimdU8x16_Store(pntr, vector)       _mm_storeu_si128((__m128i*)(pntr), (vector))
+#define SimdU8x16_Splat(value)              _mm_set1_epi8((char)(value))
+#define SimdU8x16_Equal(left, right)        _mm_cmpeq_epi8((left), (right))
+#define SimdU8x16_Or(left, right)           _mm_or_si128((left), (right))
+#define SimdU8x16_And(left, right)          _mm_and_si128((left), (right))
+#define SimdU8x16_AndNot(left, right)       _mm_andnot_si128((right), (left)) //left & ~right
+#define SimdU8x16_InRange(vector, min, max) _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8((vector), (min)), (max)), (vector)) //unsigned, inclusive
+#define SimdU8x16_Mask(vector)              (u32)_mm_movemask_epi8(vector)
+#define SimdU8x16_WidenLowU16(vector)       _mm_unpacklo_epi8((vector), _mm_setzero_si128()) //first 8 bytes zero-extended to 8 u16 lanes
+#define SimdU8x16_WidenHighU16(vector)      _mm_unpackhi_epi8((vector), _mm_setzero_si128()) //last 8 bytes zero-extended to 8 u16 lanes
+#define SimdU8x16_NarrowU16(low, high)      _mm_packus_epi16(_mm_and_si128((low), _mm_set1_epi16(0x00FF)), _mm_and_si128((high), _mm_set1_epi16(0x00FF))) //low byte of each u16 lane
+#elif TARGET_HAS_NEON
+#define SimdU8x16_Load(pntr)                vld1q_u8((const u8*)(pntr))
+#define SimdU8x16_Store(pntr, vector)       vst1q_u8((u8*)(pntr), (vector))
+#define SimdU8x16_Splat(value)              vdupq_n_u8((u8)(value))
+#define SimdU8x16_Equal(left, right)        vceqq_u8((left), (right))
+#define SimdU8x16_Or(left, right)           vorrq_u8((left), (right))
+#define SimdU8x16_And(left, right)          vandq_u8((left), (right))
+#define SimdU8x16_AndNot(left, right)       vbicq_u8((left), (right)) //left & ~right
+#define SimdU8x16_InRange(vector, min, max) vandq_u8(vcgeq_u8((vector), (min)), vcleq_u8((vector), (max))) //unsigned, inclusive
+#define SimdU8x16_Mask(vector)              SimdU8x16_MaskNeon(vector)
+#define SimdU8x16_WidenLowU16(vector)       vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(vector))) //first 8 bytes zero-extended to 8 u16 lanes
+#define SimdU8x16_WidenHighU16(vector)      vreinterpretq_u8_u16(vmovl_high_u8(vector)) //last 8 bytes zero-extended to 8 u16 lanes
+#define SimdU8x16_NarrowU16(low, high)      vuzp1q_u8((low), (high)) //low byte of each u16 lane
+#elif TARGET_HAS_WASM_SIMD
+#define SimdU8x16_Load(pntr)                wasm_v128_load((const void*)(pntr))
+#define SimdU8x16_Store(pntr, vector)       wasm_v128_store((void*)(pntr), (vector))
+#define SimdU8x16_Splat(value)              wasm_i8x16_splat((i8)(value))
+#define SimdU8x16_Equal(left, right)        wasm_i8x16_eq((left), (right))
+#define SimdU8x16_Or(left, right)           wasm_v128_or((left), (right))
+#define SimdU8x16_And(left, right)          wasm_v128_and((left), (right))
+#define SimdU8x16_AndNot(left, right)       wasm_v128_andnot((left), (right)) //left & ~right
+#define SimdU8x16_InRange(vector, min, max) wasm_v128_and(wasm_u8x16_ge((vector), (min)), wasm_u8x16_le((vector), (max))) //unsigned, inclusive
+#define SimdU8x16_Mask(vector)              (u32)wasm_i8x16_bitmask(vector)
+#define SimdU8x16_WidenLowU16(vector)       wasm_u16x8_extend_low_u8x16(vector) //first 8 bytes zero-extended to 8 u16 lanes
+#define SimdU8x16_WidenHighU16(vector)      wasm_u16x8_extend_high_u8x16(vector) //last 8 bytes zero-extended to 8 u16 lanes
+#define SimdU8x16_NarrowU16(low, high)      wasm_i8x16_shuffle((low), (high), 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30) //low byte of each u16 lane
+#endif
+
+#if TARGET_HAS_SIMD
+//Turns any uppercase ASCII letters into lowercase, all other bytes are left alone
+#define SimdU8x16_ToLowerAscii(vector) SimdU8x16_Or((vector), SimdU8x16_And(SimdU8x16_InRange((vector), SimdU8x16_Splat('A'), SimdU8x16_Splat('Z')), SimdU8x16_Splat(0x20)))
+#endif
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+//NOTE: value must be non-zero
+PEXPI u8 CountTrailingZerosU32(u32 value)
+{
+	#if COMPILER_IS_MSVC
+	unsigned long result = 0;
+	_BitScanForward(&result, (unsigned long)value);
+	return (u8)result;
+	#else
+	return (u8)__builtin_ctz(value);
+	#endif
+}
+//NOTE: value must be non-zero
+PEXPI u8 CountTrailingZerosU64(u64 value)
+{
+	#if COMPILER_IS_MSVC && TARGET_IS_64BIT
+	unsigned long result = 0;
+	_BitScanForward64(&result, (unsigned __int64)value);
+	return (u8)result;
+	#elif COMPILER_IS_MSVC
+	if ((u32)value != 0) { return CountTrailingZerosU32((u32)value); }
+	return 32 + CountTrailingZerosU32((u32)(value >> 32));
+	#else
+	return (u8)__builtin_ctzll(value);
+	#endif
+}
+//NOTE: value must be non-zero
+PEXPI u8 CountLeadingZerosU64(u64 value)
+{
+	#if COMPILER_IS_MSVC && TARGET_IS_64BIT
+	unsigned long result = 0;
+	_BitScanReverse64(&result, (unsigned __int64)value);
+	return (u8)(63 - result);
+	#elif COMPILER_IS_MSVC
+	unsigned long result = 0;
+	if ((value >> 32) != 0) { _BitScanReverse(&result, (unsigned long)(value >> 32)); return (u8)(31 - result); }
+	_BitScanReverse(&result, (unsigned long)value);
+	return (u8)(63 - result);
+	#else
+	return (u8)__builtin_clzll(value);
+	#endif
+}
+PEXPI u8 CountBitsSetU32(u32 value)
+{
+	#if COMPILER_IS_MSVC
+	//NOTE: __popcnt requires the POPCNT instruction which we don't want to assume, so we do the regular bit-twiddling version
+	value = value - ((value >> 1) & 0x55555555UL);
+	value = (value & 0x33333333UL) + ((value >> 2) & 0x33333333UL);
+	return (u8)((((value + (value >> 4)) & 0x0F0F0F0FUL) * 0x01010101UL) >> 24);
+	#else
+	return (u8)__builtin_popcount(value);
+	#endif
+}
+
+#if TARGET_HAS_NEON
+//NEON has no movemask instruction, so we smear the high bit across each byte, weight each byte by it's bit position, and add each half horizontally
+PEXPI u32 SimdU8x16_MaskNeon(SimdU8x16 vector)
+{
+	static const u8 bitWeights[SIMD_U8X16_SIZE] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+	uint8x16_t highBits = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(vector), 7));
+	uint8x16_t weighted = vandq_u8(highBits, vld1q_u8(&bitWeights[0]));
+	return (u32)vaddv_u8(vget_low_u8(weighted)) | ((u32)vaddv_u8(vget_high_u8(weighted)) << 8);
+}
+#endif //TARGET_HAS_NEON
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //  _BASE_SIMD_H
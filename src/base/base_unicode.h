@@ -20,6 +20,7 @@ Description:
 #include "base/base_typedefs.h"
 #include "base/base_assert.h"
 #include "base/base_char.h"
+#include "base/base_simd.h"
 
 // There are 2,470 combining codepoints: https://codepoints.net/search?lb=CM
 
@@ -164,12 +165,19 @@ Description:
 	u8 GetUtf8BytesForCode(u32 codepoint, u8* byteBufferOut, bool doAssertions);
 	u8 GetCodepointUtf8Size(u32 codepoint);
 	u8 GetCodepointForUtf8(u64 maxNumBytes, const char* strPntr, u32* codepointOut);
+	PIG_CORE_INLINE u8 GetCodepointForUtf8Strict(u64 maxNumBytes, const char* strPntr, u32* codepointOut);
 	u8 GetPrevCodepointForUtf8(u64 numBytesBeforePntr, const char* strEndPntr, u32* codepointOut);
 	u8 GetCodepointBeforeIndex(const char* strPntr, u64 startIndex, u32* codepointOut);
 	i32 CompareCodepoints(u32 codepoint1, u32 codepoint2);
 	bool DoesNtStrContainMultibyteUtf8Chars(const char* nullTermStr);
+	uxx FindNextNonAsciiByte(uxx numBytes, const char* bytesPntr, uxx startIndex);
+	bool IsValidUtf8(uxx numBytes, const char* bytesPntr, uxx* invalidIndexOut);
+	uxx CountUtf8Codepoints(uxx numBytes, const char* bytesPntr);
+	uxx GetUtf8ByteIndexForCodepointIndex(uxx numBytes, const char* bytesPntr, uxx codepointIndex);
 	u8 GetUcs2WordsForCode(u32 codepoint, u16* wordBufferOut, bool doAssertions);
 	u8 GetCodepointForUcs2(u64 maxNumWords, const u16* strPntr, u32* codepointOut);
+	bool TranscodeUtf8ToUcs2(uxx numBytes, const char* bytesPntr, uxx maxNumWords, u16* wordsOut, uxx* numWordsOut);
+	bool TranscodeUcs2ToUtf8(uxx numWords, const u16* wordsPntr, uxx maxNumBytes, char* bytesOut, uxx* numBytesOut);
 	PIG_CORE_INLINE u32 GetMonospaceCodepointFor(u32 codepoint);
 	PIG_CORE_INLINE u32 GetRegularCodepointForMonospace(u32 monospaceCodepoint);
 	PIG_CORE_INLINE bool IsWordBoundary(u32 prevCodepoint, u32 nextCodepoint);
@@ -376,6 +384,17 @@ PEXP u8 GetCodepointForUtf8(u64 maxNumBytes, const char* strPntr, u32* codepoint
 	}
 }
 
+//Same as GetCodepointForUtf8 but also returns 0 for overlong encodings (like C0 80 for \0), UTF-16 surrogates (U+D800-U+DFFF)
+//and anything above UTF8_MAX_CODEPOINT. This is the definition of "valid" that IsValidUtf8 and TranscodeUtf8ToUcs2 use
+PEXPI u8 GetCodepointForUtf8Strict(u64 maxNumBytes, const char* strPntr, u32* codepointOut)
+{
+	u32 codepoint = 0;
+	u8 codepointSize = GetCodepointForUtf8(maxNumBytes, strPntr, &codepoint);
+	if (codepointSize == 0 || codepointSize != GetCodepointUtf8Size(codepoint)) { SetOptionalOutPntr(codepointOut, 0); return 0; }
+	SetOptionalOutPntr(codepointOut, codepoint);
+	return codepointSize;
+}
+
 // This is sort of like GetCodepointForUtf8 but it walks backwards from the pointer until it finds a valid UTF-8 byte sequence
 PEXP u8 GetPrevCodepointForUtf8(u64 numBytesBeforePntr, const char* strEndPntr, u32* codepointOut)
 {
@@ -515,15 +534,127 @@ PEXP bool DoesNtStrContainMultibyteUtf8Chars(const char* nullTermStr)
 {
 	for (uxx bIndex = 0; nullTermStr[bIndex] != '\0'; bIndex++)
 	{
+		if (CharToU8(nullTermStr[bIndex]) < 0x80) { continue; }
 		u8 numCharsLeft = nullTermStr[bIndex+1] == '\0' ? 1
 			: (nullTermStr[bIndex+2] == '\0' ? 2
 			: (nullTermStr[bIndex+3] == '\0' ? 3
 			: 4));
-		if (GetCodepointForUtf8(numCharsLeft, nullTermStr + bIndex, nullptr) > 0) { return true; }
+		if (GetCodepointForUtf8(numCharsLeft, nullTermStr + bIndex, nullptr) > 1) { return true; }
 	}
 	return false;
 }
 
+// +--------------------------------------------------------------+
+// |                     Bulk UTF-8 Functions                     |
+// +--------------------------------------------------------------+
+// These work on whole buffers at once rather than one codepoint per call. Runs of ASCII (and continuation byte counting)
+// are handled 16 or 32 bytes at a time when TARGET_HAS_SIMD, anything else falls back to GetCodepointForUtf8Strict
+
+//Returns numBytes if there are no bytes >= 0x80 at or after startIndex
+PEXP uxx FindNextNonAsciiByte(uxx numBytes, const char* bytesPntr, uxx startIndex)
+{
+	Assert(bytesPntr != nullptr || numBytes == 0);
+	Assert(startIndex <= numBytes);
+	uxx bIndex = startIndex;
+	#if TARGET_HAS_SIMD
+	for (; bIndex + SIMD_U8X16_SIZE*2 <= numBytes; bIndex += SIMD_U8X16_SIZE*2)
+	{
+		SimdU8x16 block1 = SimdU8x16_Load(&bytesPntr[bIndex]);
+		SimdU8x16 block2 = SimdU8x16_Load(&bytesPntr[bIndex + SIMD_U8X16_SIZE]);
+		u32 nonAsciiMask = SimdU8x16_Mask(block1) | (SimdU8x16_Mask(block2) << SIMD_U8X16_SIZE);
+		if (nonAsciiMask != 0) { return bIndex + CountTrailingZerosU32(nonAsciiMask); }
+	}
+	for (; bIndex + SIMD_U8X16_SIZE <= numBytes; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 block = SimdU8x16_Load(&bytesPntr[bIndex]);
+		u32 nonAsciiMask = SimdU8x16_Mask(block);
+		if (nonAsciiMask != 0) { return bIndex + CountTrailingZerosU32(nonAsciiMask); }
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < numBytes; bIndex++)
+	{
+		if (CharToU8(bytesPntr[bIndex]) >= 0x80) { return bIndex; }
+	}
+	return numBytes;
+}
+
+//Valid means every character can be decoded by GetCodepointForUtf8Strict (no overlong encodings, surrogates or codepoints above UTF8_MAX_CODEPOINT)
+//invalidIndexOut gets the byte index of the first character that can't be (or numBytes)
+PEXP bool IsValidUtf8(uxx numBytes, const char* bytesPntr, uxx* invalidIndexOut)
+{
+	Assert(bytesPntr != nullptr || numBytes == 0);
+	uxx bIndex = 0;
+	while (bIndex < numBytes)
+	{
+		if (CharToU8(bytesPntr[bIndex]) < 0x80)
+		{
+			bIndex = FindNextNonAsciiByte(numBytes, bytesPntr, bIndex);
+			if (bIndex >= numBytes) { break; }
+		}
+		u8 codepointSize = GetCodepointForUtf8Strict(numBytes - bIndex, &bytesPntr[bIndex], nullptr);
+		if (codepointSize == 0) { SetOptionalOutPntr(invalidIndexOut, bIndex); return false; }
+		bIndex += codepointSize;
+	}
+	SetOptionalOutPntr(invalidIndexOut, numBytes);
+	return true;
+}
+
+//NOTE: This counts every byte that is not a continuation byte (10xx xxxx). For valid UTF-8 (see IsValidUtf8) that is exactly the number of codepoints,
+//      for invalid UTF-8 it's a reasonable estimate but may not match the number of characters a decoding loop would produce
+PEXP uxx CountUtf8Codepoints(uxx numBytes, const char* bytesPntr)
+{
+	Assert(bytesPntr != nullptr || numBytes == 0);
+	uxx result = 0;
+	uxx bIndex = 0;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 continuationMin = SimdU8x16_Splat(0x80);
+	SimdU8x16 continuationMax = SimdU8x16_Splat(0xBF);
+	for (; bIndex + SIMD_U8X16_SIZE <= numBytes; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 block = SimdU8x16_Load(&bytesPntr[bIndex]);
+		u32 continuationMask = SimdU8x16_Mask(SimdU8x16_InRange(block, continuationMin, continuationMax));
+		result += SIMD_U8X16_SIZE - CountBitsSetU32(continuationMask);
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < numBytes; bIndex++)
+	{
+		u8 byte = CharToU8(bytesPntr[bIndex]);
+		if (byte < 0x80 || byte >= 0xC0) { result++; }
+	}
+	return result;
+}
+
+//Returns the byte index where the codepoint at codepointIndex starts, or numBytes if there are not that many codepoints
+//NOTE: Like CountUtf8Codepoints this only looks for non-continuation bytes, so GetUtf8ByteIndexForCodepointIndex(n, CountUtf8Codepoints(n)) == n
+PEXP uxx GetUtf8ByteIndexForCodepointIndex(uxx numBytes, const char* bytesPntr, uxx codepointIndex)
+{
+	Assert(bytesPntr != nullptr || numBytes == 0);
+	uxx numCodepointsBefore = 0;
+	uxx bIndex = 0;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 continuationMin = SimdU8x16_Splat(0x80);
+	SimdU8x16 continuationMax = SimdU8x16_Splat(0xBF);
+	for (; bIndex + SIMD_U8X16_SIZE <= numBytes; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 block = SimdU8x16_Load(&bytesPntr[bIndex]);
+		u32 continuationMask = SimdU8x16_Mask(SimdU8x16_InRange(block, continuationMin, continuationMax));
+		uxx numCodepointsInBlock = SIMD_U8X16_SIZE - CountBitsSetU32(continuationMask);
+		if (numCodepointsBefore + numCodepointsInBlock > codepointIndex) { break; } //the scalar loop below will find the exact byte
+		numCodepointsBefore += numCodepointsInBlock;
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < numBytes; bIndex++)
+	{
+		u8 byte = CharToU8(bytesPntr[bIndex]);
+		if (byte < 0x80 || byte >= 0xC0)
+		{
+			if (numCodepointsBefore == codepointIndex) { return bIndex; }
+			numCodepointsBefore++;
+		}
+	}
+	return numBytes;
+}
+
 // +--------------------------------------------------------------+
 // |                       UCS-2 Functions                        |
 // +--------------------------------------------------------------+
@@ -555,13 +686,129 @@ PEXP u8 GetUcs2WordsForCode(u32 codepoint, u16* wordBufferOut, bool doAssertions
 	}
 }
 
+//returns the number of words (1 or 2) that were decoded, or 0 if the words are not valid UCS-2 (like an unpaired surrogate)
 PEXP u8 GetCodepointForUcs2(u64 maxNumWords, const u16* strPntr, u32* codepointOut)
 {
-	UNUSED(maxNumWords);
-	UNUSED(strPntr);
-	UNUSED(codepointOut);
-	Assert(false); //TODO: Implement me!
-	return 0;
+	if (maxNumWords == 0) { return 0; }
+	NotNull(strPntr);
+	u16 firstWord = strPntr[0];
+	if (firstWord < 0xD800 || firstWord > 0xDFFF)
+	{
+		SetOptionalOutPntr(codepointOut, (u32)firstWord);
+		return 1;
+	}
+	if (firstWord >= 0xDC00) { return 0; } //a low surrogate can't be the first word
+	if (maxNumWords < 2) { return 0; }
+	u16 secondWord = strPntr[1];
+	if (secondWord < 0xDC00 || secondWord > 0xDFFF) { return 0; } //a high surrogate must be followed by a low surrogate
+	SetOptionalOutPntr(codepointOut, 0x10000 + ((u32)(firstWord - 0xD800) << 10) + (u32)(secondWord - 0xDC00));
+	return 2;
+}
+
+//Converts a whole UTF-8 buffer to UCS-2, returns false if the UTF-8 is invalid (same rules as IsValidUtf8). Pass wordsOut=nullptr to just measure the number of words needed
+//NOTE: numWordsOut is filled even on failure, it holds the number of words that were successfully converted before the invalid character
+PEXP bool TranscodeUtf8ToUcs2(uxx numBytes, const char* bytesPntr, uxx maxNumWords, u16* wordsOut, uxx* numWordsOut)
+{
+	Assert(bytesPntr != nullptr || numBytes == 0);
+	uxx wordIndex = 0;
+	uxx bIndex = 0;
+	while (bIndex < numBytes)
+	{
+		#if TARGET_HAS_SIMD
+		//ASCII fast path, each byte is zero-extended into a word 16 at a time
+		while (bIndex + SIMD_U8X16_SIZE <= numBytes)
+		{
+			SimdU8x16 block = SimdU8x16_Load(&bytesPntr[bIndex]);
+			u32 nonAsciiMask = SimdU8x16_Mask(block);
+			uxx numAsciiBytes = (nonAsciiMask != 0) ? (uxx)CountTrailingZerosU32(nonAsciiMask) : SIMD_U8X16_SIZE;
+			if (wordsOut != nullptr)
+			{
+				Assert(wordIndex + numAsciiBytes <= maxNumWords);
+				if (numAsciiBytes == SIMD_U8X16_SIZE)
+				{
+					SimdU8x16_Store(&wordsOut[wordIndex], SimdU8x16_WidenLowU16(block));
+					SimdU8x16_Store(&wordsOut[wordIndex + SIMD_U8X16_SIZE/2], SimdU8x16_WidenHighU16(block));
+				}
+				else
+				{
+					for (uxx aIndex = 0; aIndex < numAsciiBytes; aIndex++) { wordsOut[wordIndex + aIndex] = (u16)CharToU8(bytesPntr[bIndex + aIndex]); }
+				}
+			}
+			wordIndex += numAsciiBytes;
+			bIndex += numAsciiBytes;
+			if (numAsciiBytes < SIMD_U8X16_SIZE) { break; }
+		}
+		if (bIndex >= numBytes) { break; }
+		#endif //TARGET_HAS_SIMD
+		
+		u32 codepoint = 0;
+		u8 codepointSize = GetCodepointForUtf8Strict(numBytes - bIndex, &bytesPntr[bIndex], &codepoint);
+		if (codepointSize == 0) { SetOptionalOutPntr(numWordsOut, wordIndex); return false; }
+		u16 encodeBuffer[UCS2_MAX_CHAR_SIZE];
+		u8 numWords = GetUcs2WordsForCode(codepoint, &encodeBuffer[0], false);
+		if (numWords == 0) { SetOptionalOutPntr(numWordsOut, wordIndex); return false; }
+		if (wordsOut != nullptr)
+		{
+			Assert(wordIndex + numWords <= maxNumWords);
+			for (u8 wIndex = 0; wIndex < numWords; wIndex++) { wordsOut[wordIndex + wIndex] = encodeBuffer[wIndex]; }
+		}
+		wordIndex += numWords;
+		bIndex += codepointSize;
+	}
+	SetOptionalOutPntr(numWordsOut, wordIndex);
+	return true;
+}
+
+//Converts a whole UCS-2 buffer to UTF-8, returns false if there is an unpaired surrogate. Pass bytesOut=nullptr to just measure the number of bytes needed
+//NOTE: numBytesOut is filled even on failure, it holds the number of bytes that were successfully converted before the invalid character
+PEXP bool TranscodeUcs2ToUtf8(uxx numWords, const u16* wordsPntr, uxx maxNumBytes, char* bytesOut, uxx* numBytesOut)
+{
+	Assert(wordsPntr != nullptr || numWords == 0);
+	#if TARGET_HAS_SIMD
+	//Every word in a block is ASCII if the top 9 bits of every (little-endian) word are zero
+	static const u8 nonAsciiWordBits[SIMD_U8X16_SIZE] = { 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF };
+	SimdU8x16 nonAsciiBitsVec = SimdU8x16_Load(&nonAsciiWordBits[0]);
+	SimdU8x16 zeroVec = SimdU8x16_Splat(0x00);
+	#endif
+	uxx byteIndex = 0;
+	uxx wIndex = 0;
+	while (wIndex < numWords)
+	{
+		#if TARGET_HAS_SIMD
+		//ASCII fast path, 16 words are narrowed to 16 bytes at a time
+		while (wIndex + SIMD_U8X16_SIZE <= numWords)
+		{
+			SimdU8x16 lowWords = SimdU8x16_Load(&wordsPntr[wIndex]);
+			SimdU8x16 highWords = SimdU8x16_Load(&wordsPntr[wIndex + SIMD_U8X16_SIZE/2]);
+			SimdU8x16 nonAsciiBits = SimdU8x16_And(SimdU8x16_Or(lowWords, highWords), nonAsciiBitsVec);
+			if (SimdU8x16_Mask(SimdU8x16_Equal(nonAsciiBits, zeroVec)) != 0xFFFF) { break; }
+			if (bytesOut != nullptr)
+			{
+				Assert(byteIndex + SIMD_U8X16_SIZE <= maxNumBytes);
+				SimdU8x16_Store(&bytesOut[byteIndex], SimdU8x16_NarrowU16(lowWords, highWords));
+			}
+			byteIndex += SIMD_U8X16_SIZE;
+			wIndex += SIMD_U8X16_SIZE;
+		}
+		if (wIndex >= numWords) { break; }
+		#endif //TARGET_HAS_SIMD
+		
+		u32 codepoint = 0;
+		u8 codepointSize = GetCodepointForUcs2(numWords - wIndex, &wordsPntr[wIndex], &codepoint);
+		if (codepointSize == 0) { SetOptionalOutPntr(numBytesOut, byteIndex); return false; }
+		u8 encodeBuffer[UTF8_MAX_CHAR_SIZE];
+		u8 encodeSize = GetUtf8BytesForCode(codepoint, &encodeBuffer[0], false);
+		if (encodeSize == 0) { SetOptionalOutPntr(numBytesOut, byteIndex); return false; }
+		if (bytesOut != nullptr)
+		{
+			Assert(byteIndex + encodeSize <= maxNumBytes);
+			for (u8 bIndex = 0; bIndex < encodeSize; bIndex++) { bytesOut[byteIndex + bIndex] = (char)encodeBuffer[bIndex]; }
+		}
+		byteIndex += encodeSize;
+		wIndex += codepointSize;
+	}
+	SetOptionalOutPntr(numBytesOut, byteIndex);
+	return true;
 }
 
 // +--------------------------------------------------------------+
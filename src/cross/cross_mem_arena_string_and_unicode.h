@@ -28,84 +28,35 @@ Date:   01\17\2025
 // +--------------------------------------------------------------+
 #if PIG_CORE_IMPLEMENTATION
 
-//TODO: This function isn't fully implemented, it just casts each 16-bit character to u32
 PEXP Str8 ConvertUcs2StrToUtf8(Arena* arena, Str16 usc2Str, bool addNullTerm)
 {
 	Assert(usc2Str.pntr != nullptr || usc2Str.length == 0);
-	u8 encodeBuffer[UTF8_MAX_CHAR_SIZE];
 	Str8 result = Str8_Empty;
-	for (u8 pass = 0; pass < 2; pass++)
-	{
-		uxx byteIndex = 0;
-		
-		for (uxx cIndex = 0; cIndex < usc2Str.length; cIndex++)
-		{
-			char16_t wideChar = usc2Str.chars[cIndex];
-			//TODO: Do better than casting wideChar to u32! We need to implement GetCodepointForUcs2
-			u8 encodeSize = GetUtf8BytesForCode((u32)wideChar, &encodeBuffer[0], false);
-			if (encodeSize == 0) { return result; }
-			if (result.chars != nullptr)
-			{
-				Assert(result.length >= byteIndex + encodeSize);
-				MyMemCopy(&result.chars[byteIndex], &encodeBuffer[0], encodeSize);
-			}
-			byteIndex += encodeSize;
-		}
-		
-		if (pass == 0)
-		{
-			result.length = byteIndex;
-			if (arena == nullptr) { return result; }
-			result.chars = (char*)AllocMem(arena, result.length + (addNullTerm ? 1 : 0));
-			NotNull(result.chars);
-		}
-		else
-		{
-			Assert(byteIndex == result.length);
-			if (addNullTerm) { result.chars[result.length] = '\0'; }
-		}
-	}
+	uxx numBytes = 0;
+	if (!TranscodeUcs2ToUtf8(usc2Str.length, usc2Str.words, 0, nullptr, &numBytes)) { return result; }
+	result.length = numBytes;
+	if (arena == nullptr) { return result; }
+	result.chars = (char*)AllocMem(arena, result.length + (addNullTerm ? 1 : 0));
+	NotNull(result.chars);
+	bool transcodeSuccess = TranscodeUcs2ToUtf8(usc2Str.length, usc2Str.words, result.length, result.chars, &numBytes);
+	Assert(transcodeSuccess && numBytes == result.length);
+	if (addNullTerm) { result.chars[result.length] = '\0'; }
 	return result;
 }
 
 PEXP Str16 ConvertUtf8StrToUcs2(Arena* arena, Str8 utf8Str, bool addNullTerm)
 {
 	NotNullStr(utf8Str);
-	u16 encodeBuffer[UCS2_MAX_CHAR_SIZE];
 	Str16 result = Str16_Empty;
-	for (u8 pass = 0; pass < 2; pass++)
-	{
-		uxx wordIndex = 0;
-		
-		for (uxx cIndex = 0; cIndex < utf8Str.length; cIndex++)
-		{
-			u32 codepoint;
-			u8 codepointSize = GetCodepointForUtf8Str(utf8Str, cIndex, &codepoint);
-			if (codepointSize == 0) { return result; }
-			u8 numWords = GetUcs2WordsForCode(codepoint, &encodeBuffer[0], false);
-			if (numWords == 0) { return result; }
-			if (result.chars != nullptr)
-			{
-				Assert(result.length >= wordIndex + numWords);
-				MyMemCopy(&result.chars[wordIndex], &encodeBuffer[0], numWords * sizeof(u16));
-			}
-			if (codepointSize > 1) { cIndex += codepointSize-1; }
-			wordIndex += numWords;
-		}
-		
-		if (pass == 0)
-		{
-			result.length = wordIndex;
-			if (arena == nullptr) { return result; }
-			result.chars = (char16_t*)AllocMem(arena, (result.length + (addNullTerm ? 1 : 0)) * sizeof(char16_t));
-			NotNull(result.chars);
-		}
-		else
-		{
-			Assert(wordIndex == result.length);
-			if (addNullTerm) { result.chars[result.length] = 0; }
-		}
-	}
+	uxx numWords = 0;
+	if (!TranscodeUtf8ToUcs2(utf8Str.length, utf8Str.chars, 0, nullptr, &numWords)) { return result; }
+	result.length = numWords;
+	if (arena == nullptr) { return result; }
+	result.chars = (char16_t*)AllocMem(arena, (result.length + (addNullTerm ? 1 : 0)) * sizeof(char16_t));
+	NotNull(result.chars);
+	bool transcodeSuccess = TranscodeUtf8ToUcs2(utf8Str.length, utf8Str.chars, result.length, result.words, &numWords);
+	Assert(transcodeSuccess && numWords == result.length);
+	if (addNullTerm) { result.chars[result.length] = 0; }
 	return result;
 }
 
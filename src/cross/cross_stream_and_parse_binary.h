@@ -9,6 +9,8 @@ Date:   09\06\2025
 
 //NOTE: Intentionally no includes here
 
+//NOTE: arenaPntr can be nullptr for Buffer streams and File streams made with ToDataStreamFromFileBuffered, the values are then read in place
+
 #define BinStreamReadU8(streamPntr, arenaPntr, errorCode)   *(u8*)TryReadFromDataStreamOrZeros((streamPntr), sizeof(u8),  (arenaPntr)); if ((streamPntr)->error != Result_None) { errorCode; }
 #define BinStreamReadU16(streamPntr, arenaPntr, errorCode) *(u16*)TryReadFromDataStreamOrZeros((streamPntr), sizeof(u16), (arenaPntr)); if ((streamPntr)->error != Result_None) { errorCode; }
 #define BinStreamReadU32(streamPntr, arenaPntr, errorCode) *(u32*)TryReadFromDataStreamOrZeros((streamPntr), sizeof(u32), (arenaPntr)); if ((streamPntr)->error != Result_None) { errorCode; }
@@ -20,4 +22,15 @@ Date:   09\06\2025
 #define BinStreamReadR32(streamPntr, arenaPntr, errorCode) *(r32*)TryReadFromDataStreamOrZeros((streamPntr), sizeof(r32), (arenaPntr)); if ((streamPntr)->error != Result_None) { errorCode; }
 #define BinStreamReadR64(streamPntr, arenaPntr, errorCode) *(r64*)TryReadFromDataStreamOrZeros((streamPntr), sizeof(r64), (arenaPntr)); if ((streamPntr)->error != Result_None) { errorCode; }
 
+#define BinStreamWriteU8(writerPntr, value, errorCode)  { u8  binStreamValue = (u8)(value);  if (!WriteToDataStream((writerPntr), sizeof(u8),  &binStreamValue)) { errorCode; } }
+#define BinStreamWriteU16(writerPntr, value, errorCode) { u16 binStreamValue = (u16)(value); if (!WriteToDataStream((writerPntr), sizeof(u16), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteU32(writerPntr, value, errorCode) { u32 binStreamValue = (u32)(value); if (!WriteToDataStream((writerPntr), sizeof(u32), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteU64(writerPntr, value, errorCode) { u64 binStreamValue = (u64)(value); if (!WriteToDataStream((writerPntr), sizeof(u64), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteI8(writerPntr, value, errorCode)  { i8  binStreamValue = (i8)(value);  if (!WriteToDataStream((writerPntr), sizeof(i8),  &binStreamValue)) { errorCode; } }
+#define BinStreamWriteI16(writerPntr, value, errorCode) { i16 binStreamValue = (i16)(value); if (!WriteToDataStream((writerPntr), sizeof(i16), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteI32(writerPntr, value, errorCode) { i32 binStreamValue = (i32)(value); if (!WriteToDataStream((writerPntr), sizeof(i32), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteI64(writerPntr, value, errorCode) { i64 binStreamValue = (i64)(value); if (!WriteToDataStream((writerPntr), sizeof(i64), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteR32(writerPntr, value, errorCode) { r32 binStreamValue = (r32)(value); if (!WriteToDataStream((writerPntr), sizeof(r32), &binStreamValue)) { errorCode; } }
+#define BinStreamWriteR64(writerPntr, value, errorCode) { r64 binStreamValue = (r64)(value); if (!WriteToDataStream((writerPntr), sizeof(r64), &binStreamValue)) { errorCode; } }
+
 #endif //  _CROSS_STREAM_AND_PARSE_BINARY_H
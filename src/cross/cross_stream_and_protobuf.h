@@ -0,0 +1,195 @@
+/*
+File:   cross_stream_and_protobuf.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** A PbStreamReader pulls varint length-prefixed protobuf messages (the framing written by PbStreamPacker)
+	** out of a DataStream one at a time. File backed streams are read through a buffer that only grows to fit the
+	** largest message seen (up to maxMessageSize), memory backed streams are read in place without any copies.
+	** Each unpacked message lives in messageArena which is reset back to where it was when the reader was initialized
+	** before every message, so replaying a recording of any length takes a constant amount of memory.
+*/
+
+#ifndef _CROSS_STREAM_AND_PROTOBUF_H
+#define _CROSS_STREAM_AND_PROTOBUF_H
+
+//NOTE: Intentionally no includes here
+
+#if BUILD_WITH_PROTOBUF
+
+#define PB_STREAM_READER_DEFAULT_BUFFER_SIZE      Kilobytes(64)
+#define PB_STREAM_READER_DEFAULT_MAX_MESSAGE_SIZE Megabytes(64)
+
+typedef plex PbStreamReader PbStreamReader;
+plex PbStreamReader
+{
+	DataStream* stream;
+	Arena* arena; //holds the read buffer (unused for memory backed streams), must NOT be messageArena
+	Arena* messageArena;
+	uxx messageArenaMark;
+	bool aliasBytes; //unpack with ProtobufUnpackInArenaAliased, bytes fields point into the read buffer and are only valid until the next message
+	bool finished;
+	Result error;
+	uxx maxMessageSize;
+	uxx numMessages;
+	bool isBufferBorrowed; //true when bufferPntr points straight at a memory backed stream's buffer
+	uxx bufferStart;
+	uxx bufferEnd;
+	uxx bufferSize;
+	u8* bufferPntr;
+};
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	PIG_CORE_INLINE void FreePbStreamReader(PbStreamReader* reader);
+	void InitPbStreamReader(PbStreamReader* readerOut, Arena* arena, DataStream* stream, Arena* messageArena, uxx initialBufferSize, uxx maxMessageSize);
+	bool PbStreamReaderNextSlice(PbStreamReader* reader, Slice* packedMessageOut);
+	void* PbStreamReaderNext_(const ProtobufCMessageDescriptor* descriptorPntr, PbStreamReader* reader);
+#endif
+
+#define PbStreamReaderNext(type, lowercaseType, readerPntr) (type*)PbStreamReaderNext_(&lowercaseType##__descriptor, (readerPntr))
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+PEXPI void FreePbStreamReader(PbStreamReader* reader)
+{
+	NotNull(reader);
+	if (!reader->isBufferBorrowed && reader->bufferPntr != nullptr) { FreeMem(reader->arena, reader->bufferPntr, reader->bufferSize); }
+	if (reader->messageArena != nullptr) { ArenaResetToMark(reader->messageArena, reader->messageArenaMark); }
+	ClearPointer(reader);
+}
+
+//NOTE: Pass 0 for initialBufferSize or maxMessageSize to get the defaults. messageArena must support ArenaResetToMark (a scratch arena works well)
+PEXP void InitPbStreamReader(PbStreamReader* readerOut, Arena* arena, DataStream* stream, Arena* messageArena, uxx initialBufferSize, uxx maxMessageSize)
+{
+	NotNull(readerOut);
+	NotNull(arena);
+	NotNull(stream);
+	NotNull(messageArena);
+	Assert(arena != messageArena);
+	Assert(CanArenaResetToMark(messageArena));
+	ClearPointer(readerOut);
+	readerOut->stream = stream;
+	readerOut->arena = arena;
+	readerOut->messageArena = messageArena;
+	readerOut->messageArenaMark = ArenaGetMark(messageArena);
+	readerOut->error = Result_None;
+	readerOut->maxMessageSize = (maxMessageSize > 0) ? maxMessageSize : PB_STREAM_READER_DEFAULT_MAX_MESSAGE_SIZE;
+	if (IsDataStreamMemoryBacked(stream))
+	{
+		readerOut->isBufferBorrowed = true;
+		readerOut->bufferPntr = stream->buffer.bytes;
+		readerOut->bufferSize = stream->size;
+		readerOut->bufferStart = stream->cursor;
+		readerOut->bufferEnd = stream->size;
+	}
+	else
+	{
+		readerOut->bufferSize = (initialBufferSize > 0) ? initialBufferSize : PB_STREAM_READER_DEFAULT_BUFFER_SIZE;
+		readerOut->bufferPntr = (u8*)AllocMem(arena, readerOut->bufferSize);
+		if (readerOut->bufferPntr == nullptr) { readerOut->bufferSize = 0; readerOut->error = Result_FailedToAllocateMemory; }
+	}
+}
+
+//Makes sure at least numBytes are sitting in the buffer after bufferStart, reading more from the stream as needed.
+//Returns false if the stream ran out first (without setting reader->error, the caller decides whether that's an error)
+static bool PbStreamReaderFillBuffer(PbStreamReader* reader, uxx numBytes)
+{
+	if (reader->bufferEnd - reader->bufferStart >= numBytes) { return true; }
+	if (reader->isBufferBorrowed || reader->error != Result_None) { return false; }
+	
+	if (reader->bufferStart + numBytes > reader->bufferSize)
+	{
+		//Slide the unconsumed bytes to the front, anything before bufferStart has already been handed out
+		uxx numBytesLeft = reader->bufferEnd - reader->bufferStart;
+		if (numBytesLeft > 0 && reader->bufferStart > 0) { MyMemMove(reader->bufferPntr, reader->bufferPntr + reader->bufferStart, numBytesLeft); }
+		reader->bufferStart = 0;
+		reader->bufferEnd = numBytesLeft;
+	}
+	if (numBytes > reader->bufferSize)
+	{
+		uxx newBufferSize = reader->bufferSize;
+		while (newBufferSize < numBytes) { newBufferSize *= 2; }
+		u8* newBufferPntr = (u8*)ReallocMem(reader->arena, reader->bufferPntr, reader->bufferSize, newBufferSize);
+		if (newBufferPntr == nullptr) { reader->error = Result_FailedToAllocateMemory; return false; }
+		reader->bufferPntr = newBufferPntr;
+		reader->bufferSize = newBufferSize;
+	}
+	
+	while (reader->bufferEnd - reader->bufferStart < numBytes)
+	{
+		uxx numBytesRead = 0;
+		Result readResult = ReadFromDataStreamInto(reader->stream, reader->bufferSize - reader->bufferEnd, reader->bufferPntr + reader->bufferEnd, &numBytesRead);
+		if (readResult == Result_EndOfFile || readResult == Result_EndOfBuffer) { reader->stream->error = Result_None; return false; }
+		if (readResult != Result_Success) { reader->error = readResult; return false; }
+		reader->bufferEnd += numBytesRead;
+	}
+	return true;
+}
+
+//Returns the next packed message (without its length prefix). The Slice is only valid until the next call.
+//Returns false at the end of the stream (reader->finished) or when something went wrong (reader->error)
+PEXP bool PbStreamReaderNextSlice(PbStreamReader* reader, Slice* packedMessageOut)
+{
+	NotNull(reader);
+	NotNull(packedMessageOut);
+	if (reader->finished || reader->error != Result_None) { return false; }
+	
+	u64 messageSize = 0;
+	uxx prefixSize = 0;
+	while (true)
+	{
+		if (!PbStreamReaderFillBuffer(reader, prefixSize+1))
+		{
+			if (reader->error == Result_None)
+			{
+				if (prefixSize == 0) { reader->finished = true; }
+				else { reader->error = Result_UnexpectedEof; }
+			}
+			return false;
+		}
+		u8 prefixByte = reader->bufferPntr[reader->bufferStart + prefixSize];
+		messageSize |= ((u64)(prefixByte & 0x7F) << (7 * prefixSize));
+		prefixSize++;
+		if ((prefixByte & 0x80) == 0) { break; }
+		if (prefixSize >= PROTOBUF_MAX_VARINT_SIZE) { reader->error = Result_InvalidInput; return false; }
+	}
+	if (messageSize > (u64)reader->maxMessageSize) { reader->error = Result_TooLong; return false; }
+	
+	if (!PbStreamReaderFillBuffer(reader, prefixSize + (uxx)messageSize))
+	{
+		if (reader->error == Result_None) { reader->error = Result_UnexpectedEof; }
+		return false;
+	}
+	*packedMessageOut = MakeSlice((uxx)messageSize, reader->bufferPntr + reader->bufferStart + prefixSize);
+	reader->bufferStart += prefixSize + (uxx)messageSize;
+	if (reader->isBufferBorrowed) { reader->stream->cursor = reader->bufferStart; }
+	reader->numMessages++;
+	return true;
+}
+
+//NOTE: The result (and everything it points to) lives in messageArena and is only valid until the next call
+PEXP void* PbStreamReaderNext_(const ProtobufCMessageDescriptor* descriptorPntr, PbStreamReader* reader)
+{
+	NotNull(descriptorPntr);
+	NotNull(reader);
+	Slice packedMessage = Slice_Empty;
+	if (!PbStreamReaderNextSlice(reader, &packedMessage)) { return nullptr; }
+	ArenaResetToMark(reader->messageArena, reader->messageArenaMark);
+	void* result = nullptr;
+	if (reader->aliasBytes) { result = ProtobufUnpackInArenaAliased_(descriptorPntr, reader->messageArena, packedMessage); }
+	else { result = ProtobufUnpackInArena_(descriptorPntr, reader->messageArena, packedMessage); }
+	if (result == nullptr) { reader->error = Result_ParsingFailure; }
+	return result;
+}
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //BUILD_WITH_PROTOBUF
+
+#endif //  _CROSS_STREAM_AND_PROTOBUF_H
@@ -18,6 +18,8 @@ Description:
 	PIG_CORE_INLINE u8 GetCodepointForUtf8Str(Str8 str, uxx index, u32* codepointOut);
 	PIG_CORE_INLINE u8 GetPrevCodepointForUtf8Str(Str8 str, uxx index, u32* codepointOut);
 	bool DoesStrContainMultibyteUtf8Chars(Str8 str);
+	PIG_CORE_INLINE bool IsValidUtf8Str(Str8 str, uxx* invalidIndexOut);
+	PIG_CORE_INLINE uxx CountUtf8CodepointsInStr(Str8 str);
 	uxx FindNextCharInStrEx(Str8 target, uxx startIndex, Str8 searchCharsStr, bool ignoreCharsInQuotes);
 	PIG_CORE_INLINE uxx FindNextCharInStr(Str8 target, uxx startIndex, Str8 searchCharsStr);
 	uxx FindNextUnknownCharInStrEx(Str8 target, uxx startIndex, Str8 knownCharsStr, bool ignoreCharsInQuotes);
@@ -45,22 +47,67 @@ PEXPI u8 GetPrevCodepointForUtf8Str(Str8 str, uxx index, u32* codepointOut)
 
 PEXP bool DoesStrContainMultibyteUtf8Chars(Str8 str)
 {
-	for (uxx bIndex = 0; bIndex < str.length; bIndex++)
+	NotNullStr(str);
+	uxx bIndex = FindNextNonAsciiByte(str.length, str.chars, 0);
+	while (bIndex < str.length)
 	{
-		if (GetCodepointForUtf8Str(str, bIndex, nullptr) > 0) { return true; }
+		if (GetCodepointForUtf8Str(str, bIndex, nullptr) > 1) { return true; }
+		bIndex = FindNextNonAsciiByte(str.length, str.chars, bIndex+1);
 	}
 	return false;
 }
 
+PEXPI bool IsValidUtf8Str(Str8 str, uxx* invalidIndexOut) { NotNullStr(str); return IsValidUtf8(str.length, str.chars, invalidIndexOut); }
+PEXPI uxx CountUtf8CodepointsInStr(Str8 str) { NotNullStr(str); return CountUtf8Codepoints(str.length, str.chars); }
+
 //Returns target.length if no matching char is found
 PEXP uxx FindNextCharInStrEx(Str8 target, uxx startIndex, Str8 searchCharsStr, bool ignoreCharsInQuotes)
 {
 	NotNullStr(target);
 	Assert(startIndex <= target.length);
+	
+	#if TARGET_HAS_SIMD
+	//When all the search chars are ASCII we can skip over runs of other ASCII bytes using FindNextByteInStr.
+	//Any quote characters need to stop the skip so we can track inQuotes. Bytes >= 0x80 also stop the skip and go through
+	//the regular decoding below, since invalid (overlong) encodings like C0 A2 decode to ASCII codepoints and invalid bytes don't update previousCodepoint
+	char skipBytesBuffer[SIMD_U8X16_SIZE];
+	Str8 skipBytes = Str8_Empty;
+	if (searchCharsStr.length + (ignoreCharsInQuotes ? 1 : 0) <= SIMD_U8X16_SIZE)
+	{
+		bool allAscii = true;
+		for (uxx sIndex = 0; sIndex < searchCharsStr.length; sIndex++) { if (searchCharsStr.bytes[sIndex] >= 0x80) { allAscii = false; break; } }
+		if (allAscii)
+		{
+			if (searchCharsStr.length > 0) { MyMemCopy(&skipBytesBuffer[0], searchCharsStr.chars, searchCharsStr.length); }
+			skipBytes = MakeStr8(searchCharsStr.length, &skipBytesBuffer[0]);
+			if (ignoreCharsInQuotes) { skipBytesBuffer[skipBytes.length] = '"'; skipBytes.length++; }
+		}
+	}
+	#endif //TARGET_HAS_SIMD
+	
 	bool inQuotes = false;
 	u32 previousCodepoint = 0;
+	#if TARGET_HAS_SIMD
+	//Both of these only move forward so we cache them rather than searching again after every codepoint we stop on
+	bool foundNextIndices = false;
+	uxx nextSkipByteIndex = 0;
+	uxx nextNonAsciiIndex = 0;
+	#endif
 	for (uxx cIndex = startIndex; cIndex < target.length; )
 	{
+		#if TARGET_HAS_SIMD
+		if (skipBytes.length > 0)
+		{
+			if (!foundNextIndices || nextSkipByteIndex < cIndex) { nextSkipByteIndex = FindNextByteInStr(target, cIndex, skipBytes); }
+			if (!foundNextIndices || nextNonAsciiIndex < cIndex) { nextNonAsciiIndex = FindNextNonAsciiByte(target.length, target.chars, cIndex); }
+			foundNextIndices = true;
+			uxx nextIndex = (nextSkipByteIndex < nextNonAsciiIndex) ? nextSkipByteIndex : nextNonAsciiIndex;
+			if (nextIndex >= target.length) { break; }
+			if (nextIndex > cIndex) { previousCodepoint = (u32)target.bytes[nextIndex-1]; } //every skipped byte is ASCII so the last one is a whole codepoint
+			cIndex = nextIndex;
+		}
+		#endif //TARGET_HAS_SIMD
+		
 		u32 codepoint = 0;
 		u8 codepointSize = GetCodepointForUtf8Str(target, cIndex, &codepoint);
 		if (codepointSize == 0) { cIndex++; continue; } //invalid utf-8 encoding in target
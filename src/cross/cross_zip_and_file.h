@@ -14,6 +14,8 @@ Date:   01\21\2025
 // +--------------------------------------------------------------+
 #if !PIG_CORE_IMPLEMENTATION
 	Result OpenZipArchivePath(Arena* arena, FilePath filePath, ZipArchive* archiveOut);
+	Result OpenZipArchivePathMapped(Arena* arena, FilePath filePath, ZipArchive* archiveOut);
+	Result OpenZipArchiveFromFile(Arena* arena, OsFile* file, ZipArchive* archiveOut);
 	Slice OpenZipArchivePathAndReadFile(Arena* fileContentsArena, FilePath zipFilePath, FilePath archiveFileName, bool convertNewLines);
 	PIG_CORE_INLINE Str8 OpenZipArchivePathAndReadTextFile(Arena* fileContentsArena, FilePath zipFilePath, FilePath archiveFileName);
 	PIG_CORE_INLINE Slice OpenZipArchivePathAndReadBinFile(Arena* fileContentsArena, FilePath zipFilePath, FilePath archiveFileName);
@@ -36,6 +38,68 @@ PEXP Result OpenZipArchivePath(Arena* arena, FilePath filePath, ZipArchive* arch
 	return result;
 }
 
+//NOTE: The file stays mapped until CloseZipArchive is called. Only the pages holding the central directory
+//      and the entries that are actually read ever get pulled in from disk
+PEXP Result OpenZipArchivePathMapped(Arena* arena, FilePath filePath, ZipArchive* archiveOut)
+{
+	NotNull(arena);
+	NotNullStr(filePath);
+	NotNull(archiveOut);
+	OsMappedFile mappedFile = ZEROED;
+	Result mapResult = OsMapFile(filePath, OsMapFileAccess_Random, &mappedFile);
+	if (mapResult != Result_Success) { return mapResult; }
+	if (mappedFile.contents.length == 0) { OsUnmapFile(&mappedFile); return Result_EmptyFile; }
+	Result result = OpenZipArchive(arena, mappedFile.contents, archiveOut);
+	if (result != Result_Success) { OsUnmapFile(&mappedFile); return result; }
+	archiveOut->mappedFile = mappedFile;
+	return result;
+}
+
+static size_t ZipArchiveOsFileReadCallback(void* contextPntr, mz_uint64 fileOffset, void* bufferPntr, size_t numBytes)
+{
+	OsFile* file = (OsFile*)contextPntr;
+	NotNull(file);
+	if (fileOffset > (mz_uint64)file->fileSize) { return 0; }
+	uxx numBytesRead = 0;
+	Result readResult = OsReadFromOpenFileAt(file, (u64)fileOffset, (uxx)numBytes, bufferPntr, &numBytesRead);
+	if (readResult != Result_Success && readResult != Result_Partial) { return 0; }
+	return (size_t)numBytesRead;
+}
+
+//NOTE: Nothing but the central directory is read up front, entries are read from the file when they are asked for.
+//      The file must have been opened with OsOpenFileMode_Read and calculateSize=true, and it has to stay open until CloseZipArchive.
+//      Entries are read with OsReadFromOpenFileAt, so don't read from the file through its cursor while the archive is open.
+//      ZipArchive contains a function pointer, so keeping one of these open is a bad idea if hot-reloading is happening
+PEXP Result OpenZipArchiveFromFile(Arena* arena, OsFile* file, ZipArchive* archiveOut)
+{
+	NotNull(arena);
+	NotNull(file);
+	NotNull(archiveOut);
+	Assert(file->isOpen && !file->openedForWriting);
+	AssertMsg(file->isKnownSize, "OpenZipArchiveFromFile needs a file that was opened with calculateSize=true");
+	ClearPointer(archiveOut);
+	if (file->fileSize == 0) { return Result_EmptyFile; }
+	
+	archiveOut->zip.m_pRead = ZipArchiveOsFileReadCallback;
+	archiveOut->zip.m_pIO_opaque = file;
+	mz_bool initResult = mz_zip_reader_init(&archiveOut->zip, (mz_uint64)file->fileSize, 0); //No MZ_ZIP_FLAGs
+	if (initResult == MZ_FALSE)
+	{
+		mz_zip_error initError = mz_zip_get_last_error(&archiveOut->zip);
+		PrintLine_E("Failed to parse zip file: \"%s\"", mz_zip_get_error_string(initError));
+		ClearPointer(archiveOut);
+		return (initError == MZ_ZIP_FILE_READ_FAILED) ? Result_FailedToReadFile : Result_ParsingFailure;
+	}
+	
+	archiveOut->arena = arena;
+	archiveOut->filePntr = file;
+	archiveOut->numFiles = (uxx)mz_zip_reader_get_num_files(&archiveOut->zip);
+	archiveOut->size = mz_zip_get_archive_size(&archiveOut->zip);
+	Result indexResult = BuildZipArchiveNameIndex(archiveOut);
+	if (indexResult != Result_Success) { CloseZipArchive(archiveOut); return indexResult; }
+	return Result_Success;
+}
+
 PEXP Slice OpenZipArchivePathAndReadFile(Arena* fileContentsArena, FilePath zipFilePath, FilePath archiveFileName, bool convertNewLines)
 {
 	ScratchBegin1(scratch, fileContentsArena);
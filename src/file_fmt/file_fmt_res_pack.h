@@ -0,0 +1,513 @@
+/*
+File:   file_fmt_res_pack.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** A "resource pack" (.pack) is our own archive format for shipping resources with a game.
+	** Unlike a .zip it's designed to be memory-mapped and used in place:
+	**   - The directory (a ResPackEntry per file) sits right after the header and is sorted by the
+	**     FNV hash of each path, so finding a file is a binary search rather than a scan of every name
+	**   - The data for each entry starts on a multiple of header->alignment (a page by default)
+	**     so stored entries can be handed out as Slices straight into the mapping with no copies
+	**   - Each entry picks its own compression. Files that don't get smaller (or that are already
+	**     compressed like .png and .ogg) are stored as-is, everything else can be deflated
+	**   - Each entry holds a hash of its uncompressed contents (VerifyResPackEntry checks it)
+	** Packs are written with a ResPackBuilder, see src/res_packer/res_packer_main.c for the command-line tool
+	** NOTE: The header and directory are written in the native (little-endian) byte order and read in place
+*/
+
+#ifndef _FILE_FMT_RES_PACK_H
+#define _FILE_FMT_RES_PACK_H
+
+#include "base/base_defines_check.h"
+#include "base/base_typedefs.h"
+#include "base/base_macros.h"
+#include "base/base_assert.h"
+#include "std/std_memset.h"
+#include "std/std_basic_math.h"
+#include "os/os_path.h"
+#include "os/os_file.h"
+#include "struct/struct_string.h"
+#include "struct/struct_var_array.h"
+#include "struct/struct_stream.h"
+#include "mem/mem_arena.h"
+#include "mem/mem_scratch.h"
+#include "misc/misc_result.h"
+#include "misc/misc_hash.h"
+#include "misc/misc_sorting.h"
+#include "misc/misc_zip.h"
+
+#if !TARGET_IS_ORCA && !TARGET_IS_PLAYDATE //NOTE: Deflated entries go through miniz, see misc_zip.h
+
+#define RES_PACK_MAGIC             0x004B434150534552ULL //"RESPACK\0"
+#define RES_PACK_VERSION           1
+#define RES_PACK_DEFAULT_ALIGNMENT Kilobytes(4)
+#define RES_PACK_MAX_PATH_LENGTH   0xFFFF
+
+enum ResPackCompression
+{
+	ResPackCompression_Store = 0,
+	ResPackCompression_Deflate, //raw deflate (no zlib header), inflated with miniz's tinfl
+	ResPackCompression_Count,
+};
+typedef enum ResPackCompression ResPackCompression;
+#if !PIG_CORE_IMPLEMENTATION
+const char* GetResPackCompressionStr(ResPackCompression enumValue);
+#else
+PEXP const char* GetResPackCompressionStr(ResPackCompression enumValue)
+{
+	switch (enumValue)
+	{
+		case ResPackCompression_Store:   return "Store";
+		case ResPackCompression_Deflate: return "Deflate";
+		case ResPackCompression_Count:   return "Count";
+		default: return UNKNOWN_STR;
+	}
+}
+#endif
+
+typedef plex ResPackHeader ResPackHeader;
+plex ResPackHeader
+{
+	u64 magic;
+	u32 version;
+	u32 alignment;
+	u64 numEntries;
+	u64 entriesOffset; //ResPackEntry[numEntries], sorted by pathHash (and then by path)
+	u64 pathsOffset; //all the paths back to back, each one null-terminated
+	u64 pathsSize;
+	u64 fileSize;
+	u64 reserved;
+};
+
+typedef plex ResPackEntry ResPackEntry;
+plex ResPackEntry
+{
+	u64 pathHash; //FnvHashU64 of the path
+	u64 contentHash; //FnvHashU64 of the uncompressed contents
+	u64 dataOffset; //always a multiple of header->alignment
+	u64 storedSize; //how many bytes are at dataOffset
+	u64 size; //uncompressed size
+	u32 pathOffset; //relative to header->pathsOffset
+	u16 pathLength; //not counting the null-terminator
+	u8 compression; //ResPackCompression
+	u8 reserved;
+};
+
+typedef plex ResPack ResPack;
+plex ResPack
+{
+	bool isOpen;
+	Slice contents;
+	const ResPackHeader* header;
+	const ResPackEntry* entries;
+	const char* paths;
+	uxx numEntries;
+	OsMappedFile mappedFile; //only set by OpenResPackPath, unmapped by CloseResPack
+};
+
+typedef plex ResPackBuilderFile ResPackBuilderFile;
+plex ResPackBuilderFile
+{
+	Str8 path; //has nullterm
+	u64 pathHash;
+	u64 contentHash;
+	u64 size;
+	ResPackCompression compression;
+	Slice storedBytes;
+};
+
+typedef plex ResPackBuilder ResPackBuilder;
+plex ResPackBuilder
+{
+	Arena* arena;
+	uxx alignment;
+	int compressionLevel; //0-10, like the MZ_ compression levels (MZ_BEST_SPEED, MZ_DEFAULT_LEVEL, etc.)
+	VarArray files; //ResPackBuilderFile
+	u64 totalSize;
+	u64 totalStoredSize;
+};
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	void CloseResPack(ResPack* pack);
+	Result OpenResPack(Slice packContents, ResPack* packOut);
+	Result OpenResPackPath(FilePath filePath, ResPack* packOut);
+	PIG_CORE_INLINE Str8 GetResPackEntryPath(const ResPack* pack, uxx entryIndex);
+	bool FindResPackEntry(const ResPack* pack, Str8 path, uxx* entryIndexOut);
+	Result ReadResPackEntry(const ResPack* pack, uxx entryIndex, Arena* arena, Slice* contentsOut);
+	PIG_CORE_INLINE Result ReadResPackFile(const ResPack* pack, Str8 path, Arena* arena, Slice* contentsOut);
+	bool VerifyResPackEntry(const ResPack* pack, uxx entryIndex);
+	void FreeResPackBuilder(ResPackBuilder* builder);
+	void InitResPackBuilder(ResPackBuilder* builderOut, Arena* arena, uxx alignment, int compressionLevel);
+	Result AddResPackBuilderFile(ResPackBuilder* builder, Str8 path, Slice contents, ResPackCompression compression);
+	Result WriteResPack(ResPackBuilder* builder, FilePath filePath);
+#endif
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+// +==============================+
+// |            Reader            |
+// +==============================+
+PEXP void CloseResPack(ResPack* pack)
+{
+	NotNull(pack);
+	if (pack->mappedFile.isMapped) { OsUnmapFile(&pack->mappedFile); }
+	ClearPointer(pack);
+}
+
+//NOTE: Nothing is copied, packContents must stay alive (and unchanged) for as long as the ResPack is in use.
+//      The header and directory are validated here so the lookup and read functions don't need to re-check offsets
+PEXP Result OpenResPack(Slice packContents, ResPack* packOut)
+{
+	NotNullStr(packContents);
+	NotNull(packOut);
+	ClearPointer(packOut);
+	if (packContents.length < sizeof(ResPackHeader)) { return Result_MissingHeader; }
+	if (!IsAlignedTo(packContents.bytes, sizeof(u64))) { return Result_WrongInternalFormat; }
+	
+	const ResPackHeader* header = (const ResPackHeader*)packContents.bytes;
+	if (header->magic != RES_PACK_MAGIC) { return Result_UnsupportedFileFormat; }
+	if (header->version != RES_PACK_VERSION) { return Result_UnsupportedFileFormat; }
+	if (header->fileSize != (u64)packContents.length) { return Result_UnexpectedEof; }
+	if (header->alignment == 0 || (header->alignment & (header->alignment-1)) != 0 || (header->entriesOffset % sizeof(u64)) != 0) { return Result_WrongInternalFormat; }
+	if (header->numEntries > (header->fileSize / sizeof(ResPackEntry))) { return Result_WrongInternalFormat; }
+	if (header->entriesOffset + header->numEntries * sizeof(ResPackEntry) > header->fileSize) { return Result_WrongInternalFormat; }
+	if (header->pathsOffset > header->fileSize || header->pathsSize > header->fileSize - header->pathsOffset) { return Result_WrongInternalFormat; }
+	
+	const ResPackEntry* entries = (const ResPackEntry*)(packContents.bytes + header->entriesOffset);
+	const char* paths = (const char*)(packContents.bytes + header->pathsOffset);
+	for (u64 eIndex = 0; eIndex < header->numEntries; eIndex++)
+	{
+		const ResPackEntry* entry = &entries[eIndex];
+		if ((u64)entry->pathOffset + entry->pathLength >= header->pathsSize || paths[entry->pathOffset + entry->pathLength] != '\0') { return Result_WrongInternalFormat; }
+		if (entry->dataOffset > header->fileSize || entry->storedSize > header->fileSize - entry->dataOffset) { return Result_WrongInternalFormat; }
+		if ((entry->dataOffset % header->alignment) != 0) { return Result_WrongInternalFormat; }
+		if (entry->compression >= ResPackCompression_Count) { return Result_UnsupportedCompression; }
+		if (entry->compression == ResPackCompression_Store && entry->storedSize != entry->size) { return Result_WrongInternalFormat; }
+		if (entry->size > (u64)UINTXX_MAX) { return Result_TooLong; }
+		if (eIndex > 0 && entries[eIndex-1].pathHash > entry->pathHash) { return Result_WrongInternalFormat; }
+	}
+	
+	packOut->isOpen = true;
+	packOut->contents = packContents;
+	packOut->header = header;
+	packOut->entries = entries;
+	packOut->paths = paths;
+	packOut->numEntries = (uxx)header->numEntries;
+	return Result_Success;
+}
+
+//NOTE: The pack stays mapped until CloseResPack is called. Only the pages for the directory and the entries that are read get pulled in from disk
+PEXP Result OpenResPackPath(FilePath filePath, ResPack* packOut)
+{
+	NotNullStr(filePath);
+	NotNull(packOut);
+	OsMappedFile mappedFile = ZEROED;
+	Result mapResult = OsMapFile(filePath, OsMapFileAccess_Random, &mappedFile);
+	if (mapResult != Result_Success) { ClearPointer(packOut); return mapResult; }
+	Result result = OpenResPack(mappedFile.contents, packOut);
+	if (result != Result_Success) { OsUnmapFile(&mappedFile); return result; }
+	packOut->mappedFile = mappedFile;
+	return result;
+}
+
+//NOTE: The path points into the pack (and is null-terminated)
+PEXPI Str8 GetResPackEntryPath(const ResPack* pack, uxx entryIndex)
+{
+	NotNull(pack);
+	Assert(entryIndex < pack->numEntries);
+	const ResPackEntry* entry = &pack->entries[entryIndex];
+	return MakeStr8((uxx)entry->pathLength, &pack->paths[entry->pathOffset]);
+}
+
+//NOTE: Paths are case-sensitive and always use forward slashes
+PEXP bool FindResPackEntry(const ResPack* pack, Str8 path, uxx* entryIndexOut)
+{
+	NotNull(pack);
+	NotNullStr(path);
+	if (pack->numEntries == 0) { return false; }
+	u64 pathHash = FnvHashU64(path.chars, path.length);
+	
+	//Find the first entry with a pathHash >= the one we want
+	uxx lowIndex = 0;
+	uxx highIndex = pack->numEntries;
+	while (lowIndex < highIndex)
+	{
+		uxx middleIndex = lowIndex + (highIndex - lowIndex) / 2;
+		if (pack->entries[middleIndex].pathHash < pathHash) { lowIndex = middleIndex + 1; }
+		else { highIndex = middleIndex; }
+	}
+	
+	for (uxx eIndex = lowIndex; eIndex < pack->numEntries && pack->entries[eIndex].pathHash == pathHash; eIndex++)
+	{
+		if (StrExactEquals(GetResPackEntryPath(pack, eIndex), path))
+		{
+			SetOptionalOutPntr(entryIndexOut, eIndex);
+			return true;
+		}
+	}
+	return false;
+}
+
+//NOTE: Stored entries are returned as a Slice straight into the pack (arena is not used and can be nullptr).
+//      Compressed entries are inflated into a new allocation from arena
+PEXP Result ReadResPackEntry(const ResPack* pack, uxx entryIndex, Arena* arena, Slice* contentsOut)
+{
+	NotNull(pack);
+	Assert(pack->isOpen);
+	Assert(entryIndex < pack->numEntries);
+	NotNull(contentsOut);
+	const ResPackEntry* entry = &pack->entries[entryIndex];
+	Slice storedBytes = MakeSlice((uxx)entry->storedSize, pack->contents.bytes + entry->dataOffset);
+	
+	switch ((ResPackCompression)entry->compression)
+	{
+		case ResPackCompression_Store:
+		{
+			*contentsOut = storedBytes;
+		} break;
+		
+		case ResPackCompression_Deflate:
+		{
+			NotNull(arena);
+			Slice result = Slice_Empty;
+			result.length = (uxx)entry->size;
+			if (result.length > 0)
+			{
+				result.bytes = (u8*)AllocMem(arena, result.length);
+				if (result.bytes == nullptr) { return Result_FailedToAllocateMemory; }
+				size_t numBytesInflated = tinfl_decompress_mem_to_mem(result.bytes, (size_t)result.length, storedBytes.bytes, (size_t)storedBytes.length, TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+				if (numBytesInflated != (size_t)result.length)
+				{
+					if (CanArenaFree(arena)) { FreeMem(arena, result.bytes, result.length); }
+					return Result_DecompressError;
+				}
+			}
+			*contentsOut = result;
+		} break;
+		
+		default: return Result_UnsupportedCompression;
+	}
+	return Result_Success;
+}
+PEXPI Result ReadResPackFile(const ResPack* pack, Str8 path, Arena* arena, Slice* contentsOut)
+{
+	uxx entryIndex = 0;
+	if (!FindResPackEntry(pack, path, &entryIndex)) { return Result_FileNotFound; }
+	return ReadResPackEntry(pack, entryIndex, arena, contentsOut);
+}
+
+//NOTE: This touches (and possibly inflates) the whole entry so it's not something to do on every load
+PEXP bool VerifyResPackEntry(const ResPack* pack, uxx entryIndex)
+{
+	NotNull(pack);
+	Assert(entryIndex < pack->numEntries);
+	ScratchBegin(scratch);
+	Slice contents = Slice_Empty;
+	Result readResult = ReadResPackEntry(pack, entryIndex, scratch, &contents);
+	bool result = (readResult == Result_Success && FnvHashU64(contents.bytes, contents.length) == pack->entries[entryIndex].contentHash);
+	ScratchEnd(scratch);
+	return result;
+}
+
+// +==============================+
+// |           Builder            |
+// +==============================+
+PEXP void FreeResPackBuilder(ResPackBuilder* builder)
+{
+	NotNull(builder);
+	if (builder->arena != nullptr && CanArenaFree(builder->arena))
+	{
+		VarArrayLoop(&builder->files, fIndex)
+		{
+			VarArrayLoopGet(ResPackBuilderFile, file, &builder->files, fIndex);
+			FreeStr8WithNt(builder->arena, &file->path);
+			if (file->storedBytes.length > 0) { FreeMem(builder->arena, file->storedBytes.bytes, file->storedBytes.length); }
+		}
+	}
+	FreeVarArray(&builder->files);
+	ClearPointer(builder);
+}
+
+//NOTE: Pass 0 for alignment to get RES_PACK_DEFAULT_ALIGNMENT
+PEXP void InitResPackBuilder(ResPackBuilder* builderOut, Arena* arena, uxx alignment, int compressionLevel)
+{
+	NotNull(builderOut);
+	NotNull(arena);
+	Assert((alignment & (alignment-1)) == 0 && alignment <= UINT32_MAX);
+	ClearPointer(builderOut);
+	builderOut->arena = arena;
+	builderOut->alignment = (alignment > 0) ? alignment : RES_PACK_DEFAULT_ALIGNMENT;
+	builderOut->compressionLevel = ClampI32(compressionLevel, MZ_NO_COMPRESSION, MZ_UBER_COMPRESSION);
+	InitVarArray(ResPackBuilderFile, &builderOut->files, arena);
+}
+
+//NOTE: contents are compressed (if asked for) and copied into the builder's arena right away, so they don't need to stay alive.
+//      Deflate falls back to Store when it doesn't make the file any smaller. Duplicate paths are caught by WriteResPack
+PEXP Result AddResPackBuilderFile(ResPackBuilder* builder, Str8 path, Slice contents, ResPackCompression compression)
+{
+	NotNull(builder);
+	NotNull(builder->arena);
+	NotEmptyStr(path);
+	NotNullStr(contents);
+	Assert(compression < ResPackCompression_Count);
+	if (path.length > RES_PACK_MAX_PATH_LENGTH) { return Result_TooLong; }
+	if (contents.length > 0 && compression == ResPackCompression_Deflate && builder->compressionLevel > MZ_NO_COMPRESSION)
+	{
+		ScratchBegin1(scratch, builder->arena);
+		u8* compressedBytes = (u8*)AllocMem(scratch, contents.length);
+		NotNull(compressedBytes);
+		mz_uint compressFlags = tdefl_create_comp_flags_from_zip_params(builder->compressionLevel, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+		//NOTE: This returns 0 if the result doesn't fit in an output buffer that's the same size as the input
+		size_t compressedSize = tdefl_compress_mem_to_mem(compressedBytes, (size_t)contents.length, contents.bytes, (size_t)contents.length, (int)compressFlags);
+		if (compressedSize > 0 && compressedSize < (size_t)contents.length)
+		{
+			ResPackBuilderFile* newFile = VarArrayAdd(ResPackBuilderFile, &builder->files);
+			if (newFile == nullptr) { ScratchEnd(scratch); return Result_FailedToAllocateMemory; }
+			ClearPointer(newFile);
+			newFile->compression = ResPackCompression_Deflate;
+			newFile->storedBytes = AllocStr8(builder->arena, MakeSlice((uxx)compressedSize, compressedBytes));
+			ScratchEnd(scratch);
+			if (newFile->storedBytes.bytes == nullptr) { VarArrayRemoveLast(ResPackBuilderFile, &builder->files); return Result_FailedToAllocateMemory; }
+			newFile->path = AllocStrAndCopy(builder->arena, path.length, path.chars, true);
+			newFile->pathHash = FnvHashU64(path.chars, path.length);
+			newFile->contentHash = FnvHashU64(contents.bytes, contents.length);
+			newFile->size = (u64)contents.length;
+			builder->totalSize += newFile->size;
+			builder->totalStoredSize += (u64)newFile->storedBytes.length;
+			return Result_Success;
+		}
+		ScratchEnd(scratch);
+	}
+	
+	ResPackBuilderFile* newFile = VarArrayAdd(ResPackBuilderFile, &builder->files);
+	if (newFile == nullptr) { return Result_FailedToAllocateMemory; }
+	ClearPointer(newFile);
+	newFile->compression = ResPackCompression_Store;
+	if (contents.length > 0)
+	{
+		newFile->storedBytes = AllocStr8(builder->arena, contents);
+		if (newFile->storedBytes.bytes == nullptr) { VarArrayRemoveLast(ResPackBuilderFile, &builder->files); return Result_FailedToAllocateMemory; }
+	}
+	newFile->path = AllocStrAndCopy(builder->arena, path.length, path.chars, true);
+	newFile->pathHash = FnvHashU64(path.chars, path.length);
+	newFile->contentHash = FnvHashU64(contents.bytes, contents.length);
+	newFile->size = (u64)contents.length;
+	builder->totalSize += newFile->size;
+	builder->totalStoredSize += (u64)newFile->storedBytes.length;
+	return Result_Success;
+}
+
+static COMPARE_FUNC_DEF(CompareResPackBuilderFiles)
+{
+	UNUSED(contextPntr);
+	const ResPackBuilderFile* leftFile = (const ResPackBuilderFile*)left;
+	const ResPackBuilderFile* rightFile = (const ResPackBuilderFile*)right;
+	if (leftFile->pathHash != rightFile->pathHash) { return (leftFile->pathHash < rightFile->pathHash) ? -1 : 1; }
+	i32 compareResult = MyMemCompare(leftFile->path.chars, rightFile->path.chars, MinUXX(leftFile->path.length, rightFile->path.length));
+	if (compareResult != 0) { return compareResult; }
+	if (leftFile->path.length != rightFile->path.length) { return (leftFile->path.length < rightFile->path.length) ? -1 : 1; }
+	return 0;
+}
+
+static u64 AlignResPackOffset(u64 offset, uxx alignment)
+{
+	return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+static bool WriteResPackPadding(DataStreamWriter* writer, uxx alignment)
+{
+	uxx numPaddingBytes = (uxx)(AlignResPackOffset((u64)writer->cursor, alignment) - (u64)writer->cursor);
+	if (numPaddingBytes == 0) { return true; }
+	u8* paddingBytes = ReserveDataStreamWriterBytes(writer, numPaddingBytes);
+	if (paddingBytes == nullptr) { return false; }
+	MyMemSet(paddingBytes, 0x00, numPaddingBytes);
+	return true;
+}
+
+//NOTE: This sorts builder->files into the order they appear in the directory
+PEXP Result WriteResPack(ResPackBuilder* builder, FilePath filePath)
+{
+	NotNull(builder);
+	NotNull(builder->arena);
+	NotNullStr(filePath);
+	ScratchBegin1(scratch, builder->arena);
+	
+	uxx numFiles = builder->files.length;
+	ResPackBuilderFile* files = (ResPackBuilderFile*)builder->files.items;
+	QuickSortFlat(files, numFiles, sizeof(ResPackBuilderFile), CompareResPackBuilderFiles, nullptr);
+	
+	// Lay out the file: header, directory, paths and then each entry's data on an aligned offset
+	ResPackHeader header = ZEROED;
+	header.magic = RES_PACK_MAGIC;
+	header.version = RES_PACK_VERSION;
+	header.alignment = (u32)builder->alignment;
+	header.numEntries = (u64)numFiles;
+	header.entriesOffset = sizeof(ResPackHeader);
+	header.pathsOffset = header.entriesOffset + (numFiles * sizeof(ResPackEntry));
+	ResPackEntry* entries = (numFiles > 0) ? AllocArray(ResPackEntry, scratch, numFiles) : nullptr;
+	if (numFiles > 0 && entries == nullptr) { ScratchEnd(scratch); return Result_FailedToAllocateMemory; }
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++)
+	{
+		ResPackBuilderFile* file = &files[fIndex];
+		if (fIndex > 0 && file->pathHash == files[fIndex-1].pathHash && StrExactEquals(file->path, files[fIndex-1].path))
+		{
+			PrintLine_E("\"%.*s\" was added to the resource pack more than once!", StrPrint(file->path));
+			ScratchEnd(scratch);
+			return Result_Duplicate;
+		}
+		if (header.pathsSize + file->path.length + 1 > UINT32_MAX) { ScratchEnd(scratch); return Result_TooLong; }
+		ResPackEntry* entry = &entries[fIndex];
+		ClearPointer(entry);
+		entry->pathHash = file->pathHash;
+		entry->contentHash = file->contentHash;
+		entry->storedSize = (u64)file->storedBytes.length;
+		entry->size = file->size;
+		entry->pathOffset = (u32)header.pathsSize;
+		entry->pathLength = (u16)file->path.length;
+		entry->compression = (u8)file->compression;
+		header.pathsSize += file->path.length + 1;
+	}
+	u64 dataOffset = AlignResPackOffset(header.pathsOffset + header.pathsSize, builder->alignment);
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++)
+	{
+		entries[fIndex].dataOffset = dataOffset;
+		dataOffset = AlignResPackOffset(dataOffset + entries[fIndex].storedSize, builder->alignment);
+	}
+	//NOTE: The last entry isn't padded out, the file ends right after its data
+	header.fileSize = (numFiles > 0) ? (entries[numFiles-1].dataOffset + entries[numFiles-1].storedSize) : dataOffset;
+	
+	OsFile file = ZEROED;
+	if (!OsOpenFile(scratch, filePath, OsOpenFileMode_Write, false, &file)) { ScratchEnd(scratch); return Result_FailedToWriteFile; }
+	DataStreamWriter writer = ToDataStreamWriterFromFile(&file, scratch, 0);
+	WriteToDataStream(&writer, sizeof(header), &header);
+	if (numFiles > 0) { WriteToDataStream(&writer, numFiles * sizeof(ResPackEntry), entries); }
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++) { WriteToDataStream(&writer, files[fIndex].path.length + 1, files[fIndex].path.chars); }
+	for (uxx fIndex = 0; fIndex < numFiles && writer.error == Result_None; fIndex++)
+	{
+		WriteResPackPadding(&writer, builder->alignment);
+		DebugAssert((u64)writer.cursor == entries[fIndex].dataOffset);
+		WriteToDataStream(&writer, files[fIndex].storedBytes.length, files[fIndex].storedBytes.bytes);
+	}
+	if (numFiles == 0) { WriteResPackPadding(&writer, builder->alignment); }
+	FlushDataStreamWriter(&writer);
+	Result result = (writer.error == Result_None) ? Result_Success : writer.error;
+	DebugAssert(result != Result_Success || (u64)writer.cursor == header.fileSize);
+	FreeDataStreamWriter(&writer);
+	OsCloseFile(&file);
+	
+	ScratchEnd(scratch);
+	return result;
+}
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //!TARGET_IS_ORCA && !TARGET_IS_PLAYDATE
+
+#endif //  _FILE_FMT_RES_PACK_H
@@ -17,6 +17,7 @@ Description:
 #include "mem/mem_scratch.h"
 #include "struct/struct_string.h"
 #include "misc/misc_result.h"
+#include "misc/misc_hash.h"
 #include "lib/lib_sokol_gfx.h"
 #include "gfx/gfx_shader.h"
 #include "gfx/gfx_texture.h"
@@ -74,6 +75,7 @@ plex GfxPipeline
 	Result error;
 	Str8 name;
 	GfxPipelineOptions options;
+	u64 optionsHash; //GetGfxPipelineOptionsHash(&options), cached so lookups can reject mismatches without a full compare
 	sg_pipeline handle;
 };
 
@@ -82,6 +84,7 @@ plex GfxPipeline
 // +--------------------------------------------------------------+
 #if !PIG_CORE_IMPLEMENTATION
 	PIG_CORE_INLINE bool AreEqualGfxPipelineOptions(const GfxPipelineOptions* left, const GfxPipelineOptions* right);
+	u64 GetGfxPipelineOptionsHash(const GfxPipelineOptions* options);
 	void FreeGfxPipeline(GfxPipeline* pipeline);
 	void MatchVertAttributesToShader(sg_pipeline_desc* pipelineDesc, const Shader* shader, uxx vertexSize, uxx numVertAttributes, const VertAttribute* vertAttributes);
 	void FillGfxPipelineOptionsFromVertBuffer(GfxPipelineOptions* options, const VertBuffer* buffer);
@@ -117,6 +120,34 @@ PEXPI bool AreEqualGfxPipelineOptions(const GfxPipelineOptions* left, const GfxP
 	#endif
 }
 
+//NOTE: We hash field-by-field (rather than the whole struct) so that padding bytes and unused
+//      vertAttributes slots don't affect the result. Any two options that AreEqualGfxPipelineOptions
+//      says are equal must produce the same hash here
+PEXP u64 GetGfxPipelineOptionsHash(const GfxPipelineOptions* options)
+{
+	NotNull(options);
+	u64 result = FNV_HASH_BASE_U64;
+	result = FnvHashU64Ex(&options->shader, sizeof(options->shader), result);
+	result = FnvHashU64Ex(&options->vertexSize, sizeof(options->vertexSize), result);
+	result = FnvHashU64Ex(&options->numVertAttributes, sizeof(options->numVertAttributes), result);
+	for (uxx aIndex = 0; aIndex < options->numVertAttributes; aIndex++)
+	{
+		const VertAttribute* attribute = &options->vertAttributes[aIndex];
+		u8 attributeBytes[3] = { (u8)attribute->type, attribute->size, attribute->offset };
+		result = FnvHashU64Ex(&attributeBytes[0], sizeof(attributeBytes), result);
+	}
+	u8 flagBytes[5] = {
+		(u8)(options->colorWriteEnabled ? 1 : 0),
+		(u8)(options->depthWriteEnabled ? 1 : 0),
+		(u8)(options->depthTestEnabled ? 1 : 0),
+		(u8)(options->cullingEnabled ? 1 : 0),
+		(u8)options->blendMode,
+	};
+	result = FnvHashU64Ex(&flagBytes[0], sizeof(flagBytes), result);
+	result = FnvHashU64Ex(&options->indexedVerticesSize, sizeof(options->indexedVerticesSize), result);
+	return result;
+}
+
 PEXP void FreeGfxPipeline(GfxPipeline* pipeline)
 {
 	NotNull(pipeline);
@@ -187,6 +218,7 @@ PEXP GfxPipeline InitGfxPipeline(Arena* arena, Str8 name, const GfxPipelineOptio
 	result.arena = arena;
 	if (!IsEmptyStr(name)) { result.name = AllocStr8(arena, name); NotNull(result.name.chars); }
 	MyMemCopy(&result.options, options, sizeof(GfxPipelineOptions));
+	result.optionsHash = GetGfxPipelineOptionsHash(options);
 	
 	// WriteLine_D("Initializing pipeline with options:");
 	// PrintLine_D("\tvertexSize=%llu", options->vertexSize);
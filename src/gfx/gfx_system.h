@@ -39,6 +39,9 @@ Description:
 #define GFX_SYSTEM_CIRCLE_NUM_SIDES     32 // aka 11.25 degree increments
 #define GFX_SYSTEM_RING_NUM_THICKNESSES 10 // aka 10% increments
 #define GFX_SYSTEM_RING_NUM_SIDES       32 // aka 11.25 degree increments
+#define GFX_SYSTEM_NUM_RECENT_PIPELINES  2 // pipelines we check before doing a hashed lookup (most state flips bounce between 2 pipelines)
+#define GFX_SYSTEM_PIPELINE_TABLE_MIN_SIZE 16 // slots, must be a power of 2
+#define GFX_SYSTEM_PIPELINE_TABLE_CAPACITY_PERCENT 0.75f
 
 typedef plex GfxSystemState GfxSystemState;
 plex GfxSystemState
@@ -79,6 +82,11 @@ plex GfxSystem
 {
 	Arena* arena;
 	VarArray pipelines; //GfxPipeline
+	//Open-addressed table keyed by GfxPipeline.optionsHash. Each slot holds (index+1) into pipelines, 0 means empty
+	uxx pipelineTableSize;
+	uxx* pipelineTable;
+	//Holds (index+1) into pipelines for the most recently found pipelines, [0] is the most recent
+	uxx recentPipelines[GFX_SYSTEM_NUM_RECENT_PIPELINES];
 	sg_bindings bindings;
 	
 	bool bindingsChanged;
@@ -110,6 +118,7 @@ plex GfxSystem
 	void InitSokolGraphics(sg_desc sokolGraphicsDesc);
 	void FreeGfxSystem(GfxSystem* system);
 	void InitGfxSystem(Arena* arena, GfxSystem* systemOut);
+	GfxPipeline* GfxSystem_FindPipelineWithOptionsHash(GfxSystem* system, const GfxPipelineOptions* options, u64 optionsHash);
 	PIG_CORE_INLINE GfxPipeline* GfxSystem_FindPipelineWithOptions(GfxSystem* system, const GfxPipelineOptions* options);
 	PIG_CORE_INLINE GfxPipeline* GfxSystem_FindOrAddPipelineWithOptions(GfxSystem* system, const GfxPipelineOptions* options);
 	void GfxSystem_FlushPipelineGen(GfxSystem* system);
@@ -222,6 +231,7 @@ PEXP void FreeGfxSystem(GfxSystem* system)
 			FreeGfxPipeline(pipeline);
 		}
 		FreeVarArray(&system->pipelines);
+		if (system->pipelineTable != nullptr) { FreeArray(uxx, system->arena, system->pipelineTableSize, system->pipelineTable); }
 		FreeTexture(&system->pixelTexture);
 		FreeVertBuffer(&system->squareBuffer);
 		FreeVertBuffer(&system->circleBuffer);
@@ -305,24 +315,94 @@ PEXP void InitGfxSystem(Arena* arena, GfxSystem* systemOut)
 	}
 }
 
-PEXPI GfxPipeline* GfxSystem_FindPipelineWithOptions(GfxSystem* system, const GfxPipelineOptions* options)
+static void GfxSystem_TouchRecentPipeline(GfxSystem* system, uxx pipelineIndex)
+{
+	uxx insertIndex = GFX_SYSTEM_NUM_RECENT_PIPELINES-1;
+	for (uxx rIndex = 0; rIndex < GFX_SYSTEM_NUM_RECENT_PIPELINES; rIndex++)
+	{
+		if (system->recentPipelines[rIndex] == pipelineIndex+1) { insertIndex = rIndex; break; }
+	}
+	for (uxx rIndex = insertIndex; rIndex > 0; rIndex--) { system->recentPipelines[rIndex] = system->recentPipelines[rIndex-1]; }
+	system->recentPipelines[0] = pipelineIndex+1;
+}
+
+static void GfxSystem_InsertIntoPipelineTable(uxx tableSize, uxx* table, u64 optionsHash, uxx pipelineIndex)
+{
+	uxx slotIndex = (uxx)(optionsHash & (tableSize-1));
+	while (table[slotIndex] != 0) { slotIndex = ((slotIndex+1) & (tableSize-1)); }
+	table[slotIndex] = pipelineIndex+1;
+}
+
+static void GfxSystem_GrowPipelineTable(GfxSystem* system, uxx minNumPipelines)
 {
+	uxx newTableSize = (system->pipelineTableSize > 0) ? system->pipelineTableSize : GFX_SYSTEM_PIPELINE_TABLE_MIN_SIZE;
+	while ((r32)minNumPipelines > (r32)newTableSize * GFX_SYSTEM_PIPELINE_TABLE_CAPACITY_PERCENT) { newTableSize *= 2; }
+	if (newTableSize == system->pipelineTableSize) { return; }
+	
+	uxx* newTable = AllocArray(uxx, system->arena, newTableSize);
+	NotNull(newTable);
+	MyMemSet(newTable, 0x00, sizeof(uxx) * newTableSize);
 	VarArrayLoop(&system->pipelines, pIndex)
 	{
 		VarArrayLoopGet(GfxPipeline, pipeline, &system->pipelines, pIndex);
-		if (AreEqualGfxPipelineOptions(&pipeline->options, options)) { return pipeline; }
+		GfxSystem_InsertIntoPipelineTable(newTableSize, newTable, pipeline->optionsHash, pIndex);
+	}
+	if (system->pipelineTable != nullptr) { FreeArray(uxx, system->arena, system->pipelineTableSize, system->pipelineTable); }
+	system->pipelineTable = newTable;
+	system->pipelineTableSize = newTableSize;
+}
+
+PEXP GfxPipeline* GfxSystem_FindPipelineWithOptionsHash(GfxSystem* system, const GfxPipelineOptions* options, u64 optionsHash)
+{
+	NotNull(system);
+	NotNull(options);
+	DebugAssert(optionsHash == GetGfxPipelineOptionsHash(options));
+	
+	for (uxx rIndex = 0; rIndex < GFX_SYSTEM_NUM_RECENT_PIPELINES; rIndex++)
+	{
+		if (system->recentPipelines[rIndex] == 0) { break; }
+		GfxPipeline* recentPipeline = VarArrayGetHard(GfxPipeline, &system->pipelines, system->recentPipelines[rIndex]-1);
+		if (recentPipeline->optionsHash == optionsHash && AreEqualGfxPipelineOptions(&recentPipeline->options, options))
+		{
+			if (rIndex > 0) { GfxSystem_TouchRecentPipeline(system, system->recentPipelines[rIndex]-1); }
+			return recentPipeline;
+		}
+	}
+	
+	if (system->pipelineTable == nullptr) { return nullptr; }
+	uxx slotIndex = (uxx)(optionsHash & (system->pipelineTableSize-1));
+	while (system->pipelineTable[slotIndex] != 0)
+	{
+		uxx pipelineIndex = system->pipelineTable[slotIndex]-1;
+		GfxPipeline* pipeline = VarArrayGetHard(GfxPipeline, &system->pipelines, pipelineIndex);
+		if (pipeline->optionsHash == optionsHash && AreEqualGfxPipelineOptions(&pipeline->options, options))
+		{
+			GfxSystem_TouchRecentPipeline(system, pipelineIndex);
+			return pipeline;
+		}
+		slotIndex = ((slotIndex+1) & (system->pipelineTableSize-1));
 	}
 	return nullptr;
 }
+PEXPI GfxPipeline* GfxSystem_FindPipelineWithOptions(GfxSystem* system, const GfxPipelineOptions* options)
+{
+	return GfxSystem_FindPipelineWithOptionsHash(system, options, GetGfxPipelineOptionsHash(options));
+}
 PEXPI GfxPipeline* GfxSystem_FindOrAddPipelineWithOptions(GfxSystem* system, const GfxPipelineOptions* options)
 {
-	GfxPipeline* existingPipeline = GfxSystem_FindPipelineWithOptions(system, options);
+	u64 optionsHash = GetGfxPipelineOptionsHash(options);
+	GfxPipeline* existingPipeline = GfxSystem_FindPipelineWithOptionsHash(system, options, optionsHash);
 	if (existingPipeline != nullptr) { return existingPipeline; }
+	GfxSystem_GrowPipelineTable(system, system->pipelines.length+1);
 	void* oldPipelinesPntr = system->pipelines.items;
+	uxx newPipelineIndex = system->pipelines.length;
 	GfxPipeline* newPipeline = VarArrayAdd(GfxPipeline, &system->pipelines);
 	NotNull(newPipeline);
 	if (system->pipelines.items != oldPipelinesPntr) { system->state.pipeline = nullptr; } //invalidate the pointer stored in the state!
 	*newPipeline = InitGfxPipeline(system->arena, StrLit("gfx_system_pipeline"), options);
+	newPipeline->optionsHash = optionsHash;
+	GfxSystem_InsertIntoPipelineTable(system->pipelineTableSize, system->pipelineTable, optionsHash, newPipelineIndex);
+	GfxSystem_TouchRecentPipeline(system, newPipelineIndex);
 	return newPipeline;
 }
 
@@ -11,6 +11,7 @@ Date:   01\05\2025
 #include "misc/misc_easing.h"
 #include "misc/misc_escaping.h"
 #include "misc/misc_file_watch.h"
+#include "misc/misc_float_conversion.h"
 #include "misc/misc_hash.h"
 #include "misc/misc_noise.h"
 #include "misc/misc_parsing.h"
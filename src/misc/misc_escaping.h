@@ -2,6 +2,11 @@
 File:   misc_escaping.h
 Author: Taylor Robbins
 Date:   09\14\2025
+Description:
+	** Contains functions that escape and unescape C-like strings and escape XML strings.
+	** Each function scans for the next byte that needs (un)escaping with FindNextByteInStr (which is vectorized)
+	** and copies the clean runs in between in bulk, since most real strings are long runs of clean ASCII.
+	** The StrBuilderAppend versions do the same thing in a single pass, appending into a StringBuilder that grows as needed
 */
 
 #ifndef _MISC_ESCAPING_H
@@ -14,6 +19,7 @@ Date:   09\14\2025
 #include "mem/mem_arena.h"
 #include "mem/mem_scratch.h"
 #include "misc/misc_two_pass.h"
+#include "struct/struct_string_builder.h"
 
 // These are escape sequences found in C-like strings
 typedef enum EscapeSequence EscapeSequence;
@@ -38,136 +44,125 @@ enum EscapeSequence
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
 #if !PIG_CORE_IMPLEMENTATION
+	PIG_CORE_INLINE Str8 GetEscapeSequenceSearchBytes(u8 escapeSequences, char* bufferOut);
+	PIG_CORE_INLINE char GetEscapeSequenceCodeChar(u8 escapeSequences, char rawChar);
+	PIG_CORE_INLINE char GetEscapeSequenceRawChar(u8 escapeSequences, char codeChar);
 	Str8 EscapeStringEx(Arena* arena, Str8 rawString, u8 escapeSequences, bool addNullTerm);
 	PIG_CORE_INLINE Str8 EscapeString(Arena* arena, Str8 rawString);
+	void StrBuilderAppendEscaped(StringBuilder* builder, Str8 rawString, u8 escapeSequences);
 	Str8 UnescapeStringEx(Arena* arena, Str8 escapedString, u8 escapeSequences, bool addNullTerm);
 	PIG_CORE_INLINE Str8 UnescapeString(Arena* arena, Str8 escapedString);
+	void StrBuilderAppendUnescaped(StringBuilder* builder, Str8 escapedString, u8 escapeSequences);
+	PIG_CORE_INLINE Str8 GetXmlEscapeSequence(char rawChar);
 	Str8 EscapeXmlString(Arena* arena, Str8 rawString, bool addNullTerm);
+	void StrBuilderAppendEscapedXml(StringBuilder* builder, Str8 rawString);
 #endif
 
+#define ESCAPE_SEQUENCE_MAX_SEARCH_BYTES 8 //one for each EscapeSequence flag
+#define XML_ESCAPE_SEARCH_BYTES          "&<>\"\'"
+
 // +--------------------------------------------------------------+
 // |                   Function Implementations                   |
 // +--------------------------------------------------------------+
 #if PIG_CORE_IMPLEMENTATION
 
+//bufferOut must have room for ESCAPE_SEQUENCE_MAX_SEARCH_BYTES, the result points into it
+PEXPI Str8 GetEscapeSequenceSearchBytes(u8 escapeSequences, char* bufferOut)
+{
+	NotNull(bufferOut);
+	uxx numBytes = 0;
+	if (IsFlagSet(escapeSequences, EscapeSequence_Backslash))      { bufferOut[numBytes++] = '\\'; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_Quote))          { bufferOut[numBytes++] = '\"'; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_Apostrophe))     { bufferOut[numBytes++] = '\''; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_NewLine))        { bufferOut[numBytes++] = '\n'; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_CarriageReturn)) { bufferOut[numBytes++] = '\r'; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_Tab))            { bufferOut[numBytes++] = '\t'; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_Backspace))      { bufferOut[numBytes++] = '\b'; }
+	if (IsFlagSet(escapeSequences, EscapeSequence_Bell))           { bufferOut[numBytes++] = '\a'; }
+	return MakeStr8(numBytes, bufferOut);
+}
+
+//Returns the character that goes after the backslash when escaping rawChar, or '\0' if rawChar doesn't need escaping
+PEXPI char GetEscapeSequenceCodeChar(u8 escapeSequences, char rawChar)
+{
+	switch (rawChar)
+	{
+		case '\\': return IsFlagSet(escapeSequences, EscapeSequence_Backslash)      ? '\\' : '\0';
+		case '\"':  return IsFlagSet(escapeSequences, EscapeSequence_Quote)          ? '\"'  : '\0';
+		case '\'':  return IsFlagSet(escapeSequences, EscapeSequence_Apostrophe)     ? '\''  : '\0';
+		case '\n':  return IsFlagSet(escapeSequences, EscapeSequence_NewLine)        ? 'n'   : '\0';
+		case '\r':  return IsFlagSet(escapeSequences, EscapeSequence_CarriageReturn) ? 'r'   : '\0';
+		case '\t':  return IsFlagSet(escapeSequences, EscapeSequence_Tab)            ? 't'   : '\0';
+		case '\b':  return IsFlagSet(escapeSequences, EscapeSequence_Backspace)      ? 'b'   : '\0';
+		case '\a':  return IsFlagSet(escapeSequences, EscapeSequence_Bell)           ? 'a'   : '\0';
+		default: return '\0';
+	}
+}
+
+//Returns the character that a backslash followed by codeChar unescapes to, or '\0' if it's not a (enabled) escape sequence
+PEXPI char GetEscapeSequenceRawChar(u8 escapeSequences, char codeChar)
+{
+	switch (codeChar)
+	{
+		case '\\': return IsFlagSet(escapeSequences, EscapeSequence_Backslash)      ? '\\' : '\0';
+		case '\"':  return IsFlagSet(escapeSequences, EscapeSequence_Quote)          ? '\"'  : '\0';
+		case '\'':  return IsFlagSet(escapeSequences, EscapeSequence_Apostrophe)     ? '\''  : '\0';
+		case 'n':   return IsFlagSet(escapeSequences, EscapeSequence_NewLine)        ? '\n'  : '\0';
+		case 'r':   return IsFlagSet(escapeSequences, EscapeSequence_CarriageReturn) ? '\r'  : '\0';
+		case 't':   return IsFlagSet(escapeSequences, EscapeSequence_Tab)            ? '\t'  : '\0';
+		case 'b':   return IsFlagSet(escapeSequences, EscapeSequence_Backspace)      ? '\b'  : '\0';
+		case 'a':   return IsFlagSet(escapeSequences, EscapeSequence_Bell)           ? '\a'  : '\0';
+		default: return '\0';
+	}
+}
+
 // This is for escaping C-like strings
 PEXP Str8 EscapeStringEx(Arena* arena, Str8 rawString, u8 escapeSequences, bool addNullTerm)
 {
 	NotNullStr(rawString);
-	Str8 result = Str8_Empty;
-	for (u8 pass = 0; pass < 2; pass++)
+	char searchBuffer[ESCAPE_SEQUENCE_MAX_SEARCH_BYTES];
+	Str8 searchBytes = GetEscapeSequenceSearchBytes(escapeSequences, &searchBuffer[0]);
+	TwoPassStr8Loop(result, arena, addNullTerm)
 	{
-		uxx outIndex = 0;
-		for (uxx bIndex = 0; bIndex < rawString.length; bIndex++)
-		{
-			char character = rawString.chars[bIndex];
-			if (IsFlagSet(escapeSequences, EscapeSequence_Backslash) && character == '\\')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = '\\';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_Quote) && character == '\"')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = '\"';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_Apostrophe) && character == '\'')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = '\'';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_NewLine) && character == '\n')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = 'n';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_CarriageReturn) && character == '\r')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = 'r';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_Tab) && character == '\t')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = 't';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_Backspace) && character == '\b')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = 'b';
-				}
-				outIndex += 2;
-			}
-			else if (IsFlagSet(escapeSequences, EscapeSequence_Bell) && character == '\a')
-			{
-				if (result.chars != nullptr)
-				{
-					Assert(outIndex+2 <= result.length);
-					result.chars[outIndex+0] = '\\';
-					result.chars[outIndex+1] = 'a';
-				}
-				outIndex += 2;
-			}
-			else
-			{
-				if (result.chars != nullptr) { Assert(outIndex < result.length); result.chars[outIndex] = character; }
-				outIndex++;
-			}
-		}
-		
-		if (pass == 0)
+		uxx bIndex = 0;
+		while (bIndex < rawString.length)
 		{
-			result.length = outIndex;
-			if (arena == nullptr || (result.length == 0 && !addNullTerm)) { return result; }
-			result.chars = (char*)AllocMem(arena, result.length + (addNullTerm ? 1 : 0));
-			NotNull(result.chars);
-		}
-		else
-		{
-			Assert(outIndex == result.length);
-			if (addNullTerm) { result.chars[result.length] = '\0'; }
+			uxx escapeIndex = FindNextByteInStr(rawString, bIndex, searchBytes);
+			TwoPassBytes(&result, escapeIndex - bIndex, &rawString.chars[bIndex]);
+			if (escapeIndex >= rawString.length) { break; }
+			TwoPassChar(&result, '\\');
+			TwoPassChar(&result, GetEscapeSequenceCodeChar(escapeSequences, rawString.chars[escapeIndex]));
+			bIndex = escapeIndex + 1;
 		}
+		TwoPassStr8LoopEnd(&result);
 	}
-	return result;
+	return result.str;
 }
 PEXPI Str8 EscapeString(Arena* arena, Str8 rawString)
 {
 	return EscapeStringEx(arena, rawString, EscapeSequence_All, false);
 }
 
+//Single pass version of EscapeStringEx that appends to the end of builder
+PEXP void StrBuilderAppendEscaped(StringBuilder* builder, Str8 rawString, u8 escapeSequences)
+{
+	NotNull(builder);
+	NotNullStr(rawString);
+	char searchBuffer[ESCAPE_SEQUENCE_MAX_SEARCH_BYTES];
+	Str8 searchBytes = GetEscapeSequenceSearchBytes(escapeSequences, &searchBuffer[0]);
+	StrBuilderReserve(builder, rawString.length);
+	uxx bIndex = 0;
+	while (bIndex < rawString.length)
+	{
+		uxx escapeIndex = FindNextByteInStr(rawString, bIndex, searchBytes);
+		StrBuilderAppendStr(builder, StrSlice(rawString, bIndex, escapeIndex));
+		if (escapeIndex >= rawString.length) { break; }
+		StrBuilderAppendChar(builder, '\\');
+		StrBuilderAppendChar(builder, GetEscapeSequenceCodeChar(escapeSequences, rawString.chars[escapeIndex]));
+		bIndex = escapeIndex + 1;
+	}
+}
+
 // This is for unescaping C-like strings
 //NOTE: Invalid escape sequences are just left as 2 characters (i.e. "\n" will stay as '\' and 'n' if the EscapeSequence_NewLine flag is not set)
 //      This means if you have an invalid escaped string, then the round-trip Unescape->Escape will produce extra backslash characters, which may not be desireable. 
@@ -175,151 +170,98 @@ PEXPI Str8 EscapeString(Arena* arena, Str8 rawString)
 PEXP Str8 UnescapeStringEx(Arena* arena, Str8 escapedString, u8 escapeSequences, bool addNullTerm)
 {
 	NotNullStr(escapedString);
-	Str8 result = Str8_Empty;
-	for (u8 pass = 0; pass < 2; pass++)
+	TwoPassStr8Loop(result, arena, addNullTerm)
 	{
-		uxx outIndex = 0;
-		for (uxx bIndex = 0; bIndex < escapedString.length; bIndex++)
-		{
-			char character = escapedString.chars[bIndex];
-			char nextCharacter = (bIndex+1 < escapedString.length) ? escapedString.chars[bIndex+1] : '\0';
-			if (character == '\\')
-			{
-				if (IsFlagSet(escapeSequences, EscapeSequence_Backslash) && nextCharacter == '\\')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\\';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_Quote) && nextCharacter == '\"')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\"';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_Apostrophe) && nextCharacter == '\'')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\'';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_NewLine) && nextCharacter == 'n')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\n';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_CarriageReturn) && nextCharacter == 'r')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\r';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_Tab) && nextCharacter == 't')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\t';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_Backspace) && nextCharacter == 'b')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\b';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else if (IsFlagSet(escapeSequences, EscapeSequence_Bell) && nextCharacter == 'a')
-				{
-					if (result.chars != nullptr)
-					{
-						Assert(outIndex < result.length);
-						result.chars[outIndex] = '\a';
-					}
-					outIndex++;
-					bIndex++;
-				}
-				else
-				{
-					if (result.chars != nullptr) { Assert(outIndex < result.length); result.chars[outIndex] = character; }
-					outIndex++;
-				}
-			}
-			else
-			{
-				if (result.chars != nullptr) { Assert(outIndex < result.length); result.chars[outIndex] = character; }
-				outIndex++;
-			}
-		}
-		
-		if (pass == 0)
+		uxx bIndex = 0;
+		while (bIndex < escapedString.length)
 		{
-			result.length = outIndex;
-			if (arena == nullptr || (result.length == 0 && !addNullTerm)) { return result; }
-			result.chars = (char*)AllocMem(arena, result.length + (addNullTerm ? 1 : 0));
-			NotNull(result.chars);
-		}
-		else
-		{
-			Assert(outIndex == result.length);
-			if (addNullTerm) { result.chars[result.length] = '\0'; }
+			uxx backslashIndex = FindNextByteInStr(escapedString, bIndex, StrLit("\\"));
+			TwoPassBytes(&result, backslashIndex - bIndex, &escapedString.chars[bIndex]);
+			if (backslashIndex >= escapedString.length) { break; }
+			char rawChar = (backslashIndex+1 < escapedString.length) ? GetEscapeSequenceRawChar(escapeSequences, escapedString.chars[backslashIndex+1]) : '\0';
+			if (rawChar != '\0') { TwoPassChar(&result, rawChar); bIndex = backslashIndex + 2; }
+			else { TwoPassChar(&result, '\\'); bIndex = backslashIndex + 1; }
 		}
+		TwoPassStr8LoopEnd(&result);
 	}
-	return result;
+	return result.str;
 }
 PEXPI Str8 UnescapeString(Arena* arena, Str8 escapedString)
 {
 	return UnescapeStringEx(arena, escapedString, EscapeSequence_All, false);
 }
 
+//Single pass version of UnescapeStringEx that appends to the end of builder
+PEXP void StrBuilderAppendUnescaped(StringBuilder* builder, Str8 escapedString, u8 escapeSequences)
+{
+	NotNull(builder);
+	NotNullStr(escapedString);
+	StrBuilderReserve(builder, escapedString.length);
+	uxx bIndex = 0;
+	while (bIndex < escapedString.length)
+	{
+		uxx backslashIndex = FindNextByteInStr(escapedString, bIndex, StrLit("\\"));
+		StrBuilderAppendStr(builder, StrSlice(escapedString, bIndex, backslashIndex));
+		if (backslashIndex >= escapedString.length) { break; }
+		char rawChar = (backslashIndex+1 < escapedString.length) ? GetEscapeSequenceRawChar(escapeSequences, escapedString.chars[backslashIndex+1]) : '\0';
+		if (rawChar != '\0') { StrBuilderAppendChar(builder, rawChar); bIndex = backslashIndex + 2; }
+		else { StrBuilderAppendChar(builder, '\\'); bIndex = backslashIndex + 1; }
+	}
+}
+
+// There are only 5 characters that need to be escaped in XML.
+// For text inside an element we don't actually need to escape " ' or > but we do anyways
+// For attribute strings we don't need to escape > but we do anyways
+PEXPI Str8 GetXmlEscapeSequence(char rawChar)
+{
+	switch (rawChar)
+	{
+		case '&':  return StrLit("&amp;");
+		case '<':  return StrLit("&lt;");
+		case '>':  return StrLit("&gt;");
+		case '"':  return StrLit("&quot;");
+		case '\'': return StrLit("&apos;");
+		default: return Str8_Empty;
+	}
+}
+
 PEXP Str8 EscapeXmlString(Arena* arena, Str8 rawString, bool addNullTerm)
 {
+	NotNullStr(rawString);
 	TwoPassStr8Loop(result, arena, addNullTerm)
 	{
-		for (uxx cIndex = 0; cIndex < rawString.length; cIndex++)
+		uxx cIndex = 0;
+		while (cIndex < rawString.length)
 		{
-			char character = rawString.chars[cIndex];
-			// There are only 5 characters that need to be escaped in XML.
-			// For text inside an element we don't actually need to escape " ' or > but we do anyways
-			// For attribute strings we don't need to escape > but we do anyways
-			if (character == '&') { TwoPassStrNt(&result, "&amp;"); }
-			else if (character == '<') { TwoPassStrNt(&result, "&lt;"); }
-			else if (character == '>') { TwoPassStrNt(&result, "&gt;"); }
-			else if (character == '"') { TwoPassStrNt(&result, "&quot;"); }
-			else if (character == '\'') { TwoPassStrNt(&result, "&apos;"); }
-			else { TwoPassChar(&result, character); }
+			uxx escapeIndex = FindNextByteInStr(rawString, cIndex, StrLit(XML_ESCAPE_SEARCH_BYTES));
+			TwoPassBytes(&result, escapeIndex - cIndex, &rawString.chars[cIndex]);
+			if (escapeIndex >= rawString.length) { break; }
+			Str8 escapeSequence = GetXmlEscapeSequence(rawString.chars[escapeIndex]);
+			TwoPassStr(&result, escapeSequence);
+			cIndex = escapeIndex + 1;
 		}
 		TwoPassStr8LoopEnd(&result);
 	}
 	return result.str;
 }
 
+//Single pass version of EscapeXmlString that appends to the end of builder
+PEXP void StrBuilderAppendEscapedXml(StringBuilder* builder, Str8 rawString)
+{
+	NotNull(builder);
+	NotNullStr(rawString);
+	StrBuilderReserve(builder, rawString.length);
+	uxx cIndex = 0;
+	while (cIndex < rawString.length)
+	{
+		uxx escapeIndex = FindNextByteInStr(rawString, cIndex, StrLit(XML_ESCAPE_SEARCH_BYTES));
+		StrBuilderAppendStr(builder, StrSlice(rawString, cIndex, escapeIndex));
+		if (escapeIndex >= rawString.length) { break; }
+		StrBuilderAppendStr(builder, GetXmlEscapeSequence(rawString.chars[escapeIndex]));
+		cIndex = escapeIndex + 1;
+	}
+}
+
 //TODO: Implement UnescapeXmlString
 
 #endif //PIG_CORE_IMPLEMENTATION
@@ -7,6 +7,11 @@ Description:
 	** which basically are just a recording of the last file write time
 	** along with some info to help us decide how often to check the write
 	** time and to handle the file existing or not
+	** An OsFileWatchSet watches many files and folders at once. On Linux/Android it asks inotify
+	** (and ReadDirectoryChangesW on Windows) to tell us when something changes so we don't have to
+	** stat every file every checkPeriod. Changes are collected once per call to OsUpdateFileWatchSet
+	** and coalesced so each path shows up at most once per update. On other platforms (or if the
+	** OS refuses to watch a particular folder) those watches fall back to polling like OsFileWatch
 */
 
 #ifndef _MISC_FILE_WATCH_H
@@ -17,7 +22,11 @@ Description:
 #include "base/base_macros.h"
 #include "base/base_assert.h"
 #include "mem/mem_arena.h"
+#include "mem/mem_scratch.h"
 #include "struct/struct_string.h"
+#include "struct/struct_string_builder.h"
+#include "struct/struct_var_array.h"
+#include "os/os_path.h"
 #include "os/os_file.h"
 
 typedef enum OsFileWatchChange OsFileWatchChange;
@@ -60,6 +69,81 @@ plex OsFileWatch
 	OsFileWatchChange change; //check and clear this!
 };
 
+#if (TARGET_IS_LINUX || TARGET_IS_ANDROID || TARGET_IS_WINDOWS)
+#define OS_FILE_WATCH_SET_EVENT_DRIVEN 1
+#else
+#define OS_FILE_WATCH_SET_EVENT_DRIVEN 0
+#endif
+
+#define OS_FILE_WATCH_SET_WIN32_BUFFER_SIZE Kilobytes(16)
+
+typedef plex OsFileWatchSetEvent OsFileWatchSetEvent;
+plex OsFileWatchSetEvent
+{
+	uxx watchId;
+	OsFileWatchChange change;
+	FilePath path; //full path of the thing that changed (for folder watches this is the file/folder inside the folder). Only valid until the next update
+	uxx pathIndex; //into OsFileWatchSet.eventPaths, path is filled out at the end of OsUpdateFileWatchSet
+};
+
+//NOTE: One of these exists for each folder we've asked the OS to watch, every watch inside the same folder shares it
+typedef plex OsFileWatchSetFolder OsFileWatchSetFolder;
+plex OsFileWatchSetFolder
+{
+	uxx refCount; //0 means this slot is unused
+	FilePath fullPath; //has a trailing slash
+	
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	int watchDescriptor;
+	#elif TARGET_IS_WINDOWS
+	HANDLE handle;
+	plex OsFileWatchSetWin32Read* read; //allocated separately because the OVERLAPPED can't move while a read is pending
+	#endif
+};
+
+#if TARGET_IS_WINDOWS
+typedef plex OsFileWatchSetWin32Read OsFileWatchSetWin32Read;
+plex OsFileWatchSetWin32Read
+{
+	OVERLAPPED overlapped;
+	bool isPending;
+	DWORD buffer[OS_FILE_WATCH_SET_WIN32_BUFFER_SIZE / sizeof(DWORD)]; //FILE_NOTIFY_INFORMATION entries must be DWORD aligned
+};
+#endif
+
+typedef plex OsFileWatchSetEntry OsFileWatchSetEntry;
+plex OsFileWatchSetEntry
+{
+	uxx id;
+	bool isFolder;
+	bool isPolled; //the OS would not watch the folder for us, so we are checking it every pollCheckPeriod instead
+	uxx folderIndex; //into OsFileWatchSet.folders (when !isPolled)
+	FilePath path;
+	FilePath fullPath; //for folders this has a trailing slash
+	Str8 fileName; //points into fullPath, empty for folder watches
+	OsFileWatch poll; //files only, also used to decide between Created/Modified/Deleted when the OS tells us something happened
+	bool folderExists; //folders only, used when isPolled
+	OsFileWriteTime folderWriteTime; //folders only, used when isPolled
+};
+
+typedef plex OsFileWatchSet OsFileWatchSet;
+plex OsFileWatchSet
+{
+	Arena* arena;
+	bool isEventDriven; //false when the OS doesn't give us change notifications and everything is polled
+	uxx pollCheckPeriod;
+	u64 lastPollTime;
+	uxx nextWatchId;
+	VarArray entries; //OsFileWatchSetEntry
+	VarArray folders; //OsFileWatchSetFolder
+	VarArray events; //OsFileWatchSetEvent, filled by OsUpdateFileWatchSet
+	StringBuilder eventPaths;
+	
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	int inotifyHandle;
+	#endif
+};
+
 // +--------------------------------------------------------------+
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
@@ -68,8 +152,18 @@ plex OsFileWatch
 	PIG_CORE_INLINE void OsInitFileWatch(Arena* arena, FilePath path, uxx checkPeriod, u64 programTime, OsFileWatch* watchOut);
 	PIG_CORE_INLINE bool OsUpdateFileWatch(OsFileWatch* watch, u64 programTime);
 	PIG_CORE_INLINE void OsResetFileWatch(OsFileWatch* watch, u64 programTime);
+	void OsFreeFileWatchSet(OsFileWatchSet* set);
+	void OsInitFileWatchSet(Arena* arena, uxx pollCheckPeriod, u64 programTime, OsFileWatchSet* setOut);
+	uxx OsFileWatchSetAdd(OsFileWatchSet* set, FilePath path, bool isFolder, u64 programTime);
+	PIG_CORE_INLINE uxx OsFileWatchSetAddFile(OsFileWatchSet* set, FilePath path, u64 programTime);
+	PIG_CORE_INLINE uxx OsFileWatchSetAddFolder(OsFileWatchSet* set, FilePath path, u64 programTime);
+	bool OsFileWatchSetRemove(OsFileWatchSet* set, uxx watchId);
+	uxx OsUpdateFileWatchSet(OsFileWatchSet* set, u64 programTime);
 #endif
 
+#define OsFileWatchSetEventLoop(setPntr, eventVarName, indexVarName) VarArrayLoop(&(setPntr)->events, indexVarName) { VarArrayLoopGet(OsFileWatchSetEvent, eventVarName, &(setPntr)->events, indexVarName);
+#define OsFileWatchSetEventLoopEnd() }
+
 // +--------------------------------------------------------------+
 // |                   Function Implementations                   |
 // +--------------------------------------------------------------+
@@ -159,6 +253,452 @@ PEXPI void OsResetFileWatch(OsFileWatch* watch, u64 programTime)
 	}
 }
 
+// +--------------------------------------------------------------+
+// |                        OsFileWatchSet                        |
+// +--------------------------------------------------------------+
+static void OsFileWatchSetReleaseFolder(OsFileWatchSet* set, uxx folderIndex)
+{
+	OsFileWatchSetFolder* folder = VarArrayGet(OsFileWatchSetFolder, &set->folders, folderIndex);
+	Assert(folder->refCount > 0);
+	folder->refCount--;
+	if (folder->refCount > 0) { return; }
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	if (folder->watchDescriptor >= 0) { inotify_rm_watch(set->inotifyHandle, folder->watchDescriptor); }
+	#elif TARGET_IS_WINDOWS
+	if (folder->handle != INVALID_HANDLE_VALUE)
+	{
+		if (folder->read != nullptr && folder->read->isPending)
+		{
+			CancelIoEx(folder->handle, &folder->read->overlapped);
+			DWORD numBytesTransferred = 0;
+			GetOverlappedResult(folder->handle, &folder->read->overlapped, &numBytesTransferred, TRUE); //wait for the cancel to finish before the buffer goes away
+		}
+		CloseHandle(folder->handle);
+	}
+	if (folder->read != nullptr) { FreeType(OsFileWatchSetWin32Read, set->arena, folder->read); }
+	#endif
+	FreeStr8(set->arena, &folder->fullPath);
+	ClearPointer(folder);
+}
+
+PEXP void OsFreeFileWatchSet(OsFileWatchSet* set)
+{
+	NotNull(set);
+	if (set->arena != nullptr)
+	{
+		VarArrayLoop(&set->entries, eIndex)
+		{
+			VarArrayLoopGet(OsFileWatchSetEntry, entry, &set->entries, eIndex);
+			if (!entry->isPolled) { OsFileWatchSetReleaseFolder(set, entry->folderIndex); }
+			if (!entry->isFolder) { OsFreeFileWatch(&entry->poll); }
+			FreeStr8(set->arena, &entry->path);
+			FreeStr8(set->arena, &entry->fullPath);
+		}
+		#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+		if (set->inotifyHandle >= 0) { close(set->inotifyHandle); }
+		#endif
+		FreeVarArray(&set->entries);
+		FreeVarArray(&set->folders);
+		FreeVarArray(&set->events);
+		FreeStrBuilder(&set->eventPaths);
+	}
+	ClearPointer(set);
+}
+
+PEXP void OsInitFileWatchSet(Arena* arena, uxx pollCheckPeriod, u64 programTime, OsFileWatchSet* setOut)
+{
+	NotNull(arena);
+	NotNull(setOut);
+	ClearPointer(setOut);
+	setOut->arena = arena;
+	setOut->pollCheckPeriod = pollCheckPeriod;
+	setOut->lastPollTime = programTime;
+	setOut->nextWatchId = 1;
+	InitVarArray(OsFileWatchSetEntry, &setOut->entries, arena);
+	InitVarArray(OsFileWatchSetFolder, &setOut->folders, arena);
+	InitVarArray(OsFileWatchSetEvent, &setOut->events, arena);
+	InitStrBuilder(&setOut->eventPaths, arena, 0);
+	
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	setOut->inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	setOut->isEventDriven = (setOut->inotifyHandle >= 0);
+	#elif TARGET_IS_WINDOWS
+	setOut->isEventDriven = true;
+	#else
+	setOut->isEventDriven = false;
+	#endif
+}
+
+#if OS_FILE_WATCH_SET_EVENT_DRIVEN
+#if TARGET_IS_WINDOWS
+static bool OsFileWatchSetIssueWin32Read(OsFileWatchSetFolder* folder)
+{
+	ClearStruct(folder->read->overlapped);
+	BOOL readResult = ReadDirectoryChangesW(
+		folder->handle, //hDirectory
+		&folder->read->buffer[0], //lpBuffer
+		(DWORD)sizeof(folder->read->buffer), //nBufferLength
+		FALSE, //bWatchSubtree
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE, //dwNotifyFilter
+		NULL, //lpBytesReturned (unused for overlapped reads)
+		&folder->read->overlapped, //lpOverlapped
+		NULL //lpCompletionRoutine
+	);
+	folder->read->isPending = (readResult != 0);
+	return folder->read->isPending;
+}
+#endif //TARGET_IS_WINDOWS
+
+//Returns the index of a folder that the OS is watching for us, or UINTXX_MAX if the OS won't watch it
+static uxx OsFileWatchSetAcquireFolder(OsFileWatchSet* set, FilePath folderFullPath)
+{
+	uxx freeIndex = set->folders.length;
+	VarArrayLoop(&set->folders, fIndex)
+	{
+		VarArrayLoopGet(OsFileWatchSetFolder, folder, &set->folders, fIndex);
+		if (folder->refCount == 0) { if (freeIndex == set->folders.length) { freeIndex = fIndex; } continue; }
+		#if TARGET_IS_WINDOWS
+		if (StrAnyCaseEquals(folder->fullPath, folderFullPath)) { folder->refCount++; return fIndex; }
+		#else
+		if (StrExactEquals(folder->fullPath, folderFullPath)) { folder->refCount++; return fIndex; }
+		#endif
+	}
+	
+	OsFileWatchSetFolder newFolder = ZEROED;
+	ScratchBegin1(scratch, set->arena);
+	FilePath folderPathNt = AllocStrAndCopy(scratch, folderFullPath.length, folderFullPath.chars, true);
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	{
+		const u32 watchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+		newFolder.watchDescriptor = inotify_add_watch(set->inotifyHandle, folderPathNt.chars, watchMask);
+		if (newFolder.watchDescriptor < 0) { ScratchEnd(scratch); return UINTXX_MAX; }
+	}
+	#elif TARGET_IS_WINDOWS
+	{
+		ChangePathSlashesTo(folderPathNt, '\\');
+		newFolder.handle = CreateFileA(
+			folderPathNt.chars, //lpFileName
+			FILE_LIST_DIRECTORY, //dwDesiredAccess
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, //dwShareMode (we don't want to stop anybody else from touching the folder)
+			NULL, //lpSecurityAttributes
+			OPEN_EXISTING, //dwCreationDisposition
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, //dwFlagsAndAttributes (BACKUP_SEMANTICS is required to open a folder)
+			NULL //hTemplateFile
+		);
+		if (newFolder.handle == INVALID_HANDLE_VALUE) { ScratchEnd(scratch); return UINTXX_MAX; }
+		newFolder.read = AllocType(OsFileWatchSetWin32Read, set->arena);
+		NotNull(newFolder.read);
+		ClearPointer(newFolder.read);
+		if (!OsFileWatchSetIssueWin32Read(&newFolder))
+		{
+			CloseHandle(newFolder.handle);
+			FreeType(OsFileWatchSetWin32Read, set->arena, newFolder.read);
+			ScratchEnd(scratch);
+			return UINTXX_MAX;
+		}
+	}
+	#endif
+	ScratchEnd(scratch);
+	
+	newFolder.refCount = 1;
+	newFolder.fullPath = AllocStr8(set->arena, folderFullPath);
+	if (freeIndex < set->folders.length) { *VarArrayGet(OsFileWatchSetFolder, &set->folders, freeIndex) = newFolder; }
+	else { VarArrayAddValue(OsFileWatchSetFolder, &set->folders, newFolder); }
+	return freeIndex;
+}
+#endif //OS_FILE_WATCH_SET_EVENT_DRIVEN
+
+//Returns a non-zero watchId that can be used to remove the watch later and is reported in each OsFileWatchSetEvent
+//NOTE: Folder watches are not recursive, we get events for files and folders directly inside the folder
+//NOTE: Files are watched by watching the folder they live in (that way we catch editors that save by renaming a new file over the old one)
+//      so the parent folder needs to exist when the file watch is added, otherwise the watch is polled
+PEXP uxx OsFileWatchSetAdd(OsFileWatchSet* set, FilePath path, bool isFolder, u64 programTime)
+{
+	NotNull(set);
+	NotNull(set->arena);
+	NotNullStr(path);
+	OsFileWatchSetEntry* newEntry = VarArrayAdd(OsFileWatchSetEntry, &set->entries);
+	NotNull(newEntry);
+	ClearPointer(newEntry);
+	newEntry->id = set->nextWatchId;
+	set->nextWatchId++;
+	newEntry->isFolder = isFolder;
+	newEntry->path = AllocStr8(set->arena, path);
+	if (isFolder)
+	{
+		ScratchBegin1(scratch, set->arena);
+		FilePath fullPath = OsGetFullPath(scratch, path);
+		newEntry->fullPath = AllocFolderPath(set->arena, fullPath, false);
+		ScratchEnd(scratch);
+		newEntry->folderExists = OsDoesFolderExist(newEntry->fullPath);
+		if (newEntry->folderExists) { OsGetFileWriteTime(newEntry->fullPath, &newEntry->folderWriteTime); }
+	}
+	else
+	{
+		OsInitFileWatch(set->arena, path, 0, programTime, &newEntry->poll);
+		newEntry->fullPath = AllocStr8(set->arena, newEntry->poll.fullPath);
+		newEntry->fileName = GetFileNamePart(newEntry->fullPath, true);
+	}
+	
+	newEntry->isPolled = true;
+	#if OS_FILE_WATCH_SET_EVENT_DRIVEN
+	if (set->isEventDriven)
+	{
+		FilePath folderFullPath = (isFolder ? newEntry->fullPath : GetFileFolderPart(newEntry->fullPath));
+		uxx folderIndex = OsFileWatchSetAcquireFolder(set, folderFullPath);
+		if (folderIndex != UINTXX_MAX)
+		{
+			newEntry->isPolled = false;
+			newEntry->folderIndex = folderIndex;
+		}
+	}
+	#endif
+	return newEntry->id;
+}
+PEXPI uxx OsFileWatchSetAddFile(OsFileWatchSet* set, FilePath path, u64 programTime) { return OsFileWatchSetAdd(set, path, false, programTime); }
+PEXPI uxx OsFileWatchSetAddFolder(OsFileWatchSet* set, FilePath path, u64 programTime) { return OsFileWatchSetAdd(set, path, true, programTime); }
+
+PEXP bool OsFileWatchSetRemove(OsFileWatchSet* set, uxx watchId)
+{
+	NotNull(set);
+	NotNull(set->arena);
+	VarArrayLoop(&set->entries, eIndex)
+	{
+		VarArrayLoopGet(OsFileWatchSetEntry, entry, &set->entries, eIndex);
+		if (entry->id == watchId)
+		{
+			if (!entry->isPolled) { OsFileWatchSetReleaseFolder(set, entry->folderIndex); }
+			if (!entry->isFolder) { OsFreeFileWatch(&entry->poll); }
+			FreeStr8(set->arena, &entry->path);
+			FreeStr8(set->arena, &entry->fullPath);
+			VarArrayRemoveAt(OsFileWatchSetEntry, &set->entries, eIndex);
+			return true;
+		}
+	}
+	return false;
+}
+
+//Adds an event, or merges it with the event we already have for the same path this update.
+//The path is passed in two parts (folder path and name) so we don't need to join them anywhere else first
+static void OsFileWatchSetPushEvent(OsFileWatchSet* set, uxx watchId, OsFileWatchChange change, Str8 pathPrefix, Str8 pathSuffix)
+{
+	VarArrayLoop(&set->events, eIndex)
+	{
+		VarArrayLoopGet(OsFileWatchSetEvent, event, &set->events, eIndex);
+		if (event->watchId != watchId || event->path.length != pathPrefix.length + pathSuffix.length) { continue; }
+		if (!StrExactEquals(MakeStr8(pathPrefix.length, set->eventPaths.chars + event->pathIndex), pathPrefix)) { continue; }
+		if (!StrExactEquals(MakeStr8(pathSuffix.length, set->eventPaths.chars + event->pathIndex + pathPrefix.length), pathSuffix)) { continue; }
+		
+		if (event->change == OsFileWatchChange_Created && change == OsFileWatchChange_Deleted) { VarArrayRemoveAt(OsFileWatchSetEvent, &set->events, eIndex); } //came and went before anyone noticed
+		else if (event->change == OsFileWatchChange_Created && change == OsFileWatchChange_Modified) { } //still just Created
+		else if (event->change == OsFileWatchChange_Deleted && change == OsFileWatchChange_Created) { event->change = OsFileWatchChange_Modified; } //replaced
+		else { event->change = change; }
+		return;
+	}
+	
+	OsFileWatchSetEvent* newEvent = VarArrayAdd(OsFileWatchSetEvent, &set->events);
+	NotNull(newEvent);
+	ClearPointer(newEvent);
+	newEvent->watchId = watchId;
+	newEvent->change = change;
+	newEvent->path.length = pathPrefix.length + pathSuffix.length;
+	newEvent->pathIndex = set->eventPaths.length;
+	StrBuilderAppendStr(&set->eventPaths, pathPrefix);
+	StrBuilderAppendStr(&set->eventPaths, pathSuffix);
+}
+
+//NOTE: For file watches we don't trust the kind of event the OS gave us (saving by renaming a new file over the old one
+//      shows up as a delete and a create for example), we only use it as a hint to go check the file ourselves
+static void OsFileWatchSetCheckFile(OsFileWatchSet* set, OsFileWatchSetEntry* entry, u64 programTime)
+{
+	if (OsUpdateFileWatch(&entry->poll, programTime))
+	{
+		OsFileWatchSetPushEvent(set, entry->id, entry->poll.change, entry->fullPath, Str8_Empty);
+		entry->poll.change = OsFileWatchChange_None;
+	}
+}
+
+static void OsFileWatchSetCheckFolder(OsFileWatchSet* set, OsFileWatchSetEntry* entry)
+{
+	bool existsNow = OsDoesFolderExist(entry->fullPath);
+	if (existsNow != entry->folderExists)
+	{
+		entry->folderExists = existsNow;
+		if (existsNow) { OsGetFileWriteTime(entry->fullPath, &entry->folderWriteTime); }
+		OsFileWatchSetPushEvent(set, entry->id, existsNow ? OsFileWatchChange_Created : OsFileWatchChange_Deleted, entry->fullPath, Str8_Empty);
+	}
+	else if (existsNow)
+	{
+		//NOTE: A folder's write time changes when something inside it is added, removed, or renamed. We can't tell what from here
+		OsFileWriteTime newWriteTime = ZEROED;
+		if (OsGetFileWriteTime(entry->fullPath, &newWriteTime) == Result_Success && !OsAreFileWriteTimesEqual(entry->folderWriteTime, newWriteTime))
+		{
+			entry->folderWriteTime = newWriteTime;
+			OsFileWatchSetPushEvent(set, entry->id, OsFileWatchChange_Modified, entry->fullPath, Str8_Empty);
+		}
+	}
+}
+
+#if OS_FILE_WATCH_SET_EVENT_DRIVEN
+//Called for each change the OS tells us about. An empty name means the watched folder itself changed
+static void OsFileWatchSetHandleOsEvent(OsFileWatchSet* set, uxx folderIndex, Str8 name, OsFileWatchChange change, u64 programTime)
+{
+	OsFileWatchSetFolder* folder = VarArrayGet(OsFileWatchSetFolder, &set->folders, folderIndex);
+	VarArrayLoop(&set->entries, eIndex)
+	{
+		VarArrayLoopGet(OsFileWatchSetEntry, entry, &set->entries, eIndex);
+		if (entry->isPolled || entry->folderIndex != folderIndex) { continue; }
+		if (entry->isFolder)
+		{
+			if (name.length == 0)
+			{
+				if (change == OsFileWatchChange_Deleted) { entry->folderExists = false; }
+				OsFileWatchSetPushEvent(set, entry->id, change, entry->fullPath, Str8_Empty);
+			}
+			else { OsFileWatchSetPushEvent(set, entry->id, change, folder->fullPath, name); }
+		}
+		#if TARGET_IS_WINDOWS
+		else if (StrAnyCaseEquals(entry->fileName, name)) { OsFileWatchSetCheckFile(set, entry, programTime); }
+		#else
+		else if (StrExactEquals(entry->fileName, name)) { OsFileWatchSetCheckFile(set, entry, programTime); }
+		#endif
+	}
+}
+
+//The OS stopped watching this folder (it was deleted, renamed, or unmounted) so everything inside it goes back to polling
+static void OsFileWatchSetFallBackToPolling(OsFileWatchSet* set, uxx folderIndex, u64 programTime)
+{
+	VarArrayLoop(&set->entries, eIndex)
+	{
+		VarArrayLoopGet(OsFileWatchSetEntry, entry, &set->entries, eIndex);
+		if (entry->isPolled || entry->folderIndex != folderIndex) { continue; }
+		OsFileWatchSetReleaseFolder(set, entry->folderIndex);
+		entry->isPolled = true;
+		if (entry->isFolder) { OsFileWatchSetCheckFolder(set, entry); }
+		else { OsFileWatchSetCheckFile(set, entry, programTime); }
+	}
+}
+#endif //OS_FILE_WATCH_SET_EVENT_DRIVEN
+
+//Returns the number of events in set->events. The events (and their paths) are valid until the next call
+PEXP uxx OsUpdateFileWatchSet(OsFileWatchSet* set, u64 programTime)
+{
+	NotNull(set);
+	NotNull(set->arena);
+	VarArrayClear(&set->events);
+	ClearStrBuilder(&set->eventPaths);
+	bool checkEverything = false;
+	
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	if (set->isEventDriven)
+	{
+		car { plex inotify_event event; u8 bytes[4096]; } buffer; //inotify_event has to be aligned
+		while (true)
+		{
+			ssize_t readResult = read(set->inotifyHandle, &buffer.bytes[0], sizeof(buffer.bytes));
+			if (readResult <= 0) { break; } //EAGAIN, nothing left to read
+			
+			uxx byteIndex = 0;
+			while (byteIndex + sizeof(plex inotify_event) <= (uxx)readResult)
+			{
+				const plex inotify_event* event = (const plex inotify_event*)&buffer.bytes[byteIndex];
+				byteIndex += sizeof(plex inotify_event) + event->len;
+				if (IsFlagSet(event->mask, IN_Q_OVERFLOW)) { checkEverything = true; continue; }
+				
+				uxx folderIndex = UINTXX_MAX;
+				VarArrayLoop(&set->folders, fIndex)
+				{
+					VarArrayLoopGet(OsFileWatchSetFolder, folder, &set->folders, fIndex);
+					if (folder->refCount > 0 && folder->watchDescriptor == event->wd) { folderIndex = fIndex; break; }
+				}
+				if (folderIndex == UINTXX_MAX) { continue; } //events can still trickle in for a watch we just removed
+				
+				if (IsFlagSet(event->mask, IN_IGNORED))
+				{
+					VarArrayGet(OsFileWatchSetFolder, &set->folders, folderIndex)->watchDescriptor = -1; //the kernel already removed it
+					OsFileWatchSetFallBackToPolling(set, folderIndex, programTime);
+					continue;
+				}
+				
+				Str8 name = (event->len > 0) ? MakeStr8((uxx)MyStrLength(event->name), event->name) : Str8_Empty; //name is null-terminated (and padded with more zeros)
+				OsFileWatchChange change = OsFileWatchChange_Modified;
+				if (IsFlagSet(event->mask, IN_CREATE) || IsFlagSet(event->mask, IN_MOVED_TO)) { change = OsFileWatchChange_Created; }
+				else if (IsFlagSet(event->mask, IN_DELETE) || IsFlagSet(event->mask, IN_MOVED_FROM) || IsFlagSet(event->mask, IN_DELETE_SELF) || IsFlagSet(event->mask, IN_MOVE_SELF)) { change = OsFileWatchChange_Deleted; }
+				OsFileWatchSetHandleOsEvent(set, folderIndex, name, change, programTime);
+			}
+		}
+	}
+	#elif TARGET_IS_WINDOWS
+	{
+		VarArrayLoop(&set->folders, fIndex)
+		{
+			OsFileWatchSetFolder* folder = VarArrayGet(OsFileWatchSetFolder, &set->folders, fIndex);
+			if (folder->refCount == 0 || folder->read == nullptr || !folder->read->isPending) { continue; }
+			
+			DWORD numBytesTransferred = 0;
+			if (!GetOverlappedResult(folder->handle, &folder->read->overlapped, &numBytesTransferred, FALSE))
+			{
+				if (GetLastError() == ERROR_IO_INCOMPLETE) { continue; } //nothing has changed yet
+				folder->read->isPending = false;
+				OsFileWatchSetFallBackToPolling(set, fIndex, programTime);
+				continue;
+			}
+			folder->read->isPending = false;
+			
+			//NOTE: 0 bytes means the buffer overflowed and the changes were thrown away
+			if (numBytesTransferred == 0) { checkEverything = true; }
+			
+			ScratchBegin1(scratch, set->arena);
+			uxx byteIndex = 0;
+			while (numBytesTransferred > 0 && byteIndex + sizeof(FILE_NOTIFY_INFORMATION) <= (uxx)numBytesTransferred)
+			{
+				const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)((const u8*)&folder->read->buffer[0] + byteIndex);
+				int nameLength = WideCharToMultiByte(CP_UTF8, 0, &info->FileName[0], (int)(info->FileNameLength / sizeof(WCHAR)), NULL, 0, NULL, NULL);
+				Str8 name = Str8_Empty;
+				if (nameLength > 0)
+				{
+					name.length = (uxx)nameLength;
+					name.chars = (char*)AllocMem(scratch, name.length);
+					WideCharToMultiByte(CP_UTF8, 0, &info->FileName[0], (int)(info->FileNameLength / sizeof(WCHAR)), name.chars, nameLength, NULL, NULL);
+				}
+				
+				OsFileWatchChange change = OsFileWatchChange_Modified;
+				if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) { change = OsFileWatchChange_Created; }
+				else if (info->Action == FILE_ACTION_REMOVED || info->Action == FILE_ACTION_RENAMED_OLD_NAME) { change = OsFileWatchChange_Deleted; }
+				if (name.length > 0) { OsFileWatchSetHandleOsEvent(set, fIndex, name, change, programTime); }
+				
+				if (info->NextEntryOffset == 0) { break; }
+				byteIndex += info->NextEntryOffset;
+			}
+			ScratchEnd(scratch);
+			
+			if (folder->refCount > 0 && !OsFileWatchSetIssueWin32Read(folder)) { OsFileWatchSetFallBackToPolling(set, fIndex, programTime); }
+		}
+	}
+	#endif
+	
+	bool isPollTime = (set->pollCheckPeriod == 0 || TimeSinceBy(programTime, set->lastPollTime) >= set->pollCheckPeriod);
+	if (isPollTime) { set->lastPollTime = programTime; }
+	if (isPollTime || checkEverything)
+	{
+		VarArrayLoop(&set->entries, eIndex)
+		{
+			VarArrayLoopGet(OsFileWatchSetEntry, entry, &set->entries, eIndex);
+			if (!entry->isPolled && !checkEverything) { continue; }
+			if (entry->isFolder) { OsFileWatchSetCheckFolder(set, entry); }
+			else { OsFileWatchSetCheckFile(set, entry, programTime); }
+		}
+	}
+	
+	//Now that eventPaths is done growing we can point each event at it's path
+	VarArrayLoop(&set->events, eIndex)
+	{
+		VarArrayLoopGet(OsFileWatchSetEvent, event, &set->events, eIndex);
+		event->path.chars = set->eventPaths.chars + event->pathIndex;
+	}
+	return set->events.length;
+}
+
 #endif //PIG_CORE_IMPLEMENTATION
 
 #endif //  _MISC_FILE_WATCH_H
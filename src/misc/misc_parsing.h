@@ -19,11 +19,25 @@ Description:
 #include "std/std_printf.h"
 #include "std/std_basic_math.h"
 #include "misc/misc_result.h"
+#include "misc/misc_float_conversion.h"
 #include "base/base_unicode.h"
 #include "struct/struct_string.h"
 
 #define MAX_FLOAT_PARSE_LENGTH   64 //characters
 
+enum ParseListType
+{
+	ParseListType_None = 0,
+	ParseListType_U64,
+	ParseListType_U32,
+	ParseListType_I64,
+	ParseListType_I32,
+	ParseListType_R64,
+	ParseListType_R32,
+	ParseListType_Count,
+};
+typedef enum ParseListType ParseListType;
+
 // +--------------------------------------------------------------+
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
@@ -48,6 +62,12 @@ Description:
 	PIG_CORE_INLINE bool TryParseR64(Str8 str, r64* valueOut, Result* errorOut);
 	bool TryParseR32Ex(Str8 str, r32* valueOut, Result* errorOut, bool allowSuffix, bool allowInfinityOrNan);
 	PIG_CORE_INLINE bool TryParseR32(Str8 str, r32* valueOut, Result* errorOut);
+	bool TryParseU64List(Str8 str, char delimiter, uxx maxNumValues, u64* valuesOut, uxx* numValuesOut, Result* errorOut);
+	bool TryParseU32List(Str8 str, char delimiter, uxx maxNumValues, u32* valuesOut, uxx* numValuesOut, Result* errorOut);
+	bool TryParseI64List(Str8 str, char delimiter, uxx maxNumValues, i64* valuesOut, uxx* numValuesOut, Result* errorOut);
+	bool TryParseI32List(Str8 str, char delimiter, uxx maxNumValues, i32* valuesOut, uxx* numValuesOut, Result* errorOut);
+	bool TryParseR64List(Str8 str, char delimiter, uxx maxNumValues, r64* valuesOut, uxx* numValuesOut, Result* errorOut);
+	bool TryParseR32List(Str8 str, char delimiter, uxx maxNumValues, r32* valuesOut, uxx* numValuesOut, Result* errorOut);
 	bool TryParseBoolEx(Str8 str, bool* valueOut, Result* errorOut, bool strict);
 	PIG_CORE_INLINE bool TryParseBool(Str8 str, bool* valueOut, Result* errorOut);
 #endif
@@ -69,7 +89,51 @@ Description:
 // +==============================+
 // |    Parse Unsigned Integer    |
 // +==============================+
-//TODO: For some reason 18446744073709551616-18446744073709551619 incorrectly succeed parsing and return 0-3
+//Parses as many decimal digits as it can starting at *indexInOut, 8 at a time when there are at least 8 bytes left (SWAR).
+//Returns false if the digits don't fit in a u64 (indexInOut is left pointing at the digit that overflowed)
+static bool ParseDecimalDigitsU64(Str8 str, uxx* indexInOut, u64* valueOut, uxx* numDigitsOut)
+{
+	static const u64 powersOfTen[] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull };
+	uxx index = *indexInOut;
+	u64 value = 0;
+	uxx numDigits = 0;
+	bool foundEnd = false;
+	while (index + 8 <= str.length && numDigits + 8 <= FLOAT_CONV_MAX_FAST_DIGITS)
+	{
+		u64 chunk = 0;
+		MyMemCopy(&chunk, &str.chars[index], sizeof(chunk));
+		//Each byte becomes 0x00 if it's a digit. Carries from non-digit bytes only affect the bytes after them, which we don't look at
+		u64 classified = (((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ^ 0x3333333333333333ull);
+		u64 nonDigitBytes = ((((classified & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | classified) & 0x8080808080808080ull);
+		u8 numChunkDigits = (nonDigitBytes == 0) ? 8 : (u8)(CountTrailingZerosU64(nonDigitBytes) / 8);
+		if (numChunkDigits < 8)
+		{
+			//Move the digits to the end of the chunk and fill the front with '0' so the 8 digit conversion still works
+			if (numChunkDigits > 0) { chunk = (chunk << (8 * (8 - numChunkDigits))) | (0x3030303030303030ull >> (8 * numChunkDigits)); }
+			foundEnd = true;
+		}
+		if (numChunkDigits > 0) { value = (value * powersOfTen[numChunkDigits]) + FloatConv_ParseEightDigits(chunk); }
+		numDigits += numChunkDigits;
+		index += numChunkDigits;
+		if (foundEnd) { break; }
+	}
+	if (!foundEnd)
+	{
+		while (index < str.length && IsCharNumeric(str.chars[index]))
+		{
+			u64 digit = (u64)GetNumericCharValue(str.chars[index]);
+			if (value > (UINT64_MAX - digit) / 10ULL) { *indexInOut = index; return false; }
+			value = (value * 10ULL) + digit;
+			numDigits++;
+			index++;
+		}
+	}
+	*indexInOut = index;
+	*valueOut = value;
+	*numDigitsOut = numDigits;
+	return true;
+}
+
 PEXP bool TryParseU64Ex(Str8 str, u64* valueOut, Result* errorOut, bool allowHex, bool allowBinary, bool allowDecimal)
 {
 	NotNullStr(str);
@@ -81,6 +145,24 @@ PEXP bool TryParseU64Ex(Str8 str, u64* valueOut, Result* errorOut, bool allowHex
 	if (allowHex && StrExactStartsWith(str, StrLit("0x"))) { foundHexDesignation = true; str = StrSliceFrom(str, 2); }
 	else if (allowBinary && StrExactStartsWith(str, StrLit("0b"))) { foundBinaryDesignation = true; str = StrSliceFrom(str, 2); }
 	
+	if (!foundHexDesignation && !foundBinaryDesignation)
+	{
+		//Fast path for plain decimal numbers, anything else falls through to the loop below which reports the right error
+		uxx digitsIndex = 0;
+		uxx numDigits = 0;
+		if (!ParseDecimalDigitsU64(str, &digitsIndex, &result, &numDigits))
+		{
+			SetOptionalOutPntr(errorOut, Result_Overflow);
+			return false;
+		}
+		if (numDigits > 0 && digitsIndex == str.length)
+		{
+			SetOptionalOutPntr(valueOut, result);
+			return true;
+		}
+		result = 0;
+	}
+	
 	bool foundNumbers = false;
 	while (str.length > 0)
 	{
@@ -135,7 +217,7 @@ PEXP bool TryParseU64Ex(Str8 str, u64* valueOut, Result* errorOut, bool allowHex
 		}
 		else if (!foundHexDesignation && !foundBinaryDesignation && codepoint >= '0' && codepoint <= '9')
 		{
-			if (result > UINT64_MAX / 10ULL)
+			if (result > (UINT64_MAX - (u64)(codepoint - '0')) / 10ULL)
 			{
 				SetOptionalOutPntr(errorOut, Result_Overflow);
 				return false;
@@ -357,98 +439,13 @@ PEXP bool TryParseR64Ex(Str8 str, r64* valueOut, Result* errorOut, bool allowInf
 	else if (StrAnyCaseEquals(str, StrLit("-infinity"))) {  if (allowInfinityOrNan) { result = -INFINITY; } else { SetOptionalOutPntr(errorOut, Result_InfinityOrNan); return false; } }
 	else
 	{
-		u64 bIndex = 0;
-		
-		bool isNegative = false;
-		if (bIndex < str.length && str.chars[bIndex] == '+') { bIndex++; isNegative = false; }
-		else if (bIndex < str.length && str.chars[bIndex] == '-') { bIndex++; isNegative = true; }
-		
-		bool foundNumbersBeforePeriod = false;
-		for (; bIndex < str.length; bIndex++)
-		{
-			char nextChar = str.chars[bIndex];
-			if (!IsCharNumeric(nextChar)) { break; }
-			foundNumbersBeforePeriod = true;
-			result = (result * 10.0) + (r64)GetNumericCharValue(nextChar);
-		}
-		
-		// bool foundPeriod = false;
-		bool foundNumbersAfterPeriod = false;
-		if (bIndex < str.length && str.chars[bIndex] == '.')
-		{
-			bIndex++;
-			// foundPeriod = true;
-			
-			r64 digitInvPower = 10.0;
-			for (; bIndex < str.length; bIndex++)
-			{
-				char nextChar = str.chars[bIndex];
-				if (!IsCharNumeric(nextChar)) { break; }
-				foundNumbersAfterPeriod = true;
-				result = result + ((r64)GetNumericCharValue(nextChar) / digitInvPower);
-				digitInvPower *= 10.0;
-			}
-		}
-		
-		// bool foundScientificNotation = false;
-		bool negativeExponent = false;
-		r64 exponentMultiplier = 1.0;
-		if (bIndex < str.length && (str.chars[bIndex] == 'e' || str.chars[bIndex] == 'E'))
-		{
-			bIndex++;
-			// foundScientificNotation = true;
-			
-			if (bIndex < str.length && str.chars[bIndex] == '+') { bIndex++; negativeExponent = false; }
-			else if (bIndex < str.length && str.chars[bIndex] == '-') { bIndex++; negativeExponent = true; }
-			
-			bool foundExponentNumbers = false;
-			r64 exponent = 0.0;
-			for (; bIndex < str.length; bIndex++)
-			{
-				char nextChar = str.chars[bIndex];
-				if (!IsCharNumeric(nextChar)) { break; }
-				foundExponentNumbers = true;
-				exponent = (exponent * 10.0) + (r64)GetNumericCharValue(nextChar);
-			}
-			if (exponent > 308.0) { exponent = 308.0; }
-			
-			if (!foundExponentNumbers)
-			{
-				if (bIndex >= str.length)
-				{
-					SetOptionalOutPntr(errorOut, Result_MissingExponent);
-					return false;
-				}
-				else
-				{
-					//NOTE: If we didn't make it to the end, there is some non-numeric
-					//      character that prevented the loop from continuing. We can
-					//      consider it an invalid character no matter what it is at this point.
-					SetOptionalOutPntr(errorOut, Result_InvalidCharacter);
-					return false;
-				}
-			}
-			
-			while (exponent >= 50.0) { exponentMultiplier *= 1e50; exponent -= 50.0; }
-			while (exponent >= 8.0)  { exponentMultiplier *= 1e8;  exponent -= 8.0;  }
-			while (exponent >  0.0)  { exponentMultiplier *= 10.0; exponent -= 1.0;  }
-		}
-		
-		// If we haven't made it to the end of the string then there must be some
-		// invalid character that blocked the loops above from continuing
-		if (bIndex < str.length)
-		{
-			SetOptionalOutPntr(errorOut, Result_InvalidCharacter);
-			return false;
-		}
-		
-		if (!foundNumbersBeforePeriod && !foundNumbersAfterPeriod)
+		if (!TryParseR64Fast(str, &result, errorOut)) { return false; }
+		//Values that are too large for r64 come back as infinity, which we treat the same as "inf"
+		if (!allowInfinityOrNan && IsInfiniteOrNanR64(result))
 		{
-			SetOptionalOutPntr(errorOut, Result_NoNumbers);
+			SetOptionalOutPntr(errorOut, Result_InfinityOrNan);
 			return false;
 		}
-		
-		result = (isNegative ? -1.0 : 1.0) * (negativeExponent ? (result / exponentMultiplier) : (result * exponentMultiplier));
 	}
 	
 	SetOptionalOutPntr(valueOut, result);
@@ -463,7 +460,8 @@ PEXP bool TryParseR32Ex(Str8 str, r32* valueOut, Result* errorOut, bool allowSuf
 {
 	NotNullStr(str);
 	str = TrimWhitespace(str);
-	if (allowSuffix && str.length > 0 && str.chars[str.length-1] == 'f')
+	//NOTE: We only strip the suffix when it follows a digit or period so things like "inf" are left alone
+	if (allowSuffix && str.length > 1 && str.chars[str.length-1] == 'f' && (IsCharNumeric(str.chars[str.length-2]) || str.chars[str.length-2] == '.'))
 	{
 		str.length--;
 	}
@@ -478,44 +476,195 @@ PEXP bool TryParseR32Ex(Str8 str, r32* valueOut, Result* errorOut, bool allowSuf
 		return false;
 	}
 	
-	//We need a local buffer to ensure the string is null-terminated (a requirement of atof)
-	char localBuffer[MAX_FLOAT_PARSE_LENGTH+1];
-	MyMemCopy(&localBuffer[0], str.chars, str.length);
-	localBuffer[str.length] = '\0';
-	Str8 tempStr = MakeStr8(str.length, &localBuffer[0]);
+	r32 result = 0.0f;
+	if (StrAnyCaseEquals(str, StrLit("nan"))) { if (allowInfinityOrNan) { result = NAN; } else { SetOptionalOutPntr(errorOut, Result_InfinityOrNan); return false; } }
+	else if (StrAnyCaseEquals(str, StrLit("inf")) || StrAnyCaseEquals(str, StrLit("+inf")) || StrAnyCaseEquals(str, StrLit("infinity")) || StrAnyCaseEquals(str, StrLit("+infinity")))
+	{
+		if (allowInfinityOrNan) { result = INFINITY; } else { SetOptionalOutPntr(errorOut, Result_InfinityOrNan); return false; }
+	}
+	else if (StrAnyCaseEquals(str, StrLit("-inf")) || StrAnyCaseEquals(str, StrLit("-infinity")))
+	{
+		if (allowInfinityOrNan) { result = -INFINITY; } else { SetOptionalOutPntr(errorOut, Result_InfinityOrNan); return false; }
+	}
+	else
+	{
+		if (!TryParseR32Fast(str, &result, errorOut)) { return false; }
+		if (!allowInfinityOrNan && IsInfiniteOrNanR32(result))
+		{
+			SetOptionalOutPntr(errorOut, Result_InfinityOrNan);
+			return false;
+		}
+	}
+	
+	SetOptionalOutPntr(valueOut, result);
+	return true;
+}
+PEXPI bool TryParseR32(Str8 str, r32* valueOut, Result* errorOut)
+{
+	return TryParseR32Ex(str, valueOut, errorOut, true, false);
+}
+
+// +==============================+
+// |      Parse Number Lists      |
+// +==============================+
+static bool IsParseListSeparator(char character, char delimiter)
+{
+	return (character == delimiter || character == ' ' || character == '\t' || character == '\n' || character == '\r');
+}
+
+//Parses a single integer element starting at *indexInOut, the element must end at a separator or the end of the string
+static bool TryParseListInteger(Str8 str, uxx* indexInOut, char delimiter, bool isSigned, u64* magnitudeOut, bool* isNegativeOut, Result* errorOut)
+{
+	uxx index = *indexInOut;
+	bool isNegative = false;
+	if (isSigned && index < str.length && (str.chars[index] == '-' || str.chars[index] == '+')) { isNegative = (str.chars[index] == '-'); index++; }
 	
-	r64 resultR64 = MyStrToFloat(tempStr.chars);
-	if (!allowInfinityOrNan && IsInfiniteOrNanR64(resultR64))
+	u64 magnitude = 0;
+	if (index + 1 < str.length && str.chars[index] == '0' && (str.chars[index+1] == 'x' || str.chars[index+1] == 'b'))
 	{
-		SetOptionalOutPntr(errorOut, Result_InfinityOrNan);
-		return false;
+		//Hex and binary are rare enough that we just hand them off to the regular parser
+		uxx elementEnd = index;
+		while (elementEnd < str.length && !IsParseListSeparator(str.chars[elementEnd], delimiter)) { elementEnd++; }
+		if (!TryParseU64Ex(StrSlice(str, index, elementEnd), &magnitude, errorOut, true, true, true)) { return false; }
+		index = elementEnd;
 	}
-	//atof doesn't really give us errors. When it fails it gives us 0.0.
-	//We are going to do some sanity checks to try and tell between a failed parse and an actual parse of 0.0
-	if (resultR64 == 0.0)
+	else
 	{
-		bool containsZero = false;
-		bool containsOtherNumbers = false;
-		for (u64 cIndex = 0; cIndex < tempStr.length; cIndex++)
+		uxx numDigits = 0;
+		if (!ParseDecimalDigitsU64(str, &index, &magnitude, &numDigits))
 		{
-			if (tempStr.chars[cIndex] == '0') { containsZero = true; break; }
-			if (tempStr.chars[cIndex] >= '1' && tempStr.chars[cIndex] <= '9') { containsOtherNumbers = true; break; }
+			SetOptionalOutPntr(errorOut, Result_Overflow);
+			return false;
 		}
-		if (!containsZero || containsOtherNumbers)
+		if (index < str.length && !IsParseListSeparator(str.chars[index], delimiter))
 		{
-			SetOptionalOutPntr(errorOut, Result_FloatParseFailure);
+			SetOptionalOutPntr(errorOut, Result_InvalidCharacter);
+			return false;
+		}
+		if (numDigits == 0)
+		{
+			SetOptionalOutPntr(errorOut, Result_NoNumbers);
 			return false;
 		}
 	}
 	
-	SetOptionalOutPntr(valueOut, (r32)resultR64);
+	*indexInOut = index;
+	*magnitudeOut = magnitude;
+	*isNegativeOut = isNegative;
 	return true;
 }
-PEXPI bool TryParseR32(Str8 str, r32* valueOut, Result* errorOut)
+
+//Values can be separated by whitespace (including new-lines), the delimiter, or both. Pass '\0' for delimiter to only allow whitespace.
+//A single trailing delimiter is allowed. If valuesOut is nullptr then the values are only validated and counted.
+//numValuesOut is always filled, on failure it's the index of the value that failed to parse
+static bool TryParseNumberList(Str8 str, char delimiter, ParseListType type, uxx maxNumValues, void* valuesOut, uxx* numValuesOut, Result* errorOut)
 {
-	return TryParseR32Ex(str, valueOut, errorOut, true, false);
+	NotNullStr(str);
+	Assert(type > ParseListType_None && type < ParseListType_Count);
+	uxx numValues = 0;
+	uxx index = 0;
+	while (index < str.length && IsParseListSeparator(str.chars[index], '\0')) { index++; }
+	while (index < str.length)
+	{
+		if (valuesOut != nullptr && numValues >= maxNumValues)
+		{
+			SetOptionalOutPntr(numValuesOut, numValues);
+			SetOptionalOutPntr(errorOut, Result_TooMany);
+			return false;
+		}
+		
+		Result elementError = Result_None;
+		bool elementSuccess = true;
+		if (type == ParseListType_R64 || type == ParseListType_R32)
+		{
+			uxx elementEnd = index;
+			while (elementEnd < str.length && !IsParseListSeparator(str.chars[elementEnd], delimiter)) { elementEnd++; }
+			Str8 elementStr = StrSlice(str, index, elementEnd);
+			if (type == ParseListType_R64)
+			{
+				r64 value = 0.0;
+				elementSuccess = TryParseR64Fast(elementStr, &value, &elementError);
+				if (elementSuccess && IsInfiniteOrNanR64(value)) { elementSuccess = false; elementError = Result_InfinityOrNan; }
+				if (elementSuccess && valuesOut != nullptr) { ((r64*)valuesOut)[numValues] = value; }
+			}
+			else
+			{
+				if (elementStr.length > 1 && elementStr.chars[elementStr.length-1] == 'f' && (IsCharNumeric(elementStr.chars[elementStr.length-2]) || elementStr.chars[elementStr.length-2] == '.')) { elementStr.length--; }
+				r32 value = 0.0f;
+				elementSuccess = TryParseR32Fast(elementStr, &value, &elementError);
+				if (elementSuccess && IsInfiniteOrNanR32(value)) { elementSuccess = false; elementError = Result_InfinityOrNan; }
+				if (elementSuccess && valuesOut != nullptr) { ((r32*)valuesOut)[numValues] = value; }
+			}
+			index = elementEnd;
+		}
+		else
+		{
+			bool isSigned = (type == ParseListType_I64 || type == ParseListType_I32);
+			u64 magnitude = 0;
+			bool isNegative = false;
+			elementSuccess = TryParseListInteger(str, &index, delimiter, isSigned, &magnitude, &isNegative, &elementError);
+			if (elementSuccess)
+			{
+				switch (type)
+				{
+					case ParseListType_U64: if (valuesOut != nullptr) { ((u64*)valuesOut)[numValues] = magnitude; } break;
+					case ParseListType_U32:
+					{
+						if (magnitude > UINT32_MAX) { elementSuccess = false; elementError = Result_Overflow; }
+						else if (valuesOut != nullptr) { ((u32*)valuesOut)[numValues] = (u32)magnitude; }
+					} break;
+					case ParseListType_I64:
+					case ParseListType_I32:
+					{
+						u64 maxMagnitude = (type == ParseListType_I64) ? (u64)INT64_MAX : (u64)INT32_MAX;
+						if (!isNegative && magnitude > maxMagnitude) { elementSuccess = false; elementError = Result_Overflow; }
+						else if (isNegative && magnitude > maxMagnitude + 1) { elementSuccess = false; elementError = Result_Underflow; }
+						else if (valuesOut != nullptr)
+						{
+							i64 value = isNegative ? (i64)(0 - magnitude) : (i64)magnitude;
+							if (type == ParseListType_I64) { ((i64*)valuesOut)[numValues] = value; }
+							else { ((i32*)valuesOut)[numValues] = (i32)value; }
+						}
+					} break;
+					default: break;
+				}
+			}
+		}
+		if (!elementSuccess)
+		{
+			SetOptionalOutPntr(numValuesOut, numValues);
+			SetOptionalOutPntr(errorOut, elementError);
+			return false;
+		}
+		numValues++;
+		
+		while (index < str.length && IsParseListSeparator(str.chars[index], '\0')) { index++; }
+		if (delimiter != '\0' && index < str.length && str.chars[index] == delimiter)
+		{
+			index++;
+			while (index < str.length && IsParseListSeparator(str.chars[index], '\0')) { index++; }
+			if (index < str.length && str.chars[index] == delimiter)
+			{
+				//Two delimiters in a row means an empty value
+				SetOptionalOutPntr(numValuesOut, numValues);
+				SetOptionalOutPntr(errorOut, Result_NoNumbers);
+				return false;
+			}
+		}
+	}
+	
+	SetOptionalOutPntr(numValuesOut, numValues);
+	SetOptionalOutPntr(errorOut, Result_Success);
+	return true;
 }
 
+PEXP bool TryParseU64List(Str8 str, char delimiter, uxx maxNumValues, u64* valuesOut, uxx* numValuesOut, Result* errorOut) { return TryParseNumberList(str, delimiter, ParseListType_U64, maxNumValues, valuesOut, numValuesOut, errorOut); }
+PEXP bool TryParseU32List(Str8 str, char delimiter, uxx maxNumValues, u32* valuesOut, uxx* numValuesOut, Result* errorOut) { return TryParseNumberList(str, delimiter, ParseListType_U32, maxNumValues, valuesOut, numValuesOut, errorOut); }
+PEXP bool TryParseI64List(Str8 str, char delimiter, uxx maxNumValues, i64* valuesOut, uxx* numValuesOut, Result* errorOut) { return TryParseNumberList(str, delimiter, ParseListType_I64, maxNumValues, valuesOut, numValuesOut, errorOut); }
+PEXP bool TryParseI32List(Str8 str, char delimiter, uxx maxNumValues, i32* valuesOut, uxx* numValuesOut, Result* errorOut) { return TryParseNumberList(str, delimiter, ParseListType_I32, maxNumValues, valuesOut, numValuesOut, errorOut); }
+PEXP bool TryParseR64List(Str8 str, char delimiter, uxx maxNumValues, r64* valuesOut, uxx* numValuesOut, Result* errorOut) { return TryParseNumberList(str, delimiter, ParseListType_R64, maxNumValues, valuesOut, numValuesOut, errorOut); }
+PEXP bool TryParseR32List(Str8 str, char delimiter, uxx maxNumValues, r32* valuesOut, uxx* numValuesOut, Result* errorOut) { return TryParseNumberList(str, delimiter, ParseListType_R32, maxNumValues, valuesOut, numValuesOut, errorOut); }
+
 // +==============================+
 // |          Parse Bool          |
 // +==============================+
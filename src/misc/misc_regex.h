@@ -4,13 +4,28 @@ Author: Taylor Robbins
 Date:   02\02\2025
 Description:
 	** This file holds functions and types that help us parse Regular Expressions
-	** and search strings for matches to those regex patterns. Currently we rely on
-	** the Super Light Regexp Engine (SLRE) for the implementation, which means we
-	** only support a limited set of Perl Regex functionality. We may move to another
-	** implementation later or make our own, but generally we don't rely on regex
-	** terribly often, and when we do we usually only care about a subset of the
-	** widely accepted functionality so a simple implementation like SLRE is better
-	** than something like Google's RE2 (https://github.com/google/re2)
+	** and search strings for matches to those regex patterns. A pattern is compiled
+	** once (CompileRegex) into a Regex that lives in an Arena and can then be used to
+	** search any number of strings. The compiled form is a Thompson NFA program, which
+	** is run in three different ways when searching:
+	**   1. A forward DFA (built lazily, one state at a time, and cached in the Regex)
+	**      scans the haystack to find where the leftmost-first match ends
+	**   2. A reverse DFA runs backwards from that end to find where the match begins
+	**   3. A Pike VM (NFA simulation that tracks captures) runs over just the matched
+	**      span to fill out capture groups (skipped when the pattern has no captures)
+	** When every match must begin with some literal bytes (like "foo" in "foo\d+") the
+	** forward DFA skips over the haystack with StrExactFind (SIMD) whenever it's not
+	** in the middle of a possible match.
+	** The supported syntax is a subset of Perl: literals, . [abc] [^a-z] \d \w \s \D \W \S,
+	** escapes like \t \n \r \xHH \., groups ( ) and (?: ), alternation |, anchors ^ $
+	** (beginning\end of the haystack) and the quantifiers * + ? {n} {n,} {n,m} with a
+	** trailing ? for lazy versions. A (?i) at the start of the pattern makes it case insensitive.
+	** Matching is byte-based (UTF-8 multi-byte characters are treated as multiple bytes)
+	** and . does not match new-line characters. Like other automata based engines (RE2, Rust's regex)
+	** loops over something that can match nothing (like (a*)*) may report different captures than a backtracking engine would
+	** NOTE: The lazily built DFA states are added to the Regex as it is used, so a Regex
+	** should not be used by multiple threads at the same time. If a pattern needs more than
+	** REGEX_DFA_MAX_NUM_STATES states the Regex falls back to only using the Pike VM.
 */
 
 #ifndef _MISC_REGEX_H
@@ -19,37 +34,145 @@ Description:
 #include "base/base_defines_check.h"
 #include "base/base_typedefs.h"
 #include "base/base_macros.h"
+#include "base/base_assert.h"
+#include "base/base_char.h"
+#include "std/std_memset.h"
 #include "misc/misc_result.h"
 #include "mem/mem_arena.h"
 #include "mem/mem_scratch.h"
 #include "struct/struct_string.h"
-
-#if !USING_CUSTOM_STDLIB //slre uses some some stdlib functions that our custom stdlib implementation doesn't support yet
-
-#include "third_party/slre/slre.h"
+#include "struct/struct_var_array.h"
 
 //NOTE: When writing regex patterns with captures make sure you stay below this number (bump this number up as needed)
 #define MAX_NUM_REGEX_CAPTURES    8
 
-typedef plex slre_cap slre_cap;
+#define REGEX_MAX_NUM_INSTRUCTIONS   8192
+#define REGEX_MAX_REPEAT_COUNT       1000 //the biggest number allowed in {n,m} quantifiers
+#define REGEX_MAX_GROUP_DEPTH        64
+#define REGEX_MAX_PREFIX_LENGTH      32 //bytes
+#define REGEX_REPEAT_INFINITE        UINT32_MAX
+#define REGEX_DFA_MAX_NUM_STATES     512
+#define REGEX_DFA_TABLE_SIZE         1024 //must be a power of 2 and bigger than REGEX_DFA_MAX_NUM_STATES
+#define REGEX_DFA_DEAD_STATE         0
+#define REGEX_DFA_UNKNOWN_STATE      UINT32_MAX
+#define REGEX_DFA_FAILED_STATE       (UINT32_MAX-1)
+#define REGEX_SLOT_UNSET             UINTXX_MAX
+
+enum RegexOp
+{
+	RegexOp_None = 0,
+	RegexOp_Byte, //consumes one byte equal to inst.byte
+	RegexOp_Set, //consumes one byte contained in regex->sets[inst.setIndex]
+	RegexOp_Split, //continues at both next (preferred) and alt
+	RegexOp_Jump,
+	RegexOp_Save, //records the current position in capture slot inst.slot
+	RegexOp_AssertBegin, //only continues at the beginning of the haystack
+	RegexOp_AssertEnd, //only continues at the end of the haystack
+	RegexOp_Match,
+	RegexOp_Count,
+};
+typedef enum RegexOp RegexOp;
+
+typedef plex RegexInst RegexInst;
+plex RegexInst
+{
+	u8 op; //RegexOp
+	u8 byte;
+	u16 slot;
+	u32 setIndex;
+	u32 next;
+	u32 alt;
+};
+
+typedef plex RegexByteSet RegexByteSet;
+plex RegexByteSet { u32 bits[256/32]; };
+
+typedef plex RegexProgram RegexProgram;
+plex RegexProgram
+{
+	uxx numInsts;
+	RegexInst* insts;
+};
+
+typedef plex RegexDfaState RegexDfaState;
+plex RegexDfaState
+{
+	u32 numThreads;
+	bool isMatch; //a match ends at the position before the next byte is consumed
+	bool isMatchAtEnd; //a match ends here if there are no more bytes (things like $ are satisfied)
+	u32* threads; //instruction indices in priority order, the forward DFA uses numInsts to mean "start another match at the next byte"
+	u32* transitions; //indexed by byte class, REGEX_DFA_UNKNOWN_STATE until that transition is first taken
+};
+
+typedef plex RegexDfa RegexDfa;
+plex RegexDfa
+{
+	bool isReverse; //reverse DFAs are anchored and find the longest match, forward DFAs are unanchored and find the leftmost-first match
+	u32 startStates[2]; //indexed by whether we are at the beginning of the haystack (for the reverse DFA: the end of the haystack)
+	uxx numStates;
+	RegexDfaState* states; //REGEX_DFA_MAX_NUM_STATES
+	u32* stateTable; //REGEX_DFA_TABLE_SIZE, open addressing hash table of state indices
+	u32 visitGeneration;
+	u32* visitMarks; //numInsts+1
+	u32* stack; //2*(numInsts+1)
+	u32* workThreads; //numInsts+1
+	u32* endThreads; //numInsts+1
+};
+
+typedef plex Regex Regex;
+plex Regex
+{
+	Arena* arena;
+	Str8 pattern;
+	bool caseSensitive;
+	bool dfaFailed; //one of the DFAs ran out of states, all searches go through the Pike VM
+	uxx numCaptures; //not counting the whole match (slots 0 and 1)
+	uxx numSlots;
+	uxx numSets;
+	RegexByteSet* sets;
+	RegexProgram forward;
+	RegexProgram reverse; //the pattern reversed (and without captures), used to find where a match begins
+	uxx numByteClasses;
+	u8 byteClasses[256]; //bytes that no instruction can tell apart share a class, this keeps DFA transition tables small
+	u8 classBytes[256]; //one representative byte for each class
+	Str8 prefix; //every match begins with these bytes (compared case insensitively if !caseSensitive)
+	RegexDfa forwardDfa;
+	RegexDfa reverseDfa;
+};
 
 typedef plex RegexResult RegexResult;
 plex RegexResult
 {
 	Result result; //Typically Result_Success or Result_NoMatch, other error codes for invalid regex or input
 	Str8 haystack;
-	// uxx matchBeginIndex; //TODO: Can we somehow get the match beginning from SLRE?
+	uxx matchBeginIndex;
 	uxx matchEndIndex;
-	uxx numCaptures;
+	Str8 match; //slice of haystack
+	uxx numCaptures; //the number of capture groups in the pattern, captures that didn't participate in the match are empty with an index of REGEX_SLOT_UNSET
 	Str8 captures[MAX_NUM_REGEX_CAPTURES]; //these are all slices of haystack
 	uxx captureIndices[MAX_NUM_REGEX_CAPTURES];
 };
 
+//Finds all non-overlapping matches in haystack, see RegexFindNext
+typedef plex RegexFindIter RegexFindIter;
+plex RegexFindIter
+{
+	Regex* regex;
+	Str8 haystack;
+	uxx index;
+	bool finished;
+};
+
 // +--------------------------------------------------------------+
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
 #if !PIG_CORE_IMPLEMENTATION
-	Result GetResultForSlreErrorCode(int slreErrorCode);
+	void FreeRegex(Regex* regex);
+	Result CompileRegex(Arena* arena, Str8 pattern, bool caseSensitive, Regex* regexOut);
+	RegexResult RegexFind(Regex* regex, Str8 haystack, uxx startIndex);
+	bool RegexContains(Regex* regex, Str8 haystack);
+	PIG_CORE_INLINE RegexFindIter NewRegexFindIter(Regex* regex, Str8 haystack);
+	bool RegexFindNext(RegexFindIter* iter, RegexResult* resultOut);
 	RegexResult StrRegexFind(Str8 haystack, Str8 needleRegexPattern, bool caseSensitive);
 	PIG_CORE_INLINE RegexResult StrExactRegexFind(Str8 haystack, Str8 needleRegexPattern);
 	PIG_CORE_INLINE RegexResult StrAnyCaseRegexFind(Str8 haystack, Str8 needleRegexPattern);
@@ -63,66 +186,1189 @@ plex RegexResult
 // +--------------------------------------------------------------+
 #if PIG_CORE_IMPLEMENTATION
 
-#if DEBUG_BUILD && !TARGET_IS_PLAYDATE
-#define SLRE_DEBUG
-#endif
-#include "third_party/slre/slre.c"
+// +==============================+
+// |          Byte Sets           |
+// +==============================+
+static void RegexSetAddByte(RegexByteSet* set, u8 byte) { set->bits[byte >> 5] |= (1UL << (byte & 31)); }
+static bool RegexSetContains(const RegexByteSet* set, u8 byte) { return (((set->bits[byte >> 5] >> (byte & 31)) & 1) != 0); }
+static void RegexSetAddRange(RegexByteSet* set, u8 minByte, u8 maxByte)
+{
+	for (uxx bIndex = minByte; bIndex <= maxByte; bIndex++) { RegexSetAddByte(set, (u8)bIndex); }
+}
+static void RegexSetInvert(RegexByteSet* set)
+{
+	for (uxx wIndex = 0; wIndex < ArrayCount(set->bits); wIndex++) { set->bits[wIndex] = ~set->bits[wIndex]; }
+}
+static void RegexSetAddLetterCases(RegexByteSet* set)
+{
+	for (uxx bIndex = 'a'; bIndex <= 'z'; bIndex++)
+	{
+		u8 upperByte = (u8)ToUpperChar((char)bIndex);
+		if (RegexSetContains(set, (u8)bIndex) || RegexSetContains(set, upperByte)) { RegexSetAddByte(set, (u8)bIndex); RegexSetAddByte(set, upperByte); }
+	}
+}
 
-PEXP Result GetResultForSlreErrorCode(int slreErrorCode)
+// +==============================+
+// |            Parser            |
+// +==============================+
+enum RegexNodeType
 {
-	switch (slreErrorCode)
+	RegexNodeType_None = 0,
+	RegexNodeType_Empty,
+	RegexNodeType_Byte,
+	RegexNodeType_Set,
+	RegexNodeType_Concat,
+	RegexNodeType_Alternate,
+	RegexNodeType_Repeat,
+	RegexNodeType_Group,
+	RegexNodeType_AssertBegin,
+	RegexNodeType_AssertEnd,
+	RegexNodeType_Count,
+};
+typedef enum RegexNodeType RegexNodeType;
+
+typedef plex RegexNode RegexNode;
+plex RegexNode
+{
+	RegexNodeType type;
+	u8 byte;
+	bool greedy;
+	u32 setIndex;
+	uxx captureIndex;
+	u32 minRepeat;
+	u32 maxRepeat;
+	RegexNode* child; //Repeat and Group
+	uxx numChildren; //Concat and Alternate
+	RegexNode** children;
+	RegexNode* next; //only used while parsing a list of children
+};
+
+typedef plex RegexParser RegexParser;
+plex RegexParser
+{
+	Arena* arena;
+	Str8 pattern;
+	uxx index;
+	bool caseSensitive;
+	uxx numGroups;
+	VarArray sets; //RegexByteSet
+	Result error;
+};
+
+static RegexNode* NewRegexNode(RegexParser* parser, RegexNodeType type)
+{
+	RegexNode* result = AllocType(RegexNode, parser->arena);
+	NotNull(result);
+	ClearPointer(result);
+	result->type = type;
+	return result;
+}
+static RegexNode* NewRegexSetNode(RegexParser* parser, const RegexByteSet* set)
+{
+	RegexNode* result = NewRegexNode(parser, RegexNodeType_Set);
+	result->setIndex = (u32)parser->sets.length;
+	VarArrayAddValue(RegexByteSet, &parser->sets, *set);
+	return result;
+}
+
+//Handles the \d \w \s (and the inverted uppercase versions) escapes, returns false if escapeChar isn't one of those
+static bool RegexGetEscapeSet(char escapeChar, RegexByteSet* setOut)
+{
+	ClearPointer(setOut);
+	switch (ToLowerChar(escapeChar))
 	{
-		case SLRE_NO_MATCH:              return Result_NoMatch;
-		case SLRE_UNEXPECTED_QUANTIFIER: return Result_UnexpectedQuantifier;
-		case SLRE_UNBALANCED_BRACKETS:   return Result_UnbalancedBrackets;
-		case SLRE_INTERNAL_ERROR:        return Result_Failure;
-		case SLRE_INVALID_CHARACTER_SET: return Result_InvalidCharacter;
-		case SLRE_INVALID_METACHARACTER: return Result_InvalidCharacter;
-		case SLRE_CAPS_ARRAY_TOO_SMALL:  return Result_NotEnoughSpace;
-		case SLRE_TOO_MANY_BRANCHES:     return Result_TooManyBranches;
-		case SLRE_TOO_MANY_BRACKETS:     return Result_TooManyBrackets;
-		default: return Result_Failure;
+		case 'd': RegexSetAddRange(setOut, '0', '9'); break;
+		case 'w': RegexSetAddRange(setOut, 'a', 'z'); RegexSetAddRange(setOut, 'A', 'Z'); RegexSetAddRange(setOut, '0', '9'); RegexSetAddByte(setOut, '_'); break;
+		case 's': RegexSetAddByte(setOut, ' '); RegexSetAddRange(setOut, '\t', '\r'); break; //\t \n \v \f \r
+		default: return false;
 	}
+	if (IsCharUppercaseAlphabet(CharToU32(escapeChar))) { RegexSetInvert(setOut); }
+	return true;
 }
 
-PEXP RegexResult StrRegexFind(Str8 haystack, Str8 needleRegexPattern, bool caseSensitive)
+//Handles escapes that stand for a single byte like \n \x41 or \. (parser->index starts right after the backslash)
+static bool RegexParseEscapeByte(RegexParser* parser, u8* byteOut)
+{
+	if (parser->index >= parser->pattern.length) { parser->error = Result_InvalidCharacter; return false; }
+	char escapeChar = parser->pattern.chars[parser->index];
+	parser->index++;
+	switch (escapeChar)
+	{
+		case 't': *byteOut = '\t'; return true;
+		case 'n': *byteOut = '\n'; return true;
+		case 'r': *byteOut = '\r'; return true;
+		case 'f': *byteOut = '\f'; return true;
+		case 'v': *byteOut = '\v'; return true;
+		case '0': *byteOut = '\0'; return true;
+		case 'x':
+		{
+			if (parser->index + 2 > parser->pattern.length || !AreCharsHexidecimal(2, &parser->pattern.chars[parser->index])) { parser->error = Result_InvalidCharacter; return false; }
+			*byteOut = (u8)((GetHexCharValue(parser->pattern.chars[parser->index]) << 4) | GetHexCharValue(parser->pattern.chars[parser->index+1]));
+			parser->index += 2;
+			return true;
+		}
+		default:
+		{
+			//Letters and numbers are reserved for escapes we might support later, all other characters just escape themselves
+			if (IsCharAlphaNumeric(CharToU32(escapeChar))) { parser->error = Result_InvalidCharacter; return false; }
+			*byteOut = (u8)escapeChar;
+			return true;
+		}
+	}
+}
+
+//parser->index starts right after the opening [
+static RegexNode* RegexParseSet(RegexParser* parser)
+{
+	Str8 pattern = parser->pattern;
+	RegexByteSet set = ZEROED;
+	bool inverted = false;
+	if (parser->index < pattern.length && pattern.chars[parser->index] == '^') { inverted = true; parser->index++; }
+	bool isFirst = true;
+	while (true)
+	{
+		if (parser->index >= pattern.length) { parser->error = Result_UnbalancedBrackets; return nullptr; }
+		char nextChar = pattern.chars[parser->index];
+		if (nextChar == ']' && !isFirst) { parser->index++; break; } //a ] right after the [ or [^ is treated as a literal
+		isFirst = false;
+		
+		u8 lowByte = 0;
+		if (nextChar == '\\')
+		{
+			parser->index++;
+			RegexByteSet escapeSet;
+			if (parser->index < pattern.length && RegexGetEscapeSet(pattern.chars[parser->index], &escapeSet))
+			{
+				parser->index++;
+				for (uxx wIndex = 0; wIndex < ArrayCount(set.bits); wIndex++) { set.bits[wIndex] |= escapeSet.bits[wIndex]; }
+				continue;
+			}
+			if (!RegexParseEscapeByte(parser, &lowByte)) { return nullptr; }
+		}
+		else { lowByte = (u8)nextChar; parser->index++; }
+		
+		if (parser->index+1 < pattern.length && pattern.chars[parser->index] == '-' && pattern.chars[parser->index+1] != ']')
+		{
+			parser->index++;
+			u8 highByte = 0;
+			if (pattern.chars[parser->index] == '\\')
+			{
+				parser->index++;
+				RegexByteSet escapeSet;
+				if (parser->index < pattern.length && RegexGetEscapeSet(pattern.chars[parser->index], &escapeSet)) { parser->error = Result_InvalidCharacter; return nullptr; }
+				if (!RegexParseEscapeByte(parser, &highByte)) { return nullptr; }
+			}
+			else { highByte = (u8)pattern.chars[parser->index]; parser->index++; }
+			if (highByte < lowByte) { parser->error = Result_InvalidCharacter; return nullptr; }
+			RegexSetAddRange(&set, lowByte, highByte);
+		}
+		else { RegexSetAddByte(&set, lowByte); }
+	}
+	
+	if (!parser->caseSensitive) { RegexSetAddLetterCases(&set); }
+	if (inverted) { RegexSetInvert(&set); }
+	return NewRegexSetNode(parser, &set);
+}
+
+//Parses {n} {n,} or {n,m} at *indexInOut, returns false (and leaves *indexInOut alone) if it's not a valid quantifier
+static bool RegexTryParseRepeatCount(Str8 pattern, uxx* indexInOut, u32* minOut, u32* maxOut)
+{
+	uxx index = *indexInOut;
+	if (index >= pattern.length || pattern.chars[index] != '{') { return false; }
+	index++;
+	u32 numbers[2] = { 0, 0 };
+	bool hasComma = false;
+	bool hasDigits[2] = { false, false };
+	while (index < pattern.length && pattern.chars[index] != '}')
+	{
+		char nextChar = pattern.chars[index];
+		uxx numIndex = hasComma ? 1 : 0;
+		if (IsCharNumeric(CharToU32(nextChar)))
+		{
+			if (numbers[numIndex] <= REGEX_MAX_REPEAT_COUNT) { numbers[numIndex] = numbers[numIndex]*10 + GetNumericCharValue(nextChar); }
+			hasDigits[numIndex] = true;
+		}
+		else if (nextChar == ',' && !hasComma) { hasComma = true; }
+		else { return false; }
+		index++;
+	}
+	if (index >= pattern.length || !hasDigits[0]) { return false; }
+	*minOut = numbers[0];
+	*maxOut = hasComma ? (hasDigits[1] ? numbers[1] : REGEX_REPEAT_INFINITE) : numbers[0];
+	*indexInOut = index+1;
+	return true;
+}
+
+static RegexNode* RegexParseAlternation(RegexParser* parser, uxx depth);
+
+static RegexNode* RegexParseAtom(RegexParser* parser, uxx depth)
+{
+	Str8 pattern = parser->pattern;
+	char nextChar = pattern.chars[parser->index];
+	switch (nextChar)
+	{
+		case '(':
+		{
+			parser->index++;
+			if (depth >= REGEX_MAX_GROUP_DEPTH) { parser->error = Result_TooManyBrackets; return nullptr; }
+			bool isCapture = true;
+			if (StrExactStartsWith(StrSliceFrom(pattern, parser->index), StrLit("?:"))) { isCapture = false; parser->index += 2; }
+			else if (parser->index < pattern.length && pattern.chars[parser->index] == '?') { parser->error = Result_InvalidCharacter; return nullptr; }
+			uxx captureIndex = 0;
+			if (isCapture) { parser->numGroups++; captureIndex = parser->numGroups; }
+			RegexNode* inner = RegexParseAlternation(parser, depth+1);
+			if (inner == nullptr) { return nullptr; }
+			if (parser->index >= pattern.length || pattern.chars[parser->index] != ')') { parser->error = Result_UnbalancedBrackets; return nullptr; }
+			parser->index++;
+			if (!isCapture) { return inner; }
+			RegexNode* result = NewRegexNode(parser, RegexNodeType_Group);
+			result->captureIndex = captureIndex;
+			result->child = inner;
+			return result;
+		}
+		case '[': parser->index++; return RegexParseSet(parser);
+		case '.':
+		{
+			parser->index++;
+			RegexByteSet set = ZEROED;
+			RegexSetAddByte(&set, '\n');
+			RegexSetInvert(&set);
+			return NewRegexSetNode(parser, &set);
+		}
+		case '^': parser->index++; return NewRegexNode(parser, RegexNodeType_AssertBegin);
+		case '$': parser->index++; return NewRegexNode(parser, RegexNodeType_AssertEnd);
+		case '\\':
+		{
+			parser->index++;
+			RegexByteSet escapeSet;
+			if (parser->index < pattern.length && RegexGetEscapeSet(pattern.chars[parser->index], &escapeSet))
+			{
+				parser->index++;
+				return NewRegexSetNode(parser, &escapeSet);
+			}
+			u8 escapedByte = 0;
+			if (!RegexParseEscapeByte(parser, &escapedByte)) { return nullptr; }
+			RegexNode* result = NewRegexNode(parser, RegexNodeType_Byte);
+			result->byte = escapedByte;
+			return result;
+		}
+		case '*': case '+': case '?': parser->error = Result_UnexpectedQuantifier; return nullptr;
+		default:
+		{
+			u32 minRepeat, maxRepeat;
+			uxx tempIndex = parser->index;
+			if (RegexTryParseRepeatCount(pattern, &tempIndex, &minRepeat, &maxRepeat)) { parser->error = Result_UnexpectedQuantifier; return nullptr; }
+			parser->index++;
+			RegexNode* result = NewRegexNode(parser, RegexNodeType_Byte);
+			result->byte = (u8)nextChar; //NOTE: A { that isn't part of a valid quantifier is treated as a literal
+			return result;
+		}
+	}
+}
+
+static RegexNode* RegexParseRepeat(RegexParser* parser, uxx depth)
+{
+	RegexNode* result = RegexParseAtom(parser, depth);
+	if (result == nullptr) { return nullptr; }
+	Str8 pattern = parser->pattern;
+	bool hadQuantifier = false;
+	while (parser->index < pattern.length)
+	{
+		char nextChar = pattern.chars[parser->index];
+		u32 minRepeat = 0, maxRepeat = 0;
+		uxx afterIndex = parser->index + 1;
+		if (nextChar == '*') { minRepeat = 0; maxRepeat = REGEX_REPEAT_INFINITE; }
+		else if (nextChar == '+') { minRepeat = 1; maxRepeat = REGEX_REPEAT_INFINITE; }
+		else if (nextChar == '?') { minRepeat = 0; maxRepeat = 1; }
+		else if (nextChar == '{') { afterIndex = parser->index; if (!RegexTryParseRepeatCount(pattern, &afterIndex, &minRepeat, &maxRepeat)) { break; } }
+		else { break; }
+		
+		if (hadQuantifier) { parser->error = Result_UnexpectedQuantifier; return nullptr; }
+		if ((maxRepeat != REGEX_REPEAT_INFINITE && maxRepeat > REGEX_MAX_REPEAT_COUNT) || minRepeat > REGEX_MAX_REPEAT_COUNT) { parser->error = Result_TooMany; return nullptr; }
+		if (minRepeat > maxRepeat) { parser->error = Result_UnexpectedQuantifier; return nullptr; }
+		parser->index = afterIndex;
+		bool greedy = true;
+		if (parser->index < pattern.length && pattern.chars[parser->index] == '?') { greedy = false; parser->index++; }
+		
+		RegexNode* repeatNode = NewRegexNode(parser, RegexNodeType_Repeat);
+		repeatNode->child = result;
+		repeatNode->minRepeat = minRepeat;
+		repeatNode->maxRepeat = maxRepeat;
+		repeatNode->greedy = greedy;
+		result = repeatNode;
+		hadQuantifier = true;
+	}
+	return result;
+}
+
+//Turns a linked list of nodes (through node->next) into a Concat or Alternate node (or just returns the node if there is only one)
+static RegexNode* RegexMakeListNode(RegexParser* parser, RegexNodeType type, RegexNode* firstNode, uxx numNodes)
 {
-	Assert(haystack.length <= INT_MAX);
+	if (numNodes == 0) { return NewRegexNode(parser, RegexNodeType_Empty); }
+	if (numNodes == 1) { return firstNode; }
+	RegexNode* result = NewRegexNode(parser, type);
+	result->numChildren = numNodes;
+	result->children = AllocArray(RegexNode*, parser->arena, numNodes);
+	NotNull(result->children);
+	RegexNode* node = firstNode;
+	for (uxx cIndex = 0; cIndex < numNodes; cIndex++) { result->children[cIndex] = node; node = node->next; }
+	return result;
+}
+
+static RegexNode* RegexParseConcat(RegexParser* parser, uxx depth)
+{
+	Str8 pattern = parser->pattern;
+	RegexNode* firstNode = nullptr;
+	RegexNode* lastNode = nullptr;
+	uxx numNodes = 0;
+	while (parser->index < pattern.length && pattern.chars[parser->index] != '|' && pattern.chars[parser->index] != ')')
+	{
+		RegexNode* node = RegexParseRepeat(parser, depth);
+		if (node == nullptr) { return nullptr; }
+		if (lastNode != nullptr) { lastNode->next = node; } else { firstNode = node; }
+		lastNode = node;
+		numNodes++;
+	}
+	return RegexMakeListNode(parser, RegexNodeType_Concat, firstNode, numNodes);
+}
+
+static RegexNode* RegexParseAlternation(RegexParser* parser, uxx depth)
+{
+	RegexNode* firstNode = RegexParseConcat(parser, depth);
+	if (firstNode == nullptr) { return nullptr; }
+	RegexNode* lastNode = firstNode;
+	uxx numNodes = 1;
+	while (parser->index < parser->pattern.length && parser->pattern.chars[parser->index] == '|')
+	{
+		parser->index++;
+		RegexNode* node = RegexParseConcat(parser, depth);
+		if (node == nullptr) { return nullptr; }
+		lastNode->next = node;
+		lastNode = node;
+		numNodes++;
+	}
+	return RegexMakeListNode(parser, RegexNodeType_Alternate, firstNode, numNodes);
+}
+
+//Appends the literal bytes that every match of node must begin with, returns true if the whole node was
+//literal (so the caller can keep appending whatever comes after it)
+static bool RegexGetLiteralPrefix(const RegexNode* node, u8* prefixBuffer, uxx* prefixLengthInOut)
+{
+	switch (node->type)
+	{
+		case RegexNodeType_Empty:
+		case RegexNodeType_AssertBegin:
+		case RegexNodeType_AssertEnd:
+			return true;
+		case RegexNodeType_Byte:
+		{
+			if (*prefixLengthInOut >= REGEX_MAX_PREFIX_LENGTH) { return false; }
+			prefixBuffer[*prefixLengthInOut] = node->byte;
+			*prefixLengthInOut += 1;
+			return true;
+		}
+		case RegexNodeType_Group: return RegexGetLiteralPrefix(node->child, prefixBuffer, prefixLengthInOut);
+		case RegexNodeType_Concat:
+		{
+			for (uxx cIndex = 0; cIndex < node->numChildren; cIndex++)
+			{
+				if (!RegexGetLiteralPrefix(node->children[cIndex], prefixBuffer, prefixLengthInOut)) { return false; }
+			}
+			return true;
+		}
+		case RegexNodeType_Repeat:
+		{
+			if (node->minRepeat == 0) { return false; }
+			bool childIsLiteral = RegexGetLiteralPrefix(node->child, prefixBuffer, prefixLengthInOut);
+			return (childIsLiteral && node->maxRepeat == 1);
+		}
+		default: return false;
+	}
+}
+
+// +==============================+
+// |           Compiler           |
+// +==============================+
+typedef plex RegexCompiler RegexCompiler;
+plex RegexCompiler
+{
+	Arena* arena;
+	VarArray* sets; //RegexByteSet
+	VarArray insts; //RegexInst
+	bool caseSensitive;
+	bool reverse;
+	bool tooManyInsts;
+};
+
+static u32 RegexEmit(RegexCompiler* compiler, RegexOp op)
+{
+	u32 result = (u32)compiler->insts.length;
+	RegexInst* inst = VarArrayAdd(RegexInst, &compiler->insts);
+	NotNull(inst);
+	ClearPointer(inst);
+	inst->op = (u8)op;
+	inst->next = result+1;
+	if (compiler->insts.length > REGEX_MAX_NUM_INSTRUCTIONS) { compiler->tooManyInsts = true; }
+	return result;
+}
+static RegexInst* RegexGetInst(RegexCompiler* compiler, u32 instIndex)
+{
+	return VarArrayGet(RegexInst, &compiler->insts, instIndex);
+}
+//Greedy splits prefer continuing into the repeated child, lazy ones prefer skipping past it
+static void RegexPatchRepeatSplit(RegexCompiler* compiler, u32 splitIndex, u32 childIndex, u32 skipIndex, bool greedy)
+{
+	RegexInst* split = RegexGetInst(compiler, splitIndex);
+	split->next = greedy ? childIndex : skipIndex;
+	split->alt = greedy ? skipIndex : childIndex;
+}
+
+//NOTE: Instructions are only ever referred to by index while compiling since emitting can move the VarArray's memory
+static void RegexCompileNode(RegexCompiler* compiler, const RegexNode* node)
+{
+	if (compiler->tooManyInsts) { return; }
+	switch (node->type)
+	{
+		case RegexNodeType_Empty: break;
+		case RegexNodeType_Byte:
+		{
+			if (!compiler->caseSensitive && IsCharAlphabetic(CharToU32((char)node->byte)))
+			{
+				RegexByteSet set = ZEROED;
+				RegexSetAddByte(&set, (u8)ToLowerChar((char)node->byte));
+				RegexSetAddByte(&set, (u8)ToUpperChar((char)node->byte));
+				u32 setIndex = (u32)compiler->sets->length;
+				VarArrayAddValue(RegexByteSet, compiler->sets, set);
+				RegexGetInst(compiler, RegexEmit(compiler, RegexOp_Set))->setIndex = setIndex;
+			}
+			else { RegexGetInst(compiler, RegexEmit(compiler, RegexOp_Byte))->byte = node->byte; }
+		} break;
+		case RegexNodeType_Set: RegexGetInst(compiler, RegexEmit(compiler, RegexOp_Set))->setIndex = node->setIndex; break;
+		case RegexNodeType_AssertBegin: RegexEmit(compiler, compiler->reverse ? RegexOp_AssertEnd : RegexOp_AssertBegin); break;
+		case RegexNodeType_AssertEnd: RegexEmit(compiler, compiler->reverse ? RegexOp_AssertBegin : RegexOp_AssertEnd); break;
+		case RegexNodeType_Group:
+		{
+			if (!compiler->reverse) { RegexGetInst(compiler, RegexEmit(compiler, RegexOp_Save))->slot = (u16)(node->captureIndex*2 + 0); }
+			RegexCompileNode(compiler, node->child);
+			if (!compiler->reverse) { RegexGetInst(compiler, RegexEmit(compiler, RegexOp_Save))->slot = (u16)(node->captureIndex*2 + 1); }
+		} break;
+		case RegexNodeType_Concat:
+		{
+			for (uxx cIndex = 0; cIndex < node->numChildren; cIndex++)
+			{
+				RegexCompileNode(compiler, node->children[compiler->reverse ? (node->numChildren-1 - cIndex) : cIndex]);
+			}
+		} break;
+		case RegexNodeType_Alternate:
+		{
+			// split L1, L2; L1: child[0]; jump end; L2: split L3, L4; L3: child[1]; jump end; ... Ln: child[n-1]; end:
+			u32* jumpIndices = AllocArray(u32, compiler->arena, node->numChildren);
+			NotNull(jumpIndices);
+			for (uxx cIndex = 0; cIndex+1 < node->numChildren; cIndex++)
+			{
+				u32 splitIndex = RegexEmit(compiler, RegexOp_Split);
+				RegexCompileNode(compiler, node->children[cIndex]);
+				jumpIndices[cIndex] = RegexEmit(compiler, RegexOp_Jump);
+				RegexGetInst(compiler, splitIndex)->alt = (u32)compiler->insts.length;
+				if (compiler->tooManyInsts) { return; }
+			}
+			RegexCompileNode(compiler, node->children[node->numChildren-1]);
+			for (uxx cIndex = 0; cIndex+1 < node->numChildren; cIndex++) { RegexGetInst(compiler, jumpIndices[cIndex])->next = (u32)compiler->insts.length; }
+		} break;
+		case RegexNodeType_Repeat:
+		{
+			bool isInfinite = (node->maxRepeat == REGEX_REPEAT_INFINITE);
+			//x{n,} is compiled as n-1 copies of x followed by x+
+			u32 numRequired = (isInfinite && node->minRepeat > 0) ? node->minRepeat-1 : node->minRepeat;
+			for (u32 rIndex = 0; rIndex < numRequired; rIndex++)
+			{
+				RegexCompileNode(compiler, node->child);
+				if (compiler->tooManyInsts) { return; }
+			}
+			if (isInfinite && node->minRepeat > 0)
+			{
+				// L1: x; split L1, L2; L2:
+				u32 loopIndex = (u32)compiler->insts.length;
+				RegexCompileNode(compiler, node->child);
+				u32 splitIndex = RegexEmit(compiler, RegexOp_Split);
+				RegexPatchRepeatSplit(compiler, splitIndex, loopIndex, splitIndex+1, node->greedy);
+			}
+			else if (isInfinite)
+			{
+				// L1: split L2, L3; L2: x; jump L1; L3:
+				u32 splitIndex = RegexEmit(compiler, RegexOp_Split);
+				RegexCompileNode(compiler, node->child);
+				RegexGetInst(compiler, RegexEmit(compiler, RegexOp_Jump))->next = splitIndex;
+				RegexPatchRepeatSplit(compiler, splitIndex, splitIndex+1, (u32)compiler->insts.length, node->greedy);
+			}
+			else
+			{
+				//x{0,3} is compiled as (x(x(x)?)?)? where every split skips to the same end
+				u32 numOptional = node->maxRepeat - node->minRepeat;
+				u32* splitIndices = AllocArray(u32, compiler->arena, numOptional);
+				if (numOptional > 0) { NotNull(splitIndices); }
+				for (u32 rIndex = 0; rIndex < numOptional; rIndex++)
+				{
+					splitIndices[rIndex] = RegexEmit(compiler, RegexOp_Split);
+					RegexCompileNode(compiler, node->child);
+					if (compiler->tooManyInsts) { return; }
+				}
+				u32 endIndex = (u32)compiler->insts.length;
+				for (u32 rIndex = 0; rIndex < numOptional; rIndex++) { RegexPatchRepeatSplit(compiler, splitIndices[rIndex], splitIndices[rIndex]+1, endIndex, node->greedy); }
+			}
+		} break;
+		default: Assert(false); break;
+	}
+}
+
+static bool RegexInstMatchesByte(const Regex* regex, const RegexInst* inst, u8 byte)
+{
+	if (inst->op == RegexOp_Byte) { return (inst->byte == byte); }
+	if (inst->op == RegexOp_Set) { return RegexSetContains(&regex->sets[inst->setIndex], byte); }
+	return false;
+}
+
+// +==============================+
+// |           Lazy DFA           |
+// +==============================+
+static void RegexDfaNextVisitGeneration(RegexDfa* dfa, uxx numInsts)
+{
+	dfa->visitGeneration++;
+	if (dfa->visitGeneration == 0) { MyMemSet(dfa->visitMarks, 0x00, sizeof(u32) * (numInsts+1)); dfa->visitGeneration = 1; }
+}
+
+//Follows all the non-consuming instructions reachable from startPc (in priority order) and appends the instructions
+//that are left waiting on the next byte (plus any Match, and AssertEnd when !atEnd) to threadsOut.
+//Returns true if a Match was reached. When stopAtMatch is true nothing is added after the Match since lower priority threads can't win
+static bool RegexDfaAddClosure(RegexDfa* dfa, const RegexProgram* program, u32 startPc, bool atBegin, bool atEnd, bool stopAtMatch, u32* threadsOut, u32* numThreadsInOut)
+{
+	bool sawMatch = false;
+	uxx stackSize = 0;
+	dfa->stack[stackSize++] = startPc;
+	while (stackSize > 0)
+	{
+		u32 pc = dfa->stack[--stackSize];
+		if (dfa->visitMarks[pc] == dfa->visitGeneration) { continue; }
+		dfa->visitMarks[pc] = dfa->visitGeneration;
+		const RegexInst* inst = &program->insts[pc];
+		switch (inst->op)
+		{
+			case RegexOp_Byte:
+			case RegexOp_Set: threadsOut[(*numThreadsInOut)++] = pc; break;
+			case RegexOp_Match:
+			{
+				threadsOut[(*numThreadsInOut)++] = pc;
+				sawMatch = true;
+				if (stopAtMatch) { return true; }
+			} break;
+			case RegexOp_Split: dfa->stack[stackSize++] = inst->alt; dfa->stack[stackSize++] = inst->next; break;
+			case RegexOp_Jump:
+			case RegexOp_Save: dfa->stack[stackSize++] = inst->next; break;
+			case RegexOp_AssertBegin: if (atBegin) { dfa->stack[stackSize++] = inst->next; } break;
+			case RegexOp_AssertEnd:
+			{
+				if (atEnd) { dfa->stack[stackSize++] = inst->next; }
+				else { threadsOut[(*numThreadsInOut)++] = pc; }
+			} break;
+			default: Assert(false); break;
+		}
+	}
+	return sawMatch;
+}
+
+//Returns the index of the state with this exact list of threads, adding it if it doesn't exist yet.
+//Returns REGEX_DFA_FAILED_STATE if we are out of states (or memory)
+static u32 RegexDfaAddState(Regex* regex, RegexDfa* dfa, const RegexProgram* program, const u32* threads, u32 numThreads)
+{
+	u32 hash = 2166136261UL ^ numThreads;
+	for (u32 tIndex = 0; tIndex < numThreads; tIndex++) { hash = (hash ^ threads[tIndex]) * 16777619UL; }
+	uxx tableIndex = (uxx)(hash & (REGEX_DFA_TABLE_SIZE-1));
+	while (dfa->stateTable[tableIndex] != REGEX_DFA_UNKNOWN_STATE)
+	{
+		RegexDfaState* existingState = &dfa->states[dfa->stateTable[tableIndex]];
+		if (existingState->numThreads == numThreads && (numThreads == 0 || MyMemEquals(existingState->threads, threads, sizeof(u32) * numThreads)))
+		{
+			return dfa->stateTable[tableIndex];
+		}
+		tableIndex = (tableIndex + 1) & (REGEX_DFA_TABLE_SIZE-1);
+	}
+	if (dfa->numStates >= REGEX_DFA_MAX_NUM_STATES) { return REGEX_DFA_FAILED_STATE; }
+	
+	u32 result = (u32)dfa->numStates;
+	RegexDfaState* newState = &dfa->states[result];
+	ClearPointer(newState);
+	newState->numThreads = numThreads;
+	newState->transitions = AllocArray(u32, regex->arena, regex->numByteClasses);
+	if (newState->transitions == nullptr) { return REGEX_DFA_FAILED_STATE; }
+	MyMemSet(newState->transitions, 0xFF, sizeof(u32) * regex->numByteClasses); //REGEX_DFA_UNKNOWN_STATE
+	if (numThreads > 0)
+	{
+		newState->threads = AllocArray(u32, regex->arena, numThreads);
+		if (newState->threads == nullptr) { return REGEX_DFA_FAILED_STATE; }
+		MyMemCopy(newState->threads, threads, sizeof(u32) * numThreads);
+	}
+	
+	for (u32 tIndex = 0; tIndex < numThreads; tIndex++)
+	{
+		if (threads[tIndex] >= program->numInsts) { continue; } //the restart thread
+		const RegexInst* inst = &program->insts[threads[tIndex]];
+		if (inst->op == RegexOp_Match) { newState->isMatch = true; newState->isMatchAtEnd = true; }
+		else if (inst->op == RegexOp_AssertEnd && !newState->isMatchAtEnd)
+		{
+			RegexDfaNextVisitGeneration(dfa, program->numInsts);
+			u32 numEndThreads = 0;
+			newState->isMatchAtEnd = RegexDfaAddClosure(dfa, program, inst->next, false, true, true, dfa->endThreads, &numEndThreads);
+		}
+	}
+	
+	dfa->numStates++;
+	dfa->stateTable[tableIndex] = result;
+	return result;
+}
+
+static u32 RegexDfaGetStartState(Regex* regex, RegexDfa* dfa, bool atBegin)
+{
+	u32* startStatePntr = &dfa->startStates[atBegin ? 1 : 0];
+	if (*startStatePntr != REGEX_DFA_UNKNOWN_STATE) { return *startStatePntr; }
+	const RegexProgram* program = dfa->isReverse ? &regex->reverse : &regex->forward;
+	RegexDfaNextVisitGeneration(dfa, program->numInsts);
+	u32 numThreads = 0;
+	bool sawMatch = RegexDfaAddClosure(dfa, program, 0, atBegin, false, !dfa->isReverse, dfa->workThreads, &numThreads);
+	if (!dfa->isReverse && !sawMatch) { dfa->workThreads[numThreads++] = (u32)program->numInsts; }
+	u32 result = RegexDfaAddState(regex, dfa, program, dfa->workThreads, numThreads);
+	if (result != REGEX_DFA_FAILED_STATE) { *startStatePntr = result; }
+	return result;
+}
+
+static u32 RegexDfaComputeTransition(Regex* regex, RegexDfa* dfa, u32 stateIndex, u8 byteClass)
+{
+	const RegexProgram* program = dfa->isReverse ? &regex->reverse : &regex->forward;
+	RegexDfaState* state = &dfa->states[stateIndex];
+	u8 byte = regex->classBytes[byteClass];
+	RegexDfaNextVisitGeneration(dfa, program->numInsts);
+	u32 numThreads = 0;
+	bool sawMatch = false;
+	for (u32 tIndex = 0; tIndex < state->numThreads && !sawMatch; tIndex++)
+	{
+		u32 pc = state->threads[tIndex];
+		if (pc == program->numInsts)
+		{
+			//The restart thread (only in forward DFAs) begins a new match attempt after every byte, at the lowest priority
+			sawMatch = RegexDfaAddClosure(dfa, program, 0, false, false, true, dfa->workThreads, &numThreads);
+			if (!sawMatch) { dfa->workThreads[numThreads++] = pc; }
+		}
+		else if (RegexInstMatchesByte(regex, &program->insts[pc], byte))
+		{
+			sawMatch = RegexDfaAddClosure(dfa, program, program->insts[pc].next, false, false, !dfa->isReverse, dfa->workThreads, &numThreads);
+			if (dfa->isReverse) { sawMatch = false; }
+		}
+	}
+	u32 result = RegexDfaAddState(regex, dfa, program, dfa->workThreads, numThreads);
+	if (result != REGEX_DFA_FAILED_STATE) { state->transitions[byteClass] = result; }
+	return result;
+}
+
+//Finds where the leftmost-first match (starting at or after startIndex) ends. Sets *failedOut if the DFA ran out of states
+static bool RegexDfaSearchForward(Regex* regex, Str8 haystack, uxx startIndex, uxx* endIndexOut, bool* failedOut)
+{
+	RegexDfa* dfa = &regex->forwardDfa;
+	u32 stateIndex = RegexDfaGetStartState(regex, dfa, (startIndex == 0));
+	if (stateIndex == REGEX_DFA_FAILED_STATE) { *failedOut = true; return false; }
+	u32 skipStateIndex = RegexDfaGetStartState(regex, dfa, false);
+	if (skipStateIndex == REGEX_DFA_FAILED_STATE) { *failedOut = true; return false; }
+	if (regex->prefix.length == 0) { skipStateIndex = REGEX_DFA_UNKNOWN_STATE; }
+	
+	bool foundMatch = false;
+	uxx bIndex = startIndex;
+	while (true)
+	{
+		if (stateIndex == skipStateIndex)
+		{
+			//No match is in progress, so the next one can't start until the next occurrence of the prefix
+			Str8 remaining = StrSliceFrom(haystack, bIndex);
+			uxx prefixIndex = regex->caseSensitive ? StrExactFind(remaining, regex->prefix) : StrAnyCaseFind(remaining, regex->prefix);
+			if (prefixIndex >= remaining.length) { break; }
+			bIndex += prefixIndex;
+		}
+		const RegexDfaState* state = &dfa->states[stateIndex];
+		if (state->isMatch) { foundMatch = true; *endIndexOut = bIndex; }
+		if (stateIndex == REGEX_DFA_DEAD_STATE) { break; }
+		if (bIndex >= haystack.length)
+		{
+			if (state->isMatchAtEnd) { foundMatch = true; *endIndexOut = haystack.length; }
+			break;
+		}
+		u8 byteClass = regex->byteClasses[haystack.bytes[bIndex]];
+		u32 nextStateIndex = state->transitions[byteClass];
+		if (nextStateIndex == REGEX_DFA_UNKNOWN_STATE)
+		{
+			nextStateIndex = RegexDfaComputeTransition(regex, dfa, stateIndex, byteClass);
+			if (nextStateIndex == REGEX_DFA_FAILED_STATE) { *failedOut = true; return false; }
+		}
+		stateIndex = nextStateIndex;
+		bIndex++;
+	}
+	return foundMatch;
+}
+
+//Given the end of a match, finds the smallest beginning index (no lower than minIndex) for a match that ends there
+static uxx RegexDfaSearchReverse(Regex* regex, Str8 haystack, uxx minIndex, uxx endIndex, bool* failedOut)
+{
+	RegexDfa* dfa = &regex->reverseDfa;
+	u32 stateIndex = RegexDfaGetStartState(regex, dfa, (endIndex == haystack.length));
+	if (stateIndex == REGEX_DFA_FAILED_STATE) { *failedOut = true; return endIndex; }
+	uxx result = endIndex;
+	bool foundMatch = false;
+	uxx bIndex = endIndex;
+	while (true)
+	{
+		const RegexDfaState* state = &dfa->states[stateIndex];
+		if (state->isMatch) { foundMatch = true; result = bIndex; }
+		if (stateIndex == REGEX_DFA_DEAD_STATE) { break; }
+		if (bIndex <= minIndex)
+		{
+			if (minIndex == 0 && state->isMatchAtEnd) { foundMatch = true; result = 0; }
+			break;
+		}
+		u8 byteClass = regex->byteClasses[haystack.bytes[bIndex-1]];
+		u32 nextStateIndex = state->transitions[byteClass];
+		if (nextStateIndex == REGEX_DFA_UNKNOWN_STATE)
+		{
+			nextStateIndex = RegexDfaComputeTransition(regex, dfa, stateIndex, byteClass);
+			if (nextStateIndex == REGEX_DFA_FAILED_STATE) { *failedOut = true; return endIndex; }
+		}
+		stateIndex = nextStateIndex;
+		bIndex--;
+	}
+	DebugAssert(foundMatch);
+	UNUSED(foundMatch);
+	return result;
+}
+
+// +==============================+
+// |           Pike VM            |
+// +==============================+
+typedef plex RegexPikeStackEntry RegexPikeStackEntry;
+plex RegexPikeStackEntry
+{
+	u32 pc;
+	u32 restoreSlot; //UINT32_MAX for entries that visit pc, otherwise this entry puts restoreValue back into slots[restoreSlot]
+	uxx restoreValue;
+};
+
+typedef plex RegexPikeList RegexPikeList;
+plex RegexPikeList
+{
+	uxx numThreads;
+	u32* pcs;
+	uxx* slots; //numSlots for each thread
+};
+
+typedef plex RegexPikeVm RegexPikeVm;
+plex RegexPikeVm
+{
+	const Regex* regex;
+	Str8 haystack;
+	uxx visitGeneration;
+	uxx* visitMarks;
+	RegexPikeStackEntry* stack;
+};
+
+//Follows non-consuming instructions from startPc (in priority order) and adds the threads that are waiting on a byte (or Match) to list.
+//slots is modified by Save instructions while exploring but is back to it's original values when this returns
+static void RegexPikeAddThread(RegexPikeVm* vm, RegexPikeList* list, u32 startPc, uxx* slots, uxx position)
+{
+	const RegexProgram* program = &vm->regex->forward;
+	uxx numSlots = vm->regex->numSlots;
+	uxx stackSize = 0;
+	vm->stack[stackSize].pc = startPc;
+	vm->stack[stackSize].restoreSlot = UINT32_MAX;
+	stackSize++;
+	while (stackSize > 0)
+	{
+		RegexPikeStackEntry entry = vm->stack[--stackSize];
+		if (entry.restoreSlot != UINT32_MAX) { slots[entry.restoreSlot] = entry.restoreValue; continue; }
+		if (vm->visitMarks[entry.pc] == vm->visitGeneration) { continue; }
+		vm->visitMarks[entry.pc] = vm->visitGeneration;
+		const RegexInst* inst = &program->insts[entry.pc];
+		switch (inst->op)
+		{
+			case RegexOp_Byte:
+			case RegexOp_Set:
+			case RegexOp_Match:
+			{
+				list->pcs[list->numThreads] = entry.pc;
+				MyMemCopy(&list->slots[list->numThreads * numSlots], slots, sizeof(uxx) * numSlots);
+				list->numThreads++;
+			} break;
+			case RegexOp_Split:
+			{
+				vm->stack[stackSize].pc = inst->alt; vm->stack[stackSize].restoreSlot = UINT32_MAX; stackSize++;
+				vm->stack[stackSize].pc = inst->next; vm->stack[stackSize].restoreSlot = UINT32_MAX; stackSize++;
+			} break;
+			case RegexOp_Save:
+			{
+				vm->stack[stackSize].restoreSlot = inst->slot; vm->stack[stackSize].restoreValue = slots[inst->slot]; stackSize++;
+				slots[inst->slot] = position;
+				vm->stack[stackSize].pc = inst->next; vm->stack[stackSize].restoreSlot = UINT32_MAX; stackSize++;
+			} break;
+			case RegexOp_Jump:
+			case RegexOp_AssertBegin:
+			case RegexOp_AssertEnd:
+			{
+				if (inst->op == RegexOp_AssertBegin && position != 0) { break; }
+				if (inst->op == RegexOp_AssertEnd && position != vm->haystack.length) { break; }
+				vm->stack[stackSize].pc = inst->next; vm->stack[stackSize].restoreSlot = UINT32_MAX; stackSize++;
+			} break;
+			default: Assert(false); break;
+		}
+	}
+}
+
+//Finds the leftmost-first match at or after startIndex (or only at startIndex if anchored) and fills slotsOut with the capture positions
+static bool RegexPikeSearch(const Regex* regex, Arena* scratch, Str8 haystack, uxx startIndex, bool anchored, uxx* slotsOut)
+{
+	uxx numInsts = regex->forward.numInsts;
+	uxx numSlots = regex->numSlots;
+	RegexPikeVm vm = ZEROED;
+	vm.regex = regex;
+	vm.haystack = haystack;
+	vm.visitMarks = AllocArray(uxx, scratch, numInsts);
+	vm.stack = AllocArray(RegexPikeStackEntry, scratch, 2*numInsts + 1);
+	uxx* workSlots = AllocArray(uxx, scratch, numSlots);
+	RegexPikeList lists[2] = ZEROED;
+	for (uxx lIndex = 0; lIndex < 2; lIndex++)
+	{
+		lists[lIndex].pcs = AllocArray(u32, scratch, numInsts);
+		lists[lIndex].slots = AllocArray(uxx, scratch, numInsts * numSlots);
+		NotNull(lists[lIndex].pcs);
+		NotNull(lists[lIndex].slots);
+	}
+	NotNull(vm.visitMarks);
+	NotNull(vm.stack);
+	NotNull(workSlots);
+	MyMemSet(vm.visitMarks, 0x00, sizeof(uxx) * numInsts);
+	
+	bool matched = false;
+	RegexPikeList* currentList = &lists[0];
+	RegexPikeList* nextList = &lists[1];
+	vm.visitGeneration = 1;
+	for (uxx position = startIndex; true; position++)
+	{
+		//New match attempts always have a lower priority than the ones that started earlier
+		if (!matched && (!anchored || position == startIndex))
+		{
+			for (uxx sIndex = 0; sIndex < numSlots; sIndex++) { workSlots[sIndex] = REGEX_SLOT_UNSET; }
+			RegexPikeAddThread(&vm, currentList, 0, workSlots, position);
+		}
+		if (currentList->numThreads == 0) { break; }
+		
+		vm.visitGeneration++;
+		nextList->numThreads = 0;
+		for (uxx tIndex = 0; tIndex < currentList->numThreads; tIndex++)
+		{
+			const RegexInst* inst = &regex->forward.insts[currentList->pcs[tIndex]];
+			uxx* threadSlots = &currentList->slots[tIndex * numSlots];
+			if (inst->op == RegexOp_Match)
+			{
+				MyMemCopy(slotsOut, threadSlots, sizeof(uxx) * numSlots);
+				matched = true;
+				break; //lower priority threads can't win anymore
+			}
+			if (position < haystack.length && RegexInstMatchesByte(regex, inst, haystack.bytes[position]))
+			{
+				MyMemCopy(workSlots, threadSlots, sizeof(uxx) * numSlots);
+				RegexPikeAddThread(&vm, nextList, inst->next, workSlots, position+1);
+			}
+		}
+		if (position >= haystack.length) { break; }
+		RegexPikeList* tempList = currentList;
+		currentList = nextList;
+		nextList = tempList;
+	}
+	return matched;
+}
+
+// +==============================+
+// |          Public API          |
+// +==============================+
+static void FreeRegexDfa(Regex* regex, RegexDfa* dfa, uxx numInsts)
+{
+	if (dfa->states != nullptr)
+	{
+		for (uxx sIndex = 0; sIndex < dfa->numStates; sIndex++)
+		{
+			RegexDfaState* state = &dfa->states[sIndex];
+			if (state->threads != nullptr) { FreeArray(u32, regex->arena, state->numThreads, state->threads); }
+			if (state->transitions != nullptr) { FreeArray(u32, regex->arena, regex->numByteClasses, state->transitions); }
+		}
+		FreeArray(RegexDfaState, regex->arena, REGEX_DFA_MAX_NUM_STATES, dfa->states);
+	}
+	if (dfa->stateTable != nullptr) { FreeArray(u32, regex->arena, REGEX_DFA_TABLE_SIZE, dfa->stateTable); }
+	if (dfa->visitMarks != nullptr) { FreeArray(u32, regex->arena, numInsts+1, dfa->visitMarks); }
+	if (dfa->stack != nullptr) { FreeArray(u32, regex->arena, 2*(numInsts+1), dfa->stack); }
+	if (dfa->workThreads != nullptr) { FreeArray(u32, regex->arena, numInsts+1, dfa->workThreads); }
+	if (dfa->endThreads != nullptr) { FreeArray(u32, regex->arena, numInsts+1, dfa->endThreads); }
+}
+
+PEXP void FreeRegex(Regex* regex)
+{
+	NotNull(regex);
+	if (regex->arena != nullptr && CanArenaFree(regex->arena))
+	{
+		FreeRegexDfa(regex, &regex->forwardDfa, regex->forward.numInsts);
+		FreeRegexDfa(regex, &regex->reverseDfa, regex->reverse.numInsts);
+		if (regex->forward.insts != nullptr) { FreeArray(RegexInst, regex->arena, regex->forward.numInsts, regex->forward.insts); }
+		if (regex->reverse.insts != nullptr) { FreeArray(RegexInst, regex->arena, regex->reverse.numInsts, regex->reverse.insts); }
+		if (regex->sets != nullptr) { FreeArray(RegexByteSet, regex->arena, regex->numSets, regex->sets); }
+		FreeStr8(regex->arena, &regex->prefix);
+		FreeStr8(regex->arena, &regex->pattern);
+	}
+	ClearPointer(regex);
+}
+
+static bool InitRegexDfa(Regex* regex, RegexDfa* dfa, bool isReverse)
+{
+	const RegexProgram* program = isReverse ? &regex->reverse : &regex->forward;
+	ClearPointer(dfa);
+	dfa->isReverse = isReverse;
+	dfa->startStates[0] = REGEX_DFA_UNKNOWN_STATE;
+	dfa->startStates[1] = REGEX_DFA_UNKNOWN_STATE;
+	dfa->states = AllocArray(RegexDfaState, regex->arena, REGEX_DFA_MAX_NUM_STATES);
+	dfa->stateTable = AllocArray(u32, regex->arena, REGEX_DFA_TABLE_SIZE);
+	dfa->visitMarks = AllocArray(u32, regex->arena, program->numInsts+1);
+	dfa->stack = AllocArray(u32, regex->arena, 2*(program->numInsts+1));
+	dfa->workThreads = AllocArray(u32, regex->arena, program->numInsts+1);
+	dfa->endThreads = AllocArray(u32, regex->arena, program->numInsts+1);
+	if (dfa->states == nullptr || dfa->stateTable == nullptr || dfa->visitMarks == nullptr || dfa->stack == nullptr || dfa->workThreads == nullptr || dfa->endThreads == nullptr) { return false; }
+	MyMemSet(dfa->stateTable, 0xFF, sizeof(u32) * REGEX_DFA_TABLE_SIZE); //REGEX_DFA_UNKNOWN_STATE
+	MyMemSet(dfa->visitMarks, 0x00, sizeof(u32) * (program->numInsts+1));
+	u32 deadStateIndex = RegexDfaAddState(regex, dfa, program, nullptr, 0);
+	Assert(deadStateIndex == REGEX_DFA_DEAD_STATE || deadStateIndex == REGEX_DFA_FAILED_STATE);
+	return (deadStateIndex == REGEX_DFA_DEAD_STATE);
+}
+
+static bool CopyRegexProgram(Arena* arena, const VarArray* insts, RegexProgram* programOut)
+{
+	programOut->numInsts = insts->length;
+	programOut->insts = AllocArray(RegexInst, arena, insts->length);
+	if (programOut->insts == nullptr) { return false; }
+	MyMemCopy(programOut->insts, insts->items, sizeof(RegexInst) * insts->length);
+	return true;
+}
+
+PEXP Result CompileRegex(Arena* arena, Str8 pattern, bool caseSensitive, Regex* regexOut)
+{
+	NotNull(arena);
+	NotNullStr(pattern);
+	NotNull(regexOut);
+	ClearPointer(regexOut);
+	ScratchBegin1(scratch, arena);
+	
+	RegexParser parser = ZEROED;
+	parser.arena = scratch;
+	parser.pattern = pattern;
+	parser.caseSensitive = caseSensitive;
+	parser.error = Result_Success;
+	InitVarArray(RegexByteSet, &parser.sets, scratch);
+	if (StrExactStartsWith(pattern, StrLit("(?i)"))) { parser.caseSensitive = false; parser.index = 4; }
+	RegexNode* root = RegexParseAlternation(&parser, 0);
+	if (root != nullptr && parser.index < pattern.length) { parser.error = Result_UnbalancedBrackets; } //an unmatched )
+	if (parser.error == Result_Success && parser.numGroups > MAX_NUM_REGEX_CAPTURES) { parser.error = Result_NotEnoughSpace; }
+	if (parser.error != Result_Success) { ScratchEnd(scratch); return parser.error; }
+	
+	RegexCompiler compiler = ZEROED;
+	compiler.arena = scratch;
+	compiler.sets = &parser.sets;
+	compiler.caseSensitive = parser.caseSensitive;
+	InitVarArray(RegexInst, &compiler.insts, scratch);
+	RegexGetInst(&compiler, RegexEmit(&compiler, RegexOp_Save))->slot = 0;
+	RegexCompileNode(&compiler, root);
+	RegexGetInst(&compiler, RegexEmit(&compiler, RegexOp_Save))->slot = 1;
+	RegexEmit(&compiler, RegexOp_Match);
+	VarArray forwardInsts = compiler.insts;
+	InitVarArray(RegexInst, &compiler.insts, scratch);
+	compiler.reverse = true;
+	RegexCompileNode(&compiler, root);
+	RegexEmit(&compiler, RegexOp_Match);
+	if (compiler.tooManyInsts) { ScratchEnd(scratch); return Result_TooMany; }
+	
+	regexOut->arena = arena;
+	regexOut->caseSensitive = parser.caseSensitive;
+	regexOut->numCaptures = parser.numGroups;
+	regexOut->numSlots = (parser.numGroups + 1) * 2;
+	regexOut->pattern = AllocStr8(arena, pattern);
+	regexOut->numSets = parser.sets.length;
+	regexOut->sets = (parser.sets.length > 0) ? AllocArray(RegexByteSet, arena, parser.sets.length) : nullptr;
+	if (regexOut->sets != nullptr) { MyMemCopy(regexOut->sets, parser.sets.items, sizeof(RegexByteSet) * parser.sets.length); }
+	bool allocSucceeded = (regexOut->pattern.chars != nullptr || pattern.length == 0);
+	allocSucceeded = allocSucceeded && (regexOut->sets != nullptr || parser.sets.length == 0);
+	allocSucceeded = allocSucceeded && CopyRegexProgram(arena, &forwardInsts, &regexOut->forward);
+	allocSucceeded = allocSucceeded && CopyRegexProgram(arena, &compiler.insts, &regexOut->reverse);
+	
+	//Split the 256 byte values into classes, bytes in the same class are treated identically by every instruction
+	bool classBoundaries[256] = ZEROED;
+	VarArrayLoop(&forwardInsts, iIndex)
+	{
+		VarArrayLoopGet(RegexInst, inst, &forwardInsts, iIndex);
+		if (inst->op == RegexOp_Byte) { classBoundaries[inst->byte] = true; if (inst->byte < 255) { classBoundaries[inst->byte+1] = true; } }
+		else if (inst->op == RegexOp_Set)
+		{
+			const RegexByteSet* set = VarArrayGet(RegexByteSet, &parser.sets, inst->setIndex);
+			for (uxx bIndex = 1; bIndex < 256; bIndex++)
+			{
+				if (RegexSetContains(set, (u8)bIndex) != RegexSetContains(set, (u8)(bIndex-1))) { classBoundaries[bIndex] = true; }
+			}
+		}
+	}
+	regexOut->numByteClasses = 0;
+	for (uxx bIndex = 0; bIndex < 256; bIndex++)
+	{
+		if (bIndex > 0 && classBoundaries[bIndex]) { regexOut->numByteClasses++; }
+		if (bIndex == 0 || classBoundaries[bIndex]) { regexOut->classBytes[regexOut->numByteClasses] = (u8)bIndex; }
+		regexOut->byteClasses[bIndex] = (u8)regexOut->numByteClasses;
+	}
+	regexOut->numByteClasses++;
+	
+	u8 prefixBuffer[REGEX_MAX_PREFIX_LENGTH];
+	uxx prefixLength = 0;
+	RegexGetLiteralPrefix(root, &prefixBuffer[0], &prefixLength);
+	if (prefixLength > 0 && allocSucceeded)
+	{
+		regexOut->prefix = AllocStr8(arena, MakeStr8(prefixLength, (char*)&prefixBuffer[0]));
+		allocSucceeded = (regexOut->prefix.chars != nullptr);
+	}
+	
+	ScratchEnd(scratch);
+	allocSucceeded = allocSucceeded && InitRegexDfa(regexOut, &regexOut->forwardDfa, false);
+	allocSucceeded = allocSucceeded && InitRegexDfa(regexOut, &regexOut->reverseDfa, true);
+	if (!allocSucceeded) { FreeRegex(regexOut); return Result_FailedToAllocateMemory; }
+	return Result_Success;
+}
+
+PEXP RegexResult RegexFind(Regex* regex, Str8 haystack, uxx startIndex)
+{
+	NotNull(regex);
+	NotNull(regex->arena);
+	NotNullStr(haystack);
+	Assert(startIndex <= haystack.length);
 	RegexResult result = ZEROED;
+	result.result = Result_NoMatch;
 	result.haystack = haystack;
-	// result.matchBeginIndex = haystack.length;
+	result.matchBeginIndex = haystack.length;
 	result.matchEndIndex = haystack.length;
 	
-	ScratchBegin(scratch);
-	Str8 haystackNt = AllocStrAndCopy(scratch, haystack.length, haystack.chars, true);
-	NotNull(haystackNt.chars);
-	Str8 regexNt = AllocStrAndCopy(scratch, needleRegexPattern.length, needleRegexPattern.chars, true);
-	NotNull(regexNt.chars);
+	uxx beginIndex = startIndex;
+	uxx endIndex = startIndex;
+	bool useDfa = (!regex->dfaFailed && haystack.length > 0);
+	if (useDfa)
+	{
+		bool dfaFailed = false;
+		bool foundMatch = RegexDfaSearchForward(regex, haystack, startIndex, &endIndex, &dfaFailed);
+		if (!dfaFailed && !foundMatch) { return result; }
+		if (!dfaFailed) { beginIndex = RegexDfaSearchReverse(regex, haystack, startIndex, endIndex, &dfaFailed); }
+		if (dfaFailed) { regex->dfaFailed = true; useDfa = false; }
+	}
 	
-	slre_cap captures[MAX_NUM_REGEX_CAPTURES] = ZEROED;
-	int matchResult = slre_match(regexNt.chars, haystackNt.chars, (int)haystackNt.length, &captures[0], MAX_NUM_REGEX_CAPTURES, caseSensitive ? 0 : SLRE_IGNORE_CASE);
-	if (matchResult < 0) { result.result = GetResultForSlreErrorCode(matchResult); ScratchEnd(scratch); return result; }
+	ScratchBegin1(scratch, regex->arena);
+	uxx* slots = AllocArray(uxx, scratch, regex->numSlots);
+	NotNull(slots);
+	for (uxx sIndex = 0; sIndex < regex->numSlots; sIndex++) { slots[sIndex] = REGEX_SLOT_UNSET; }
+	if (useDfa && regex->numCaptures > 0)
+	{
+		bool foundMatch = RegexPikeSearch(regex, scratch, haystack, beginIndex, true, slots);
+		DebugAssert(foundMatch && slots[0] == beginIndex && slots[1] == endIndex);
+		UNUSED(foundMatch);
+	}
+	else if (!useDfa)
+	{
+		if (!RegexPikeSearch(regex, scratch, haystack, startIndex, false, slots)) { ScratchEnd(scratch); return result; }
+		beginIndex = slots[0];
+		endIndex = slots[1];
+	}
 	
 	result.result = Result_Success;
-	//TODO: We need to figure out why the matchResult is sometimes coming back as 1 past the end!
-	Assert((uxx)matchResult <= haystack.length+1);
-	result.matchEndIndex = (uxx)matchResult;
-	
-	for (uxx cIndex = 0; cIndex < MAX_NUM_REGEX_CAPTURES; cIndex++)
+	result.matchBeginIndex = beginIndex;
+	result.matchEndIndex = endIndex;
+	result.match = StrSlice(haystack, beginIndex, endIndex);
+	result.numCaptures = regex->numCaptures;
+	for (uxx cIndex = 0; cIndex < regex->numCaptures; cIndex++)
 	{
-		slre_cap* slreCapture = &captures[cIndex];
-		if (slreCapture->ptr != nullptr)
+		uxx captureBegin = slots[(cIndex+1)*2 + 0];
+		uxx captureEnd = slots[(cIndex+1)*2 + 1];
+		if (captureBegin != REGEX_SLOT_UNSET && captureEnd != REGEX_SLOT_UNSET)
 		{
-			//TODO: We need to figure out why the matchResult is sometimes coming back as 1 past the end!
-			Assert(IsSizedPntrWithin(haystackNt.chars, haystackNt.length+1, slreCapture->ptr, slreCapture->len));
-			if (slreCapture->ptr + slreCapture->len == haystackNt.chars + haystackNt.length+1) { Decrement(slreCapture->len); } //subtract 1 from the length if it dangles off the end
-			result.captures[result.numCaptures] = MakeStr8((uxx)slreCapture->len, &haystack.chars[(slreCapture->ptr - haystackNt.chars)]);
-			result.captureIndices[result.numCaptures] = (uxx)(slreCapture->ptr - haystack.chars);
-			// PrintLine_D("slreCapture[%llu]: \"%.*s\" at %llu", (u64)cIndex, StrPrint(result.captures[result.numCaptures]), (u64)result.captureIndices[result.numCaptures]);
-			result.numCaptures++;
+			result.captures[cIndex] = StrSlice(haystack, captureBegin, captureEnd);
+			result.captureIndices[cIndex] = captureBegin;
 		}
+		else { result.captureIndices[cIndex] = REGEX_SLOT_UNSET; }
 	}
-	
+	ScratchEnd(scratch);
+	return result;
+}
+
+//Like RegexFind but only answers whether there is a match, which only needs the forward DFA (when it doesn't run out of states)
+PEXP bool RegexContains(Regex* regex, Str8 haystack)
+{
+	NotNull(regex);
+	NotNullStr(haystack);
+	if (!regex->dfaFailed && haystack.length > 0)
+	{
+		bool dfaFailed = false;
+		uxx endIndex = 0;
+		bool foundMatch = RegexDfaSearchForward(regex, haystack, 0, &endIndex, &dfaFailed);
+		if (!dfaFailed) { return foundMatch; }
+		regex->dfaFailed = true;
+	}
+	return (RegexFind(regex, haystack, 0).result == Result_Success);
+}
+
+PEXPI RegexFindIter NewRegexFindIter(Regex* regex, Str8 haystack)
+{
+	NotNull(regex);
+	NotNullStr(haystack);
+	RegexFindIter result = ZEROED;
+	result.regex = regex;
+	result.haystack = haystack;
+	return result;
+}
+//Returns the next non-overlapping match, searching continues from the end of the previous match
+//(or one byte past it if the previous match was empty)
+PEXP bool RegexFindNext(RegexFindIter* iter, RegexResult* resultOut)
+{
+	NotNull(iter);
+	NotNull(iter->regex);
+	if (iter->finished) { return false; }
+	RegexResult result = RegexFind(iter->regex, iter->haystack, iter->index);
+	if (result.result != Result_Success) { iter->finished = true; return false; }
+	iter->index = result.matchEndIndex;
+	if (result.matchEndIndex == result.matchBeginIndex)
+	{
+		if (iter->index >= iter->haystack.length) { iter->finished = true; }
+		else { iter->index++; }
+	}
+	SetOptionalOutPntr(resultOut, result);
+	return true;
+}
+
+//NOTE: These functions compile the pattern every time they are called, if the same pattern is used repeatedly
+//      it is better to call CompileRegex once and use RegexFind, RegexContains or RegexFindNext
+PEXP RegexResult StrRegexFind(Str8 haystack, Str8 needleRegexPattern, bool caseSensitive)
+{
+	ScratchBegin(scratch);
+	Regex regex = ZEROED;
+	Result compileResult = CompileRegex(scratch, needleRegexPattern, caseSensitive, &regex);
+	if (compileResult != Result_Success)
+	{
+		RegexResult result = ZEROED;
+		result.result = compileResult;
+		result.haystack = haystack;
+		result.matchBeginIndex = haystack.length;
+		result.matchEndIndex = haystack.length;
+		ScratchEnd(scratch);
+		return result;
+	}
+	RegexResult result = RegexFind(&regex, haystack, 0);
 	ScratchEnd(scratch);
 	return result;
 }
@@ -151,6 +1397,4 @@ PEXPI bool StrAnyCaseRegexContains(Str8 haystack, Str8 needleRegexPattern)
 
 #endif //PIG_CORE_IMPLEMENTATION
 
-#endif //!USING_CUSTOM_STDLIB
-
 #endif //  _MISC_REGEX_H
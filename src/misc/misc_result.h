@@ -122,6 +122,7 @@ enum Result
 	Result_DBusError,
 	Result_Disconnected,
 	Result_Uninitialized,
+	Result_FailedToWriteFile,
 	
 	Result_Count,
 };
@@ -229,6 +230,7 @@ PEXP const char* GetResultStr(Result result)
 		case Result_DBusError: return "DBusError";
 		case Result_Disconnected: return "Disconnected";
 		case Result_Uninitialized: return "Uninitialized";
+		case Result_FailedToWriteFile: return "FailedToWriteFile";
 		default: return UNKNOWN_STR;
 	}
 }
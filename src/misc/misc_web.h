@@ -17,6 +17,8 @@ Description:
 #include "struct/struct_ranges.h"
 #include "mem/mem_arena.h"
 #include "misc/misc_two_pass.h"
+#include "struct/struct_string_builder.h"
+#include "base/base_simd.h"
 #include "misc/misc_parsing.h"
 #include "struct/struct_string_error_list.h"
 
@@ -101,7 +103,9 @@ PEXP const char* GetMimeTypeOfficialName(MimeType enumValue)
 	uxx GetHttpHeaderKeyErrors(Str8 key, StrErrorList* list);
 	uxx GetHttpHeaderValueErrors(Str8 value, StrErrorList* list);
 	Str8 EncodeHttpHeaders(Arena* arena, uxx numHeaders, const Str8Pair* headers, bool addNullTerm);
+	uxx FindNextFormUrlEscapeByte(Str8 str, uxx startIndex);
 	Str8 EscapeStr_FormUrlEncoding(Arena* arena, Str8 str, bool addNullTerm);
+	void StrBuilderAppendFormUrlEncoded(StringBuilder* builder, Str8 str);
 	Str8 EncodeHttpKeyValuePairContent(Arena* arena, uxx numItems, const Str8Pair* contentItems, MimeType encoding, bool addNullTerm);
 	uxx DecodeHttpHeaders(Arena* arena, Str8 encodedHeadersStr, bool allocatePairSlices, Str8Pair** headersOut);
 	const char* GetHttpStatusCodeDescription(u16 code);
@@ -348,35 +352,93 @@ PEXP Str8 EncodeHttpHeaders(Arena* arena, uxx numHeaders, const Str8Pair* header
 	return result.str;
 }
 
-PEXPI Str8 EscapeStr_FormUrlEncoding(Arena* arena, Str8 str, bool addNullTerm)
+//Returns the index of the first byte at or after startIndex that is not an unreserved character (RFC 3986 section 2.3), or str.length if there isn't one
+PEXP uxx FindNextFormUrlEscapeByte(Str8 str, uxx startIndex)
 {
+	NotNullStr(str);
+	Assert(startIndex <= str.length);
+	uxx bIndex = startIndex;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 lowerA = SimdU8x16_Splat('a');
+	SimdU8x16 lowerZ = SimdU8x16_Splat('z');
+	SimdU8x16 upperA = SimdU8x16_Splat('A');
+	SimdU8x16 upperZ = SimdU8x16_Splat('Z');
+	SimdU8x16 digit0 = SimdU8x16_Splat('0');
+	SimdU8x16 digit9 = SimdU8x16_Splat('9');
+	SimdU8x16 dash = SimdU8x16_Splat('-');
+	SimdU8x16 period = SimdU8x16_Splat('.');
+	SimdU8x16 underscore = SimdU8x16_Splat('_');
+	SimdU8x16 tilde = SimdU8x16_Splat('~');
+	for (; bIndex + SIMD_U8X16_SIZE <= str.length; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 block = SimdU8x16_Load(&str.bytes[bIndex]);
+		SimdU8x16 isUnreserved = SimdU8x16_Or(SimdU8x16_InRange(block, lowerA, lowerZ), SimdU8x16_InRange(block, upperA, upperZ));
+		isUnreserved = SimdU8x16_Or(isUnreserved, SimdU8x16_InRange(block, digit0, digit9));
+		isUnreserved = SimdU8x16_Or(isUnreserved, SimdU8x16_Or(SimdU8x16_Equal(block, dash), SimdU8x16_Equal(block, period)));
+		isUnreserved = SimdU8x16_Or(isUnreserved, SimdU8x16_Or(SimdU8x16_Equal(block, underscore), SimdU8x16_Equal(block, tilde)));
+		u32 escapeMask = (~SimdU8x16_Mask(isUnreserved) & 0xFFFF);
+		if (escapeMask != 0) { return bIndex + CountTrailingZerosU32(escapeMask); }
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < str.length; bIndex++)
+	{
+		u8 byte = str.bytes[bIndex];
+		if (!IsCharAlphaNumeric(byte) && byte != '-' && byte != '.' && byte != '_' && byte != '~') { return bIndex; }
+	}
+	return str.length;
+}
+
+//NOTE: Every byte of a multi-byte UTF-8 codepoint gets percent-encoded separately
+PEXP Str8 EscapeStr_FormUrlEncoding(Arena* arena, Str8 str, bool addNullTerm)
+{
+	NotNullStr(str);
 	TwoPassStr8Loop(result, arena, addNullTerm)
 	{
-		for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+		uxx cIndex = 0;
+		while (cIndex < str.length)
 		{
-			u32 codepoint = 0;
-			u8 codepointSize = GetCodepointForUtf8Str(str, cIndex, &codepoint);
-			if (IsCharAlphaNumeric(codepoint) ||
-				codepoint == '-' || codepoint == '.' || codepoint == '_' || codepoint == '~') //these are all unreserved characters according to RFC 3986 section 2.3
-			{
-				TwoPassBytes(&result, codepointSize, &str.chars[cIndex]);
-			}
-			else if (codepoint == ' ') { TwoPassChar(&result, '+'); } //this is allowed in media type application/x-www-form-urlencoded
+			uxx escapeIndex = FindNextFormUrlEscapeByte(str, cIndex);
+			TwoPassBytes(&result, escapeIndex - cIndex, &str.chars[cIndex]);
+			if (escapeIndex >= str.length) { break; }
+			u8 byte = str.bytes[escapeIndex];
+			if (byte == ' ') { TwoPassChar(&result, '+'); } //this is allowed in media type application/x-www-form-urlencoded
 			else
 			{
-				for (u8 byteIndex = 0; byteIndex < codepointSize; byteIndex++)
-				{
-					TwoPassChar(&result, '%');
-					TwoPassPrint(&result, "%02X", str.chars[cIndex + byteIndex]);
-				}
+				TwoPassChar(&result, '%');
+				TwoPassChar(&result, GetHexChar(byte >> 4, true));
+				TwoPassChar(&result, GetHexChar(byte & 0x0F, true));
 			}
-			if (codepointSize > 1) { cIndex += codepointSize-1; }
+			cIndex = escapeIndex + 1;
 		}
 		TwoPassStr8LoopEnd(&result);
 	}
 	return result.str;
 }
 
+//Single pass version of EscapeStr_FormUrlEncoding that appends to the end of builder
+PEXP void StrBuilderAppendFormUrlEncoded(StringBuilder* builder, Str8 str)
+{
+	NotNull(builder);
+	NotNullStr(str);
+	StrBuilderReserve(builder, str.length);
+	uxx cIndex = 0;
+	while (cIndex < str.length)
+	{
+		uxx escapeIndex = FindNextFormUrlEscapeByte(str, cIndex);
+		StrBuilderAppendStr(builder, StrSlice(str, cIndex, escapeIndex));
+		if (escapeIndex >= str.length) { break; }
+		u8 byte = str.bytes[escapeIndex];
+		if (byte == ' ') { StrBuilderAppendChar(builder, '+'); }
+		else
+		{
+			StrBuilderAppendChar(builder, '%');
+			StrBuilderAppendChar(builder, GetHexChar(byte >> 4, true));
+			StrBuilderAppendChar(builder, GetHexChar(byte & 0x0F, true));
+		}
+		cIndex = escapeIndex + 1;
+	}
+}
+
 PEXP Str8 EncodeHttpKeyValuePairContent(Arena* arena, uxx numItems, const Str8Pair* contentItems, MimeType encoding, bool addNullTerm)
 {
 	Str8 result = Str8_Empty;
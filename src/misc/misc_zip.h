@@ -5,6 +5,13 @@ Date:   01\21\2025
 Description:
 	** Holds functions that help us parse and load files out of .zip archives
 	** This file depends on miniz to do the parsing
+	** Archives can be opened from memory (OpenZipArchive), from a memory-mapped file (OpenZipArchivePathMapped)
+	** or straight from an open OsFile (OpenZipArchiveFromFile) so that only the central directory and the entries
+	** we actually ask for are read. A ZipArchiveEntry inflates one entry a piece at a time into caller-provided buffers
+	** When an archive is opened we copy every entry's path into a name index (hash tables for exact and any-case
+	** lookups plus a path-sorted list for prefix/folder enumeration) so finding a file doesn't touch every entry
+	** New archives are made with CreateZipArchive, filled with AddZipArchiveFile or AddZipArchiveFiles (which
+	** deflates a batch of files across a ThreadPool and then adds them in order) and finished with FinishZipArchive
 */
 
 #ifndef _MISC_ZIP_H
@@ -13,12 +20,21 @@ Description:
 #include "base/base_defines_check.h"
 #include "base/base_typedefs.h"
 #include "base/base_assert.h"
+#include "base/base_char.h"
 #include "std/std_memset.h"
+#include "std/std_basic_math.h"
+#include "std/std_malloc.h"
 #include "mem/mem_arena.h"
 #include "mem/mem_scratch.h"
 #include "struct/struct_string.h"
 #include "os/os_path.h"
+#include "os/os_file.h"
+#include "os/os_threading.h"
+#include "os/os_thread_pool.h"
+#include "os/os_sleep.h"
 #include "misc/misc_result.h"
+#include "misc/misc_hash.h"
+#include "misc/misc_sorting.h"
 
 #if !TARGET_IS_ORCA && !TARGET_IS_PLAYDATE //TODO: miniz.h relies on time.h which isn't available in Orca std C-lib, nor Playdate stdlib
 
@@ -51,6 +67,14 @@ Description:
 	#endif
 #endif //PIG_CORE_IMPLEMENTATION
 
+typedef plex ZipArchiveName ZipArchiveName;
+plex ZipArchiveName
+{
+	FilePath path; //null-terminated, points into ZipArchive.indexMemory
+	u64 hash;
+	u64 anyCaseHash;
+};
+
 typedef plex ZipArchive ZipArchive;
 plex ZipArchive
 {
@@ -59,6 +83,43 @@ plex ZipArchive
 	mz_zip_archive zip;
 	uxx numFiles;
 	u64 size;
+	OsFile* filePntr; //only set by OpenZipArchiveFromFile, the archive does not own this file
+	OsMappedFile mappedFile; //only set by OpenZipArchivePathMapped, unmapped by CloseZipArchive
+	u8* writeBuffer; //only used by writers, allocated from arena and grown as miniz writes to it, size is the number of bytes written
+	uxx writeBufferSize;
+	
+	//NOTE: The name index is built by OpenZipArchive/OpenZipArchivePathMapped/OpenZipArchiveFromFile (not for writers)
+	//      and lives in a single allocation from arena. The tables are open-addressed and hold fileIndex+1 (0 = empty slot)
+	u8* indexMemory;
+	uxx indexMemorySize;
+	ZipArchiveName* names; //[numFiles]
+	uxx nameTableSize; //power of 2
+	u32* nameTable; //[nameTableSize]
+	u32* anyCaseNameTable; //[nameTableSize]
+	u32* sortedNames; //[numFiles] file indices sorted by path
+};
+
+//NOTE: A ZipArchiveEntry reads one file out of an archive incrementally. Stored entries are copied and deflated
+//      entries are inflated through miniz's 32kB dictionary, so memory use doesn't depend on the size of the entry
+typedef plex ZipArchiveEntry ZipArchiveEntry;
+plex ZipArchiveEntry
+{
+	ZipArchive* archive;
+	uxx fileIndex;
+	Result error;
+	u64 size; //uncompressed size
+	u64 cursor;
+	mz_zip_reader_extract_iter_state* iterState;
+};
+
+#define ZIP_ARCHIVE_MAX_BATCH_HELPERS 32 //max number of ThreadPool work items a single AddZipArchiveFiles call will queue
+
+typedef plex ZipArchiveBatchFile ZipArchiveBatchFile;
+plex ZipArchiveBatchFile
+{
+	FilePath fileName;
+	Slice fileContents;
+	bool convertNewLines;
 };
 
 // +--------------------------------------------------------------+
@@ -68,7 +129,11 @@ plex ZipArchive
 	void CloseZipArchive(ZipArchive* archive);
 	Result OpenZipArchive(Arena* arena, Slice zipFileContents, ZipArchive* archiveOut);
 	FilePath GetZipArchiveFilePath(ZipArchive* archive, Arena* pathArena, uxx fileIndex);
+	Result BuildZipArchiveNameIndex(ZipArchive* archive);
 	bool FindZipArchiveFileNamed(ZipArchive* archive, Str8 fileName, uxx* fileIndexOut);
+	bool FindZipArchiveFileNamedAnyCase(ZipArchive* archive, Str8 fileName, uxx* fileIndexOut);
+	uxx FindZipArchiveFilesWithPrefix(ZipArchive* archive, Arena* arena, Str8 prefix, uxx** fileIndicesOut);
+	uxx FindZipArchiveFilesInFolder(ZipArchive* archive, Arena* arena, FilePath folderPath, bool recursive, uxx** fileIndicesOut);
 	Slice ReadZipArchiveFileAtIndex(ZipArchive* archive, Arena* fileContentsArena, uxx fileIndex, bool convertNewLines);
 	PIG_CORE_INLINE Str8 ReadZipArchiveTextFileAtIndex(ZipArchive* archive, Arena* fileContentsArena, uxx fileIndex);
 	PIG_CORE_INLINE Slice ReadZipArchiveBinFileAtIndex(ZipArchive* archive, Arena* fileContentsArena, uxx fileIndex);
@@ -78,10 +143,17 @@ plex ZipArchive
 	Slice OpenZipArchiveAndReadFile(Arena* fileContentsArena, Slice zipFileContents, Str8 fileName, bool convertNewLines);
 	PIG_CORE_INLINE Str8 OpenZipArchiveAndReadTextFile(Arena* fileContentsArena, Slice zipFileContents, Str8 fileName);
 	PIG_CORE_INLINE Slice OpenZipArchiveAndReadBinFile(Arena* fileContentsArena, Slice zipFileContents, Str8 fileName);
+	void CloseZipArchiveEntry(ZipArchiveEntry* entry);
+	Result OpenZipArchiveEntry(ZipArchive* archive, uxx fileIndex, ZipArchiveEntry* entryOut);
+	Result ReadFromZipArchiveEntry(ZipArchiveEntry* entry, uxx maxNumBytes, void* bufferOut, uxx* numBytesReadOut);
+	PIG_CORE_INLINE bool IsZipArchiveEntryFinished(const ZipArchiveEntry* entry);
 	void CreateZipArchive(Arena* arena, ZipArchive* archiveOut);
 	Result AddZipArchiveFile(ZipArchive* archive, FilePath fileName, Slice fileContents, bool convertNewLines);
 	PIG_CORE_INLINE Result AddZipArchiveTextFile(ZipArchive* archive, FilePath fileName, Str8 fileContents);
 	PIG_CORE_INLINE Result AddZipArchiveBinFile(ZipArchive* archive, FilePath fileName, Slice fileContents);
+	Result AddZipArchiveFileEx(ZipArchive* archive, FilePath fileName, Slice fileContents, bool convertNewLines, int compressionLevel);
+	Result AddZipArchiveFiles(ZipArchive* archive, uxx numFiles, const ZipArchiveBatchFile* files, int compressionLevel, plex ThreadPool* pool);
+	Result FinishZipArchive(ZipArchive* archive, Slice* contentsOut);
 	Slice ZlibDecompressIntoArena(Arena* arena, Slice compressedBytes, uxx expectedSize);
 #endif
 
@@ -97,10 +169,111 @@ PEXP void CloseZipArchive(ZipArchive* archive)
 	{
 		mz_bool endResult = mz_zip_end(&archive->zip);
 		Assert(endResult == MZ_TRUE);
+		if (archive->writeBuffer != nullptr && CanArenaFree(archive->arena)) { FreeMem(archive->arena, archive->writeBuffer, archive->writeBufferSize); }
+		if (archive->indexMemory != nullptr && CanArenaFree(archive->arena)) { FreeMem(archive->arena, archive->indexMemory, archive->indexMemorySize); }
 	}
+	if (archive->mappedFile.isMapped) { OsUnmapFile(&archive->mappedFile); }
 	ClearPointer(archive);
 }
 
+static u64 ZipArchiveHashName(Str8 name, bool anyCase)
+{
+	if (!anyCase) { return FnvHashU64(name.chars, name.length); }
+	u64 result = FNV_HASH_BASE_U64;
+	for (uxx cIndex = 0; cIndex < name.length; cIndex++)
+	{
+		result = result ^ (u8)ToLowerChar(name.chars[cIndex]);
+		result = result * FNV_HASH_PRIME_U64;
+	}
+	return result;
+}
+
+static i32 ZipArchiveComparePaths(Str8 left, Str8 right)
+{
+	i32 compareResult = MyMemCompare(left.chars, right.chars, MinUXX(left.length, right.length));
+	if (compareResult != 0) { return compareResult; }
+	if (left.length != right.length) { return (left.length < right.length) ? -1 : 1; }
+	return 0;
+}
+
+static COMPARE_FUNC_DEF(CompareZipArchiveSortedNames)
+{
+	const ZipArchive* archive = (const ZipArchive*)contextPntr;
+	u32 leftIndex = *(const u32*)left;
+	u32 rightIndex = *(const u32*)right;
+	i32 compareResult = ZipArchiveComparePaths(archive->names[leftIndex].path, archive->names[rightIndex].path);
+	if (compareResult != 0) { return compareResult; }
+	return (leftIndex < rightIndex) ? -1 : ((leftIndex > rightIndex) ? 1 : 0);
+}
+
+//NOTE: This is called when an archive is opened, you shouldn't need to call it yourself.
+//      Entries are inserted in order so when an archive holds the same path twice lookups find the first one
+PEXP Result BuildZipArchiveNameIndex(ZipArchive* archive)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	Assert(!archive->isWriter);
+	if (archive->indexMemory != nullptr && CanArenaFree(archive->arena)) { FreeMem(archive->arena, archive->indexMemory, archive->indexMemorySize); }
+	archive->indexMemory = nullptr;
+	archive->indexMemorySize = 0;
+	archive->names = nullptr;
+	archive->nameTableSize = 0;
+	archive->nameTable = nullptr;
+	archive->anyCaseNameTable = nullptr;
+	archive->sortedNames = nullptr;
+	if (archive->numFiles == 0) { return Result_Success; }
+	if (archive->numFiles >= UINT32_MAX) { return Result_TooMany; }
+	
+	uxx numCharBytes = 0;
+	for (uxx fIndex = 0; fIndex < archive->numFiles; fIndex++)
+	{
+		numCharBytes += (uxx)mz_zip_reader_get_filename(&archive->zip, (mz_uint)fIndex, nullptr, 0); //includes the null-term
+	}
+	uxx tableSize = 16;
+	while (tableSize < archive->numFiles * 2) { tableSize *= 2; }
+	
+	uxx namesOffset = 0;
+	uxx nameTableOffset = namesOffset + sizeof(ZipArchiveName) * archive->numFiles;
+	uxx anyCaseNameTableOffset = nameTableOffset + sizeof(u32) * tableSize;
+	uxx sortedNamesOffset = anyCaseNameTableOffset + sizeof(u32) * tableSize;
+	uxx charsOffset = sortedNamesOffset + sizeof(u32) * archive->numFiles;
+	uxx indexMemorySize = charsOffset + numCharBytes;
+	u8* indexMemory = (u8*)AllocMem(archive->arena, indexMemorySize);
+	if (indexMemory == nullptr) { return Result_FailedToAllocateMemory; }
+	MyMemSet(&indexMemory[nameTableOffset], 0x00, sizeof(u32) * tableSize * 2);
+	
+	archive->indexMemory = indexMemory;
+	archive->indexMemorySize = indexMemorySize;
+	archive->names = (ZipArchiveName*)&indexMemory[namesOffset];
+	archive->nameTableSize = tableSize;
+	archive->nameTable = (u32*)&indexMemory[nameTableOffset];
+	archive->anyCaseNameTable = (u32*)&indexMemory[anyCaseNameTableOffset];
+	archive->sortedNames = (u32*)&indexMemory[sortedNamesOffset];
+	
+	char* charsPntr = (char*)&indexMemory[charsOffset];
+	uxx tableMask = tableSize - 1;
+	for (uxx fIndex = 0; fIndex < archive->numFiles; fIndex++)
+	{
+		ZipArchiveName* name = &archive->names[fIndex];
+		mz_uint nameSize = mz_zip_reader_get_filename(&archive->zip, (mz_uint)fIndex, charsPntr, (mz_uint)(numCharBytes - (uxx)(charsPntr - (char*)&indexMemory[charsOffset])));
+		name->path = MakeStr8((nameSize > 0) ? (uxx)(nameSize-1) : 0, charsPntr);
+		charsPntr += nameSize;
+		name->hash = ZipArchiveHashName(name->path, false);
+		name->anyCaseHash = ZipArchiveHashName(name->path, true);
+		archive->sortedNames[fIndex] = (u32)fIndex;
+		
+		uxx slotIndex = (uxx)(name->hash & tableMask);
+		while (archive->nameTable[slotIndex] != 0) { slotIndex = ((slotIndex + 1) & tableMask); }
+		archive->nameTable[slotIndex] = (u32)(fIndex + 1);
+		slotIndex = (uxx)(name->anyCaseHash & tableMask);
+		while (archive->anyCaseNameTable[slotIndex] != 0) { slotIndex = ((slotIndex + 1) & tableMask); }
+		archive->anyCaseNameTable[slotIndex] = (u32)(fIndex + 1);
+	}
+	QuickSortFlat(archive->sortedNames, archive->numFiles, sizeof(u32), CompareZipArchiveSortedNames, archive);
+	
+	return Result_Success;
+}
+
 PEXP Result OpenZipArchive(Arena* arena, Slice zipFileContents, ZipArchive* archiveOut)
 {
 	NotNull(arena);
@@ -121,6 +294,8 @@ PEXP Result OpenZipArchive(Arena* arena, Slice zipFileContents, ZipArchive* arch
 	archiveOut->arena = arena;
 	archiveOut->numFiles = (uxx)mz_zip_reader_get_num_files(&archiveOut->zip);
 	archiveOut->size = mz_zip_get_archive_size(&archiveOut->zip);
+	Result indexResult = BuildZipArchiveNameIndex(archiveOut);
+	if (indexResult != Result_Success) { CloseZipArchive(archiveOut); return indexResult; }
 	
 	#if 0
 	ScratchBegin1(scratch, arena);
@@ -206,18 +381,42 @@ PEXP FilePath GetZipArchiveFilePath(ZipArchive* archive, Arena* pathArena, uxx f
 	return result;
 }
 
-//TODO: Should we add a case-insensitive search option?
+//NOTE: A full path inside the archive is found through the name index in O(1). Anything else falls back to
+//      the old behavior of returning the first entry whose path ends with fileName (ex. "file.png" finding "images/file.png")
 PEXP bool FindZipArchiveFileNamed(ZipArchive* archive, Str8 fileName, uxx* fileIndexOut)
 {
 	NotNull(archive);
 	NotNull(archive->arena);
+	if (archive->names != nullptr)
+	{
+		u64 hash = ZipArchiveHashName(fileName, false);
+		uxx tableMask = archive->nameTableSize - 1;
+		for (uxx slotIndex = (uxx)(hash & tableMask); archive->nameTable[slotIndex] != 0; slotIndex = ((slotIndex + 1) & tableMask))
+		{
+			uxx fIndex = (uxx)archive->nameTable[slotIndex] - 1;
+			if (archive->names[fIndex].hash == hash && StrExactEquals(archive->names[fIndex].path, fileName))
+			{
+				SetOptionalOutPntr(fileIndexOut, fIndex);
+				return true;
+			}
+		}
+		for (uxx fIndex = 0; fIndex < archive->numFiles; fIndex++)
+		{
+			if (StrExactEndsWith(archive->names[fIndex].path, fileName))
+			{
+				SetOptionalOutPntr(fileIndexOut, fIndex);
+				return true;
+			}
+		}
+		return false;
+	}
+	
 	ScratchBegin(scratch);
 	for (uxx fIndex = 0; fIndex < archive->numFiles; fIndex++)
 	{
 		uxx scratchMark = ArenaGetMark(scratch);
 		FilePath filePath = GetZipArchiveFilePath(archive, scratch, fIndex);
-		//TODO: Replace with StrEndsWith call
-		if (filePath.length >= fileName.length && MyStrCompare(filePath.chars + filePath.length - fileName.length, fileName.chars, fileName.length) == 0)
+		if (StrExactEndsWith(filePath, fileName))
 		{
 			SetOptionalOutPntr(fileIndexOut, fIndex);
 			ScratchEnd(scratch);
@@ -229,6 +428,145 @@ PEXP bool FindZipArchiveFileNamed(ZipArchive* archive, Str8 fileName, uxx* fileI
 	return false;
 }
 
+//NOTE: Same as FindZipArchiveFileNamed but ASCII letters match regardless of case (ex. "Images/Logo.PNG" finds "images/logo.png")
+PEXP bool FindZipArchiveFileNamedAnyCase(ZipArchive* archive, Str8 fileName, uxx* fileIndexOut)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	if (archive->names != nullptr)
+	{
+		u64 anyCaseHash = ZipArchiveHashName(fileName, true);
+		uxx tableMask = archive->nameTableSize - 1;
+		for (uxx slotIndex = (uxx)(anyCaseHash & tableMask); archive->anyCaseNameTable[slotIndex] != 0; slotIndex = ((slotIndex + 1) & tableMask))
+		{
+			uxx fIndex = (uxx)archive->anyCaseNameTable[slotIndex] - 1;
+			if (archive->names[fIndex].anyCaseHash == anyCaseHash && StrAnyCaseEquals(archive->names[fIndex].path, fileName))
+			{
+				SetOptionalOutPntr(fileIndexOut, fIndex);
+				return true;
+			}
+		}
+		for (uxx fIndex = 0; fIndex < archive->numFiles; fIndex++)
+		{
+			if (StrAnyCaseEndsWith(archive->names[fIndex].path, fileName))
+			{
+				SetOptionalOutPntr(fileIndexOut, fIndex);
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	ScratchBegin(scratch);
+	for (uxx fIndex = 0; fIndex < archive->numFiles; fIndex++)
+	{
+		uxx scratchMark = ArenaGetMark(scratch);
+		FilePath filePath = GetZipArchiveFilePath(archive, scratch, fIndex);
+		if (StrAnyCaseEndsWith(filePath, fileName))
+		{
+			SetOptionalOutPntr(fileIndexOut, fIndex);
+			ScratchEnd(scratch);
+			return true;
+		}
+		ArenaResetToMark(scratch, scratchMark);
+	}
+	ScratchEnd(scratch);
+	return false;
+}
+
+//Returns the position in archive->sortedNames of the first path that is >= prefix
+static uxx ZipArchiveFindSortedLowerBound(const ZipArchive* archive, Str8 prefix)
+{
+	uxx lowIndex = 0;
+	uxx highIndex = archive->numFiles;
+	while (lowIndex < highIndex)
+	{
+		uxx middleIndex = lowIndex + (highIndex - lowIndex) / 2;
+		if (ZipArchiveComparePaths(archive->names[archive->sortedNames[middleIndex]].path, prefix) < 0) { lowIndex = middleIndex + 1; }
+		else { highIndex = middleIndex; }
+	}
+	return lowIndex;
+}
+
+//NOTE: Finds every entry whose path starts with prefix (case-sensitive), in path order. Pass nullptr for
+//      fileIndicesOut to only count them, otherwise the indices are allocated from arena (nullptr when the count is 0)
+PEXP uxx FindZipArchiveFilesWithPrefix(ZipArchive* archive, Arena* arena, Str8 prefix, uxx** fileIndicesOut)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	NotNullStr(prefix);
+	Assert(fileIndicesOut == nullptr || arena != nullptr);
+	SetOptionalOutPntr(fileIndicesOut, nullptr);
+	AssertMsg(archive->names != nullptr || archive->numFiles == 0, "FindZipArchiveFilesWithPrefix needs the name index built by opening the archive");
+	if (archive->names == nullptr) { return 0; }
+	
+	uxx firstSortedIndex = ZipArchiveFindSortedLowerBound(archive, prefix);
+	uxx numMatches = 0;
+	while (firstSortedIndex + numMatches < archive->numFiles &&
+		StrExactStartsWith(archive->names[archive->sortedNames[firstSortedIndex + numMatches]].path, prefix))
+	{
+		numMatches++;
+	}
+	if (fileIndicesOut != nullptr && numMatches > 0)
+	{
+		uxx* fileIndices = AllocArray(uxx, arena, numMatches);
+		if (fileIndices == nullptr) { return 0; }
+		for (uxx mIndex = 0; mIndex < numMatches; mIndex++) { fileIndices[mIndex] = (uxx)archive->sortedNames[firstSortedIndex + mIndex]; }
+		*fileIndicesOut = fileIndices;
+	}
+	return numMatches;
+}
+
+//NOTE: Pass an empty folderPath for the root of the archive. When recursive is false we only return the direct children
+//      of the folder (files and the entries for subfolders, which end with a '/'). The folder's own entry is never returned.
+//      Many zip tools don't write entries for folders, so subfolders only show up here when the archive has an entry for them
+PEXP uxx FindZipArchiveFilesInFolder(ZipArchive* archive, Arena* arena, FilePath folderPath, bool recursive, uxx** fileIndicesOut)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	NotNullStr(folderPath);
+	Assert(fileIndicesOut == nullptr || arena != nullptr);
+	SetOptionalOutPntr(fileIndicesOut, nullptr);
+	AssertMsg(archive->names != nullptr || archive->numFiles == 0, "FindZipArchiveFilesInFolder needs the name index built by opening the archive");
+	if (archive->names == nullptr) { return 0; }
+	
+	ScratchBegin1(scratch, arena);
+	FilePath prefix = AllocFilePath(scratch, folderPath, false);
+	ChangePathSlashesTo(prefix, '/');
+	if (prefix.length > 0 && prefix.chars[prefix.length-1] != '/') { prefix = JoinStringsInArena(scratch, prefix, StrLit("/"), false); }
+	
+	uxx firstSortedIndex = ZipArchiveFindSortedLowerBound(archive, prefix);
+	uxx numMatches = 0;
+	uxx* fileIndices = nullptr;
+	for (uxx pass = 0; pass < 2; pass++) //first pass counts, second pass fills fileIndices
+	{
+		uxx matchIndex = 0;
+		for (uxx sIndex = firstSortedIndex; sIndex < archive->numFiles; sIndex++)
+		{
+			uxx fIndex = (uxx)archive->sortedNames[sIndex];
+			FilePath path = archive->names[fIndex].path;
+			if (!StrExactStartsWith(path, prefix)) { break; }
+			if (path.length == prefix.length) { continue; }
+			if (!recursive)
+			{
+				Str8 remainingPath = StrSliceFrom(path, prefix.length);
+				uxx slashIndex = 0;
+				while (slashIndex < remainingPath.length && remainingPath.chars[slashIndex] != '/') { slashIndex++; }
+				if (slashIndex < remainingPath.length - 1) { continue; }
+			}
+			if (fileIndices != nullptr) { fileIndices[matchIndex] = fIndex; }
+			matchIndex++;
+		}
+		numMatches = matchIndex;
+		if (pass > 0 || fileIndicesOut == nullptr || numMatches == 0) { break; }
+		fileIndices = AllocArray(uxx, arena, numMatches);
+		if (fileIndices == nullptr) { ScratchEnd(scratch); return 0; }
+	}
+	ScratchEnd(scratch);
+	SetOptionalOutPntr(fileIndicesOut, fileIndices);
+	return numMatches;
+}
+
 PEXP Slice ReadZipArchiveFileAtIndex(ZipArchive* archive, Arena* fileContentsArena, uxx fileIndex, bool convertNewLines)
 {
 	NotNull(archive);
@@ -285,16 +623,98 @@ PEXP Slice OpenZipArchiveAndReadFile(Arena* fileContentsArena, Slice zipFileCont
 PEXPI Str8 OpenZipArchiveAndReadTextFile(Arena* fileContentsArena, Slice zipFileContents, Str8 fileName) { return OpenZipArchiveAndReadFile(fileContentsArena, zipFileContents, fileName, true); }
 PEXPI Slice OpenZipArchiveAndReadBinFile(Arena* fileContentsArena, Slice zipFileContents, Str8 fileName) { return OpenZipArchiveAndReadFile(fileContentsArena, zipFileContents, fileName, false); }
 
+// +--------------------------------------------------------------+
+// |                     Streaming Entry Reads                    |
+// +--------------------------------------------------------------+
+PEXP void CloseZipArchiveEntry(ZipArchiveEntry* entry)
+{
+	NotNull(entry);
+	if (entry->iterState != nullptr) { mz_zip_reader_extract_iter_free(entry->iterState); }
+	ClearPointer(entry);
+}
 
+//NOTE: The archive must stay open (and must not be read from on another thread) until the entry is closed
+PEXP Result OpenZipArchiveEntry(ZipArchive* archive, uxx fileIndex, ZipArchiveEntry* entryOut)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	Assert(!archive->isWriter);
+	Assert(fileIndex < archive->numFiles);
+	NotNull(entryOut);
+	ClearPointer(entryOut);
+	
+	mz_zip_archive_file_stat fileStats = ZEROED;
+	if (mz_zip_reader_file_stat(&archive->zip, (mz_uint)fileIndex, &fileStats) == MZ_FALSE) { return Result_ParsingFailure; }
+	if (!fileStats.m_is_supported) { return Result_UnsupportedCompression; }
+	if (fileStats.m_uncomp_size > (u64)UINTXX_MAX) { return Result_TooLong; }
+	
+	entryOut->archive = archive;
+	entryOut->fileIndex = fileIndex;
+	entryOut->size = fileStats.m_uncomp_size;
+	entryOut->error = Result_None;
+	entryOut->iterState = mz_zip_reader_extract_iter_new(&archive->zip, (mz_uint)fileIndex, 0); //No MZ_ZIP_FLAGs
+	if (entryOut->iterState == nullptr)
+	{
+		mz_zip_error iterError = mz_zip_get_last_error(&archive->zip);
+		ClearPointer(entryOut);
+		return (iterError == MZ_ZIP_ALLOC_FAILED) ? Result_FailedToAllocateMemory : Result_FailedToReadFile;
+	}
+	return Result_Success;
+}
+
+//Inflates up to maxNumBytes of the entry into bufferOut. Like ReadFromDataStreamInto this is allowed to read less than maxNumBytes
+//at the end of the entry and returns Result_EndOfFile only when there were no bytes left at all. The CRC of the entry is checked
+//once the last byte has been read, a mismatch (or any other failure) is stored in entry->error and returned from every later call
+PEXP Result ReadFromZipArchiveEntry(ZipArchiveEntry* entry, uxx maxNumBytes, void* bufferOut, uxx* numBytesReadOut)
+{
+	NotNull(entry);
+	NotNull(entry->archive);
+	NotNull(numBytesReadOut);
+	Assert(bufferOut != nullptr || maxNumBytes == 0);
+	*numBytesReadOut = 0;
+	if (entry->error != Result_None) { return entry->error; }
+	if (maxNumBytes == 0) { return Result_Success; }
+	if (entry->cursor >= entry->size) { return Result_EndOfFile; }
+	NotNull(entry->iterState);
+	
+	u64 numBytesToRead = MinU64((u64)maxNumBytes, entry->size - entry->cursor);
+	size_t numBytesRead = mz_zip_reader_extract_iter_read(entry->iterState, bufferOut, (size_t)numBytesToRead);
+	entry->cursor += (u64)numBytesRead;
+	*numBytesReadOut = (uxx)numBytesRead;
+	
+	if (entry->cursor >= entry->size || numBytesRead < (size_t)numBytesToRead)
+	{
+		//NOTE: mz_zip_reader_extract_iter_free is where miniz checks the size and CRC of what it inflated
+		mz_bool freeResult = mz_zip_reader_extract_iter_free(entry->iterState);
+		entry->iterState = nullptr;
+		if (entry->cursor < entry->size) { entry->error = Result_UnexpectedEof; }
+		else if (freeResult == MZ_FALSE) { entry->error = Result_DecompressError; }
+		if (entry->error != Result_None) { *numBytesReadOut = 0; return entry->error; }
+	}
+	return Result_Success;
+}
+PEXPI bool IsZipArchiveEntryFinished(const ZipArchiveEntry* entry) { return (entry->error != Result_None || entry->cursor >= entry->size); }
+
+
+//NOTE: miniz mostly appends but it goes back and rewrites each local header once the entry's compressed size is known
 size_t ZipFileWriteCallback(void* contextPntr, mz_uint64 fileOffset, const void* bufferPntr, size_t numBytes)
 {
-	PrintLine_D("ZipFileWriteCallback(%p, %llu, %p, %zu)", contextPntr, fileOffset, bufferPntr, numBytes);
 	ZipArchive* archive = (ZipArchive*)contextPntr;
-	if (archive != nullptr)
+	NotNull(archive);
+	NotNull(archive->arena);
+	if (fileOffset + numBytes > UINTXX_MAX) { return 0; }
+	uxx endOffset = (uxx)(fileOffset + numBytes);
+	if (endOffset > archive->writeBufferSize)
 	{
-		PrintLine_D("ZipFileWriteCallback archive: %p %s %llu file%s", archive->arena, archive->isWriter ? "Writer" : "Reader", (u64)archive->numFiles, Plural(archive->numFiles, "s"));
+		uxx newSize = (archive->writeBufferSize > 0) ? archive->writeBufferSize : Kilobytes(64);
+		while (newSize < endOffset) { newSize *= 2; }
+		u8* newBuffer = (u8*)ReallocMem(archive->arena, archive->writeBuffer, archive->writeBufferSize, newSize);
+		if (newBuffer == nullptr) { return 0; }
+		archive->writeBuffer = newBuffer;
+		archive->writeBufferSize = newSize;
 	}
-	//TODO: Implement me!
+	if (numBytes > 0) { MyMemCopy(&archive->writeBuffer[fileOffset], bufferPntr, numBytes); }
+	if (endOffset > archive->size) { archive->size = (u64)endOffset; }
 	return numBytes;
 }
 
@@ -313,12 +733,15 @@ PEXP void CreateZipArchive(Arena* arena, ZipArchive* archiveOut)
 	Assert(initResult == MZ_TRUE);
 }
 
-PEXP Result AddZipArchiveFile(ZipArchive* archive, FilePath fileName, Slice fileContents, bool convertNewLines)
+//NOTE: compressionLevel is 0-10 (0 = store, MZ_BEST_SPEED = 1, MZ_BEST_COMPRESSION = 9) or MZ_DEFAULT_COMPRESSION
+PEXP Result AddZipArchiveFileEx(ZipArchive* archive, FilePath fileName, Slice fileContents, bool convertNewLines, int compressionLevel)
 {
 	NotNull(archive);
 	NotNull(archive->arena);
 	NotEmptyStr(fileName);
 	NotNullStr(fileContents);
+	Assert(compressionLevel <= MZ_UBER_COMPRESSION);
+	if (compressionLevel < 0) { compressionLevel = MZ_DEFAULT_COMPRESSION; }
 	ScratchBegin(scratch);
 	
 	if (convertNewLines && fileContents.length > 0)
@@ -328,16 +751,277 @@ PEXP Result AddZipArchiveFile(ZipArchive* archive, FilePath fileName, Slice file
 	}
 	// Allocate a null-terminated version of fileName
 	FilePath fileNameNt = AllocFilePath(scratch, fileName, true);
-	mz_bool addMemSuccess = mz_zip_writer_add_mem(&archive->zip, fileNameNt.chars, fileContents.bytes, (size_t)fileContents.length, (mz_uint)MZ_DEFAULT_COMPRESSION); //TODO: Should we tune this compression level? Maybe choose MZ_BEST_SPEED sometimes?
-	Assert(addMemSuccess); //TODO: Do we want to return a failure result for this? Why would it fail?
-	IncrementUXX(archive->numFiles);
-	
+	mz_bool addMemSuccess = mz_zip_writer_add_mem(&archive->zip, fileNameNt.chars, fileContents.bytes, (size_t)fileContents.length, (mz_uint)compressionLevel);
 	ScratchEnd(scratch);
+	if (!addMemSuccess) { return (mz_zip_get_last_error(&archive->zip) == MZ_ZIP_FILE_WRITE_FAILED) ? Result_FailedToAllocateMemory : Result_Failure; }
+	IncrementUXX(archive->numFiles);
 	return Result_Success;
 }
+PEXP Result AddZipArchiveFile(ZipArchive* archive, FilePath fileName, Slice fileContents, bool convertNewLines) { return AddZipArchiveFileEx(archive, fileName, fileContents, convertNewLines, MZ_DEFAULT_COMPRESSION); }
 PEXPI Result AddZipArchiveTextFile(ZipArchive* archive, FilePath fileName, Str8 fileContents) { return AddZipArchiveFile(archive, fileName, fileContents, true); }
 PEXPI Result AddZipArchiveBinFile(ZipArchive* archive, FilePath fileName, Slice fileContents) { return AddZipArchiveFile(archive, fileName, fileContents, false); }
 
+typedef plex ZipArchiveBatchSlot ZipArchiveBatchSlot;
+plex ZipArchiveBatchSlot
+{
+	bool isClaimed;
+	bool isDone;
+	Result error;
+	u8* convertedBytes; //MyMalloc'd copy of the contents with \r\n line endings (when convertNewLines is set)
+	Slice contents; //the uncompressed bytes we're adding, either the caller's fileContents or convertedBytes
+	void* compressedBytes; //allocated by miniz (MZ_MALLOC), freed with mz_free
+	size_t compressedSize;
+	u32 crc32;
+};
+
+typedef plex ZipArchiveBatch ZipArchiveBatch;
+plex ZipArchiveBatch
+{
+	uxx numFiles;
+	const ZipArchiveBatchFile* files;
+	ZipArchiveBatchSlot* slots;
+	int compressionLevel;
+	uxx nextIndex;
+	#if TARGET_HAS_THREADING
+	bool useMutex;
+	Mutex mutex;
+	#endif
+};
+
+//Converts and deflates one file into its slot. This is called on pool threads, so it only touches the slot and MyMalloc/miniz's heap
+static void ZipArchiveBatchCompressFile(ZipArchiveBatch* batch, uxx fileIndex)
+{
+	const ZipArchiveBatchFile* file = &batch->files[fileIndex];
+	ZipArchiveBatchSlot* slot = &batch->slots[fileIndex];
+	slot->contents = file->fileContents;
+	if (file->convertNewLines && file->fileContents.length > 0)
+	{
+		uxx numNewLines = 0;
+		for (uxx bIndex = 0; bIndex < file->fileContents.length; bIndex++) { if (file->fileContents.chars[bIndex] == '\n') { numNewLines++; } }
+		if (numNewLines > 0)
+		{
+			slot->convertedBytes = (u8*)MyMalloc(file->fileContents.length + numNewLines);
+			if (slot->convertedBytes == nullptr) { slot->error = Result_FailedToAllocateMemory; return; }
+			uxx writeIndex = 0;
+			for (uxx bIndex = 0; bIndex < file->fileContents.length; bIndex++)
+			{
+				if (file->fileContents.chars[bIndex] == '\n') { slot->convertedBytes[writeIndex++] = '\r'; }
+				slot->convertedBytes[writeIndex++] = file->fileContents.bytes[bIndex];
+			}
+			slot->contents = MakeSlice(writeIndex, slot->convertedBytes);
+		}
+	}
+	
+	//NOTE: miniz stores anything 3 bytes or smaller no matter the level, we also store anything that doesn't get smaller
+	if (batch->compressionLevel > 0 && slot->contents.length > 3)
+	{
+		slot->crc32 = (u32)mz_crc32(MZ_CRC32_INIT, slot->contents.bytes, (size_t)slot->contents.length);
+		mz_uint compFlags = tdefl_create_comp_flags_from_zip_params(batch->compressionLevel, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+		slot->compressedBytes = tdefl_compress_mem_to_heap(slot->contents.bytes, (size_t)slot->contents.length, &slot->compressedSize, (int)compFlags);
+		if (slot->compressedBytes == nullptr) { slot->error = Result_FailedToAllocateMemory; return; }
+		if (slot->compressedSize >= slot->contents.length)
+		{
+			mz_free(slot->compressedBytes);
+			slot->compressedBytes = nullptr;
+			slot->compressedSize = 0;
+		}
+	}
+}
+
+//Returns false when there are no unclaimed files left
+static bool ZipArchiveBatchClaimAndCompress(ZipArchiveBatch* batch)
+{
+	uxx fileIndex = batch->numFiles;
+	#if TARGET_HAS_THREADING
+	if (batch->useMutex)
+	{
+		LockMutexBlock(&batch->mutex, TIMEOUT_FOREVER)
+		{
+			if (batch->nextIndex < batch->numFiles) { fileIndex = batch->nextIndex++; batch->slots[fileIndex].isClaimed = true; }
+		}
+	}
+	else
+	#endif
+	{
+		if (batch->nextIndex < batch->numFiles) { fileIndex = batch->nextIndex++; batch->slots[fileIndex].isClaimed = true; }
+	}
+	if (fileIndex >= batch->numFiles) { return false; }
+	
+	ZipArchiveBatchCompressFile(batch, fileIndex);
+	
+	#if TARGET_HAS_THREADING
+	if (batch->useMutex) { LockMutexBlock(&batch->mutex, TIMEOUT_FOREVER) { batch->slots[fileIndex].isDone = true; } }
+	else
+	#endif
+	{
+		batch->slots[fileIndex].isDone = true;
+	}
+	return true;
+}
+
+static bool IsZipArchiveBatchFileDone(ZipArchiveBatch* batch, uxx fileIndex)
+{
+	bool result = false;
+	#if TARGET_HAS_THREADING
+	if (batch->useMutex) { LockMutexBlock(&batch->mutex, TIMEOUT_FOREVER) { result = batch->slots[fileIndex].isDone; } }
+	else
+	#endif
+	{
+		result = batch->slots[fileIndex].isDone;
+	}
+	return result;
+}
+
+#if TARGET_HAS_THREADING
+static THREAD_POOL_WORK_ITEM_FUNC_DEF(ZipArchiveBatchWorkItem)
+{
+	UNUSED(thread);
+	ZipArchiveBatch* batch = (ZipArchiveBatch*)workItem->subject.pntr;
+	while (ZipArchiveBatchClaimAndCompress(batch)) { }
+	return Result_Success;
+}
+#endif
+
+//NOTE: The files are deflated in parallel (on the calling thread plus any idle threads in pool, pass nullptr to
+//      compress on the calling thread only) but they are always added to the archive in the order they were given.
+//      Each file gets its own compressor and output buffer so the entries come out identical to adding the files
+//      one at a time at the same compressionLevel, except entries that don't shrink are stored rather than deflated.
+//      The calling thread adds each file as soon as it (and every file before it) is finished, so while the
+//      pool is busy we only hold onto the compressed copies of files that are waiting on an earlier file.
+//      Our helper work items are private so another thread calling GetFinishedThreadPoolWorkItem on the same pool won't take them
+PEXP Result AddZipArchiveFiles(ZipArchive* archive, uxx numFiles, const ZipArchiveBatchFile* files, int compressionLevel, plex ThreadPool* pool)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	Assert(archive->isWriter);
+	Assert(files != nullptr || numFiles == 0);
+	Assert(compressionLevel <= MZ_UBER_COMPRESSION);
+	if (numFiles == 0) { return Result_Success; }
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++) { NotEmptyStr(files[fIndex].fileName); NotNullStr(files[fIndex].fileContents); }
+	if (compressionLevel < 0) { compressionLevel = MZ_DEFAULT_LEVEL; }
+	
+	ZipArchiveBatch batch = ZEROED;
+	batch.numFiles = numFiles;
+	batch.files = files;
+	batch.compressionLevel = compressionLevel;
+	batch.slots = (ZipArchiveBatchSlot*)MyMalloc(sizeof(ZipArchiveBatchSlot) * numFiles);
+	if (batch.slots == nullptr) { return Result_FailedToAllocateMemory; }
+	MyMemSet(batch.slots, 0x00, sizeof(ZipArchiveBatchSlot) * numFiles);
+	
+	#if TARGET_HAS_THREADING
+	uxx numHelpers = 0;
+	ThreadPoolWorkItem* helperItems[ZIP_ARCHIVE_MAX_BATCH_HELPERS];
+	uxx helperItemIds[ZIP_ARCHIVE_MAX_BATCH_HELPERS];
+	if (pool != nullptr && numFiles > 1)
+	{
+		batch.useMutex = true;
+		InitMutex(&batch.mutex);
+		numHelpers = MinUXX(MinUXX(pool->threads.length, numFiles - 1), ZIP_ARCHIVE_MAX_BATCH_HELPERS);
+		for (uxx hIndex = 0; hIndex < numHelpers; hIndex++)
+		{
+			WorkSubject subject = ZEROED;
+			subject.pntr = &batch;
+			helperItems[hIndex] = AddWorkItemToThreadPoolEx(pool, ZipArchiveBatchWorkItem, &subject, true);
+			NotNull(helperItems[hIndex]);
+			helperItemIds[hIndex] = helperItems[hIndex]->id;
+		}
+	}
+	#else
+	UNUSED(pool);
+	#endif
+	
+	ScratchBegin1(scratch, archive->arena);
+	Result result = Result_Success;
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++)
+	{
+		//While we wait on a pool thread to finish the next file in order we compress files further down the list ourselves
+		while (!IsZipArchiveBatchFileDone(&batch, fIndex))
+		{
+			if (!ZipArchiveBatchClaimAndCompress(&batch)) { OsSleepMs(1); }
+		}
+		
+		ZipArchiveBatchSlot* slot = &batch.slots[fIndex];
+		if (result == Result_Success && slot->error != Result_None) { result = slot->error; }
+		if (result == Result_Success)
+		{
+			ScratchBegin1(nameScratch, scratch);
+			FilePath fileNameNt = AllocFilePath(nameScratch, files[fIndex].fileName, true);
+			mz_bool addMemSuccess;
+			if (slot->compressedBytes != nullptr)
+			{
+				addMemSuccess = mz_zip_writer_add_mem_ex(&archive->zip, fileNameNt.chars,
+					slot->compressedBytes, slot->compressedSize, nullptr, 0,
+					(mz_uint)compressionLevel | MZ_ZIP_FLAG_COMPRESSED_DATA, (mz_uint64)slot->contents.length, (mz_uint32)slot->crc32
+				);
+			}
+			else
+			{
+				addMemSuccess = mz_zip_writer_add_mem(&archive->zip, fileNameNt.chars, slot->contents.bytes, (size_t)slot->contents.length, 0);
+			}
+			ScratchEnd(nameScratch);
+			if (addMemSuccess) { IncrementUXX(archive->numFiles); }
+			else { result = (mz_zip_get_last_error(&archive->zip) == MZ_ZIP_FILE_WRITE_FAILED) ? Result_FailedToAllocateMemory : Result_Failure; }
+		}
+		
+		if (slot->compressedBytes != nullptr) { mz_free(slot->compressedBytes); slot->compressedBytes = nullptr; }
+		if (slot->convertedBytes != nullptr) { MyFree(slot->convertedBytes); slot->convertedBytes = nullptr; }
+	}
+	ScratchEnd(scratch);
+	
+	#if TARGET_HAS_THREADING
+	if (batch.useMutex)
+	{
+		//Helpers that no thread got around to claiming are marked done here (under the pool's mutex, the same way a thread claims an item)
+		LockMutexBlock(&pool->workItemsMutex, TIMEOUT_FOREVER)
+		{
+			for (uxx hIndex = 0; hIndex < numHelpers; hIndex++)
+			{
+				ThreadPoolWorkItem* item = helperItems[hIndex];
+				if (item->id == helperItemIds[hIndex] && !item->isWorking && !item->isDone && item->workerThreadId == THREAD_POOL_ID_INVALID)
+				{
+					item->result = Result_Canceled;
+					item->isDone = true;
+				}
+			}
+		}
+		for (uxx hIndex = 0; hIndex < numHelpers; hIndex++)
+		{
+			ThreadPoolWorkItem* item = helperItems[hIndex];
+			while (!item->isDone) { OsSleepMs(1); }
+			FreeThreadPoolWorkItem(pool, item);
+		}
+		DestroyMutex(&batch.mutex);
+	}
+	#endif
+	
+	MyFree(batch.slots);
+	return result;
+}
+
+//NOTE: Writes the central directory and hands back the whole archive. contentsOut is allocated from the archive's
+//      arena and now belongs to the caller (CloseZipArchive won't free it). The archive still needs to be closed
+PEXP Result FinishZipArchive(ZipArchive* archive, Slice* contentsOut)
+{
+	NotNull(archive);
+	NotNull(archive->arena);
+	Assert(archive->isWriter);
+	NotNull(contentsOut);
+	if (!mz_zip_writer_finalize_archive(&archive->zip))
+	{
+		return (mz_zip_get_last_error(&archive->zip) == MZ_ZIP_FILE_WRITE_FAILED) ? Result_FailedToAllocateMemory : Result_Failure;
+	}
+	if (archive->writeBuffer != nullptr && (uxx)archive->size < archive->writeBufferSize && CanArenaFree(archive->arena))
+	{
+		//Shrink to fit so the caller can free the contents using contentsOut->length
+		u8* shrunkBuffer = (u8*)ReallocMem(archive->arena, archive->writeBuffer, archive->writeBufferSize, (uxx)archive->size);
+		if (shrunkBuffer != nullptr) { archive->writeBuffer = shrunkBuffer; archive->writeBufferSize = (uxx)archive->size; }
+	}
+	*contentsOut = MakeSlice((uxx)archive->size, archive->writeBuffer);
+	archive->writeBuffer = nullptr;
+	archive->writeBufferSize = 0;
+	return Result_Success;
+}
+
 //NOTE: This always allocates expectedSize from arena, when freeing the Slice don't use the length of the slice as the size
 PEXP Slice ZlibDecompressIntoArena(Arena* arena, Slice compressedBytes, uxx expectedSize)
 {
@@ -11,9 +11,11 @@ Description:
 
 #include "os/os_atomics.h"
 #include "os/os_clipboard.h"
+#include "os/os_dir_walk.h"
 #include "os/os_dll.h"
 #include "os/os_error.h"
 #include "os/os_file.h"
+#include "os/os_file_async.h"
 #include "os/os_file_dialog.h"
 #include "os/os_font.h"
 #include "os/os_http.h"
@@ -0,0 +1,486 @@
+/*
+File:   os_dir_walk.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** OsWalkDirectory recursively enumerates a folder and hands back every file and subfolder
+	** (relative path, isFolder, size, write time) packed into a few large OsDirWalkBatch allocations,
+	** so callers don't need to re-stat each file or free thousands of tiny path allocations.
+	** When given a ThreadPool the subfolders are fanned out across the pool's threads (the calling thread works too).
+	** On Linux folders are read with getdents64 and stat'd with fstatat relative to the open folder,
+	** on Windows FindFirstFileExA already gives us the size and write time for free.
+	** NOTE: When walking with a ThreadPool the order of the entries is not deterministic
+*/
+
+#ifndef _OS_DIR_WALK_H
+#define _OS_DIR_WALK_H
+
+#include "base/base_compiler_check.h"
+#include "base/base_defines_check.h"
+#include "base/base_typedefs.h"
+#include "base/base_assert.h"
+#include "base/base_macros.h"
+#include "std/std_includes.h"
+#include "std/std_memset.h"
+#include "std/std_malloc.h"
+#include "std/std_basic_math.h"
+#include "os/os_threading.h"
+#include "os/os_thread_pool.h"
+#include "os/os_sleep.h"
+#include "os/os_path.h"
+#include "os/os_file.h"
+#include "mem/mem_arena.h"
+#include "mem/mem_scratch.h"
+#include "struct/struct_string.h"
+#include "struct/struct_var_array.h"
+#include "misc/misc_result.h"
+
+#if TARGET_HAS_THREADING
+
+#define OS_DIR_WALK_MAX_PATH_LENGTH       4096 //bytes, entries with longer full paths are skipped
+#define OS_DIR_WALK_BATCH_NUM_ENTRIES     512
+#define OS_DIR_WALK_BATCH_CHARS_SIZE      Kilobytes(24)
+#define OS_DIR_WALK_DIRENT_BUFFER_SIZE    Kilobytes(16)
+#define OS_DIR_WALK_MAX_HELPERS           32 //max number of ThreadPool work items a single walk will queue
+
+typedef plex OsDirWalkEntry OsDirWalkEntry;
+plex OsDirWalkEntry
+{
+	FilePath path; //relative to OsDirWalk.rootPath, uses forward slashes and has a null-term, points into the batch's chars
+	bool isFolder;
+	u64 size; //0 for folders
+	OsFileWriteTime writeTime;
+};
+
+typedef plex OsDirWalkBatch OsDirWalkBatch;
+plex OsDirWalkBatch
+{
+	OsDirWalkBatch* next;
+	uxx allocSize;
+	uxx numEntries;
+	uxx maxEntries;
+	OsDirWalkEntry* entries;
+	uxx charsUsed;
+	uxx charsSize;
+	char* chars;
+};
+
+//NOTE: When walking with a ThreadPool this is called from multiple threads at once, so it must be thread-safe.
+//      Returning true for a folder skips the folder AND everything inside it
+#define OS_DIR_WALK_EXCLUDE_FUNC_DEF(functionName) bool functionName(FilePath fullPath, FilePath relativePath, bool isFolder, void* contextPntr)
+typedef OS_DIR_WALK_EXCLUDE_FUNC_DEF(OsDirWalkExcludeFunc_f);
+
+typedef plex OsDirWalkFolder OsDirWalkFolder;
+plex OsDirWalkFolder
+{
+	FilePath relativePath; //empty for the root folder
+	uxx depth;
+};
+
+typedef plex OsDirWalk OsDirWalk;
+plex OsDirWalk
+{
+	Arena* arena;
+	FilePath rootPath; //full path without a trailing slash, has a null-term
+	uxx maxDepth; //0 means no limit, otherwise folders at depth >= maxDepth are listed but not searched
+	OsDirWalkExcludeFunc_f* excludeFunc;
+	void* excludeContext;
+	
+	Result error; //Success, FileNotFound (rootPath couldn't be opened), Partial (some subfolder couldn't be opened or a path was too long) or FailedToAllocateMemory
+	uxx numFiles;
+	uxx numFolders;
+	uxx numFoldersSearched;
+	uxx numFailedFolders;
+	uxx numEntries;
+	uxx numBatches;
+	OsDirWalkBatch* firstBatch;
+	OsDirWalkBatch* lastBatch;
+	
+	//Only used while the walk is running
+	Mutex mutex;
+	Arena pendingArena; //std heap, keeps the growing pendingFolders array out of arena (which may be a stack that can't free)
+	VarArray pendingFolders; //OsDirWalkFolder
+	uxx numBusyWorkers;
+	bool outOfMemory;
+	bool pathTooLong;
+};
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	void FreeOsDirWalk(OsDirWalk* walk);
+	Result OsWalkDirectory(Arena* arena, FilePath folderPath, uxx maxDepth, OsDirWalkExcludeFunc_f* excludeFunc, void* excludeContext, ThreadPool* pool, OsDirWalk* walkOut);
+#endif
+
+//NOTE: Gives an OsDirWalkEntry* named entryName, use like: OsDirWalkLoop(&walk, entry) { ... }
+#define OsDirWalkLoop(walkPntr, entryName)                                                                                   \
+	for (OsDirWalkBatch* entryName##_batch = (walkPntr)->firstBatch; entryName##_batch != nullptr; entryName##_batch = entryName##_batch->next) \
+	for (OsDirWalkEntry* entryName = &entryName##_batch->entries[0]; entryName < &entryName##_batch->entries[entryName##_batch->numEntries]; entryName++)
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+#if TARGET_IS_LINUX
+//NOTE: glibc doesn't expose a struct for the records getdents64 gives back, this matches the kernel's linux_dirent64
+typedef plex OsLinuxDirent64 OsLinuxDirent64;
+plex OsLinuxDirent64
+{
+	u64 d_ino;
+	i64 d_off;
+	u16 d_reclen;
+	u8 d_type;
+	char d_name[1];
+};
+#endif
+
+//State that each thread keeps to itself while taking part in a walk
+typedef plex OsDirWalkWorker OsDirWalkWorker;
+plex OsDirWalkWorker
+{
+	OsDirWalkBatch* batch;
+	uxx pathLength;
+	char path[OS_DIR_WALK_MAX_PATH_LENGTH]; //rootPath + "/" + relative path of the current entry
+};
+
+PEXP void FreeOsDirWalk(OsDirWalk* walk)
+{
+	NotNull(walk);
+	if (walk->arena != nullptr && CanArenaFree(walk->arena))
+	{
+		OsDirWalkBatch* batch = walk->firstBatch;
+		while (batch != nullptr)
+		{
+			OsDirWalkBatch* nextBatch = batch->next;
+			FreeMem(walk->arena, batch, batch->allocSize);
+			batch = nextBatch;
+		}
+		FreeStr8WithNt(walk->arena, &walk->rootPath);
+	}
+	ClearPointer(walk);
+}
+
+//NOTE: walk->mutex must be locked
+static OsDirWalkBatch* OsDirWalkAllocBatch(OsDirWalk* walk, uxx minCharsSize)
+{
+	uxx charsSize = MaxUXX(OS_DIR_WALK_BATCH_CHARS_SIZE, minCharsSize);
+	uxx allocSize = sizeof(OsDirWalkBatch) + (OS_DIR_WALK_BATCH_NUM_ENTRIES * sizeof(OsDirWalkEntry)) + charsSize;
+	OsDirWalkBatch* batch = (OsDirWalkBatch*)AllocMemAligned(walk->arena, allocSize, (uxx)sizeof(u64));
+	if (batch == nullptr) { walk->outOfMemory = true; return nullptr; }
+	ClearPointer(batch);
+	batch->allocSize = allocSize;
+	batch->maxEntries = OS_DIR_WALK_BATCH_NUM_ENTRIES;
+	batch->entries = (OsDirWalkEntry*)(batch + 1);
+	batch->charsSize = charsSize;
+	batch->chars = (char*)(batch->entries + batch->maxEntries);
+	return batch;
+}
+
+static void OsDirWalkFinishBatch(OsDirWalk* walk, OsDirWalkBatch* batch)
+{
+	LockMutexBlock(&walk->mutex, TIMEOUT_FOREVER)
+	{
+		if (walk->lastBatch != nullptr) { walk->lastBatch->next = batch; }
+		else { walk->firstBatch = batch; }
+		walk->lastBatch = batch;
+		walk->numBatches++;
+	}
+}
+
+static OsDirWalkEntry* OsDirWalkAddEntry(OsDirWalk* walk, OsDirWalkWorker* worker, Str8 relativePath)
+{
+	OsDirWalkBatch* batch = worker->batch;
+	if (batch == nullptr || batch->numEntries >= batch->maxEntries || batch->charsSize - batch->charsUsed < relativePath.length+1)
+	{
+		if (batch != nullptr) { OsDirWalkFinishBatch(walk, batch); }
+		batch = nullptr;
+		LockMutexBlock(&walk->mutex, TIMEOUT_FOREVER) { batch = OsDirWalkAllocBatch(walk, relativePath.length+1); }
+		worker->batch = batch;
+		if (batch == nullptr) { return nullptr; }
+	}
+	OsDirWalkEntry* entry = &batch->entries[batch->numEntries];
+	batch->numEntries++;
+	ClearPointer(entry);
+	entry->path = MakeFilePath(relativePath.length, &batch->chars[batch->charsUsed]);
+	MyMemCopy(entry->path.chars, relativePath.chars, relativePath.length);
+	entry->path.chars[relativePath.length] = '\0';
+	batch->charsUsed += relativePath.length+1;
+	return entry;
+}
+
+//Called for every item found in a folder. worker->path holds the folder's path (with a trailing slash) up to folderPathLength
+static void OsDirWalkVisit(OsDirWalk* walk, OsDirWalkWorker* worker, const OsDirWalkFolder* folder, uxx folderPathLength, Str8 name, bool isFolder, bool canSearch, u64 size, OsFileWriteTime writeTime)
+{
+	if (folderPathLength + name.length + 1 > OS_DIR_WALK_MAX_PATH_LENGTH) { walk->pathTooLong = true; return; }
+	MyMemCopy(&worker->path[folderPathLength], name.chars, name.length);
+	worker->pathLength = folderPathLength + name.length;
+	worker->path[worker->pathLength] = '\0';
+	
+	FilePath fullPath = MakeFilePath(worker->pathLength, &worker->path[0]);
+	FilePath relativePath = StrSliceFrom(fullPath, walk->rootPath.length+1);
+	if (walk->excludeFunc != nullptr && walk->excludeFunc(fullPath, relativePath, isFolder, walk->excludeContext)) { return; }
+	
+	OsDirWalkEntry* entry = OsDirWalkAddEntry(walk, worker, relativePath);
+	if (entry == nullptr) { return; }
+	entry->isFolder = isFolder;
+	entry->size = isFolder ? 0 : size;
+	entry->writeTime = writeTime;
+	
+	if (isFolder && canSearch && (walk->maxDepth == 0 || folder->depth+1 < walk->maxDepth))
+	{
+		OsDirWalkFolder subFolder = ZEROED;
+		subFolder.relativePath = entry->path;
+		subFolder.depth = folder->depth+1;
+		LockMutexBlock(&walk->mutex, TIMEOUT_FOREVER) { VarArrayAddValue(OsDirWalkFolder, &walk->pendingFolders, subFolder); }
+	}
+}
+
+#if (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+static void OsDirWalkVisitStat(OsDirWalk* walk, OsDirWalkWorker* worker, const OsDirWalkFolder* folder, uxx folderPathLength, int folderFd, Str8 name, bool isSymLink)
+{
+	plex stat statStruct = ZEROED;
+	if (fstatat(folderFd, name.chars, &statStruct, 0) != 0) { return; } //most likely a dangling symlink
+	bool isFolder = S_ISDIR(statStruct.st_mode);
+	if (!isFolder && !S_ISREG(statStruct.st_mode)) { return; } //skip sockets, pipes, devices, etc.
+	OsFileWriteTime writeTime = ZEROED;
+	#if TARGET_IS_OSX
+	writeTime.timeSpec = statStruct.st_mtimespec;
+	#else
+	writeTime.timeSpec = statStruct.st_mtim;
+	#endif
+	//NOTE: Symlinked folders are listed but not searched so a link back up the tree can't send us in circles
+	OsDirWalkVisit(walk, worker, folder, folderPathLength, name, isFolder, !isSymLink, (u64)statStruct.st_size, writeTime);
+}
+#endif
+
+//Returns false if the folder couldn't be opened
+static bool OsDirWalkSearchFolder(OsDirWalk* walk, OsDirWalkWorker* worker, const OsDirWalkFolder* folder)
+{
+	uxx rootLength = walk->rootPath.length;
+	uxx folderPathLength = rootLength + 1 + folder->relativePath.length + ((folder->relativePath.length > 0) ? 1 : 0);
+	if (folderPathLength + 2 > OS_DIR_WALK_MAX_PATH_LENGTH) { walk->pathTooLong = true; return true; }
+	MyMemCopy(&worker->path[0], walk->rootPath.chars, rootLength);
+	worker->path[rootLength] = '/';
+	if (folder->relativePath.length > 0)
+	{
+		MyMemCopy(&worker->path[rootLength+1], folder->relativePath.chars, folder->relativePath.length);
+		worker->path[folderPathLength-1] = '/';
+	}
+	worker->path[folderPathLength] = '\0';
+	
+	#if TARGET_IS_WINDOWS
+	{
+		worker->path[folderPathLength] = '*';
+		worker->path[folderPathLength+1] = '\0';
+		WIN32_FIND_DATAA findData;
+		HANDLE findHandle = FindFirstFileExA(
+			&worker->path[0], //lpFileName
+			FindExInfoBasic, //fInfoLevelId (we don't need the 8.3 short names)
+			&findData, //lpFindFileData
+			FindExSearchNameMatch, //fSearchOp
+			nullptr, //lpSearchFilter
+			FIND_FIRST_EX_LARGE_FETCH //dwAdditionalFlags
+		);
+		if (findHandle == INVALID_HANDLE_VALUE) { return false; }
+		do
+		{
+			Str8 name = MakeStr8Nt(findData.cFileName);
+			if (StrExactEquals(name, StrLit(".")) || StrExactEquals(name, StrLit(".."))) { continue; } //ignore current and parent folder entries
+			bool isFolder = IsFlagSet(findData.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
+			bool isReparsePoint = IsFlagSet(findData.dwFileAttributes, FILE_ATTRIBUTE_REPARSE_POINT);
+			OsFileWriteTime writeTime = ZEROED;
+			writeTime.fileTime = findData.ftLastWriteTime;
+			u64 size = ((u64)findData.nFileSizeHigh << 32) | (u64)findData.nFileSizeLow;
+			//NOTE: Junctions and symlinked folders are listed but not searched so a link back up the tree can't send us in circles
+			OsDirWalkVisit(walk, worker, folder, folderPathLength, name, isFolder, !isReparsePoint, size, writeTime);
+		} while (FindNextFileA(findHandle, &findData));
+		FindClose(findHandle);
+		return true;
+	}
+	#elif TARGET_IS_LINUX
+	{
+		int folderFd = open(&worker->path[0], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (folderFd < 0) { return false; }
+		u8 direntBuffer[OS_DIR_WALK_DIRENT_BUFFER_SIZE];
+		while (true)
+		{
+			long numBytesRead = syscall(SYS_getdents64, folderFd, &direntBuffer[0], sizeof(direntBuffer));
+			if (numBytesRead <= 0) { break; }
+			long offset = 0;
+			while (offset < numBytesRead)
+			{
+				OsLinuxDirent64* dirent = (OsLinuxDirent64*)&direntBuffer[offset];
+				offset += dirent->d_reclen;
+				Str8 name = MakeStr8Nt(&dirent->d_name[0]);
+				if (StrExactEquals(name, StrLit(".")) || StrExactEquals(name, StrLit(".."))) { continue; }
+				OsDirWalkVisitStat(walk, worker, folder, folderPathLength, folderFd, name, (dirent->d_type == DT_LNK));
+			}
+		}
+		close(folderFd);
+		return true;
+	}
+	#elif (TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		DIR* dirHandle = opendir(&worker->path[0]);
+		if (dirHandle == nullptr) { return false; }
+		int folderFd = dirfd(dirHandle);
+		plex dirent* dirEntry = nullptr;
+		while ((dirEntry = readdir(dirHandle)) != nullptr)
+		{
+			Str8 name = MakeStr8Nt(&dirEntry->d_name[0]);
+			if (StrExactEquals(name, StrLit(".")) || StrExactEquals(name, StrLit(".."))) { continue; }
+			OsDirWalkVisitStat(walk, worker, folder, folderPathLength, folderFd, name, (dirEntry->d_type == DT_LNK));
+		}
+		closedir(dirHandle);
+		return true;
+	}
+	#else
+	UNUSED(walk);
+	UNUSED(folder);
+	AssertMsg(false, "OsWalkDirectory does not support the current platform yet!");
+	return false;
+	#endif
+}
+
+//Pulls folders off walk->pendingFolders until there are none left AND no other thread is busy searching a folder (which could add more)
+static void OsDirWalkRun(OsDirWalk* walk)
+{
+	OsDirWalkWorker* worker = (OsDirWalkWorker*)MyMalloc(sizeof(OsDirWalkWorker));
+	if (worker == nullptr) { walk->outOfMemory = true; return; }
+	ClearPointer(worker);
+	while (true)
+	{
+		OsDirWalkFolder folder = ZEROED;
+		bool gotFolder = false;
+		bool isFinished = false;
+		LockMutexBlock(&walk->mutex, TIMEOUT_FOREVER)
+		{
+			if (walk->pendingFolders.length > 0 && !walk->outOfMemory)
+			{
+				folder = VarArrayPop(OsDirWalkFolder, &walk->pendingFolders);
+				walk->numBusyWorkers++;
+				gotFolder = true;
+			}
+			else if (walk->numBusyWorkers == 0) { isFinished = true; }
+		}
+		if (isFinished) { break; }
+		if (!gotFolder) { OsSleepMs(1); continue; }
+		
+		bool openedFolder = OsDirWalkSearchFolder(walk, worker, &folder);
+		LockMutexBlock(&walk->mutex, TIMEOUT_FOREVER)
+		{
+			if (openedFolder) { walk->numFoldersSearched++; }
+			else { walk->numFailedFolders++; }
+			walk->numBusyWorkers--;
+		}
+	}
+	if (worker->batch != nullptr) { OsDirWalkFinishBatch(walk, worker->batch); }
+	MyFree(worker);
+}
+
+static THREAD_POOL_WORK_ITEM_FUNC_DEF(OsDirWalkWorkItem)
+{
+	UNUSED(thread);
+	OsDirWalk* walk = (OsDirWalk*)workItem->subject.pntr;
+	OsDirWalkRun(walk);
+	return Result_Success;
+}
+
+//NOTE: Pass nullptr for pool to walk on the calling thread only. The pool can be shared with other work,
+//      any of its threads that are idle (or become idle) while we walk will help out. Our helper work items are
+//      private so another thread calling GetFinishedThreadPoolWorkItem on the same pool won't take them
+PEXP Result OsWalkDirectory(Arena* arena, FilePath folderPath, uxx maxDepth, OsDirWalkExcludeFunc_f* excludeFunc, void* excludeContext, ThreadPool* pool, OsDirWalk* walkOut)
+{
+	NotNull(arena);
+	NotNullStr(folderPath);
+	NotNull(walkOut);
+	ClearPointer(walkOut);
+	walkOut->arena = arena;
+	walkOut->maxDepth = maxDepth;
+	walkOut->excludeFunc = excludeFunc;
+	walkOut->excludeContext = excludeContext;
+	
+	ScratchBegin1(scratch, arena);
+	FilePath fullPath = OsGetFullPath(scratch, folderPath);
+	if (DoesPathHaveTrailingSlash(fullPath)) { fullPath.length--; }
+	walkOut->rootPath = AllocStrAndCopy(arena, fullPath.length, fullPath.chars, true);
+	ScratchEnd(scratch);
+	if (walkOut->rootPath.chars == nullptr) { walkOut->error = Result_FailedToAllocateMemory; return walkOut->error; }
+	
+	InitMutex(&walkOut->mutex);
+	InitArenaStdHeap(&walkOut->pendingArena);
+	InitVarArrayWithInitial(OsDirWalkFolder, &walkOut->pendingFolders, &walkOut->pendingArena, 64);
+	OsDirWalkFolder rootFolder = ZEROED;
+	rootFolder.relativePath = Str8_Empty;
+	rootFolder.depth = 0;
+	VarArrayAddValue(OsDirWalkFolder, &walkOut->pendingFolders, rootFolder);
+	
+	uxx numHelpers = 0;
+	ThreadPoolWorkItem* helperItems[OS_DIR_WALK_MAX_HELPERS];
+	uxx helperItemIds[OS_DIR_WALK_MAX_HELPERS];
+	if (pool != nullptr)
+	{
+		numHelpers = MinUXX(pool->threads.length, OS_DIR_WALK_MAX_HELPERS);
+		for (uxx hIndex = 0; hIndex < numHelpers; hIndex++)
+		{
+			WorkSubject subject = ZEROED;
+			subject.pntr = walkOut;
+			helperItems[hIndex] = AddWorkItemToThreadPoolEx(pool, OsDirWalkWorkItem, &subject, true);
+			NotNull(helperItems[hIndex]);
+			helperItemIds[hIndex] = helperItems[hIndex]->id;
+		}
+	}
+	
+	OsDirWalkRun(walkOut);
+	
+	if (pool != nullptr)
+	{
+		//Helpers that no thread got around to claiming are marked done here (under the pool's mutex, the same way a thread claims an item)
+		LockMutexBlock(&pool->workItemsMutex, TIMEOUT_FOREVER)
+		{
+			for (uxx hIndex = 0; hIndex < numHelpers; hIndex++)
+			{
+				ThreadPoolWorkItem* item = helperItems[hIndex];
+				if (item->id == helperItemIds[hIndex] && !item->isWorking && !item->isDone && item->workerThreadId == THREAD_POOL_ID_INVALID)
+				{
+					item->result = Result_Canceled;
+					item->isDone = true;
+				}
+			}
+		}
+		for (uxx hIndex = 0; hIndex < numHelpers; hIndex++)
+		{
+			ThreadPoolWorkItem* item = helperItems[hIndex];
+			while (!item->isDone) { OsSleepMs(1); }
+			FreeThreadPoolWorkItem(pool, item);
+		}
+	}
+	
+	FreeVarArray(&walkOut->pendingFolders);
+	DestroyMutex(&walkOut->mutex);
+	ClearStruct(walkOut->pendingArena);
+	
+	for (OsDirWalkBatch* batch = walkOut->firstBatch; batch != nullptr; batch = batch->next)
+	{
+		for (uxx eIndex = 0; eIndex < batch->numEntries; eIndex++)
+		{
+			if (batch->entries[eIndex].isFolder) { walkOut->numFolders++; }
+			else { walkOut->numFiles++; }
+		}
+		walkOut->numEntries += batch->numEntries;
+	}
+	
+	if (walkOut->outOfMemory) { walkOut->error = Result_FailedToAllocateMemory; }
+	else if (walkOut->numFoldersSearched == 0) { walkOut->error = Result_FileNotFound; }
+	else if (walkOut->numFailedFolders > 0 || walkOut->pathTooLong) { walkOut->error = Result_Partial; }
+	else { walkOut->error = Result_Success; }
+	return walkOut->error;
+}
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //TARGET_HAS_THREADING
+
+#endif //  _OS_DIR_WALK_H
@@ -4,6 +4,9 @@ Author: Taylor Robbins
 Date:   01\06\2025
 Description:
 	** Contains functions that help us open, read, write, delete, and iterate files and folders
+	** OsWriteFileAtomic replaces a file through a temporary file + flush + rename so a crash leaves either the old or the new contents.
+	** Files opened with OsOpenFileMode_ReadWrite can be read and written at any offset (OsReadFromOpenFileAt/OsWriteToOpenFileAt)
+	** from multiple threads at once, and OsSyncOpenFile makes those writes durable
 */
 
 #ifndef _OS_FILE_H
@@ -14,6 +17,8 @@ Description:
 #include "base/base_typedefs.h"
 #include "base/base_macros.h"
 #include "std/std_includes.h"
+#include "std/std_printf.h"
+#include "std/std_basic_math.h"
 #include "struct/struct_string.h"
 #include "mem/mem_scratch.h"
 #include "base/base_debug_output.h" //TODO: Remove the need for debug output in this file? Return Result values instead!
@@ -64,6 +69,7 @@ enum OsOpenFileMode
 	OsOpenFileMode_Create, //Opens a NEW file for writing (fails if the file already exists)
 	OsOpenFileMode_Write, //Opens a file for writing (clearing the contents if it already existed)
 	OsOpenFileMode_Append, //Opens a file for writing, jumping to the end if it already exists (creating a new file if it doesn't exist)
+	OsOpenFileMode_ReadWrite, //Opens a file for reading and writing, keeping the contents if it already exists (creating a new file if it doesn't exist). Meant for OsReadFromOpenFileAt/OsWriteToOpenFileAt
 	//TODO: Do we want a mode where we open for appending but ONLY if the file exists?
 	OsOpenFileMode_Count,
 };
@@ -80,6 +86,7 @@ PEXP const char* GetOsOpenFileModeStr(OsOpenFileMode enumValue)
 		case OsOpenFileMode_Create:    return "Create";
 		case OsOpenFileMode_Write:     return "Write";
 		case OsOpenFileMode_Append:    return "Append";
+		case OsOpenFileMode_ReadWrite: return "ReadWrite";
 		default: return UNKNOWN_STR;
 	}
 }
@@ -116,6 +123,46 @@ plex OsFileWriteTime
 	#endif
 };
 
+//NOTE: These are hints to the OS about how we plan to touch the pages of a mapped file,
+//      they map to madvise on POSIX and FILE_FLAG_SEQUENTIAL_SCAN/FILE_FLAG_RANDOM_ACCESS/PrefetchVirtualMemory on Windows
+typedef enum OsMapFileAccess OsMapFileAccess;
+enum OsMapFileAccess
+{
+	OsMapFileAccess_Normal = 0, //No hint, let the OS decide how much to read ahead
+	OsMapFileAccess_Sequential, //We are going to read front to back once (aggressive read ahead, pages can be dropped after use)
+	OsMapFileAccess_Random, //We are going to jump around (little or no read ahead)
+	OsMapFileAccess_WillNeed, //We are going to touch the whole file soon, start paging it in now
+	OsMapFileAccess_Count,
+};
+#if !PIG_CORE_IMPLEMENTATION
+const char* GetOsMapFileAccessStr(OsMapFileAccess enumValue);
+#else
+PEXP const char* GetOsMapFileAccessStr(OsMapFileAccess enumValue)
+{
+	switch (enumValue)
+	{
+		case OsMapFileAccess_Normal:     return "Normal";
+		case OsMapFileAccess_Sequential: return "Sequential";
+		case OsMapFileAccess_Random:     return "Random";
+		case OsMapFileAccess_WillNeed:   return "WillNeed";
+		default: return UNKNOWN_STR;
+	}
+}
+#endif
+
+typedef plex OsMappedFile OsMappedFile;
+plex OsMappedFile
+{
+	bool isMapped;
+	u64 size;
+	Slice contents; //read-only! Writing through this pointer will crash
+	
+	#if TARGET_IS_WINDOWS
+	HANDLE fileHandle;
+	HANDLE mappingHandle;
+	#endif
+};
+
 // +--------------------------------------------------------------+
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
@@ -136,9 +183,12 @@ plex OsFileWriteTime
 	PIG_CORE_INLINE Slice OsReadFileScratch(FilePath path, bool convertNewLines);
 	PIG_CORE_INLINE Str8 OsReadTextFileScratch(FilePath path);
 	PIG_CORE_INLINE Slice OsReadBinFileScratch(FilePath path);
+	void OsUnmapFile(OsMappedFile* mappedFile);
+	Result OsMapFile(FilePath path, OsMapFileAccess access, OsMappedFile* mappedFileOut);
 	bool OsWriteFile(FilePath path, Str8 fileContents, bool convertNewLines);
 	PIG_CORE_INLINE bool OsWriteTextFile(FilePath path, Str8 fileContents);
 	PIG_CORE_INLINE bool OsWriteBinFile(FilePath path, Str8 fileContents);
+	Result OsWriteFileAtomic(FilePath path, Slice fileContents, bool convertNewLines);
 	PIG_CORE_INLINE bool OsCopyFile(FilePath fromPath, FilePath toPath);
 	Result OsCreateFolder(FilePath path, bool createParentFoldersIfNeeded);
 	void OsCloseFile(OsFile* file);
@@ -149,7 +199,13 @@ plex OsFileWriteTime
 	bool OsWriteToOpenFile(OsFile* file, Str8 fileContentsPart, bool convertNewLines);
 	PIG_CORE_INLINE bool OsWriteToOpenTextFile(OsFile* file, Str8 fileContentsPart);
 	PIG_CORE_INLINE bool OsWriteToOpenBinFile(OsFile* file, Str8 fileContentsPart);
-	Result OsGetFileWriteTime(FilePath filePath, OsFileWriteTime* timeOut);
+	Result OsReadFromOpenFileAt(OsFile* file, u64 offset, uxx numBytes, void* bufferOut, uxx* numBytesReadOut);
+	Result OsWriteToOpenFileAt(OsFile* file, u64 offset, Slice contents);
+	Result OsGetOpenFileSize(OsFile* file, u64* sizeOut);
+	Result OsPreallocateOpenFile(OsFile* file, u64 numBytes);
+	Result OsSyncOpenFile(OsFile* file);
+	Result OsGetFileWriteTimeAndSize(FilePath filePath, OsFileWriteTime* timeOut, u64* sizeOut);
+	PIG_CORE_INLINE Result OsGetFileWriteTime(FilePath filePath, OsFileWriteTime* timeOut);
 	PIG_CORE_INLINE i32 OsCompareFileWriteTime(OsFileWriteTime left, OsFileWriteTime right);
 	PIG_CORE_INLINE bool OsAreFileWriteTimesEqual(OsFileWriteTime left, OsFileWriteTime right);
 #endif //!PIG_CORE_IMPLEMENTATION
@@ -689,19 +745,19 @@ PEXP bool OsReadFile(FilePath path, Arena* arena, bool convertNewLines, Slice* c
 			return false;
 		}
 		
-		fseek(fileHandle, 0, SEEK_END);
-		int fileSizeInt = ftell(fileHandle);
-		DebugAssert(fileSizeInt >= 0);
-		if ((unsigned int)fileSizeInt > (unsigned int)UINTXX_MAX)
+		//NOTE: ftell returns a long which is only 32-bits on some targets, ftello gives us a 64-bit off_t
+		fseeko(fileHandle, 0, SEEK_END);
+		i64 fileSizeI64 = (i64)ftello(fileHandle);
+		if (fileSizeI64 < 0 || (u64)fileSizeI64 >= (u64)UINTXX_MAX)
 		{
-			NotifyPrint_E("File is %d bytes, too big for uxx type!", fileSizeInt);
+			NotifyPrint_E("File is %lld bytes, too big for uxx type!", (long long)fileSizeI64);
 			fclose(fileHandle);
 			ScratchEnd(scratch);
 			return false;
 		}
 		rewind(fileHandle);
 		
-		contentsOut->length = (uxx)fileSizeInt;
+		contentsOut->length = (uxx)fileSizeI64;
 		contentsOut->chars = (char*)AllocMem(convertNewLines ? scratch : arena, contentsOut->length+1);
 		AssertMsg(contentsOut->chars != nullptr, "Failed to allocate space to hold file contents. The application probably tried to open a massive file");
 		
@@ -722,6 +778,7 @@ PEXP bool OsReadFile(FilePath path, Arena* arena, bool convertNewLines, Slice* c
 			return false;
 		}
 		
+		fclose(fileHandle);
 		contentsOut->chars[contentsOut->length] = '\0';
 		
 		if (convertNewLines)
@@ -756,6 +813,149 @@ PEXPI Slice OsReadBinFileScratch(FilePath path) { return OsReadFileScratch(path,
 
 //TODO: Can we do some sort of asynchronous file read? Like kick off the read and get a callback later?
 
+// +--------------------------------------------------------------+
+// |                         Mapped Files                         |
+// +--------------------------------------------------------------+
+PEXP void OsUnmapFile(OsMappedFile* mappedFile)
+{
+	NotNull(mappedFile);
+	#if TARGET_IS_WINDOWS
+	{
+		if (mappedFile->contents.bytes != nullptr && mappedFile->contents.length > 0) { UnmapViewOfFile(mappedFile->contents.bytes); }
+		if (mappedFile->mappingHandle != NULL) { CloseHandle(mappedFile->mappingHandle); }
+		if (mappedFile->fileHandle != NULL && mappedFile->fileHandle != INVALID_HANDLE_VALUE) { CloseHandle(mappedFile->fileHandle); }
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		if (mappedFile->contents.bytes != nullptr && mappedFile->contents.length > 0) { munmap(mappedFile->contents.bytes, (size_t)mappedFile->contents.length); }
+	}
+	#endif
+	ClearPointer(mappedFile);
+}
+
+//NOTE: Maps the entire file into our address space as read-only. Pages are only read from disk as they are touched
+//      so this is much cheaper than OsReadFile for large files that we only look at part of, and it shares the OS's page cache.
+//      The contents are NOT null-terminated and an empty file gives an empty Slice (with isMapped still set to true)
+//      Files that are larger than our address space (>4GB on 32-bit targets) return Result_TooLong
+PEXP Result OsMapFile(FilePath path, OsMapFileAccess access, OsMappedFile* mappedFileOut)
+{
+	//NOTE: This function should be multi-thread safe!
+	NotNullStr(path);
+	NotNull(mappedFileOut);
+	ClearPointer(mappedFileOut);
+	Result result = Result_None;
+	ScratchBegin(scratch);
+	
+	#if TARGET_IS_WINDOWS
+	{
+		Str8 fullPath = OsGetFullPath(scratch, path); //ensures null-termination
+		ChangePathSlashesTo(fullPath, '\\');
+		
+		DWORD flagsAndAttributes = FILE_ATTRIBUTE_NORMAL;
+		if (access == OsMapFileAccess_Sequential) { flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN; }
+		if (access == OsMapFileAccess_Random) { flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS; }
+		mappedFileOut->fileHandle = CreateFileA(
+			fullPath.chars,     //lpFileName
+			GENERIC_READ,       //dwDesiredAccess
+			FILE_SHARE_READ,    //dwShareMode
+			NULL,               //lpSecurityAttributes (NULL: no sub process access)
+			OPEN_EXISTING,      //dwCreationDisposition
+			flagsAndAttributes, //dwFlagsAndAttributes
+			NULL                //hTemplateFile
+		);
+		if (mappedFileOut->fileHandle == INVALID_HANDLE_VALUE)
+		{
+			DWORD errorCode = GetLastError();
+			mappedFileOut->fileHandle = NULL;
+			ScratchEnd(scratch);
+			return (errorCode == ERROR_FILE_NOT_FOUND || errorCode == ERROR_PATH_NOT_FOUND) ? Result_FileNotFound : Result_FailedToReadFile;
+		}
+		
+		LARGE_INTEGER fileSizeLargeInt;
+		if (GetFileSizeEx(mappedFileOut->fileHandle, &fileSizeLargeInt) == 0) { OsUnmapFile(mappedFileOut); ScratchEnd(scratch); return Result_FailedToReadFile; }
+		u64 fileSize = (u64)fileSizeLargeInt.QuadPart;
+		if (fileSize > (u64)UINTXX_MAX) { OsUnmapFile(mappedFileOut); ScratchEnd(scratch); return Result_TooLong; }
+		mappedFileOut->size = fileSize;
+		
+		//NOTE: CreateFileMappingA fails on empty files, so there's nothing else to do for those
+		if (fileSize > 0)
+		{
+			mappedFileOut->mappingHandle = CreateFileMappingA(
+				mappedFileOut->fileHandle, //hFile
+				NULL, //lpFileMappingAttributes
+				PAGE_READONLY, //flProtect
+				0, //dwMaximumSizeHigh (0: size of the file)
+				0, //dwMaximumSizeLow
+				NULL //lpName
+			);
+			if (mappedFileOut->mappingHandle == NULL) { OsUnmapFile(mappedFileOut); ScratchEnd(scratch); return Result_FailedToReadFile; }
+			
+			void* viewPntr = MapViewOfFile(
+				mappedFileOut->mappingHandle, //hFileMappingObject
+				FILE_MAP_READ, //dwDesiredAccess
+				0, //dwFileOffsetHigh
+				0, //dwFileOffsetLow
+				0 //dwNumberOfBytesToMap (0: to the end of the mapping)
+			);
+			if (viewPntr == nullptr) { OsUnmapFile(mappedFileOut); ScratchEnd(scratch); return Result_FailedToReadFile; }
+			mappedFileOut->contents = MakeSlice((uxx)fileSize, viewPntr);
+			
+			#if (_WIN32_WINNT >= 0x0602) //PrefetchVirtualMemory is only available on Windows 8 and later
+			if (access == OsMapFileAccess_WillNeed)
+			{
+				WIN32_MEMORY_RANGE_ENTRY rangeEntry = { .VirtualAddress = viewPntr, .NumberOfBytes = (SIZE_T)fileSize };
+				PrefetchVirtualMemory(GetCurrentProcess(), 1, &rangeEntry, 0);
+			}
+			#endif
+		}
+		
+		mappedFileOut->isMapped = true;
+		result = Result_Success;
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		Str8 fullPath = OsGetFullPath(scratch, path); //ensures null-termination
+		int fileDescriptor = open(fullPath.chars, O_RDONLY);
+		if (fileDescriptor < 0)
+		{
+			ScratchEnd(scratch);
+			return (errno == ENOENT || errno == ENOTDIR) ? Result_FileNotFound : Result_FailedToReadFile;
+		}
+		
+		plex stat statStruct = ZEROED;
+		if (fstat(fileDescriptor, &statStruct) != 0 || !S_ISREG(statStruct.st_mode)) { close(fileDescriptor); ScratchEnd(scratch); return Result_FailedToReadFile; }
+		u64 fileSize = (u64)statStruct.st_size;
+		if (fileSize > (u64)UINTXX_MAX || fileSize > (u64)SIZE_MAX) { close(fileDescriptor); ScratchEnd(scratch); return Result_TooLong; }
+		mappedFileOut->size = fileSize;
+		
+		//NOTE: mmap fails on a length of 0, so there's nothing else to do for empty files
+		if (fileSize > 0)
+		{
+			void* mapPntr = mmap(nullptr, (size_t)fileSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+			if (mapPntr == MAP_FAILED) { close(fileDescriptor); ScratchEnd(scratch); return Result_FailedToReadFile; }
+			mappedFileOut->contents = MakeSlice((uxx)fileSize, mapPntr);
+			
+			//NOTE: madvise is only a hint, we don't care if it fails
+			if (access == OsMapFileAccess_Sequential) { madvise(mapPntr, (size_t)fileSize, MADV_SEQUENTIAL); }
+			else if (access == OsMapFileAccess_Random) { madvise(mapPntr, (size_t)fileSize, MADV_RANDOM); }
+			else if (access == OsMapFileAccess_WillNeed) { madvise(mapPntr, (size_t)fileSize, MADV_WILLNEED); }
+		}
+		
+		//NOTE: The mapping keeps its own reference to the file so we don't need to hold onto the descriptor
+		close(fileDescriptor);
+		mappedFileOut->isMapped = true;
+		result = Result_Success;
+	}
+	#else
+	UNUSED(path);
+	UNUSED(access);
+	result = Result_UnsupportedPlatform;
+	#endif
+	
+	ScratchEnd(scratch);
+	return result;
+}
+
 // +--------------------------------------------------------------+
 // |                      Write Entire File                       |
 // +--------------------------------------------------------------+
@@ -877,6 +1077,137 @@ PEXP bool OsWriteFile(FilePath path, Str8 fileContents, bool convertNewLines)
 PEXPI bool OsWriteTextFile(FilePath path, Str8 fileContents) { return OsWriteFile(path, fileContents, true); }
 PEXPI bool OsWriteBinFile(FilePath path, Str8 fileContents) { return OsWriteFile(path, fileContents, false); }
 
+#define OS_WRITE_FILE_ATOMIC_MAX_TEMP_FILES 64 //how many "[path].[pid].[N].tmp" names we try before giving up
+
+//NOTE: Unlike OsWriteFile this never leaves a half-written file at path. The contents are written to a temporary
+//      file in the same folder, flushed to disk, and then renamed over path (replacing any existing file in one step).
+//      On Linux/OSX the folder is flushed too so the rename itself survives a crash, and the old file's permissions are kept
+PEXP Result OsWriteFileAtomic(FilePath path, Slice fileContents, bool convertNewLines)
+{
+	NotNullStr(path);
+	NotNullStr(fileContents);
+	Result result = Result_None;
+	
+	#if TARGET_IS_WINDOWS
+	{
+		ScratchBegin(scratch);
+		if (convertNewLines && fileContents.length > 0)
+		{
+			fileContents = StrReplace(scratch, fileContents, StrLit("\n"), StrLit("\r\n"), false);
+			NotNullStr(fileContents);
+		}
+		
+		FilePath fullPath = OsGetFullPath(scratch, path);
+		uxx tempPathSize = fullPath.length + 32;
+		char* tempPath = (char*)AllocMem(scratch, tempPathSize);
+		NotNull(tempPath);
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		for (uxx attempt = 0; attempt < OS_WRITE_FILE_ATOMIC_MAX_TEMP_FILES; attempt++)
+		{
+			MyBufferPrintf(tempPath, tempPathSize, "%.*s.%u.%u.tmp", StrPrint(fullPath), (u32)GetCurrentProcessId(), (u32)attempt);
+			fileHandle = CreateFileA(tempPath, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle != INVALID_HANDLE_VALUE || GetLastError() != ERROR_FILE_EXISTS) { break; }
+		}
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			PrintLine_E("ERROR: Failed to create temporary file next to \"%.*s\"", StrPrint(fullPath));
+			ScratchEnd(scratch);
+			return Result_FailedToWriteFile;
+		}
+		
+		result = Result_Success;
+		uxx numBytesWritten = 0;
+		while (numBytesWritten < fileContents.length)
+		{
+			DWORD numBytesToWrite = (DWORD)MinUXX(fileContents.length - numBytesWritten, (uxx)Gigabytes(1));
+			DWORD numBytesWrittenPart = 0;
+			if (WriteFile(fileHandle, &fileContents.bytes[numBytesWritten], numBytesToWrite, &numBytesWrittenPart, NULL) == 0 || numBytesWrittenPart == 0) { result = Result_FailedToWriteFile; break; }
+			numBytesWritten += (uxx)numBytesWrittenPart;
+		}
+		if (result == Result_Success && FlushFileBuffers(fileHandle) == 0) { result = Result_FailedToWriteFile; }
+		CloseHandle(fileHandle);
+		if (result == Result_Success && MoveFileExA(tempPath, fullPath.chars, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0)
+		{
+			DWORD errorCode = GetLastError();
+			PrintLine_E("ERROR: Failed to replace \"%.*s\": %s", StrPrint(fullPath), Win32_GetErrorCodeStr(errorCode));
+			result = Result_FailedToWriteFile;
+		}
+		if (result != Result_Success) { DeleteFileA(tempPath); }
+		ScratchEnd(scratch);
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		//NOTE: Like OsWriteFile we don't need to convert new-lines outside of Windows
+		UNUSED(convertNewLines);
+		ScratchBegin(scratch);
+		FilePath fullPath = OsGetFullPath(scratch, path); //ensures null-termination
+		uxx tempPathSize = fullPath.length + 32;
+		char* tempPath = (char*)AllocMem(scratch, tempPathSize);
+		NotNull(tempPath);
+		int fileDescriptor = -1;
+		for (uxx attempt = 0; attempt < OS_WRITE_FILE_ATOMIC_MAX_TEMP_FILES; attempt++)
+		{
+			MyBufferPrintf(tempPath, tempPathSize, "%.*s.%d.%u.tmp", StrPrint(fullPath), (int)getpid(), (u32)attempt);
+			fileDescriptor = open(tempPath, O_WRONLY | O_CREAT | O_EXCL, 0666);
+			if (fileDescriptor >= 0 || errno != EEXIST) { break; }
+		}
+		if (fileDescriptor < 0)
+		{
+			PrintLine_E("ERROR: Failed to create temporary file next to \"%.*s\": %s", StrPrint(fullPath), GetErrnoStr(errno));
+			ScratchEnd(scratch);
+			return Result_FailedToWriteFile;
+		}
+		
+		struct stat oldFileStat;
+		if (stat(fullPath.chars, &oldFileStat) == 0) { fchmod(fileDescriptor, oldFileStat.st_mode & 07777); }
+		
+		result = Result_Success;
+		uxx numBytesWritten = 0;
+		while (numBytesWritten < fileContents.length)
+		{
+			ssize_t writeResult = write(fileDescriptor, &fileContents.bytes[numBytesWritten], (size_t)MinUXX(fileContents.length - numBytesWritten, (uxx)Gigabytes(1)));
+			if (writeResult < 0 && errno == EINTR) { continue; }
+			if (writeResult <= 0) { result = Result_FailedToWriteFile; break; }
+			numBytesWritten += (uxx)writeResult;
+		}
+		#if TARGET_IS_OSX
+		//NOTE: fsync on OSX only gets the data to the drive, F_FULLFSYNC asks the drive to flush its own cache
+		if (result == Result_Success && fcntl(fileDescriptor, F_FULLFSYNC) != 0 && fsync(fileDescriptor) != 0) { result = Result_FailedToWriteFile; }
+		#else
+		if (result == Result_Success && fsync(fileDescriptor) != 0) { result = Result_FailedToWriteFile; }
+		#endif
+		if (close(fileDescriptor) != 0 && result == Result_Success) { result = Result_FailedToWriteFile; }
+		if (result == Result_Success && rename(tempPath, fullPath.chars) != 0)
+		{
+			PrintLine_E("ERROR: Failed to replace \"%.*s\": %s", StrPrint(fullPath), GetErrnoStr(errno));
+			result = Result_FailedToWriteFile;
+		}
+		if (result != Result_Success) { unlink(tempPath); }
+		else
+		{
+			//The rename lives in the folder's entries, so flush the folder as well (some file systems don't allow this, which is fine)
+			uxx folderPathLength = fullPath.length;
+			while (folderPathLength > 0 && fullPath.chars[folderPathLength-1] != '/') { folderPathLength--; }
+			if (folderPathLength > 0)
+			{
+				FilePath folderPath = AllocFilePath(scratch, MakeStr8((folderPathLength > 1) ? folderPathLength-1 : folderPathLength, fullPath.chars), true);
+				int folderDescriptor = open(folderPath.chars, O_RDONLY);
+				if (folderDescriptor >= 0) { fsync(folderDescriptor); close(folderDescriptor); }
+			}
+		}
+		ScratchEnd(scratch);
+	}
+	#else
+	UNUSED(path);
+	UNUSED(fileContents);
+	UNUSED(convertNewLines);
+	AssertMsg(false, "OsWriteFileAtomic does not support the current platform yet!");
+	result = Result_UnsupportedPlatform;
+	#endif
+	
+	return result;
+}
+
 //TODO: Can we do some sort of asynchronous file write function? Like a fire and forget style thing?
 //      This would probably require the code to know if an operation on that file is already in
 //      progress, otherwise we may run into conflicts with order of operations
@@ -1020,6 +1351,7 @@ PEXP bool OsOpenFile(Arena* arena, FilePath path, OsOpenFileMode mode, bool calc
 			case OsOpenFileMode_Create: creationDisposition = CREATE_NEW;    desiredAccess |= GENERIC_WRITE; break;
 			case OsOpenFileMode_Write:  creationDisposition = CREATE_ALWAYS; desiredAccess |= GENERIC_WRITE; break;
 			case OsOpenFileMode_Append: creationDisposition = OPEN_ALWAYS;   desiredAccess |= GENERIC_WRITE; break;
+			case OsOpenFileMode_ReadWrite: creationDisposition = OPEN_ALWAYS; desiredAccess |= GENERIC_WRITE; shareMode |= FILE_SHARE_READ; break;
 			default: AssertMsg(false, "Unhandled mode passed to OsOpenFile"); break;
 		}
 		
@@ -1044,7 +1376,7 @@ PEXP bool OsOpenFile(Arena* arena, FilePath path, OsOpenFileMode mode, bool calc
 		
 		uxx fileSize = 0;
 		uxx cursorIndex = 0;
-		if (calculateSize && (mode == OsOpenFileMode_Read || mode == OsOpenFileMode_Append))
+		if (calculateSize && (mode == OsOpenFileMode_Read || mode == OsOpenFileMode_Append || mode == OsOpenFileMode_ReadWrite))
 		{
 			//Seek to the end of the file
 			LONG newCursorPosHighOrder = 0;
@@ -1130,10 +1462,22 @@ PEXP bool OsOpenFile(Arena* arena, FilePath path, OsOpenFileMode mode, bool calc
 			case OsOpenFileMode_Create: openModeStr = "w"; break;
 			case OsOpenFileMode_Write:  openModeStr = "w"; break;
 			case OsOpenFileMode_Append: openModeStr = "a"; break;
+			case OsOpenFileMode_ReadWrite: openModeStr = "r+"; break;
 			default: AssertMsg(false, "Unhandled mode passed to OsOpenFile"); break;
 		}
 		
-		FILE* fileHandle = fopen(fullPath.chars, openModeStr);
+		FILE* fileHandle = nullptr;
+		if (mode == OsOpenFileMode_ReadWrite)
+		{
+			//NOTE: "r+" fails if the file doesn't exist and "a+" forces every write to the end (even pwrite on Linux), so we open() it ourselves
+			int fileDescriptor = open(fullPath.chars, O_RDWR | O_CREAT, 0666);
+			if (fileDescriptor >= 0)
+			{
+				fileHandle = fdopen(fileDescriptor, openModeStr);
+				if (fileHandle == nullptr) { close(fileDescriptor); }
+			}
+		}
+		else { fileHandle = fopen(fullPath.chars, openModeStr); }
 		if (fileHandle == nullptr)
 		{
 			PrintLine_E("ERROR: Failed to open file for %s at \"%.*s\"", GetOsOpenFileModeStr(mode), StrPrint(fullPath));
@@ -1151,7 +1495,7 @@ PEXP bool OsOpenFile(Arena* arena, FilePath path, OsOpenFileMode mode, bool calc
 		openFileOut->path = AllocStrAndCopy(arena, path.length, path.chars, true);
 		openFileOut->fullPath = AllocStrAndCopy(arena, fullPath.length, fullPath.chars, true);
 		
-		if (calculateSize && (mode == OsOpenFileMode_Read || mode == OsOpenFileMode_Append))
+		if (calculateSize && (mode == OsOpenFileMode_Read || mode == OsOpenFileMode_Append || mode == OsOpenFileMode_ReadWrite))
 		{
 			int seekResult = fseek(fileHandle, 0, SEEK_END);
 			Assert(seekResult == 0);
@@ -1160,7 +1504,7 @@ PEXP bool OsOpenFile(Arena* arena, FilePath path, OsOpenFileMode mode, bool calc
 			Assert((unsigned long long)fileSize <= UINTXX_MAX);
 			openFileOut->fileSize = (uxx)fileSize;
 			
-			if (mode == OsOpenFileMode_Read)
+			if (mode != OsOpenFileMode_Append)
 			{
 				seekResult = fseek(fileHandle, 0, SEEK_SET); //back to the beginning of the file
 				Assert(seekResult == 0);
@@ -1382,10 +1726,226 @@ PEXPI bool OsWriteToOpenBinFile(OsFile* file, Str8 fileContentsPart) { return Os
 //TODO: Implement OsMoveFileCursorRelative
 //TODO: Implement OsMoveFileCursor
 
+// +--------------------------------------------------------------+
+// |                  Positioned Reads and Writes                 |
+// +--------------------------------------------------------------+
+//NOTE: The functions below don't use or change file->cursorIndex or file->fileSize, so they can be called from
+//      multiple threads on the same OsFile at once. On Linux/OSX they go around the FILE* buffer (pread/pwrite on its
+//      descriptor) and on Windows they move the handle's file pointer, so don't mix them with the cursor-based
+//      OsReadFromOpenFile/OsWriteToOpenFile on the same file. There is no new-line conversion.
+
+//Returns Result_Partial if the end of the file was hit part way through and Result_EndOfFile if offset is at or past the end
+PEXP Result OsReadFromOpenFileAt(OsFile* file, u64 offset, uxx numBytes, void* bufferOut, uxx* numBytesReadOut)
+{
+	NotNull(file);
+	Assert(file->isOpen);
+	Assert(bufferOut != nullptr || numBytes == 0);
+	SetOptionalOutPntr(numBytesReadOut, 0);
+	if (numBytes == 0) { return Result_Success; }
+	uxx numBytesRead = 0;
+	
+	#if TARGET_IS_WINDOWS
+	{
+		Assert(file->handle != INVALID_HANDLE_VALUE);
+		while (numBytesRead < numBytes)
+		{
+			u64 readOffset = offset + numBytesRead;
+			OVERLAPPED overlapped = ZEROED;
+			overlapped.Offset = (DWORD)(readOffset & 0xFFFFFFFFULL);
+			overlapped.OffsetHigh = (DWORD)(readOffset >> 32);
+			DWORD numBytesReadPart = 0;
+			if (ReadFile(file->handle, (u8*)bufferOut + numBytesRead, (DWORD)MinUXX(numBytes - numBytesRead, (uxx)Gigabytes(1)), &numBytesReadPart, &overlapped) == 0)
+			{
+				if (GetLastError() == ERROR_HANDLE_EOF) { break; }
+				SetOptionalOutPntr(numBytesReadOut, numBytesRead);
+				return Result_FailedToReadFile;
+			}
+			if (numBytesReadPart == 0) { break; }
+			numBytesRead += (uxx)numBytesReadPart;
+		}
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		Assert(file->handle != nullptr);
+		int fileDescriptor = fileno(file->handle);
+		while (numBytesRead < numBytes)
+		{
+			ssize_t readResult = pread(fileDescriptor, (u8*)bufferOut + numBytesRead, (size_t)MinUXX(numBytes - numBytesRead, (uxx)Gigabytes(1)), (off_t)(offset + numBytesRead));
+			if (readResult < 0 && errno == EINTR) { continue; }
+			if (readResult < 0) { SetOptionalOutPntr(numBytesReadOut, numBytesRead); return Result_FailedToReadFile; }
+			if (readResult == 0) { break; }
+			numBytesRead += (uxx)readResult;
+		}
+	}
+	#else
+	UNUSED(offset);
+	AssertMsg(false, "OsReadFromOpenFileAt does not support the current platform yet!");
+	return Result_UnsupportedPlatform;
+	#endif
+	
+	SetOptionalOutPntr(numBytesReadOut, numBytesRead);
+	if (numBytesRead == 0) { return Result_EndOfFile; }
+	return (numBytesRead < numBytes) ? Result_Partial : Result_Success;
+}
+
+//NOTE: Writing past the end of the file grows it (any gap reads back as zeros). The file must be opened for writing
+PEXP Result OsWriteToOpenFileAt(OsFile* file, u64 offset, Slice contents)
+{
+	NotNull(file);
+	NotNullStr(contents);
+	Assert(file->isOpen);
+	AssertMsg(file->openedForWriting, "OsWriteToOpenFileAt needs a file that was opened for writing");
+	uxx numBytesWritten = 0;
+	
+	#if TARGET_IS_WINDOWS
+	{
+		Assert(file->handle != INVALID_HANDLE_VALUE);
+		while (numBytesWritten < contents.length)
+		{
+			u64 writeOffset = offset + numBytesWritten;
+			OVERLAPPED overlapped = ZEROED;
+			overlapped.Offset = (DWORD)(writeOffset & 0xFFFFFFFFULL);
+			overlapped.OffsetHigh = (DWORD)(writeOffset >> 32);
+			DWORD numBytesWrittenPart = 0;
+			if (WriteFile(file->handle, &contents.bytes[numBytesWritten], (DWORD)MinUXX(contents.length - numBytesWritten, (uxx)Gigabytes(1)), &numBytesWrittenPart, &overlapped) == 0 || numBytesWrittenPart == 0)
+			{
+				return Result_FailedToWriteFile;
+			}
+			numBytesWritten += (uxx)numBytesWrittenPart;
+		}
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		Assert(file->handle != nullptr);
+		int fileDescriptor = fileno(file->handle);
+		while (numBytesWritten < contents.length)
+		{
+			ssize_t writeResult = pwrite(fileDescriptor, &contents.bytes[numBytesWritten], (size_t)MinUXX(contents.length - numBytesWritten, (uxx)Gigabytes(1)), (off_t)(offset + numBytesWritten));
+			if (writeResult < 0 && errno == EINTR) { continue; }
+			if (writeResult <= 0) { return Result_FailedToWriteFile; }
+			numBytesWritten += (uxx)writeResult;
+		}
+	}
+	#else
+	UNUSED(offset);
+	UNUSED(numBytesWritten);
+	AssertMsg(false, "OsWriteToOpenFileAt does not support the current platform yet!");
+	return Result_UnsupportedPlatform;
+	#endif
+	
+	return Result_Success;
+}
+
+//NOTE: Asks the OS for the current size, which includes anything written with OsWriteToOpenFileAt (file->fileSize does not)
+PEXP Result OsGetOpenFileSize(OsFile* file, u64* sizeOut)
+{
+	NotNull(file);
+	NotNull(sizeOut);
+	Assert(file->isOpen);
+	#if TARGET_IS_WINDOWS
+	{
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file->handle, &fileSize) == 0) { return Result_FailedToReadFile; }
+		*sizeOut = (u64)fileSize.QuadPart;
+		return Result_Success;
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		fflush(file->handle); //so bytes sitting in the FILE* buffer are counted
+		struct stat fileStat;
+		if (fstat(fileno(file->handle), &fileStat) != 0) { return Result_FailedToReadFile; }
+		*sizeOut = (u64)fileStat.st_size;
+		return Result_Success;
+	}
+	#else
+	AssertMsg(false, "OsGetOpenFileSize does not support the current platform yet!");
+	return Result_UnsupportedPlatform;
+	#endif
+}
+
+//NOTE: Reserves space on disk for a file that will be numBytes long WITHOUT changing its size, so writing a file
+//      whose final size we know up front doesn't fragment or fail part way through for lack of space.
+//      Returns Result_NotImplemented when the file system (or 32-bit Linux/Android) can't do this, which callers can ignore
+PEXP Result OsPreallocateOpenFile(OsFile* file, u64 numBytes)
+{
+	NotNull(file);
+	Assert(file->isOpen);
+	Assert(file->openedForWriting);
+	if (numBytes == 0) { return Result_Success; }
+	
+	#if TARGET_IS_WINDOWS
+	{
+		//NOTE: Setting an allocation size smaller than the file would truncate it
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file->handle, &fileSize) != 0 && (u64)fileSize.QuadPart >= numBytes) { return Result_Success; }
+		FILE_ALLOCATION_INFO allocationInfo = ZEROED;
+		allocationInfo.AllocationSize.QuadPart = (LONGLONG)numBytes;
+		if (SetFileInformationByHandle(file->handle, FileAllocationInfo, &allocationInfo, sizeof(allocationInfo)) == 0) { return Result_FailedToWriteFile; }
+		return Result_Success;
+	}
+	#elif ((TARGET_IS_LINUX || TARGET_IS_ANDROID) && TARGET_IS_64BIT)
+	{
+		//NOTE: glibc only declares fallocate with _GNU_SOURCE (and posix_fallocate changes the file size) so we go through syscall
+		if (syscall(SYS_fallocate, fileno(file->handle), FALLOC_FL_KEEP_SIZE, (off_t)0, (off_t)numBytes) != 0)
+		{
+			return (errno == EOPNOTSUPP || errno == ENOSYS) ? Result_NotImplemented : Result_FailedToWriteFile;
+		}
+		return Result_Success;
+	}
+	#elif TARGET_IS_OSX
+	{
+		//NOTE: F_PEOFPOSMODE allocates relative to the end of what's already allocated
+		struct stat fileStat;
+		if (fstat(fileno(file->handle), &fileStat) != 0) { return Result_FailedToWriteFile; }
+		if ((u64)fileStat.st_size >= numBytes) { return Result_Success; }
+		fstore_t store = ZEROED;
+		store.fst_flags = F_ALLOCATECONTIG;
+		store.fst_posmode = F_PEOFPOSMODE;
+		store.fst_offset = 0;
+		store.fst_length = (off_t)(numBytes - (u64)fileStat.st_size);
+		if (fcntl(fileno(file->handle), F_PREALLOCATE, &store) == -1)
+		{
+			store.fst_flags = F_ALLOCATEALL; //the space doesn't have to be contiguous
+			if (fcntl(fileno(file->handle), F_PREALLOCATE, &store) == -1) { return (errno == ENOTSUP) ? Result_NotImplemented : Result_FailedToWriteFile; }
+		}
+		return Result_Success;
+	}
+	#else
+	return Result_NotImplemented;
+	#endif
+}
+
+//NOTE: Flushes everything written to the file (through either the cursor or the positioned functions) out to the disk.
+//      Writes that happen at the same time on other threads may or may not be included
+PEXP Result OsSyncOpenFile(OsFile* file)
+{
+	NotNull(file);
+	Assert(file->isOpen);
+	#if TARGET_IS_WINDOWS
+	{
+		if (FlushFileBuffers(file->handle) == 0) { return Result_FailedToWriteFile; }
+		return Result_Success;
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		if (fflush(file->handle) != 0) { return Result_FailedToWriteFile; }
+		#if TARGET_IS_OSX
+		if (fcntl(fileno(file->handle), F_FULLFSYNC) == 0) { return Result_Success; }
+		#endif
+		if (fsync(fileno(file->handle)) != 0) { return Result_FailedToWriteFile; }
+		return Result_Success;
+	}
+	#else
+	AssertMsg(false, "OsSyncOpenFile does not support the current platform yet!");
+	return Result_UnsupportedPlatform;
+	#endif
+}
+
 // +--------------------------------------------------------------+
 // |                       File Write Time                        |
 // +--------------------------------------------------------------+
-PEXP Result OsGetFileWriteTime(FilePath filePath, OsFileWriteTime* timeOut)
+// Gets the write time and size of a file in a single query (both timeOut and sizeOut are optional)
+PEXP Result OsGetFileWriteTimeAndSize(FilePath filePath, OsFileWriteTime* timeOut, u64* sizeOut)
 {
 	NotNullStr(filePath);
 	Result result = Result_None;
@@ -1398,6 +1958,7 @@ PEXP Result OsGetFileWriteTime(FilePath filePath, OsFileWriteTime* timeOut)
 		if (GetFileAttributesExA(filePathNt.chars, GetFileExInfoStandard, &attributeData))
 		{
 			if (timeOut != nullptr) { timeOut->fileTime = attributeData.ftLastWriteTime; }
+			if (sizeOut != nullptr) { *sizeOut = ((u64)attributeData.nFileSizeHigh << 32) | (u64)attributeData.nFileSizeLow; }
 			result = Result_Success;
 		}
 		else { result = Result_NotFound; }
@@ -1420,14 +1981,19 @@ PEXP Result OsGetFileWriteTime(FilePath filePath, OsFileWriteTime* timeOut)
 			timeOut->timeSpec = statStruct.st_mtim;
 			#endif
 		}
+		if (sizeOut != nullptr) { *sizeOut = (u64)statStruct.st_size; }
 		result = Result_Success;
 	}
 	#else
-	AssertMsg(false, "OsGetFileWriteTime does not support the current platform yet!");
+	AssertMsg(false, "OsGetFileWriteTimeAndSize does not support the current platform yet!");
 	result = Result_UnsupportedPlatform;
 	#endif
 	return result;
 }
+PEXPI Result OsGetFileWriteTime(FilePath filePath, OsFileWriteTime* timeOut)
+{
+	return OsGetFileWriteTimeAndSize(filePath, timeOut, nullptr);
+}
 
 PEXPI i32 OsCompareFileWriteTime(OsFileWriteTime left, OsFileWriteTime right)
 {
@@ -1475,9 +2041,7 @@ PEXPI bool OsAreFileWriteTimesEqual(OsFileWriteTime left, OsFileWriteTime right)
 #include "cross/cross_image_loading_and_file.h"
 #endif
 
-#if defined(_MISC_ZIP_H) && defined(_OS_FILE_H)
-#include "cross/cross_zip_and_file.h"
-#endif
+//NOTE: misc_zip.h includes os_file.h itself, so cross_zip_and_file.h is only included from the bottom of misc_zip.h
 
 #if defined(_FILE_FMT_GLTF_H) && defined(_OS_FILE_H)
 #include "cross/cross_gltf_and_os_file.h"
@@ -0,0 +1,676 @@
+/*
+File:   os_file_async.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** An OsAsyncReader owns a dedicated I/O thread that services batches of file read requests
+	** (path or already open OsFile, offset, length, destination buffer) without stalling the thread that submitted them.
+	** On Linux the I/O thread keeps many reads in flight at once through io_uring (when the kernel allows it),
+	** everywhere else (and as a fallback) the I/O thread just does the reads one after another.
+	** Finished reads come back through a queue (OsGetAsyncReadCompletion) and optionally a callback that runs
+	** on the I/O thread the moment the read is done (useful for kicking off decode work on a ThreadPool)
+	** NOTE: An OsAsyncReader should not be moved in memory after it's initialized, the I/O thread holds a pointer to it
+*/
+
+#ifndef _OS_FILE_ASYNC_H
+#define _OS_FILE_ASYNC_H
+
+#include "base/base_compiler_check.h"
+#include "base/base_defines_check.h"
+#include "base/base_typedefs.h"
+#include "base/base_assert.h"
+#include "base/base_macros.h"
+#include "std/std_includes.h"
+#include "std/std_memset.h"
+#include "os/os_threading.h"
+#include "os/os_sleep.h"
+#include "os/os_path.h"
+#include "os/os_file.h"
+#include "mem/mem_arena.h"
+#include "struct/struct_string.h"
+#include "std/std_basic_math.h"
+#include "misc/misc_result.h"
+#include "base/base_notifications.h"
+
+#if TARGET_HAS_THREADING
+
+#define OS_ASYNC_READER_DEFAULT_QUEUE_DEPTH 64
+#define OS_ASYNC_READER_MAX_STOP_WAIT_TIME  1500 //ms
+#define OS_ASYNC_READ_ID_INVALID            0
+
+typedef plex OsAsyncReadCompletion OsAsyncReadCompletion;
+plex OsAsyncReadCompletion
+{
+	uxx id;
+	Result result; //Success, Partial (the file ended before length bytes were read), FileNotFound or FailedToReadFile
+	u64 offset;
+	uxx length;
+	uxx numBytesRead;
+	u8* buffer;
+	void* userPntr;
+};
+
+//NOTE: This is called on the I/O thread, so it must be thread-safe and should be quick (it holds up the next batch of reads)
+#define OS_ASYNC_READ_CALLBACK_DEF(functionName) void functionName(const OsAsyncReadCompletion* completion)
+typedef OS_ASYNC_READ_CALLBACK_DEF(OsAsyncReadCallback_f);
+
+typedef plex OsAsyncReadRequest OsAsyncReadRequest;
+plex OsAsyncReadRequest
+{
+	FilePath path; //fill either path or file
+	OsFile* file; //must stay open until the read completes. The read doesn't use (or update) file->cursorIndex
+	u64 offset;
+	uxx length;
+	void* buffer; //must be at least length bytes and stay alive until the completion is retrieved
+	void* userPntr;
+	OsAsyncReadCallback_f* callback; //optional
+};
+
+//NOTE: These are only used internally, one for each request that has not been retrieved with OsGetAsyncReadCompletion yet
+typedef plex OsAsyncRead OsAsyncRead;
+plex OsAsyncRead
+{
+	OsAsyncRead* next;
+	FilePath pathNt; //allocated from the reader's arena (with null-term and native slashes)
+	OsFile* file;
+	OsAsyncReadCallback_f* callback;
+	OsAsyncReadCompletion completion;
+	bool ownsFile;
+	#if TARGET_IS_WINDOWS
+	HANDLE fileHandle;
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	int fileDescriptor;
+	#endif
+	#if TARGET_IS_LINUX
+	plex iovec ioVector;
+	#endif
+};
+
+#if TARGET_IS_LINUX
+typedef plex OsIoUring OsIoUring;
+plex OsIoUring
+{
+	int fileDescriptor;
+	u32 numEntries;
+	uxx submitRingSize;
+	u8* submitRing;
+	u32* submitHead;
+	u32* submitTail;
+	u32* submitMask;
+	u32* submitArray;
+	uxx submitEntriesSize;
+	plex io_uring_sqe* submitEntries;
+	uxx completeRingSize;
+	u8* completeRing; //same as submitRing when the kernel supports IORING_FEAT_SINGLE_MMAP
+	u32* completeHead;
+	u32* completeTail;
+	u32* completeMask;
+	plex io_uring_cqe* completeEntries;
+};
+#endif //TARGET_IS_LINUX
+
+typedef plex OsAsyncReader OsAsyncReader;
+plex OsAsyncReader
+{
+	Arena* arena; //only touched on the thread that owns the reader
+	uxx queueDepth; //max number of reads the I/O thread keeps in flight at once
+	bool isUsingIoUring;
+	uxx nextId;
+	uxx numOutstanding; //submitted but not retrieved yet
+	OsAsyncRead* freeList;
+	
+	OsThreadHandle thread;
+	bool isRunning;
+	bool stopRequested;
+	Mutex mutex; //protects stopRequested and the pending/completed lists
+	#if TARGET_IS_WINDOWS
+	HANDLE wakeEvent;
+	#else
+	pthread_cond_t wakeCondition;
+	#endif
+	OsAsyncRead* pendingHead;
+	OsAsyncRead* pendingTail;
+	OsAsyncRead* completedHead;
+	OsAsyncRead* completedTail;
+	
+	#if TARGET_IS_LINUX
+	OsIoUring ring; //only touched by the I/O thread after initialization
+	#endif
+};
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	void FreeOsAsyncReader(OsAsyncReader* reader);
+	void InitOsAsyncReader(Arena* arena, uxx queueDepth, bool allowIoUring, OsAsyncReader* readerOut);
+	uxx OsSubmitAsyncReads(OsAsyncReader* reader, uxx numRequests, const OsAsyncReadRequest* requests, uxx* idsOut);
+	PIG_CORE_INLINE uxx OsSubmitAsyncRead(OsAsyncReader* reader, const OsAsyncReadRequest* request);
+	uxx OsSubmitAsyncReadEntireFile(OsAsyncReader* reader, FilePath path, Arena* bufferArena, void* userPntr, OsAsyncReadCallback_f* callback);
+	bool OsGetAsyncReadCompletion(OsAsyncReader* reader, OsAsyncReadCompletion* completionOut);
+	PIG_CORE_INLINE bool IsOsAsyncReaderIdle(const OsAsyncReader* reader);
+#endif
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+OS_THREAD_FUNC_DEF(OsAsyncReader_Main);
+
+// +==============================+
+// |           io_uring           |
+// +==============================+
+#if TARGET_IS_LINUX
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+static void OsCloseIoUring(OsIoUring* ring)
+{
+	if (ring->submitEntries != nullptr) { munmap(ring->submitEntries, ring->submitEntriesSize); }
+	if (ring->completeRing != nullptr && ring->completeRing != ring->submitRing) { munmap(ring->completeRing, ring->completeRingSize); }
+	if (ring->submitRing != nullptr) { munmap(ring->submitRing, ring->submitRingSize); }
+	if (ring->fileDescriptor > 0) { close(ring->fileDescriptor); }
+	ClearPointer(ring);
+}
+
+//Returns false if the kernel doesn't support io_uring (or it's been disabled, which is common in containers)
+static bool OsOpenIoUring(u32 numEntries, OsIoUring* ringOut)
+{
+	ClearPointer(ringOut);
+	plex io_uring_params params = ZEROED;
+	int ringFd = (int)syscall(__NR_io_uring_setup, numEntries, &params);
+	if (ringFd < 0) { return false; }
+	ringOut->fileDescriptor = ringFd;
+	ringOut->numEntries = params.sq_entries;
+	
+	ringOut->submitRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+	ringOut->completeRingSize = params.cq_off.cqes + params.cq_entries * sizeof(plex io_uring_cqe);
+	bool isSingleMmap = IsFlagSet(params.features, IORING_FEAT_SINGLE_MMAP);
+	if (isSingleMmap) { ringOut->submitRingSize = MaxUXX(ringOut->submitRingSize, ringOut->completeRingSize); ringOut->completeRingSize = ringOut->submitRingSize; }
+	
+	void* submitRing = mmap(nullptr, ringOut->submitRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+	if (submitRing == MAP_FAILED) { OsCloseIoUring(ringOut); return false; }
+	ringOut->submitRing = (u8*)submitRing;
+	if (isSingleMmap) { ringOut->completeRing = ringOut->submitRing; }
+	else
+	{
+		void* completeRing = mmap(nullptr, ringOut->completeRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+		if (completeRing == MAP_FAILED) { OsCloseIoUring(ringOut); return false; }
+		ringOut->completeRing = (u8*)completeRing;
+	}
+	ringOut->submitEntriesSize = params.sq_entries * sizeof(plex io_uring_sqe);
+	void* submitEntries = mmap(nullptr, ringOut->submitEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+	if (submitEntries == MAP_FAILED) { OsCloseIoUring(ringOut); return false; }
+	ringOut->submitEntries = (plex io_uring_sqe*)submitEntries;
+	
+	ringOut->submitHead = (u32*)(ringOut->submitRing + params.sq_off.head);
+	ringOut->submitTail = (u32*)(ringOut->submitRing + params.sq_off.tail);
+	ringOut->submitMask = (u32*)(ringOut->submitRing + params.sq_off.ring_mask);
+	ringOut->submitArray = (u32*)(ringOut->submitRing + params.sq_off.array);
+	ringOut->completeHead = (u32*)(ringOut->completeRing + params.cq_off.head);
+	ringOut->completeTail = (u32*)(ringOut->completeRing + params.cq_off.tail);
+	ringOut->completeMask = (u32*)(ringOut->completeRing + params.cq_off.ring_mask);
+	ringOut->completeEntries = (plex io_uring_cqe*)(ringOut->completeRing + params.cq_off.cqes);
+	return true;
+}
+
+//Queues a readv for the part of the request that hasn't been read yet. The caller makes sure there is room in the ring
+static void OsIoUringQueueRead(OsIoUring* ring, OsAsyncRead* read)
+{
+	u32 tail = *ring->submitTail; //we are the only producer so this doesn't need to be atomic
+	u32 index = (tail & *ring->submitMask);
+	plex io_uring_sqe* entry = &ring->submitEntries[index];
+	MyMemSet(entry, 0x00, sizeof(plex io_uring_sqe));
+	read->ioVector.iov_base = read->completion.buffer + read->completion.numBytesRead;
+	read->ioVector.iov_len = (size_t)(read->completion.length - read->completion.numBytesRead);
+	entry->opcode = IORING_OP_READV; //READV (rather than READ) works all the way back to 5.1 kernels
+	entry->fd = read->fileDescriptor;
+	entry->addr = (u64)(size_t)&read->ioVector;
+	entry->len = 1;
+	entry->off = read->completion.offset + read->completion.numBytesRead;
+	entry->user_data = (u64)(size_t)read;
+	ring->submitArray[index] = index;
+	__atomic_store_n(ring->submitTail, tail+1, __ATOMIC_RELEASE);
+}
+
+//Returns the number of entries the kernel consumed, or -errno
+static int OsIoUringEnter(OsIoUring* ring, u32 numToSubmit, u32 minComplete)
+{
+	while (true)
+	{
+		int enterResult = (int)syscall(__NR_io_uring_enter, ring->fileDescriptor, numToSubmit, minComplete, (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+		if (enterResult >= 0) { return enterResult; }
+		if (errno != EINTR) { return -errno; }
+	}
+}
+
+#endif //TARGET_IS_LINUX
+
+// +==============================+
+// |       Reader Functions       |
+// +==============================+
+static void OsAsyncReaderRecycle(OsAsyncReader* reader, OsAsyncRead* read)
+{
+	FreeStr8WithNt(reader->arena, &read->pathNt);
+	ClearPointer(read);
+	read->next = reader->freeList;
+	reader->freeList = read;
+}
+
+PEXP void FreeOsAsyncReader(OsAsyncReader* reader)
+{
+	NotNull(reader);
+	if (reader->arena != nullptr)
+	{
+		if (reader->thread.isFilled)
+		{
+			//NOTE: The I/O thread finishes any reads that are already in flight (the kernel may still be writing into those buffers)
+			//      but it won't start any new ones once stopRequested is set
+			LockMutex(&reader->mutex, TIMEOUT_FOREVER);
+			reader->stopRequested = true;
+			#if TARGET_IS_WINDOWS
+			SetEvent(reader->wakeEvent);
+			#else
+			pthread_cond_signal(&reader->wakeCondition);
+			#endif
+			UnlockMutex(&reader->mutex);
+			
+			uxx numMillisecondsWaited = 0;
+			while (numMillisecondsWaited < OS_ASYNC_READER_MAX_STOP_WAIT_TIME)
+			{
+				bool isRunning = true;
+				LockMutexBlock(&reader->mutex, TIMEOUT_FOREVER) { isRunning = reader->isRunning; }
+				if (!isRunning) { break; }
+				OsSleepMs(1);
+				numMillisecondsWaited++;
+			}
+			if (numMillisecondsWaited >= OS_ASYNC_READER_MAX_STOP_WAIT_TIME) { NotifyPrint_E("Async reader I/O thread didn't stop after %llums! Dangerously terminating the thread!", (u64)numMillisecondsWaited); }
+			OsCloseThread(&reader->thread);
+		}
+		
+		#if TARGET_IS_LINUX
+		if (reader->isUsingIoUring) { OsCloseIoUring(&reader->ring); }
+		#endif
+		#if TARGET_IS_WINDOWS
+		if (reader->wakeEvent != NULL) { CloseHandle(reader->wakeEvent); }
+		#else
+		pthread_cond_destroy(&reader->wakeCondition);
+		#endif
+		DestroyMutex(&reader->mutex);
+		
+		OsAsyncRead* lists[] = { reader->pendingHead, reader->completedHead, reader->freeList };
+		for (uxx lIndex = 0; lIndex < ArrayCount(lists); lIndex++)
+		{
+			OsAsyncRead* read = lists[lIndex];
+			while (read != nullptr)
+			{
+				OsAsyncRead* nextRead = read->next;
+				FreeStr8WithNt(reader->arena, &read->pathNt);
+				FreeType(OsAsyncRead, reader->arena, read);
+				read = nextRead;
+			}
+		}
+	}
+	ClearPointer(reader);
+}
+
+//NOTE: Pass 0 for queueDepth to get OS_ASYNC_READER_DEFAULT_QUEUE_DEPTH. queueDepth is only meaningful when using io_uring
+PEXP void InitOsAsyncReader(Arena* arena, uxx queueDepth, bool allowIoUring, OsAsyncReader* readerOut)
+{
+	NotNull(arena);
+	NotNull(readerOut);
+	ClearPointer(readerOut);
+	readerOut->arena = arena;
+	readerOut->queueDepth = (queueDepth > 0) ? queueDepth : OS_ASYNC_READER_DEFAULT_QUEUE_DEPTH;
+	readerOut->nextId = 1;
+	InitMutex(&readerOut->mutex);
+	#if TARGET_IS_WINDOWS
+	readerOut->wakeEvent = CreateEventA(nullptr, false, false, nullptr); //auto-reset, so a wake that comes in before the I/O thread starts waiting is not lost
+	NotNull(readerOut->wakeEvent);
+	#else
+	int condInitResult = pthread_cond_init(&readerOut->wakeCondition, nullptr);
+	Assert(condInitResult == 0);
+	#endif
+	
+	#if TARGET_IS_LINUX
+	if (allowIoUring && queueDepth <= UINT32_MAX)
+	{
+		readerOut->isUsingIoUring = OsOpenIoUring((u32)readerOut->queueDepth, &readerOut->ring);
+		if (readerOut->isUsingIoUring) { readerOut->queueDepth = MinUXX(readerOut->queueDepth, (uxx)readerOut->ring.numEntries); }
+	}
+	#else
+	UNUSED(allowIoUring);
+	#endif
+	
+	readerOut->isRunning = true; //set before the thread starts so FreeOsAsyncReader always waits for it
+	readerOut->thread = OsCreateThread(OsAsyncReader_Main, (void*)readerOut, true);
+}
+
+//Returns the number of requests submitted, all of them unless one of them was invalid (idsOut gets OS_ASYNC_READ_ID_INVALID for those)
+PEXP uxx OsSubmitAsyncReads(OsAsyncReader* reader, uxx numRequests, const OsAsyncReadRequest* requests, uxx* idsOut)
+{
+	NotNull(reader);
+	NotNull(reader->arena);
+	Assert(requests != nullptr || numRequests == 0);
+	if (numRequests == 0) { return 0; }
+	
+	//Build up the new reads in a local list so the I/O thread only waits on the mutex for a moment
+	OsAsyncRead* newHead = nullptr;
+	OsAsyncRead* newTail = nullptr;
+	uxx numSubmitted = 0;
+	for (uxx rIndex = 0; rIndex < numRequests; rIndex++)
+	{
+		const OsAsyncReadRequest* request = &requests[rIndex];
+		if (idsOut != nullptr) { idsOut[rIndex] = OS_ASYNC_READ_ID_INVALID; }
+		if ((request->path.length == 0 && request->file == nullptr) || (request->buffer == nullptr && request->length > 0)) { continue; }
+		
+		OsAsyncRead* newRead = reader->freeList;
+		if (newRead != nullptr) { reader->freeList = newRead->next; }
+		else { newRead = AllocType(OsAsyncRead, reader->arena); }
+		NotNull(newRead);
+		ClearPointer(newRead);
+		if (request->file == nullptr)
+		{
+			newRead->pathNt = AllocStrAndCopy(reader->arena, request->path.length, request->path.chars, true);
+			#if TARGET_IS_WINDOWS
+			ChangePathSlashesTo(newRead->pathNt, '\\');
+			#endif
+		}
+		newRead->file = request->file;
+		newRead->callback = request->callback;
+		newRead->completion.id = reader->nextId;
+		reader->nextId++;
+		newRead->completion.offset = request->offset;
+		newRead->completion.length = request->length;
+		newRead->completion.buffer = (u8*)request->buffer;
+		newRead->completion.userPntr = request->userPntr;
+		if (idsOut != nullptr) { idsOut[rIndex] = newRead->completion.id; }
+		
+		if (newTail != nullptr) { newTail->next = newRead; } else { newHead = newRead; }
+		newTail = newRead;
+		numSubmitted++;
+	}
+	
+	if (newHead != nullptr)
+	{
+		LockMutexBlock(&reader->mutex, TIMEOUT_FOREVER)
+		{
+			if (reader->pendingTail != nullptr) { reader->pendingTail->next = newHead; } else { reader->pendingHead = newHead; }
+			reader->pendingTail = newTail;
+			#if TARGET_IS_WINDOWS
+			SetEvent(reader->wakeEvent);
+			#else
+			pthread_cond_signal(&reader->wakeCondition);
+			#endif
+		}
+		reader->numOutstanding += numSubmitted;
+	}
+	return numSubmitted;
+}
+PEXPI uxx OsSubmitAsyncRead(OsAsyncReader* reader, const OsAsyncReadRequest* request)
+{
+	uxx result = OS_ASYNC_READ_ID_INVALID;
+	OsSubmitAsyncReads(reader, 1, request, &result);
+	return result;
+}
+
+//NOTE: This asks for the size of the file right away (a quick stat, not a read) so it can allocate the buffer from bufferArena.
+//      The buffer gets an extra null-terminator byte past the end of the file contents. Returns OS_ASYNC_READ_ID_INVALID if the file doesn't exist
+PEXP uxx OsSubmitAsyncReadEntireFile(OsAsyncReader* reader, FilePath path, Arena* bufferArena, void* userPntr, OsAsyncReadCallback_f* callback)
+{
+	NotNull(reader);
+	NotNullStr(path);
+	NotNull(bufferArena);
+	u64 fileSize = 0;
+	if (OsGetFileWriteTimeAndSize(path, nullptr, &fileSize) != Result_Success) { return OS_ASYNC_READ_ID_INVALID; }
+	if (fileSize >= (u64)UINTXX_MAX) { return OS_ASYNC_READ_ID_INVALID; }
+	u8* buffer = (u8*)AllocMem(bufferArena, (uxx)fileSize + 1);
+	if (buffer == nullptr) { return OS_ASYNC_READ_ID_INVALID; }
+	buffer[fileSize] = '\0';
+	
+	OsAsyncReadRequest request = ZEROED;
+	request.path = path;
+	request.length = (uxx)fileSize;
+	request.buffer = buffer;
+	request.userPntr = userPntr;
+	request.callback = callback;
+	return OsSubmitAsyncRead(reader, &request);
+}
+
+//Pops one finished read off the completion queue. Returns false if nothing has finished since the last call
+PEXP bool OsGetAsyncReadCompletion(OsAsyncReader* reader, OsAsyncReadCompletion* completionOut)
+{
+	NotNull(reader);
+	NotNull(reader->arena);
+	NotNull(completionOut);
+	if (reader->numOutstanding == 0) { return false; }
+	OsAsyncRead* finishedRead = nullptr;
+	LockMutexBlock(&reader->mutex, TIMEOUT_FOREVER)
+	{
+		finishedRead = reader->completedHead;
+		if (finishedRead != nullptr)
+		{
+			reader->completedHead = finishedRead->next;
+			if (reader->completedHead == nullptr) { reader->completedTail = nullptr; }
+		}
+	}
+	if (finishedRead == nullptr) { return false; }
+	MyMemCopy(completionOut, &finishedRead->completion, sizeof(OsAsyncReadCompletion));
+	OsAsyncReaderRecycle(reader, finishedRead);
+	reader->numOutstanding--;
+	return true;
+}
+
+PEXPI bool IsOsAsyncReaderIdle(const OsAsyncReader* reader) { NotNull(reader); return (reader->numOutstanding == 0); }
+
+// +==============================+
+// |      OsAsyncReader_Main      |
+// +==============================+
+//Opens the file for reads that were given a path. Returns false (and fills in completion.result) if it couldn't be opened
+static bool OsAsyncReaderOpenFile(OsAsyncRead* read)
+{
+	#if TARGET_IS_WINDOWS
+	{
+		if (read->file != nullptr) { read->fileHandle = read->file->handle; return true; }
+		read->fileHandle = CreateFileA(
+			read->pathNt.chars, //lpFileName
+			GENERIC_READ, //dwDesiredAccess
+			FILE_SHARE_READ, //dwShareMode
+			NULL, //lpSecurityAttributes
+			OPEN_EXISTING, //dwCreationDisposition
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, //dwFlagsAndAttributes
+			NULL //hTemplateFile
+		);
+		if (read->fileHandle == INVALID_HANDLE_VALUE)
+		{
+			DWORD errorCode = GetLastError();
+			read->completion.result = (errorCode == ERROR_FILE_NOT_FOUND || errorCode == ERROR_PATH_NOT_FOUND) ? Result_FileNotFound : Result_FailedToReadFile;
+			return false;
+		}
+		read->ownsFile = true;
+		return true;
+	}
+	#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+	{
+		if (read->file != nullptr) { read->fileDescriptor = fileno(read->file->handle); return true; }
+		read->fileDescriptor = open(read->pathNt.chars, O_RDONLY | O_CLOEXEC);
+		if (read->fileDescriptor < 0)
+		{
+			read->completion.result = (errno == ENOENT || errno == ENOTDIR) ? Result_FileNotFound : Result_FailedToReadFile;
+			return false;
+		}
+		read->ownsFile = true;
+		return true;
+	}
+	#else
+	read->completion.result = Result_UnsupportedPlatform;
+	return false;
+	#endif
+}
+
+//The worker thread fallback, does the whole read right here on the I/O thread
+static void OsAsyncReaderDoBlockingRead(OsAsyncRead* read)
+{
+	read->completion.result = Result_Success;
+	while (read->completion.numBytesRead < read->completion.length)
+	{
+		uxx numBytesLeft = read->completion.length - read->completion.numBytesRead;
+		u64 readOffset = read->completion.offset + read->completion.numBytesRead;
+		#if TARGET_IS_WINDOWS
+		DWORD numBytesToRead = (DWORD)MinUXX(numBytesLeft, (uxx)Gigabytes(1));
+		DWORD numBytesRead = 0;
+		OVERLAPPED overlapped = ZEROED;
+		overlapped.Offset = (DWORD)(readOffset & 0xFFFFFFFFULL);
+		overlapped.OffsetHigh = (DWORD)(readOffset >> 32);
+		if (!ReadFile(read->fileHandle, read->completion.buffer + read->completion.numBytesRead, numBytesToRead, &numBytesRead, &overlapped))
+		{
+			if (GetLastError() == ERROR_HANDLE_EOF) { read->completion.result = Result_Partial; }
+			else { read->completion.result = Result_FailedToReadFile; }
+			break;
+		}
+		#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+		ssize_t numBytesRead = pread(read->fileDescriptor, read->completion.buffer + read->completion.numBytesRead, (size_t)MinUXX(numBytesLeft, (uxx)Gigabytes(1)), (off_t)readOffset);
+		if (numBytesRead < 0)
+		{
+			if (errno == EINTR) { continue; }
+			read->completion.result = Result_FailedToReadFile;
+			break;
+		}
+		#else
+		UNUSED(numBytesLeft);
+		UNUSED(readOffset);
+		uxx numBytesRead = 0;
+		#endif
+		if (numBytesRead == 0) { read->completion.result = Result_Partial; break; }
+		read->completion.numBytesRead += (uxx)numBytesRead;
+	}
+}
+
+static void OsAsyncReaderFinish(OsAsyncReader* reader, OsAsyncRead* read)
+{
+	if (read->ownsFile)
+	{
+		#if TARGET_IS_WINDOWS
+		CloseHandle(read->fileHandle);
+		#elif (TARGET_IS_LINUX || TARGET_IS_OSX || TARGET_IS_ANDROID)
+		close(read->fileDescriptor);
+		#endif
+		read->ownsFile = false;
+	}
+	if (read->callback != nullptr) { read->callback(&read->completion); }
+	read->next = nullptr;
+	LockMutexBlock(&reader->mutex, TIMEOUT_FOREVER)
+	{
+		if (reader->completedTail != nullptr) { reader->completedTail->next = read; } else { reader->completedHead = read; }
+		reader->completedTail = read;
+	}
+}
+
+//NOTE: This is declared above as well so it can be passed to OsCreateThread in InitOsAsyncReader
+OS_THREAD_FUNC_DEF(OsAsyncReader_Main)
+{
+	OsAsyncReader* reader = (OsAsyncReader*)contextPntr;
+	uxx numInFlight = 0; //io_uring only
+	u32 numToSubmit = 0; //io_uring only
+	
+	while (true)
+	{
+		//Grab as many pending reads as we have room for, or go to sleep if there's nothing to do
+		OsAsyncRead* batchHead = nullptr;
+		LockMutex(&reader->mutex, TIMEOUT_FOREVER);
+		while (reader->pendingHead == nullptr && numInFlight == 0 && !reader->stopRequested)
+		{
+			#if TARGET_IS_WINDOWS
+			UnlockMutex(&reader->mutex);
+			WaitForSingleObject(reader->wakeEvent, INFINITE);
+			LockMutex(&reader->mutex, TIMEOUT_FOREVER);
+			#else
+			pthread_cond_wait(&reader->wakeCondition, &reader->mutex);
+			#endif
+		}
+		if (reader->stopRequested && numInFlight == 0) { UnlockMutex(&reader->mutex); break; }
+		if (!reader->stopRequested)
+		{
+			uxx numRoom = reader->isUsingIoUring ? (reader->queueDepth - numInFlight) : 1;
+			OsAsyncRead* batchTail = nullptr;
+			while (numRoom > 0 && reader->pendingHead != nullptr)
+			{
+				OsAsyncRead* read = reader->pendingHead;
+				reader->pendingHead = read->next;
+				if (reader->pendingHead == nullptr) { reader->pendingTail = nullptr; }
+				read->next = nullptr;
+				if (batchTail != nullptr) { batchTail->next = read; } else { batchHead = read; }
+				batchTail = read;
+				numRoom--;
+			}
+		}
+		UnlockMutex(&reader->mutex);
+		
+		while (batchHead != nullptr)
+		{
+			OsAsyncRead* read = batchHead;
+			batchHead = read->next;
+			if (!OsAsyncReaderOpenFile(read)) { OsAsyncReaderFinish(reader, read); continue; }
+			if (read->completion.length == 0) { read->completion.result = Result_Success; OsAsyncReaderFinish(reader, read); continue; }
+			#if TARGET_IS_LINUX
+			if (reader->isUsingIoUring)
+			{
+				OsIoUringQueueRead(&reader->ring, read);
+				numToSubmit++;
+				numInFlight++;
+				continue;
+			}
+			#endif
+			OsAsyncReaderDoBlockingRead(read);
+			OsAsyncReaderFinish(reader, read);
+		}
+		
+		#if TARGET_IS_LINUX
+		if (reader->isUsingIoUring && numInFlight > 0)
+		{
+			//NOTE: This blocks until at least one read finishes, new requests get picked up after that
+			int enterResult = OsIoUringEnter(&reader->ring, numToSubmit, 1);
+			if (enterResult >= 0) { numToSubmit -= MinU32(numToSubmit, (u32)enterResult); }
+			else if (enterResult != -EBUSY) { OsSleepMs(1); } //EBUSY means the completion queue is full, reaping below makes room. Anything else we just try again shortly
+			
+			u32 head = *reader->ring.completeHead;
+			u32 tail = __atomic_load_n(reader->ring.completeTail, __ATOMIC_ACQUIRE);
+			while (head != tail)
+			{
+				plex io_uring_cqe* entry = &reader->ring.completeEntries[head & *reader->ring.completeMask];
+				OsAsyncRead* read = (OsAsyncRead*)(size_t)entry->user_data;
+				int readResult = entry->res;
+				head++;
+				
+				if (readResult == -EINTR || readResult == -EAGAIN) { OsIoUringQueueRead(&reader->ring, read); numToSubmit++; continue; }
+				if (readResult > 0)
+				{
+					read->completion.numBytesRead += (uxx)readResult;
+					if (read->completion.numBytesRead < read->completion.length) { OsIoUringQueueRead(&reader->ring, read); numToSubmit++; continue; } //short read, ask for the rest
+					read->completion.result = Result_Success;
+				}
+				else if (readResult == 0) { read->completion.result = Result_Partial; }
+				else { read->completion.result = Result_FailedToReadFile; }
+				numInFlight--;
+				OsAsyncReaderFinish(reader, read);
+			}
+			__atomic_store_n(reader->ring.completeHead, head, __ATOMIC_RELEASE);
+		}
+		#endif
+	}
+	
+	LockMutexBlock(&reader->mutex, TIMEOUT_FOREVER) { reader->isRunning = false; }
+	OsThreadReturn(0, nullptr);
+}
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //TARGET_HAS_THREADING
+
+#endif //  _OS_FILE_ASYNC_H
@@ -64,6 +64,7 @@ plex ThreadPoolWorkItem
 	
 	bool isWorking;
 	bool isDone;
+	bool isPrivate; //GetFinishedThreadPoolWorkItem skips these, whoever added the item waits on isDone and frees it themselves
 	uxx workerThreadId;
 	Result result;
 };
@@ -100,7 +101,8 @@ plex ThreadPool
 	PIG_CORE_INLINE void FreeThreadPool(ThreadPool* pool);
 	PIG_CORE_INLINE void InitThreadPool(Arena* arena, Str8 debugName, bool threadsHaveScratch, bool threadScratchIsVirtual, uxx threadScratchSize, ThreadPool* poolOut);
 	ThreadPoolThread* AddThreadToPool(ThreadPool* pool);
-	ThreadPoolWorkItem* AddWorkItemToThreadPool(ThreadPool* pool, ThreadPoolWorkItemFunc_f* workItemFunc, WorkSubject* subject);
+	ThreadPoolWorkItem* AddWorkItemToThreadPoolEx(ThreadPool* pool, ThreadPoolWorkItemFunc_f* workItemFunc, WorkSubject* subject, bool isPrivate);
+	PIG_CORE_INLINE ThreadPoolWorkItem* AddWorkItemToThreadPool(ThreadPool* pool, ThreadPoolWorkItemFunc_f* workItemFunc, WorkSubject* subject);
 	PIG_CORE_INLINE ThreadPoolWorkItem* GetFinishedThreadPoolWorkItem(ThreadPool* pool); //NOTE: Remember to call FreeThreadPoolWorkItem when done!
 #endif
 
@@ -229,7 +231,7 @@ PEXP ThreadPoolThread* AddThreadToPool(ThreadPool* pool)
 	NotNull(pool);
 	NotNull(pool->arena);
 	Assert(OsGetCurrentThreadId() == pool->mainThreadId);
-
+	
 	ThreadPoolThread* newThread = BktArrayAdd(ThreadPoolThread, &pool->threads);
 	NotNull(newThread);
 	ClearPointer(newThread);
@@ -247,7 +249,9 @@ PEXP ThreadPoolThread* AddThreadToPool(ThreadPool* pool)
 	return newThread;
 }
 
-PEXP ThreadPoolWorkItem* AddWorkItemToThreadPool(ThreadPool* pool, ThreadPoolWorkItemFunc_f* workItemFunc, WorkSubject* subject)
+//NOTE: Private work items are never returned by GetFinishedThreadPoolWorkItem, so other code draining the pool can't take or free
+//      them. This is for functions like OsWalkDirectory that queue helper items on a shared pool and clean them up before returning
+PEXP ThreadPoolWorkItem* AddWorkItemToThreadPoolEx(ThreadPool* pool, ThreadPoolWorkItemFunc_f* workItemFunc, WorkSubject* subject, bool isPrivate)
 {
 	NotNull(pool);
 	NotNull(pool->arena);
@@ -279,11 +283,16 @@ PEXP ThreadPoolWorkItem* AddWorkItemToThreadPool(ThreadPool* pool, ThreadPoolWor
 		if (subject != nullptr) { MyMemCopy(&result->subject, subject, sizeof(WorkSubject)); }
 		result->isWorking = false;
 		result->isDone = false;
+		result->isPrivate = isPrivate;
 		result->workerThreadId = THREAD_POOL_ID_INVALID;
 		result->result = Result_None;
 	}
 	return result;
 }
+PEXPI ThreadPoolWorkItem* AddWorkItemToThreadPool(ThreadPool* pool, ThreadPoolWorkItemFunc_f* workItemFunc, WorkSubject* subject)
+{
+	return AddWorkItemToThreadPoolEx(pool, workItemFunc, subject, false);
+}
 
 //NOTE: Remember to call FreeThreadPoolWorkItem on the item when the result has been processed, otherwise the workItems array will get very long!
 PEXPI ThreadPoolWorkItem* GetFinishedThreadPoolWorkItem(ThreadPool* pool)
@@ -293,7 +302,7 @@ PEXPI ThreadPoolWorkItem* GetFinishedThreadPoolWorkItem(ThreadPool* pool)
 	for (uxx wIndex = 0; wIndex < pool->workItems.length; wIndex++)
 	{
 		ThreadPoolWorkItem* workItem = BktArrayGet(ThreadPoolWorkItem, &pool->workItems, wIndex);
-		if (workItem->id != THREAD_POOL_ID_INVALID && workItem->isDone)
+		if (workItem->id != THREAD_POOL_ID_INVALID && workItem->isDone && !workItem->isPrivate)
 		{
 			return workItem;
 		}
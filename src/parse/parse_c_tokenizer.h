@@ -22,6 +22,7 @@ Description:
 #include "base/base_assert.h"
 #include "base/base_char.h"
 #include "base/base_unicode.h"
+#include "base/base_simd.h"
 #include "misc/misc_result.h"
 #include "std/std_memset.h"
 #include "mem/mem_arena.h"
@@ -78,7 +79,7 @@ plex cToken
 	u8 flags; //cTokenFlags
 	Str8 rawStr; //quoted and escaped string, or leading/trailing syntax included for stuff like directives
 	Str8 leadingWhitespace;
-	Str8 str; //allocated on tokenizer arena
+	Str8 str; //allocated on tokenizer arena (when streaming this is a slice of inputStr or unescapeBuffer instead)
 };
 
 typedef plex cTokenizer cTokenizer;
@@ -86,11 +87,14 @@ plex cTokenizer
 {
 	Arena* arena;
 	Str8 inputStr;
+	bool streaming; //see NewCTokenizerStream
 	bool finished;
 	Result error;
 	uxx inputByteIndex;
 	uxx outputTokenIndex;
-	VarArray tokens; //cToken
+	VarArray tokens; //cToken (not filled when streaming)
+	uxx unescapeBufferSize;
+	char* unescapeBuffer; //only used when streaming, holds the str of the most recent token that contained escape sequences
 };
 
 // +--------------------------------------------------------------+
@@ -99,7 +103,9 @@ plex cTokenizer
 #if !PIG_CORE_IMPLEMENTATION
 	PIG_CORE_INLINE void FreeCTokenizer(cTokenizer* tokenizer);
 	PIG_CORE_INLINE cTokenizer NewCTokenizer(Arena* arena, Str8 inputStr);
+	PIG_CORE_INLINE cTokenizer NewCTokenizerStream(Arena* arena, Str8 inputStr);
 	cToken* NextCToken(cTokenizer* tokenizer);
+	bool NextCTokenStream(cTokenizer* tokenizer, cToken* tokenOut);
 #endif
 
 // +--------------------------------------------------------------+
@@ -126,6 +132,10 @@ PEXPI void FreeCTokenizer(cTokenizer* tokenizer)
 			FreeStr8(tokenizer->arena, &token->str);
 		}
 		FreeVarArray(&tokenizer->tokens);
+		if (tokenizer->unescapeBuffer != nullptr && CanArenaFree(tokenizer->arena))
+		{
+			FreeMem(tokenizer->arena, tokenizer->unescapeBuffer, tokenizer->unescapeBufferSize);
+		}
 	}
 	ClearPointer(tokenizer);
 }
@@ -137,6 +147,7 @@ PEXPI cTokenizer NewCTokenizer(Arena* arena, Str8 inputStr)
 	cTokenizer result = ZEROED;
 	result.arena = arena;
 	result.inputStr = inputStr;
+	result.streaming = false;
 	result.finished = false;
 	result.error = Result_None;
 	result.inputByteIndex = 0;
@@ -145,45 +156,92 @@ PEXPI cTokenizer NewCTokenizer(Arena* arena, Str8 inputStr)
 	return result;
 }
 
-PEXP cToken* NextCToken(cTokenizer* tokenizer)
+//A streaming tokenizer only hands out tokens through NextCTokenStream. The tokens VarArray is never filled
+//and the arena is only used for the unescapeBuffer, so memory usage doesn't grow with the size of inputStr
+PEXPI cTokenizer NewCTokenizerStream(Arena* arena, Str8 inputStr)
 {
-	NotNull(tokenizer);
-	NotNull(tokenizer->arena);
-	
-	if (tokenizer->finished) { return nullptr; }
-	
-	if (tokenizer->outputTokenIndex < tokenizer->tokens.length)
+	cTokenizer result = NewCTokenizer(arena, inputStr);
+	result.streaming = true;
+	return result;
+}
+
+// Returns the index of the first byte at or after startIndex that is not a space or tab, or str.length
+static uxx FindCWhitespaceEnd(Str8 str, uxx startIndex)
+{
+	uxx bIndex = startIndex;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 spaceVector = SimdU8x16_Splat(' ');
+	SimdU8x16 tabVector = SimdU8x16_Splat('\t');
+	for (; bIndex + SIMD_U8X16_SIZE <= str.length; bIndex += SIMD_U8X16_SIZE)
 	{
-		cToken* nextToken = VarArrayGetHard(cToken, &tokenizer->tokens, tokenizer->outputTokenIndex);
-		tokenizer->outputTokenIndex++;
-		if (tokenizer->outputTokenIndex >= tokenizer->tokens.length && tokenizer->inputByteIndex >= tokenizer->inputStr.length)
-		{
-			tokenizer->finished = true;
-			tokenizer->error = Result_Success;
-		}
-		return nextToken;
+		SimdU8x16 block = SimdU8x16_Load(&str.bytes[bIndex]);
+		u32 otherMask = ~SimdU8x16_Mask(SimdU8x16_Or(SimdU8x16_Equal(block, spaceVector), SimdU8x16_Equal(block, tabVector))) & 0xFFFF;
+		if (otherMask != 0) { return bIndex + CountTrailingZerosU32(otherMask); }
 	}
-	
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < str.length; bIndex++)
+	{
+		if (str.chars[bIndex] != ' ' && str.chars[bIndex] != '\t') { return bIndex; }
+	}
+	return str.length;
+}
+// Returns the index of the first byte at or after startIndex that can't be part of an identifier (i.e. isn't [A-Za-z0-9_]), or str.length
+static uxx FindCIdentifierEnd(Str8 str, uxx startIndex)
+{
+	uxx bIndex = startIndex;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 lowerMin = SimdU8x16_Splat('a');
+	SimdU8x16 lowerMax = SimdU8x16_Splat('z');
+	SimdU8x16 digitMin = SimdU8x16_Splat('0');
+	SimdU8x16 digitMax = SimdU8x16_Splat('9');
+	SimdU8x16 underscoreVector = SimdU8x16_Splat('_');
+	for (; bIndex + SIMD_U8X16_SIZE <= str.length; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 block = SimdU8x16_Load(&str.bytes[bIndex]);
+		SimdU8x16 lowerBlock = SimdU8x16_ToLowerAscii(block);
+		SimdU8x16 identifierChars = SimdU8x16_Or(
+			SimdU8x16_Or(SimdU8x16_InRange(lowerBlock, lowerMin, lowerMax), SimdU8x16_InRange(block, digitMin, digitMax)),
+			SimdU8x16_Equal(block, underscoreVector)
+		);
+		u32 otherMask = ~SimdU8x16_Mask(identifierChars) & 0xFFFF;
+		if (otherMask != 0) { return bIndex + CountTrailingZerosU32(otherMask); }
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < str.length; bIndex++)
+	{
+		if (str.chars[bIndex] != '_' && !IsCharAlphaNumeric(CharToU32(str.chars[bIndex]))) { return bIndex; }
+	}
+	return str.length;
+}
+
+// Consumes whitespace/new-lines and the next token from inputStr, filling everything in tokenOut except index.
+// tokenOut->str is left as a slice of inputStr (for strings this slice has not been unescaped yet)
+// sawBackslashOut is set if a string token had any backslashes in it (i.e. it might need to be unescaped)
+// Returns false if there are no more tokens, or if we ran into invalid UTF-8 (in which case tokenizer->finished and error are set)
+static bool ScanCToken(cTokenizer* tokenizer, cToken* tokenOut, bool* sawBackslashOut)
+{
 	bool isOnNewLine = (tokenizer->inputByteIndex == 0);
-	cToken newToken = ZEROED;
-	newToken.index = tokenizer->tokens.length;
-	if (isOnNewLine) { FlagSet(newToken.flags, cTokenFlag_IsOnNewLine); }
+	ClearPointer(tokenOut);
+	*sawBackslashOut = false;
+	if (isOnNewLine) { FlagSet(tokenOut->flags, cTokenFlag_IsOnNewLine); }
 	
 	while (tokenizer->inputByteIndex < tokenizer->inputStr.length)
 	{
-		u32 codepoint = 0;
-		u8 codepointSize = GetCodepointForUtf8Str(tokenizer->inputStr, tokenizer->inputByteIndex, &codepoint);
+		//NOTE: Most input is ASCII so we skip the UTF-8 decode for bytes that are obviously a single codepoint
+		u32 codepoint = tokenizer->inputStr.bytes[tokenizer->inputByteIndex];
+		u8 codepointSize = (codepoint < 0x80) ? 1 : GetCodepointForUtf8Str(tokenizer->inputStr, tokenizer->inputByteIndex, &codepoint);
 		if (codepointSize == 0)
 		{
 			tokenizer->finished = true;
 			tokenizer->error = Result_InvalidUtf8;
-			return nullptr;
+			return false;
 		}
 		u32 nextCodepoint = 0;
 		u8 nextCodepointSize = 0;
 		if (tokenizer->inputByteIndex + codepointSize < tokenizer->inputStr.length)
 		{
-			nextCodepointSize = GetCodepointForUtf8Str(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize, &nextCodepoint);
+			nextCodepoint = tokenizer->inputStr.bytes[tokenizer->inputByteIndex + codepointSize];
+			nextCodepointSize = (nextCodepoint < 0x80) ? 1 : GetCodepointForUtf8Str(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize, &nextCodepoint);
 		}
 		
 		// +==============================+
@@ -193,7 +251,7 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 		{
 			bool twoCharNewline = (nextCodepoint != codepoint && (nextCodepoint == '\n' || nextCodepoint == '\r'));
 			isOnNewLine = true;
-			FlagSet(newToken.flags, cTokenFlag_IsOnNewLine);
+			FlagSet(tokenOut->flags, cTokenFlag_IsOnNewLine);
 			tokenizer->inputByteIndex += codepointSize + (twoCharNewline ? nextCodepointSize : 0);
 		}
 		// +==============================+
@@ -201,54 +259,25 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 		// +==============================+
 		else if (IsCharWhitespace(codepoint, false))
 		{
-			if (newToken.leadingWhitespace.chars == nullptr) { newToken.leadingWhitespace.chars = &tokenizer->inputStr.chars[tokenizer->inputByteIndex]; }
-			newToken.leadingWhitespace.length += codepointSize;
-			tokenizer->inputByteIndex += codepointSize;
+			uxx whitespaceEndIndex = FindCWhitespaceEnd(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize);
+			if (tokenOut->leadingWhitespace.chars == nullptr) { tokenOut->leadingWhitespace.chars = &tokenizer->inputStr.chars[tokenizer->inputByteIndex]; }
+			tokenOut->leadingWhitespace.length += whitespaceEndIndex - tokenizer->inputByteIndex;
+			tokenizer->inputByteIndex = whitespaceEndIndex;
 		}
 		// +==============================+
 		// |   Consume Directive Token    |
 		// +==============================+
 		else if (isOnNewLine && codepoint == '#')
 		{
-			uxx lineEndIndex = tokenizer->inputStr.length;
-			uxx identifierEndIndex = tokenizer->inputStr.length;
-			for (uxx cIndex = tokenizer->inputByteIndex + codepointSize; cIndex < tokenizer->inputStr.length; cIndex++)
-			{
-				if (tokenizer->inputStr.chars[cIndex] == '\r' || tokenizer->inputStr.chars[cIndex] == '\n')
-				{
-					lineEndIndex = cIndex;
-					if (identifierEndIndex > lineEndIndex) { identifierEndIndex = lineEndIndex; }
-					break;
-				}
-				else if (identifierEndIndex > cIndex &&
-					!IsCharAlphaNumeric(tokenizer->inputStr.chars[cIndex]) && tokenizer->inputStr.chars[cIndex] != '_')
-				{
-					identifierEndIndex = cIndex;
-				}
-			}
-			
-			newToken.type = cTokenType_Directive;
-			newToken.rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, lineEndIndex);
-			Str8 identiferStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize, identifierEndIndex);
-			newToken.str = AllocStr8(tokenizer->arena, identiferStr);
-			if (newToken.str.chars == nullptr && identiferStr.length > 0)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
+			//NOTE: New-line characters can't be part of an identifier so identifierEndIndex is never past lineEndIndex
+			uxx identifierEndIndex = FindCIdentifierEnd(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize);
+			uxx lineEndIndex = FindNextByteInStr(tokenizer->inputStr, identifierEndIndex, StrLit("\r\n"));
 			
+			tokenOut->type = cTokenType_Directive;
+			tokenOut->rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, lineEndIndex);
+			tokenOut->str = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize, identifierEndIndex);
 			tokenizer->inputByteIndex = lineEndIndex;
-			
-			cToken* allocToken = VarArrayAdd(cToken, &tokenizer->tokens);
-			if (allocToken == nullptr)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			MyMemCopy(allocToken, &newToken, sizeof(cToken));
-			break;
+			return true;
 		}
 		// +==============================+
 		// |     Consume String Token     |
@@ -257,13 +286,17 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 		{
 			uxx stringEndIndex = tokenizer->inputStr.length;
 			uxx innerStringEndIndex = tokenizer->inputStr.length;
-			for (uxx cIndex = tokenizer->inputByteIndex + codepointSize; cIndex < tokenizer->inputStr.length; cIndex++)
+			uxx cIndex = tokenizer->inputByteIndex + codepointSize;
+			while (cIndex < tokenizer->inputStr.length)
 			{
+				cIndex = FindNextByteInStr(tokenizer->inputStr, cIndex, StrLit("\"\\\n\r"));
+				if (cIndex >= tokenizer->inputStr.length) { break; }
 				if (tokenizer->inputStr.chars[cIndex] == '\\')
 				{
 					//skip the next character, we don't need to validate the escape sequence because
 					//all we care about is differentiating between a close quote and an escaped quote
-					cIndex++;
+					*sawBackslashOut = true;
+					cIndex += 2;
 				}
 				else if (tokenizer->inputStr.chars[cIndex] == '"')
 				{
@@ -271,7 +304,7 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 					innerStringEndIndex = cIndex;
 					break;
 				}
-				else if (tokenizer->inputStr.chars[cIndex] == '\n' || tokenizer->inputStr.chars[cIndex] == '\r')
+				else //new-line
 				{
 					stringEndIndex = cIndex;
 					innerStringEndIndex = cIndex;
@@ -279,66 +312,24 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 				}
 			}
 			
-			newToken.type = cTokenType_String;
-			newToken.rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, stringEndIndex);
-			Str8 innerStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize, innerStringEndIndex);
-			newToken.str = UnescapeStringEx(tokenizer->arena, innerStr, EscapeSequence_All, false);
-			if (newToken.str.chars == nullptr && innerStr.length > 0)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			if (innerStr.length != newToken.str.length) { FlagSet(newToken.flags, cTokenFlag_ContainedEscapeSequence); }
-			
+			tokenOut->type = cTokenType_String;
+			tokenOut->rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, stringEndIndex);
+			tokenOut->str = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize, innerStringEndIndex);
 			tokenizer->inputByteIndex = stringEndIndex;
-			
-			cToken* allocToken = VarArrayAdd(cToken, &tokenizer->tokens);
-			if (allocToken == nullptr)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			MyMemCopy(allocToken, &newToken, sizeof(cToken));
-			break;
+			return true;
 		}
 		// +==============================+
 		// |   Consume Identifier Token   |
 		// +==============================+
 		else if (IsCharAlphabetic(codepoint) || codepoint == '_')
 		{
-			uxx identifierEndIndex = tokenizer->inputStr.length;
-			for (uxx cIndex = tokenizer->inputByteIndex + codepointSize; cIndex < tokenizer->inputStr.length; cIndex++)
-			{
-				if (tokenizer->inputStr.chars[cIndex] != '_' && !IsCharAlphaNumeric(tokenizer->inputStr.chars[cIndex]))
-				{
-					identifierEndIndex = cIndex;
-					break;
-				}
-			}
-			
-			newToken.type = cTokenType_Identifier;
-			newToken.rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, identifierEndIndex);
-			newToken.str = AllocStr8(tokenizer->arena, newToken.rawStr);
-			if (newToken.str.chars == nullptr && newToken.rawStr.length > 0)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
+			uxx identifierEndIndex = FindCIdentifierEnd(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize);
 			
+			tokenOut->type = cTokenType_Identifier;
+			tokenOut->rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, identifierEndIndex);
+			tokenOut->str = tokenOut->rawStr;
 			tokenizer->inputByteIndex = identifierEndIndex;
-			
-			cToken* allocToken = VarArrayAdd(cToken, &tokenizer->tokens);
-			if (allocToken == nullptr)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			MyMemCopy(allocToken, &newToken, sizeof(cToken));
-			break;
+			return true;
 		}
 		// +==============================+
 		// |     Consume Number Token     |
@@ -369,27 +360,11 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 				break;
 			}
 			
-			newToken.type = cTokenType_Number;
-			newToken.rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, numberEndIndex);
-			newToken.str = AllocStr8(tokenizer->arena, newToken.rawStr);
-			if (newToken.str.chars == nullptr && newToken.rawStr.length > 0)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			
+			tokenOut->type = cTokenType_Number;
+			tokenOut->rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, numberEndIndex);
+			tokenOut->str = tokenOut->rawStr;
 			tokenizer->inputByteIndex = numberEndIndex;
-			
-			cToken* allocToken = VarArrayAdd(cToken, &tokenizer->tokens);
-			if (allocToken == nullptr)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			MyMemCopy(allocToken, &newToken, sizeof(cToken));
-			break;
+			return true;
 		}
 		// +==============================+
 		// |    Consume Comment Token     |
@@ -399,46 +374,34 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 			bool isSingleLine = (nextCodepoint == '/');
 			uxx commentEndIndex = tokenizer->inputStr.length;
 			uxx innerEndIndex = tokenizer->inputStr.length;
-			for (uxx cIndex = tokenizer->inputByteIndex + codepointSize + nextCodepointSize; cIndex < tokenizer->inputStr.length; cIndex++)
+			uxx innerStartIndex = tokenizer->inputByteIndex + codepointSize + nextCodepointSize;
+			if (isSingleLine)
 			{
-				if (isSingleLine && (tokenizer->inputStr.chars[cIndex] == '\n' || tokenizer->inputStr.chars[cIndex] == '\r'))
+				commentEndIndex = FindNextByteInStr(tokenizer->inputStr, innerStartIndex, StrLit("\n\r"));
+				innerEndIndex = commentEndIndex;
+			}
+			else
+			{
+				for (uxx cIndex = FindNextByteInStr(tokenizer->inputStr, innerStartIndex, StrLit("*"));
+					cIndex+1 < tokenizer->inputStr.length;
+					cIndex = FindNextByteInStr(tokenizer->inputStr, cIndex+1, StrLit("*")))
 				{
-					commentEndIndex = cIndex;
-					innerEndIndex = cIndex;
-					break;
-				}
-				else if (!isSingleLine && cIndex+1 < tokenizer->inputStr.length && tokenizer->inputStr.chars[cIndex] == '*' && tokenizer->inputStr.chars[cIndex+1] == '/')
-				{
-					commentEndIndex = cIndex+2;
-					innerEndIndex = cIndex;
-					break;
+					if (tokenizer->inputStr.chars[cIndex+1] == '/')
+					{
+						commentEndIndex = cIndex+2;
+						innerEndIndex = cIndex;
+						break;
+					}
 				}
 			}
 			
-			if (isSingleLine) { FlagSet(newToken.flags, cTokenFlag_IsDoubleSlashComment); }
-			
-			newToken.type = cTokenType_Comment;
-			newToken.rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, commentEndIndex);
-			Str8 innerStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex + codepointSize + nextCodepointSize, innerEndIndex);
-			newToken.str = AllocStr8(tokenizer->arena, innerStr);
-			if (newToken.str.chars == nullptr && innerStr.length > 0)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
+			if (isSingleLine) { FlagSet(tokenOut->flags, cTokenFlag_IsDoubleSlashComment); }
 			
+			tokenOut->type = cTokenType_Comment;
+			tokenOut->rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, commentEndIndex);
+			tokenOut->str = StrSlice(tokenizer->inputStr, innerStartIndex, innerEndIndex);
 			tokenizer->inputByteIndex = commentEndIndex;
-			
-			cToken* allocToken = VarArrayAdd(cToken, &tokenizer->tokens);
-			if (allocToken == nullptr)
-			{
-				tokenizer->finished = true;
-				tokenizer->error = Result_FailedToAllocateMemory;
-				return nullptr;
-			}
-			MyMemCopy(allocToken, &newToken, sizeof(cToken));
-			break;
+			return true;
 		}
 		// +==============================+
 		// |    Consume Operator Token    |
@@ -446,7 +409,9 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 		else
 		{
 			uxx operatorEndIndex = tokenizer->inputByteIndex + codepointSize;
-			for (uxx oIndex = 0; oIndex < ArrayCount(WellKnownMulticharOperators); oIndex++)
+			//NOTE: All the well-known operators are made of ASCII punctuation, so most single-character operators (followed by whitespace or an identifier) can skip the search
+			bool couldBeMultichar = (nextCodepoint < 0x80 && nextCodepoint > ' ' && !IsCharAlphaNumeric(nextCodepoint) && nextCodepoint != '_');
+			for (uxx oIndex = 0; couldBeMultichar && oIndex < ArrayCount(WellKnownMulticharOperators); oIndex++)
 			{
 				DebugAssertMsg(WellKnownMulticharOperators[oIndex][2] == '\0', "This code only handles 2-character operators right now!");
 				if (codepoint == CharToU32(WellKnownMulticharOperators[oIndex][0]) && nextCodepoint == CharToU32(WellKnownMulticharOperators[oIndex][1]))
@@ -456,28 +421,57 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 				}
 			}
 			
-			newToken.type = cTokenType_Operator;
-			newToken.rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, operatorEndIndex);
-			newToken.str = AllocStr8(tokenizer->arena, newToken.rawStr);
-			if (newToken.str.chars == nullptr && newToken.rawStr.length > 0)
+			tokenOut->type = cTokenType_Operator;
+			tokenOut->rawStr = StrSlice(tokenizer->inputStr, tokenizer->inputByteIndex, operatorEndIndex);
+			tokenOut->str = tokenOut->rawStr;
+			tokenizer->inputByteIndex = operatorEndIndex;
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+PEXP cToken* NextCToken(cTokenizer* tokenizer)
+{
+	NotNull(tokenizer);
+	NotNull(tokenizer->arena);
+	Assert(!tokenizer->streaming);
+	
+	if (tokenizer->finished) { return nullptr; }
+	
+	if (tokenizer->outputTokenIndex >= tokenizer->tokens.length)
+	{
+		cToken newToken = ZEROED;
+		bool sawBackslash = false;
+		if (ScanCToken(tokenizer, &newToken, &sawBackslash))
+		{
+			newToken.index = tokenizer->tokens.length;
+			Str8 sliceStr = newToken.str;
+			if (newToken.type == cTokenType_String)
+			{
+				newToken.str = UnescapeStringEx(tokenizer->arena, sliceStr, EscapeSequence_All, false);
+				if (sliceStr.length != newToken.str.length) { FlagSet(newToken.flags, cTokenFlag_ContainedEscapeSequence); }
+			}
+			else { newToken.str = AllocStr8(tokenizer->arena, sliceStr); }
+			if (newToken.str.chars == nullptr && sliceStr.length > 0)
 			{
 				tokenizer->finished = true;
 				tokenizer->error = Result_FailedToAllocateMemory;
 				return nullptr;
 			}
 			
-			tokenizer->inputByteIndex = operatorEndIndex;
-			
 			cToken* allocToken = VarArrayAdd(cToken, &tokenizer->tokens);
 			if (allocToken == nullptr)
 			{
+				FreeStr8(tokenizer->arena, &newToken.str);
 				tokenizer->finished = true;
 				tokenizer->error = Result_FailedToAllocateMemory;
 				return nullptr;
 			}
 			MyMemCopy(allocToken, &newToken, sizeof(cToken));
-			break;
 		}
+		else if (tokenizer->finished) { return nullptr; }
 	}
 	
 	if (tokenizer->outputTokenIndex < tokenizer->tokens.length)
@@ -500,6 +494,70 @@ PEXP cToken* NextCToken(cTokenizer* tokenizer)
 	return nullptr;
 }
 
+// Returns the next token by value without allocating anything per-token. tokenOut->str is a slice of inputStr,
+// except when a string contained escape sequences, in which case it points into tokenizer->unescapeBuffer and
+// is only valid until the next call. Only works on a tokenizer made with NewCTokenizerStream
+PEXP bool NextCTokenStream(cTokenizer* tokenizer, cToken* tokenOut)
+{
+	NotNull(tokenizer);
+	NotNull(tokenizer->arena);
+	NotNull(tokenOut);
+	Assert(tokenizer->streaming);
+	
+	if (tokenizer->finished) { return false; }
+	
+	bool sawBackslash = false;
+	if (!ScanCToken(tokenizer, tokenOut, &sawBackslash))
+	{
+		if (!tokenizer->finished)
+		{
+			tokenizer->finished = true;
+			tokenizer->error = Result_Success;
+		}
+		return false;
+	}
+	tokenOut->index = tokenizer->outputTokenIndex;
+	tokenizer->outputTokenIndex++;
+	
+	if (tokenOut->type == cTokenType_String && sawBackslash)
+	{
+		//Unescaping never makes a string longer, so a buffer as long as the escaped string is always big enough
+		if (tokenizer->unescapeBufferSize < tokenOut->str.length)
+		{
+			uxx newBufferSize = MaxUXX(tokenizer->unescapeBufferSize, 64);
+			while (newBufferSize < tokenOut->str.length) { newBufferSize *= 2; }
+			if (tokenizer->unescapeBuffer != nullptr && CanArenaFree(tokenizer->arena))
+			{
+				FreeMem(tokenizer->arena, tokenizer->unescapeBuffer, tokenizer->unescapeBufferSize);
+			}
+			tokenizer->unescapeBuffer = (char*)AllocMem(tokenizer->arena, newBufferSize);
+			tokenizer->unescapeBufferSize = (tokenizer->unescapeBuffer != nullptr) ? newBufferSize : 0;
+			if (tokenizer->unescapeBuffer == nullptr)
+			{
+				tokenizer->finished = true;
+				tokenizer->error = Result_FailedToAllocateMemory;
+				return false;
+			}
+		}
+		
+		Arena bufferArena = ZEROED;
+		InitArenaBuffer(&bufferArena, tokenizer->unescapeBuffer, tokenizer->unescapeBufferSize);
+		Str8 unescapedStr = UnescapeStringEx(&bufferArena, tokenOut->str, EscapeSequence_All, false);
+		if (unescapedStr.length != tokenOut->str.length)
+		{
+			FlagSet(tokenOut->flags, cTokenFlag_ContainedEscapeSequence);
+			tokenOut->str = unescapedStr;
+		}
+	}
+	
+	if (tokenizer->inputByteIndex >= tokenizer->inputStr.length)
+	{
+		tokenizer->finished = true;
+		tokenizer->error = Result_Success;
+	}
+	return true;
+}
+
 #endif //PIG_CORE_IMPLEMENTATION
 
 #endif //  _PARSE_C_TOKENIZER_H
@@ -5,6 +5,11 @@ Date:   09\03\2025
 Description:
 	** Contains code that helps us serialize to and deserialize from Google's Protocol Buffers (aka protobuf) format
 	** NOTE: We use protobuf-c as a C version of the protobuf API instead of the officially supported C++ version
+	** ProtobufUnpackInArenaAliased is like ProtobufUnpackInArena but bytes fields point directly into the packed Slice
+	** instead of being copied out of it, so the packed Slice must outlive the unpacked message.
+	** NOTE: string fields are always copied since protobuf-c stores them as null-terminated char* and the packed data has no room for a terminator
+	** A PbStreamPacker packs many messages, each prefixed with a varint length, into one growing arena allocation
+	** or through a fixed size staging buffer into an OsFile, without allocating a PbBuffer for each message.
 */
 
 #ifndef _PARSE_PROTOBUF_H
@@ -17,6 +22,9 @@ Description:
 #include "std/std_memset.h"
 #include "mem/mem_arena.h"
 #include "base/base_debug_output.h"
+#include "std/std_basic_math.h"
+#include "struct/struct_string.h"
+#include "os/os_file.h"
 
 #if BUILD_WITH_PROTOBUF
 
@@ -35,6 +43,31 @@ Description:
 #endif
 #include "third_party/protobuf_c/protobuf-c/protobuf-c.h"
 #if PIG_CORE_IMPLEMENTATION
+// The aliasing allocator is recognized by protobuf-c through PROTOBUF_C_ALIAS_BYTES so it needs to be defined before we #include protobuf-c.c
+typedef plex ProtobufAliasContext ProtobufAliasContext;
+plex ProtobufAliasContext
+{
+	Arena* arena;
+	Slice packedSlice;
+};
+static void* ProtobufAllocator_AliasingAlloc(void* contextPntr, size_t numBytes)
+{
+	return AllocMem(((ProtobufAliasContext*)contextPntr)->arena, (uxx)numBytes);
+}
+static void ProtobufAllocator_AliasingFree(void* contextPntr, void* pointer)
+{
+	ProtobufAliasContext* context = (ProtobufAliasContext*)contextPntr;
+	if ((u8*)pointer >= context->packedSlice.bytes && (u8*)pointer < context->packedSlice.bytes + context->packedSlice.length) { return; } //aliased, not ours to free
+	if (CanArenaFree(context->arena)) { FreeMem(context->arena, pointer, 0); }
+}
+static void* ProtobufAllocator_TryAliasBytes(ProtobufCAllocator* allocator, const u8* dataPntr, size_t dataLength)
+{
+	if (allocator == nullptr || allocator->alloc != ProtobufAllocator_AliasingAlloc) { return nullptr; }
+	UNUSED(dataLength);
+	DebugAssert(dataPntr >= ((ProtobufAliasContext*)allocator->allocator_data)->packedSlice.bytes);
+	return (void*)dataPntr;
+}
+#define PROTOBUF_C_ALIAS_BYTES(allocator, dataPntr, dataLength) ProtobufAllocator_TryAliasBytes((allocator), (dataPntr), (dataLength))
 #include "third_party/protobuf_c/protobuf-c/protobuf-c.c"
 #endif
 #if COMPILER_IS_MSVC
@@ -54,6 +87,25 @@ plex PbBuffer
 };
 #define MakePbBuffer(bufferLength, bufferPntr) NEW_STRUCT(PbBuffer){ .buffer = { .append = ProtobufBuffer_Append }, .length=0, .allocLength=(bufferLength), .pntr=(bufferPntr) }
 
+#define PROTOBUF_MAX_VARINT_SIZE          10 //bytes, enough for any u64
+#define PB_STREAM_PACKER_MIN_ALLOC_SIZE   256 //bytes
+#define PB_STREAM_PACKER_FILE_BUFFER_SIZE Kilobytes(64)
+
+//NOTE: Each message is written as a varint length followed by the packed message, the same framing as Google's writeDelimitedTo/parseDelimitedFrom
+typedef plex PbStreamPacker PbStreamPacker;
+plex PbStreamPacker
+{
+	ProtobufCBuffer buffer; //NOTE: Must be first, protobuf-c hands us back this pointer for large messages in file mode
+	Arena* arena;
+	OsFile* file; //nullptr when packing into the arena
+	bool error; //set if an allocation or file write failed, all further packing is ignored
+	uxx numMessages;
+	u64 totalLength; //bytes packed so far, including bytes still sitting in the staging buffer in file mode
+	uxx length;
+	uxx allocLength;
+	u8* pntr; //arena mode: every message packed so far, file mode: staging buffer that gets flushed to the file when it fills up
+};
+
 // +--------------------------------------------------------------+
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
@@ -68,6 +120,19 @@ plex PbBuffer
 	PIG_CORE_INLINE Slice ProtobufPackInArena_(Arena* arena, const ProtobufCMessage* message);
 	#endif
 	PIG_CORE_INLINE void* ProtobufUnpackInArena_(const ProtobufCMessageDescriptor* descriptorPntr, Arena* arena, Slice packedSlice);
+	PIG_CORE_INLINE void* ProtobufUnpackInArenaAliased_(const ProtobufCMessageDescriptor* descriptorPntr, Arena* arena, Slice packedSlice);
+	PIG_CORE_INLINE uxx ProtobufEncodeVarint(u64 value, u8* bufferOut);
+	PIG_CORE_INLINE void FreePbStreamPacker(PbStreamPacker* packer);
+	PIG_CORE_INLINE void InitPbStreamPackerInArena(PbStreamPacker* packerOut, Arena* arena, uxx initialCapacity);
+	PIG_CORE_INLINE void InitPbStreamPackerForFile(PbStreamPacker* packerOut, Arena* arena, OsFile* file);
+	bool FlushPbStreamPacker(PbStreamPacker* packer);
+	void ProtobufStreamPacker_Append(ProtobufCBuffer* bufferPntr, size_t dataLength, const u8* dataPntr);
+	#if DEBUG_BUILD
+	bool ProtobufStreamPack_(const ProtobufCMessageDescriptor* descriptorPntr, PbStreamPacker* packer, const ProtobufCMessage* message);
+	#else
+	bool ProtobufStreamPack_(PbStreamPacker* packer, const ProtobufCMessage* message);
+	#endif
+	PIG_CORE_INLINE Slice GetPbStreamPackerSlice(const PbStreamPacker* packer);
 #endif
 
 #if DEBUG_BUILD
@@ -77,6 +142,13 @@ plex PbBuffer
 #endif
 
 #define ProtobufUnpackInArena(type, lowercaseType, arenaPntr, packedSlice) (type*)ProtobufUnpackInArena_(&lowercaseType##__descriptor, (arenaPntr), (packedSlice))
+#define ProtobufUnpackInArenaAliased(type, lowercaseType, arenaPntr, packedSlice) (type*)ProtobufUnpackInArenaAliased_(&lowercaseType##__descriptor, (arenaPntr), (packedSlice))
+
+#if DEBUG_BUILD
+#define ProtobufStreamPack(lowercaseType, packerPntr, structPntr) ProtobufStreamPack_(&lowercaseType##__descriptor, (packerPntr), &(structPntr)->base)
+#else
+#define ProtobufStreamPack(lowercaseType, packerPntr, structPntr) ProtobufStreamPack_((packerPntr), &(structPntr)->base)
+#endif
 
 // +--------------------------------------------------------------+
 // |                   Function Implementations                   |
@@ -158,8 +230,180 @@ PEXPI void* ProtobufUnpackInArena_(const ProtobufCMessageDescriptor* descriptorP
 	return result;
 }
 
+//NOTE: bytes fields in the result point into packedSlice, so packedSlice must stay alive (and unchanged) as long as the result is used.
+//Don't pass the result to __free_unpacked with a regular ProtobufAllocatorFromArena allocator, free/reset the arena instead
+PEXPI void* ProtobufUnpackInArenaAliased_(const ProtobufCMessageDescriptor* descriptorPntr, Arena* arena, Slice packedSlice)
+{
+	NotNull(descriptorPntr);
+	NotNull(arena);
+	ProtobufAliasContext context = ZEROED;
+	context.arena = arena;
+	context.packedSlice = packedSlice;
+	ProtobufCAllocator allocator = ZEROED;
+	allocator.allocator_data = (void*)&context;
+	allocator.alloc = ProtobufAllocator_AliasingAlloc;
+	allocator.free = ProtobufAllocator_AliasingFree;
+	ProtobufCMessage* result = protobuf_c_message_unpack(descriptorPntr, &allocator, packedSlice.length, packedSlice.bytes);
+	DebugAssert(result == nullptr || result->descriptor == descriptorPntr);
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                       Stream Packing                         |
+// +--------------------------------------------------------------+
+//NOTE: bufferOut must have room for PROTOBUF_MAX_VARINT_SIZE bytes, returns the number of bytes written
+PEXPI uxx ProtobufEncodeVarint(u64 value, u8* bufferOut)
+{
+	NotNull(bufferOut);
+	uxx result = 0;
+	while (value >= 0x80)
+	{
+		bufferOut[result++] = (u8)(value | 0x80);
+		value >>= 7;
+	}
+	bufferOut[result++] = (u8)value;
+	return result;
+}
+
+PEXPI void FreePbStreamPacker(PbStreamPacker* packer)
+{
+	NotNull(packer);
+	if (packer->arena != nullptr && packer->pntr != nullptr) { FreeMem(packer->arena, packer->pntr, packer->allocLength); }
+	ClearPointer(packer);
+}
+
+//Writes the staging buffer to the file (does nothing in arena mode). Returns false if the packer has hit an error at any point
+PEXP bool FlushPbStreamPacker(PbStreamPacker* packer)
+{
+	NotNull(packer);
+	if (packer->error) { return false; }
+	if (packer->file == nullptr || packer->length == 0) { return true; }
+	if (!OsWriteToOpenBinFile(packer->file, MakeStr8(packer->length, (const char*)packer->pntr))) { packer->error = true; return false; }
+	packer->length = 0;
+	return true;
+}
+
+//Makes sure there is room for numBytes more bytes in the buffer. In arena mode the buffer grows, in file mode the staging buffer is flushed
+static bool PbStreamPackerReserve(PbStreamPacker* packer, uxx numBytes)
+{
+	if (packer->error) { return false; }
+	if (packer->length + numBytes <= packer->allocLength) { return true; }
+	if (packer->file != nullptr)
+	{
+		if (!FlushPbStreamPacker(packer)) { return false; }
+		return (numBytes <= packer->allocLength);
+	}
+	
+	uxx newAllocLength = MaxUXX(packer->allocLength, PB_STREAM_PACKER_MIN_ALLOC_SIZE);
+	while (newAllocLength < packer->length + numBytes) { newAllocLength *= 2; }
+	u8* newPntr = (u8*)ReallocMem(packer->arena, packer->pntr, packer->allocLength, newAllocLength);
+	if (newPntr == nullptr) { packer->error = true; return false; }
+	packer->pntr = newPntr;
+	packer->allocLength = newAllocLength;
+	return true;
+}
+
+//Only used for messages that don't fit in the staging buffer in file mode, protobuf-c calls this many times with small pieces of the message
+PEXP void ProtobufStreamPacker_Append(ProtobufCBuffer* bufferPntr, size_t dataLength, const u8* dataPntr)
+{
+	PbStreamPacker* packer = (PbStreamPacker*)bufferPntr;
+	if (packer->error || dataLength == 0) { return; }
+	Assert(dataLength <= UINTXX_MAX);
+	if ((uxx)dataLength > packer->allocLength && packer->file != nullptr)
+	{
+		if (!FlushPbStreamPacker(packer)) { return; }
+		if (!OsWriteToOpenBinFile(packer->file, MakeStr8((uxx)dataLength, (const char*)dataPntr))) { packer->error = true; }
+		return;
+	}
+	if (!PbStreamPackerReserve(packer, (uxx)dataLength)) { return; }
+	MyMemCopy(packer->pntr + packer->length, dataPntr, (uxx)dataLength);
+	packer->length += (uxx)dataLength;
+}
+
+PEXPI void InitPbStreamPackerInArena(PbStreamPacker* packerOut, Arena* arena, uxx initialCapacity)
+{
+	NotNull(packerOut);
+	NotNull(arena);
+	ClearPointer(packerOut);
+	packerOut->buffer.append = ProtobufStreamPacker_Append;
+	packerOut->arena = arena;
+	if (initialCapacity > 0)
+	{
+		packerOut->pntr = (u8*)AllocMem(arena, initialCapacity);
+		if (packerOut->pntr != nullptr) { packerOut->allocLength = initialCapacity; }
+	}
+}
+
+//NOTE: The staging buffer is allocated from arena, file must already be open for writing and stay open until the packer is flushed
+PEXPI void InitPbStreamPackerForFile(PbStreamPacker* packerOut, Arena* arena, OsFile* file)
+{
+	NotNull(packerOut);
+	NotNull(arena);
+	NotNull(file);
+	Assert(file->isOpen && file->openedForWriting);
+	ClearPointer(packerOut);
+	packerOut->buffer.append = ProtobufStreamPacker_Append;
+	packerOut->arena = arena;
+	packerOut->file = file;
+	packerOut->pntr = (u8*)AllocMem(arena, PB_STREAM_PACKER_FILE_BUFFER_SIZE);
+	if (packerOut->pntr != nullptr) { packerOut->allocLength = PB_STREAM_PACKER_FILE_BUFFER_SIZE; }
+	else { packerOut->error = true; }
+}
+
+#if DEBUG_BUILD
+PEXP bool ProtobufStreamPack_(const ProtobufCMessageDescriptor* descriptorPntr, PbStreamPacker* packer, const ProtobufCMessage* message)
+#else
+PEXP bool ProtobufStreamPack_(PbStreamPacker* packer, const ProtobufCMessage* message)
+#endif
+{
+	NotNull(packer);
+	NotNull(message);
+	#if DEBUG_BUILD
+	AssertMsg(message->descriptor == descriptorPntr, "Wrong type passed to ProtobufStreamPack() macro!");
+	#endif
+	if (packer->error) { return false; }
+	
+	u64 packedSize = (u64)protobuf_c_message_get_packed_size(message);
+	u8 prefixBytes[PROTOBUF_MAX_VARINT_SIZE];
+	uxx prefixSize = ProtobufEncodeVarint(packedSize, &prefixBytes[0]);
+	uxx totalSize = prefixSize + (uxx)packedSize;
+	
+	if (PbStreamPackerReserve(packer, totalSize))
+	{
+		//Common case: pack straight into the arena buffer (or staging buffer) with no intermediate copies
+		MyMemCopy(packer->pntr + packer->length, &prefixBytes[0], prefixSize);
+		size_t packResult = protobuf_c_message_pack(message, packer->pntr + packer->length + prefixSize);
+		DebugAssert((u64)packResult == packedSize);
+		packer->length += totalSize;
+	}
+	else if (!packer->error && packer->file != nullptr)
+	{
+		//The message is bigger than the staging buffer, let protobuf-c stream it to the file in pieces
+		ProtobufStreamPacker_Append(&packer->buffer, prefixSize, &prefixBytes[0]);
+		size_t packResult = protobuf_c_message_pack_to_buffer(message, &packer->buffer);
+		DebugAssert((u64)packResult == packedSize);
+	}
+	if (packer->error) { return false; }
+	
+	packer->totalLength += totalSize;
+	packer->numMessages++;
+	return true;
+}
+
+//NOTE: Only valid in arena mode, the Slice is invalidated by the next ProtobufStreamPack
+PEXPI Slice GetPbStreamPackerSlice(const PbStreamPacker* packer)
+{
+	NotNull(packer);
+	Assert(packer->file == nullptr);
+	return MakeSlice(packer->length, packer->pntr);
+}
+
 #endif //PIG_CORE_IMPLEMENTATION
 
 #endif //BUILD_WITH_PROTOBUF
 
 #endif //  _PARSE_PROTOBUF_H
+
+#if defined(_STRUCT_STREAM_H) && defined(_PARSE_PROTOBUF_H)
+#include "cross/cross_stream_and_protobuf.h"
+#endif
@@ -35,9 +35,21 @@ Description:
 #include "struct/struct_var_array.h"
 #include "parse/parse_simple_parsers.h"
 #include "parse/parse_metadesk.h"
+#include "os/os_time.h"
+#include "os/os_threading.h"
+#include "os/os_thread_pool.h"
+#include "os/os_dir_walk.h"
+#include "misc/misc_hash.h"
+#include "struct/struct_string_builder.h"
 
 #include "base/base_debug_output_impl.h"
 
+#define PIGGEN_CACHE_FILENAME      "piggen_cache.bin"
+#define PIGGEN_CACHE_MAGIC         0x4548434143474950ULL //"PIGCACHE"
+#define PIGGEN_CACHE_VERSION       1
+#define PIGGEN_DEFAULT_NUM_THREADS 8
+#define PIGGEN_THREAD_SCRATCH_SIZE Gigabytes(1)
+
 const char* SourceFileExtensions[] = {
 	".c",
 	".cpp",
@@ -68,15 +80,67 @@ plex Snippet
 	VarArray pieces; //SnippetPiece
 };
 
+// The cache remembers what each source file looked like the last time piggen ran on it
+// (after any #include splicing) and the raw text of the snippets found inside it.
+// Files whose size and write time (or content hash) still match skip reading and scanning entirely
+typedef plex PiggenCacheSnippet PiggenCacheSnippet;
+plex PiggenCacheSnippet
+{
+	FilePath genFilePath;
+	u64 sourceLineNum;
+	Str8 snippetStr;
+};
+typedef plex PiggenCacheEntry PiggenCacheEntry;
+plex PiggenCacheEntry
+{
+	FilePath path;
+	u64 fileSize;
+	OsFileWriteTime writeTime;
+	u64 contentHash;
+	VarArray snippets; //PiggenCacheSnippet
+};
+
+// The size and write time come from the directory walk so we don't need to stat each file again before checking the cache
+typedef plex PiggenSourceFile PiggenSourceFile;
+plex PiggenSourceFile
+{
+	FilePath path;
+	u64 fileSize;
+	OsFileWriteTime writeTime;
+};
+
+typedef plex PiggenFile PiggenFile;
+plex PiggenFile
+{
+	FilePath path;
+	Arena arena; //each file gets it's own heap arena so worker threads never allocate from mainArena
+	PiggenCacheEntry* cacheEntry; //nullptr if the file was not in the cache, shared between threads so it must not be modified
+	
+	bool readFailed;
+	bool matchedCache;
+	bool hadErrors; //files with errors are not cached, so the errors are reported again on the next run
+	u64 fileSize;
+	OsFileWriteTime writeTime;
+	u64 contentHash;
+	
+	VarArray snippets; //Snippet
+};
+
 typedef plex PiggenState PiggenState;
 plex PiggenState
 {
 	Arena* mainArena; //really this is just scratch[0]
 	ProgramArgs args;
 	FilePath outputFolderPath;
+	FilePath cacheFilePath;
+	bool ignoreCache;
+	uxx numThreads;
 	VarArray searchPaths; //FilePath
 	VarArray excludePaths; //FilePath
-	VarArray sourceFilePaths; //FilePath
+	VarArray sourceFiles; //PiggenSourceFile
+	VarArray cacheEntries; //PiggenCacheEntry
+	uxx numFiles;
+	PiggenFile* files;
 	VarArray snippets; //Snippet
 };
 PiggenState* piggen = nullptr;
@@ -97,41 +161,38 @@ bool ShouldExcludePath(FilePath fileOrFolderPath)
 	return false;
 }
 
+static OS_DIR_WALK_EXCLUDE_FUNC_DEF(PiggenDirWalkExclude)
+{
+	UNUSED(relativePath);
+	UNUSED(contextPntr);
+	if (ShouldExcludePath(fullPath)) { return true; }
+	if (isFolder) { return false; }
+	for (uxx eIndex = 0; eIndex < ArrayCount(SourceFileExtensions); eIndex++)
+	{
+		if (StrAnyCaseEndsWith(fullPath, MakeStr8Nt(SourceFileExtensions[eIndex]))) { return false; }
+	}
+	return true; //files without a source extension are left out of the walk results entirely
+}
+
 //Returns number of folders searched
-uxx FindSourceFilesInFolderRecursive(FilePath folderPath, uxx maxDepth, uxx depth)
+uxx FindSourceFilesInFolder(FilePath folderPath)
 {
 	// PrintLine_D("Searching folder \"%.*s\"", StrPrint(folderPath));
-	uxx numFoldersSearched = 1;
 	ScratchBegin1(scratch, piggen->mainArena);
-	OsFileIter fileIter = OsIterateFiles(scratch, folderPath, true, true);
-	bool isFolder = false;
-	FilePath filePath = Str8_Empty;
-	while (OsIterFileStepEx(&fileIter, &isFolder, &filePath, scratch, true))
+	OsDirWalk walk = ZEROED;
+	Result walkResult = OsWalkDirectory(scratch, folderPath, 0, PiggenDirWalkExclude, nullptr, nullptr, &walk);
+	if (walkResult != Result_Success) { PrintLine_W("WARNING: Failed to search all of \"%.*s\": %s", StrPrint(folderPath), GetResultStr(walkResult)); }
+	OsDirWalkLoop(&walk, entry)
 	{
-		if (isFolder)
-		{
-			if (maxDepth == 0 || depth < maxDepth)
-			{
-				if (!ShouldExcludePath(filePath))
-				{
-					numFoldersSearched += FindSourceFilesInFolderRecursive(filePath, maxDepth, depth+1);
-				}
-			}
-		}
-		else if (!ShouldExcludePath(filePath))
-		{
-			bool hasSourceExtension = false;
-			for (uxx eIndex = 0; eIndex < ArrayCount(SourceFileExtensions); eIndex++)
-			{
-				if (StrAnyCaseEndsWith(filePath, MakeStr8Nt(SourceFileExtensions[eIndex])))
-				{
-					hasSourceExtension = true;
-					break;
-				}
-			}
-			if (hasSourceExtension) { VarArrayAddValue(FilePath, &piggen->sourceFilePaths, AllocStr8(piggen->mainArena, filePath)); }
-		}
+		if (entry->isFolder) { continue; }
+		PiggenSourceFile* sourceFile = VarArrayAdd(PiggenSourceFile, &piggen->sourceFiles);
+		NotNull(sourceFile);
+		ClearPointer(sourceFile);
+		sourceFile->path = PrintInArenaStr(piggen->mainArena, "%.*s/%.*s", StrPrint(walk.rootPath), StrPrint(entry->path));
+		sourceFile->fileSize = entry->size;
+		sourceFile->writeTime = entry->writeTime;
 	}
+	uxx numFoldersSearched = walk.numFoldersSearched;
 	ScratchEnd(scratch);
 	return numFoldersSearched;
 }
@@ -154,11 +215,477 @@ Str8 SpliceFile(Arena* arena, FilePath filePath, Str8 fileContents, uxx startInd
 	return newFileContents;
 }
 
+void PrintSnippetPieces(Snippet* snippet)
+{
+	NotNull(snippet);
+	Str8 sourceFileName = GetFileNamePart(snippet->sourceFilePath, true);
+	PrintLine_D("Snippet has %llu piece%s in \"%.*s\" line %llu:", snippet->pieces.length, Plural(snippet->pieces.length, "s"), StrPrint(sourceFileName), snippet->sourceLineNum);
+	VarArrayLoop(&snippet->pieces, pIndex)
+	{
+		VarArrayLoopGet(SnippetPiece, piece, &snippet->pieces, pIndex);
+		Str8 snippetNodeName = ToStr8FromMd(piece->rootNode->string);
+		PrintLine_D("\tPiece[%llu]: %.*s \"%.*s\"", (u64)pIndex, StrPrint(piece->typeStr), StrPrint(snippetNodeName));
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                         Cache File                           |
+// +--------------------------------------------------------------+
+// Format (all integers are u64 in native byte order, the cache is never shared between machines):
+//   magic, version, sizeof(OsFileWriteTime), numEntries
+//   entry:   path, fileSize, writeTime (raw bytes), contentHash, numSnippets
+//   snippet: genFilePath, sourceLineNum, snippetStr
+//   strings are stored as a u64 length followed by the bytes (no null-terminator)
+static bool ReadPiggenCacheBytes(Slice cacheData, uxx* readIndex, uxx numBytes, void* bytesOut)
+{
+	if (numBytes > cacheData.length - *readIndex) { return false; }
+	if (numBytes > 0) { MyMemCopy(bytesOut, &cacheData.bytes[*readIndex], numBytes); }
+	*readIndex += numBytes;
+	return true;
+}
+static bool ReadPiggenCacheU64(Slice cacheData, uxx* readIndex, u64* valueOut)
+{
+	return ReadPiggenCacheBytes(cacheData, readIndex, sizeof(u64), valueOut);
+}
+static bool ReadPiggenCacheStr(Arena* arena, Slice cacheData, uxx* readIndex, Str8* strOut)
+{
+	u64 length = 0;
+	if (!ReadPiggenCacheU64(cacheData, readIndex, &length)) { return false; }
+	if (length > cacheData.length - *readIndex) { return false; }
+	*strOut = AllocStr8(arena, MakeStr8((uxx)length, &cacheData.chars[*readIndex]));
+	*readIndex += (uxx)length;
+	return true;
+}
+
+static bool ParsePiggenCache(Arena* arena, Slice cacheData, VarArray* entriesOut)
+{
+	uxx readIndex = 0;
+	u64 magic = 0, version = 0, writeTimeSize = 0, numEntries = 0;
+	if (!ReadPiggenCacheU64(cacheData, &readIndex, &magic) || magic != PIGGEN_CACHE_MAGIC) { return false; }
+	if (!ReadPiggenCacheU64(cacheData, &readIndex, &version) || version != PIGGEN_CACHE_VERSION) { return false; }
+	if (!ReadPiggenCacheU64(cacheData, &readIndex, &writeTimeSize) || writeTimeSize != sizeof(OsFileWriteTime)) { return false; }
+	if (!ReadPiggenCacheU64(cacheData, &readIndex, &numEntries)) { return false; }
+	
+	for (u64 eIndex = 0; eIndex < numEntries; eIndex++)
+	{
+		PiggenCacheEntry* entry = VarArrayAdd(PiggenCacheEntry, entriesOut);
+		NotNull(entry);
+		ClearPointer(entry);
+		u64 numSnippets = 0;
+		if (!ReadPiggenCacheStr(arena, cacheData, &readIndex, &entry->path)) { return false; }
+		if (!ReadPiggenCacheU64(cacheData, &readIndex, &entry->fileSize)) { return false; }
+		if (!ReadPiggenCacheBytes(cacheData, &readIndex, sizeof(OsFileWriteTime), &entry->writeTime)) { return false; }
+		if (!ReadPiggenCacheU64(cacheData, &readIndex, &entry->contentHash)) { return false; }
+		if (!ReadPiggenCacheU64(cacheData, &readIndex, &numSnippets)) { return false; }
+		InitVarArray(PiggenCacheSnippet, &entry->snippets, arena);
+		for (u64 sIndex = 0; sIndex < numSnippets; sIndex++)
+		{
+			PiggenCacheSnippet* snippet = VarArrayAdd(PiggenCacheSnippet, &entry->snippets);
+			NotNull(snippet);
+			ClearPointer(snippet);
+			if (!ReadPiggenCacheStr(arena, cacheData, &readIndex, &snippet->genFilePath)) { return false; }
+			if (!ReadPiggenCacheU64(cacheData, &readIndex, &snippet->sourceLineNum)) { return false; }
+			if (!ReadPiggenCacheStr(arena, cacheData, &readIndex, &snippet->snippetStr)) { return false; }
+		}
+	}
+	return (readIndex == cacheData.length);
+}
+
+// Fills piggen->cacheEntries, returns false (and leaves it empty) if the cache file is missing or can't be parsed
+bool LoadPiggenCache()
+{
+	InitVarArray(PiggenCacheEntry, &piggen->cacheEntries, piggen->mainArena);
+	if (!OsDoesFileExist(piggen->cacheFilePath)) { return false; }
+	
+	uxx arenaMark = ArenaGetMark(piggen->mainArena);
+	Slice cacheData = Str8_Empty;
+	if (!OsReadBinFile(piggen->cacheFilePath, piggen->mainArena, &cacheData)) { return false; }
+	if (!ParsePiggenCache(piggen->mainArena, cacheData, &piggen->cacheEntries))
+	{
+		PrintLine_W("WARNING: Ignoring invalid or outdated cache file \"%.*s\"", StrPrint(piggen->cacheFilePath));
+		ArenaResetToMark(piggen->mainArena, arenaMark);
+		InitVarArray(PiggenCacheEntry, &piggen->cacheEntries, piggen->mainArena);
+		return false;
+	}
+	return true;
+}
+
+// Source files are found in the same order every run so the entry at the same index is almost always the right one
+PiggenCacheEntry* FindPiggenCacheEntry(FilePath path, uxx hintIndex)
+{
+	if (hintIndex < piggen->cacheEntries.length)
+	{
+		PiggenCacheEntry* hintEntry = VarArrayGet(PiggenCacheEntry, &piggen->cacheEntries, hintIndex);
+		if (StrExactEquals(hintEntry->path, path)) { return hintEntry; }
+	}
+	VarArrayLoop(&piggen->cacheEntries, eIndex)
+	{
+		VarArrayLoopGet(PiggenCacheEntry, entry, &piggen->cacheEntries, eIndex);
+		if (StrExactEquals(entry->path, path)) { return entry; }
+	}
+	return nullptr;
+}
+
+static void AppendPiggenCacheU64(StringBuilder* builder, u64 value)
+{
+	StrBuilderAppendStr(builder, MakeStr8(sizeof(u64), (const char*)&value));
+}
+static void AppendPiggenCacheStr(StringBuilder* builder, Str8 str)
+{
+	AppendPiggenCacheU64(builder, (u64)str.length);
+	StrBuilderAppendStr(builder, str);
+}
+
+// Returns true if the cache file was written, the file is left untouched when it's contents would not change
+bool SavePiggenCache()
+{
+	ScratchBegin1(scratch, piggen->mainArena);
+	StringBuilder builder;
+	InitStrBuilder(&builder, scratch, Kilobytes(64));
+	
+	uxx numEntries = 0;
+	for (uxx fIndex = 0; fIndex < piggen->numFiles; fIndex++)
+	{
+		PiggenFile* file = &piggen->files[fIndex];
+		if (!file->readFailed && !file->hadErrors) { numEntries++; }
+	}
+	
+	AppendPiggenCacheU64(&builder, PIGGEN_CACHE_MAGIC);
+	AppendPiggenCacheU64(&builder, PIGGEN_CACHE_VERSION);
+	AppendPiggenCacheU64(&builder, sizeof(OsFileWriteTime));
+	AppendPiggenCacheU64(&builder, (u64)numEntries);
+	for (uxx fIndex = 0; fIndex < piggen->numFiles; fIndex++)
+	{
+		PiggenFile* file = &piggen->files[fIndex];
+		if (file->readFailed || file->hadErrors) { continue; }
+		AppendPiggenCacheStr(&builder, file->path);
+		AppendPiggenCacheU64(&builder, file->fileSize);
+		StrBuilderAppendStr(&builder, MakeStr8(sizeof(OsFileWriteTime), (const char*)&file->writeTime));
+		AppendPiggenCacheU64(&builder, file->contentHash);
+		AppendPiggenCacheU64(&builder, (u64)file->snippets.length);
+		VarArrayLoop(&file->snippets, sIndex)
+		{
+			VarArrayLoopGet(Snippet, snippet, &file->snippets, sIndex);
+			AppendPiggenCacheStr(&builder, snippet->genFilePath);
+			AppendPiggenCacheU64(&builder, snippet->sourceLineNum);
+			AppendPiggenCacheStr(&builder, snippet->snippetStr);
+		}
+	}
+	
+	bool cacheChanged = true;
+	Slice oldCacheData = Str8_Empty;
+	if (OsDoesFileExist(piggen->cacheFilePath) && OsReadBinFile(piggen->cacheFilePath, scratch, &oldCacheData))
+	{
+		cacheChanged = !StrExactEquals(oldCacheData, builder.str);
+	}
+	if (cacheChanged && !OsWriteBinFile(piggen->cacheFilePath, builder.str))
+	{
+		PrintLine_E("ERROR: Failed to write cache file \"%.*s\"", StrPrint(piggen->cacheFilePath));
+		cacheChanged = false;
+	}
+	ScratchEnd(scratch);
+	return cacheChanged;
+}
+
+// +--------------------------------------------------------------+
+// |                     Source File Scanning                     |
+// +--------------------------------------------------------------+
+// Finds all #if PIGGEN regions and PIGGEN_INLINE macros in the file, parses them into file->snippets
+// and splices the generated file #includes into the source file when they are missing.
+// Returns the (possibly spliced) file contents, allocated from scratch
+Str8 ScanSourceFileForSnippets(PiggenFile* file, Arena* scratch, Str8 fileContents)
+{
+	Str8 sourceFileName = GetFileNamePart(file->path, true);
+	
+	uxx snippetIndex = 0;
+	LineParser lineParser = MakeLineParser(fileContents);
+	Str8 fileLine = Str8_Empty;
+	while (LineParserGetLine(&lineParser, &fileLine))
+	{
+		Str8 trimmedLine = TrimWhitespace(fileLine);
+		Str8 indentationStr = StrSlice(fileLine, 0, (uxx)(trimmedLine.chars - fileLine.chars));
+		Str8 inlineMacroStartStr = StrLit("PIGGEN_INLINE(");
+		// +==============================+
+		// |      Handle #if PIGGEN       |
+		// +==============================+
+		if (StrExactStartsWith(trimmedLine, StrLit("#if PIGGEN")))
+		{
+			uxx snippetStartIndex = lineParser.byteIndex;
+			bool foundElse = false;
+			uxx elseByteIndex = 0;
+			uxx elseContentsByteIndex = 0;
+			bool foundEndif = false;
+			uxx endifByteIndex = 0;
+			LineParser scanLineParser = lineParser;
+			Str8 scanLine = Str8_Empty;
+			while (LineParserGetLine(&scanLineParser, &scanLine))
+			{
+				Str8 trimmedScanLine = TrimWhitespace(scanLine);
+				if (StrExactStartsWith(trimmedScanLine, StrLit("#else")))
+				{
+					foundElse = true;
+					elseByteIndex = scanLineParser.lineBeginByteIndex;
+					elseContentsByteIndex = scanLineParser.byteIndex;
+				}
+				else if (StrExactStartsWith(trimmedScanLine, StrLit("#endif")))
+				{
+					foundEndif = true;
+					endifByteIndex = scanLineParser.lineBeginByteIndex;
+					break;
+				}
+			}
+			
+			if (foundEndif)
+			{
+				uxx snippetEndIndex = endifByteIndex;
+				if (foundElse) { snippetEndIndex = elseByteIndex; }
+				Str8 snippetStr = StrSlice(fileContents, snippetStartIndex, snippetEndIndex);
+				// PrintLine_D("Found %llu byte snippet in \"%.*s\" line %llu", (u64)snippetStr.length, StrPrint(sourceFileName), lineParser.lineIndex);
+				
+				Str8 sanitizedFileName = StrReplace(scratch, sourceFileName, StrLit("."), StrLit("_"), false);
+				Str8 genFileName = PrintInArenaStr(scratch, "%.*s_%llu.h", StrPrint(sanitizedFileName), (u64)snippetIndex);
+				FilePath genFilePath = JoinStringsInArena(scratch, piggen->outputFolderPath, genFileName, false);
+				
+				Snippet snippet = ZEROED;
+				Result parseResult = ParseSnippet(&file->arena, genFilePath, file->path, lineParser.lineIndex, snippetStr, &snippet);
+				if (parseResult != Result_Success)
+				{
+					PrintLine_E("Error parsing PIGGEN region in \"%.*s\" line %llu: %s", StrPrint(sourceFileName), (u64)lineParser.lineIndex, GetResultStr(parseResult));
+					file->hadErrors = true;
+				}
+				else
+				{
+					PrintSnippetPieces(&snippet);
+					
+					// +================================+
+					// | Insert Generated File #include |
+					// +================================+
+					{
+						Str8 genFileInclude = PrintInArenaStr(scratch, "#include \"%.*s\"", StrPrint(genFileName));
+						bool needToInsertElse = !foundElse;
+						if (foundElse)
+						{
+							Str8 elseContents = TrimWhitespaceAndNewLines(StrSlice(fileContents, elseContentsByteIndex, endifByteIndex));
+							if (!StrExactEquals(elseContents, genFileInclude)) { needToInsertElse = true; }
+						}
+						if (needToInsertElse)
+						{
+							uxx replaceStartIndex = (foundElse ? elseContentsByteIndex : endifByteIndex);
+							uxx replaceEndIndex = endifByteIndex;
+							
+							Str8 spliceStr = PrintInArenaStr(scratch, "%.*s%s%.*s%.*s\n",
+								StrPrint(foundElse ? Str8_Empty : indentationStr),
+								foundElse ? "" : "#else\n",
+								StrPrint(indentationStr),
+								StrPrint(genFileInclude)
+							);
+							fileContents = SpliceFile(scratch, file->path, fileContents, replaceStartIndex, replaceEndIndex, spliceStr);
+							
+							if ((replaceEndIndex - replaceStartIndex) > spliceStr.length)
+							{
+								uxx numBytesRemoved = (replaceEndIndex - replaceStartIndex) - spliceStr.length;
+								scanLineParser.byteIndex -= numBytesRemoved;
+								scanLineParser.lineBeginByteIndex -= numBytesRemoved;
+							}
+							else if ((replaceEndIndex - replaceStartIndex) < spliceStr.length)
+							{
+								uxx numBytesAdded = spliceStr.length - (replaceEndIndex - replaceStartIndex);
+								scanLineParser.byteIndex += numBytesAdded;
+								scanLineParser.lineBeginByteIndex += numBytesAdded;
+							}
+							scanLineParser.inputStr = fileContents;
+						}
+					}
+					
+					Snippet* newSnippet = VarArrayAdd(Snippet, &file->snippets);
+					NotNull(newSnippet);
+					MyMemCopy(newSnippet, &snippet, sizeof(Snippet));
+				}
+				
+				snippetIndex++;
+				lineParser = scanLineParser;
+			}
+			else
+			{
+				PrintLine_W("WARNING: #if PIGGEN region doesn't have a closing #endif in \"%.*s\" line %llu", StrPrint(file->path), lineParser.lineIndex);
+				file->hadErrors = true;
+			}
+		}
+		// +==============================+
+		// |  Handle PIGGEN_INLINE (...)  |
+		// +==============================+
+		else if (StrExactContains(trimmedLine, inlineMacroStartStr))
+		{
+			uxx macroIndex = StrExactFind(trimmedLine, inlineMacroStartStr);
+			uxx closeParensIndex = FindNextCharInStrEx(trimmedLine, macroIndex + inlineMacroStartStr.length, StrLit(")"), true);
+			if (closeParensIndex < trimmedLine.length)
+			{
+				Str8 snippetStr = TrimWhitespace(StrSlice(trimmedLine, macroIndex + inlineMacroStartStr.length, closeParensIndex));
+				if (StrExactStartsWith(snippetStr, StrLit("\"")) && StrExactEndsWith(snippetStr, StrLit("\"")))
+				{
+					snippetStr = StrSlice(snippetStr, 1, snippetStr.length-1);
+					//TODO: Convert escape sequences to there equivalent characters!
+				}
+				
+				Str8 sanitizedFileName = StrReplace(scratch, sourceFileName, StrLit("."), StrLit("_"), false);
+				Str8 genFileName = PrintInArenaStr(scratch, "%.*s_%llu.h", StrPrint(sanitizedFileName), (u64)snippetIndex);
+				FilePath genFilePath = JoinStringsInArena(scratch, piggen->outputFolderPath, genFileName, false);
+				
+				Snippet snippet = ZEROED;
+				Result parseResult = ParseSnippet(&file->arena, genFilePath, file->path, lineParser.lineIndex, snippetStr, &snippet);
+				if (parseResult != Result_Success)
+				{
+					PrintLine_E("Error parsing PIGGEN_INLINE macro in \"%.*s\" line %llu: %s", StrPrint(sourceFileName), (u64)lineParser.lineIndex, GetResultStr(parseResult));
+					file->hadErrors = true;
+				}
+				else
+				{
+					PrintSnippetPieces(&snippet);
+					
+					// +================================+
+					// | Insert Generated File #include |
+					// +================================+
+					{
+						Str8 genFileInclude = PrintInArenaStr(scratch, "#include \"%.*s\"", StrPrint(genFileName));
+						bool needToInsertInclude = true;
+						uxx replaceStartIndex = lineParser.byteIndex;
+						uxx replaceEndIndex = lineParser.byteIndex;
+						LineParser scanLineParser = lineParser;
+						Str8 nextLine = Str8_Empty;
+						if (LineParserGetLine(&scanLineParser, &nextLine))
+						{
+							nextLine = TrimWhitespace(nextLine);
+							if (StrExactStartsWith(nextLine, genFileInclude))
+							{
+								needToInsertInclude = false;
+							}
+							else if (StrExactStartsWith(nextLine, StrLit("#include")))
+							{
+								replaceEndIndex = scanLineParser.byteIndex;
+							}
+						}
+						
+						if (needToInsertInclude)
+						{
+							Str8 spliceStr = PrintInArenaStr(scratch, "%.*s%.*s\n",
+								StrPrint(indentationStr),
+								StrPrint(genFileInclude)
+							);
+							fileContents = SpliceFile(scratch, file->path, fileContents, replaceStartIndex, replaceEndIndex, spliceStr);
+							
+							if ((replaceEndIndex - replaceStartIndex) > spliceStr.length)
+							{
+								uxx numBytesRemoved = (replaceEndIndex - replaceStartIndex) - spliceStr.length;
+								scanLineParser.byteIndex -= numBytesRemoved;
+								scanLineParser.lineBeginByteIndex -= numBytesRemoved;
+							}
+							else if ((replaceEndIndex - replaceStartIndex) < spliceStr.length)
+							{
+								uxx numBytesAdded = spliceStr.length - (replaceEndIndex - replaceStartIndex);
+								scanLineParser.byteIndex += numBytesAdded;
+								scanLineParser.lineBeginByteIndex += numBytesAdded;
+							}
+							scanLineParser.inputStr = fileContents;
+						}
+					}
+					
+					Snippet* newSnippet = VarArrayAdd(Snippet, &file->snippets);
+					NotNull(newSnippet);
+					MyMemCopy(newSnippet, &snippet, sizeof(Snippet));
+				}
+			}
+			else
+			{
+				PrintLine_W("WARNING: PIGGEN_INLINE macro does not have a closing parenthesis in \"%.*s\" line %llu", StrPrint(sourceFileName), lineParser.lineIndex);
+				file->hadErrors = true;
+			}
+		}
+	}
+	return fileContents;
+}
+
+// Runs on worker threads, so it must only touch the PiggenFile it's given (plus read-only piggen state)
+void ProcessSourceFile(PiggenFile* file)
+{
+	NotNull(file);
+	ScratchBegin1(scratch, &file->arena);
+	PiggenCacheEntry* cacheEntry = file->cacheEntry;
+	
+	if (cacheEntry != nullptr &&
+		cacheEntry->fileSize == file->fileSize && OsAreFileWriteTimesEqual(cacheEntry->writeTime, file->writeTime))
+	{
+		file->matchedCache = true;
+		file->contentHash = cacheEntry->contentHash;
+	}
+	else
+	{
+		Str8 fileContents = Str8_Empty;
+		if (!OsReadTextFile(file->path, scratch, &fileContents))
+		{
+			PrintLine_E("ERROR: Failed to read file at \"%.*s\"", StrPrint(file->path));
+			file->readFailed = true;
+			ScratchEnd(scratch);
+			return;
+		}
+		
+		file->contentHash = FnvHashU64(fileContents.bytes, fileContents.length);
+		if (cacheEntry != nullptr && cacheEntry->contentHash == file->contentHash)
+		{
+			// The file was touched but not changed, the new write time gets saved so we don't need to read it next time
+			file->matchedCache = true;
+		}
+		else
+		{
+			Str8 newFileContents = ScanSourceFileForSnippets(file, scratch, fileContents);
+			if (newFileContents.chars != fileContents.chars)
+			{
+				// We spliced #includes into the file, the cache needs to describe the file as it is now, not as we read it
+				file->contentHash = FnvHashU64(newFileContents.bytes, newFileContents.length);
+				OsGetFileWriteTimeAndSize(file->path, &file->writeTime, &file->fileSize);
+			}
+		}
+	}
+	
+	if (file->matchedCache)
+	{
+		VarArrayLoop(&cacheEntry->snippets, sIndex)
+		{
+			VarArrayLoopGet(PiggenCacheSnippet, cachedSnippet, &cacheEntry->snippets, sIndex);
+			Snippet snippet = ZEROED;
+			Result parseResult = ParseSnippet(&file->arena, cachedSnippet->genFilePath, file->path, cachedSnippet->sourceLineNum, cachedSnippet->snippetStr, &snippet);
+			if (parseResult != Result_Success)
+			{
+				PrintLine_E("Error parsing cached snippet from \"%.*s\" line %llu: %s", StrPrint(file->path), cachedSnippet->sourceLineNum, GetResultStr(parseResult));
+				file->hadErrors = true;
+			}
+			else
+			{
+				PrintSnippetPieces(&snippet);
+				Snippet* newSnippet = VarArrayAdd(Snippet, &file->snippets);
+				NotNull(newSnippet);
+				MyMemCopy(newSnippet, &snippet, sizeof(Snippet));
+			}
+		}
+	}
+	
+	ScratchEnd(scratch);
+}
+
+#if TARGET_HAS_THREADING
+THREAD_POOL_WORK_ITEM_FUNC_DEF(ProcessSourceFileWorkItem)
+{
+	UNUSED(thread);
+	ProcessSourceFile((PiggenFile*)workItem->subject.pntr);
+	return Result_Success;
+}
+#endif
+
 // +--------------------------------------------------------------+
 // |                       Main Entry Point                       |
 // +--------------------------------------------------------------+
 int main(int argc, char* argv[])
 {
+	InitDebugOutputRouter(nullptr);
 	InitScratchArenasVirtual(Gigabytes(4));
 	ScratchBegin(scratch);
 	ScratchBegin1(scratch2, scratch);
@@ -167,6 +694,7 @@ int main(int argc, char* argv[])
 	PrintLine_N("Running piggen...");
 	fflush(stdout);
 	fflush(stderr);
+	OsTime startTime = OsGetTime();
 	piggen = AllocType(PiggenState, scratch);
 	NotNull(piggen);
 	ClearPointer(piggen);
@@ -174,7 +702,7 @@ int main(int argc, char* argv[])
 	ParseProgramArgs(scratch, (uxx)argc-1, (const char**)&argv[1], &piggen->args);
 	InitVarArrayWithInitial(FilePath, &piggen->searchPaths, piggen->mainArena, (uxx)piggen->args.args.length);
 	InitVarArrayWithInitial(FilePath, &piggen->excludePaths, piggen->mainArena, (uxx)piggen->args.args.length);
-	InitVarArrayWithInitial(FilePath, &piggen->sourceFilePaths, piggen->mainArena, 128);
+	InitVarArrayWithInitial(PiggenSourceFile, &piggen->sourceFiles, piggen->mainArena, 128);
 	InitVarArrayWithInitial(Snippet, &piggen->snippets, piggen->mainArena, 128);
 	
 	piggen->outputFolderPath = FindNamedProgramArgStr(&piggen->args, StrLit("output"), StrLit("o"), StrLit("."));
@@ -182,6 +710,20 @@ int main(int argc, char* argv[])
 	piggen->outputFolderPath = AllocFolderPath(piggen->mainArena, piggen->outputFolderPath, false);
 	Assert(DoesPathHaveTrailingSlash(piggen->outputFolderPath));
 	PrintLine_D("Outputting to \"%.*s\"", StrPrint(piggen->outputFolderPath));
+	piggen->cacheFilePath = JoinStringsInArena(piggen->mainArena, piggen->outputFolderPath, StrLit(PIGGEN_CACHE_FILENAME), true);
+	piggen->ignoreCache = FindNamedProgramArgBool(&piggen->args, StrLit("force"), false);
+	
+	piggen->numThreads = PIGGEN_DEFAULT_NUM_THREADS;
+	Str8 threadsArgStr = FindNamedProgramArgStr(&piggen->args, StrLit("threads"), StrLit("j"), Str8_Empty);
+	if (!IsEmptyStr(threadsArgStr))
+	{
+		u64 numThreads = 0;
+		if (TryParseU64(threadsArgStr, &numThreads, nullptr)) { piggen->numThreads = (uxx)numThreads; }
+		else { PrintLine_W("WARNING: Invalid thread count \"%.*s\", using %u threads", StrPrint(threadsArgStr), PIGGEN_DEFAULT_NUM_THREADS); }
+	}
+	#if !TARGET_HAS_THREADING
+	piggen->numThreads = 0;
+	#endif
 	
 	// +==============================+
 	// |   Injest Search Path Args    |
@@ -224,254 +766,119 @@ int main(int argc, char* argv[])
 		{
 			VarArrayLoopGetValue(FilePath, rootPath, &piggen->searchPaths, pIndex);
 			Print_D("Searching \"%.*s\"...", StrPrint(rootPath));
-			uxx numFilesBefore = piggen->sourceFilePaths.length;
+			uxx numFilesBefore = piggen->sourceFiles.length;
 			uxx numFoldersBefore = numFoldersSearched;
-			numFoldersSearched += FindSourceFilesInFolderRecursive(rootPath, 0, 0);
+			numFoldersSearched += FindSourceFilesInFolder(rootPath);
 			PrintLine_D("Found %llu file%s (in %llu subfolders)",
-				piggen->sourceFilePaths.length - numFilesBefore, Plural(piggen->sourceFilePaths.length - numFilesBefore, "s"),
+				piggen->sourceFiles.length - numFilesBefore, Plural(piggen->sourceFiles.length - numFilesBefore, "s"),
 				numFoldersSearched - numFoldersBefore, Plural(numFoldersSearched - numFoldersBefore, "s")
 			);
 		}
 		PrintLine_D("Searched %llu folder%s, found %llu source file%s",
 			numFoldersSearched, Plural(numFoldersSearched, "s"),
-			piggen->sourceFilePaths.length, Plural(piggen->sourceFilePaths.length, "s")
+			piggen->sourceFiles.length, Plural(piggen->sourceFiles.length, "s")
 		);
-		// VarArrayLoop(&sourceFilePaths, fIndex)
+		// VarArrayLoop(&piggen->sourceFiles, fIndex)
 		// {
-		// 	VarArrayLoopGetValue(Str8, sourceFilePath, &sourceFilePaths, fIndex);
-		// 	PrintLine_D("\t[%llu] \"%.*s\"", (u64)fIndex, StrPrint(sourceFilePath));
+		// 	VarArrayLoopGet(PiggenSourceFile, sourceFile, &piggen->sourceFiles, fIndex);
+		// 	PrintLine_D("\t[%llu] \"%.*s\"", (u64)fIndex, StrPrint(sourceFile->path));
 		// }
 	}
 	
 	// +==============================+
-	// |   Find and Parse Snippets    |
+	// |      Load Piggen Cache       |
 	// +==============================+
+	OsTime loadCacheStartTime = OsGetTime();
 	{
-		VarArrayLoop(&piggen->sourceFilePaths, fIndex)
+		if (piggen->ignoreCache)
 		{
-			uxx scratchMark = ArenaGetMark(scratch2);
-			VarArrayLoopGetValue(FilePath, sourceFilePath, &piggen->sourceFilePaths, fIndex);
-			Str8 sourceFileName = GetFileNamePart(sourceFilePath, true);
-			
-			Str8 fileContents = Str8_Empty;
-			bool readSuccess = OsReadTextFile(sourceFilePath, scratch2, &fileContents);
-			if (!readSuccess) { PrintLine_E("ERROR: Failed to read file at \"%.*s\"", StrPrint(sourceFilePath)); continue; }
+			InitVarArray(PiggenCacheEntry, &piggen->cacheEntries, piggen->mainArena);
+			PrintLine_D("Ignoring cache file because of -force");
+		}
+		else if (LoadPiggenCache())
+		{
+			PrintLine_D("Loaded cache for %llu file%s from \"%.*s\"", piggen->cacheEntries.length, Plural(piggen->cacheEntries.length, "s"), StrPrint(piggen->cacheFilePath));
+		}
+	}
+	
+	// +==============================+
+	// |     Process Source Files     |
+	// +==============================+
+	OsTime processStartTime = OsGetTime();
+	{
+		// Allocated once up front so the PiggenFile pointers handed to worker threads stay valid
+		piggen->numFiles = piggen->sourceFiles.length;
+		piggen->files = (piggen->numFiles > 0) ? AllocArray(PiggenFile, piggen->mainArena, piggen->numFiles) : nullptr;
+		VarArrayLoop(&piggen->sourceFiles, fIndex)
+		{
+			VarArrayLoopGet(PiggenSourceFile, sourceFile, &piggen->sourceFiles, fIndex);
+			PiggenFile* file = &piggen->files[fIndex];
+			ClearPointer(file);
+			file->path = sourceFile->path;
+			file->fileSize = sourceFile->fileSize;
+			file->writeTime = sourceFile->writeTime;
+			InitArenaStdHeap(&file->arena);
+			file->cacheEntry = FindPiggenCacheEntry(sourceFile->path, fIndex);
+			InitVarArray(Snippet, &file->snippets, &file->arena);
+		}
+		
+		uxx numThreads = MinUXX(piggen->numThreads, piggen->numFiles);
+		#if TARGET_HAS_THREADING
+		if (numThreads > 0)
+		{
+			ThreadPool* pool = AllocType(ThreadPool, piggen->mainArena);
+			NotNull(pool);
+			InitThreadPool(piggen->mainArena, StrLit("PiggenPool"), true, true, PIGGEN_THREAD_SCRATCH_SIZE, pool);
+			// Work items are queued before the threads are started so no thread goes to sleep thinking there is nothing to do
+			for (uxx fIndex = 0; fIndex < piggen->numFiles; fIndex++)
+			{
+				WorkSubject subject = ZEROED;
+				subject.pntr = &piggen->files[fIndex];
+				AddWorkItemToThreadPool(pool, ProcessSourceFileWorkItem, &subject);
+			}
+			for (uxx tIndex = 0; tIndex < numThreads; tIndex++) { AddThreadToPool(pool); }
 			
-			uxx snippetIndex = 0;
-			LineParser lineParser = MakeLineParser(fileContents);
-			Str8 fileLine = Str8_Empty;
-			while (LineParserGetLine(&lineParser, &fileLine))
+			uxx numFinished = 0;
+			while (numFinished < piggen->numFiles)
 			{
-				Str8 trimmedLine = TrimWhitespace(fileLine);
-				Str8 indentationStr = StrSlice(fileLine, 0, (uxx)(trimmedLine.chars - fileLine.chars));
-				Str8 inlineMacroStartStr = StrLit("PIGGEN_INLINE(");
-				// +==============================+
-				// |      Handle #if PIGGEN       |
-				// +==============================+
-				if (StrExactStartsWith(trimmedLine, StrLit("#if PIGGEN")))
-				{
-					uxx snippetStartIndex = lineParser.byteIndex;
-					bool foundElse = false;
-					uxx elseByteIndex = 0;
-					uxx elseContentsByteIndex = 0;
-					bool foundEndif = false;
-					uxx endifByteIndex = 0;
-					LineParser scanLineParser = lineParser;
-					Str8 scanLine = Str8_Empty;
-					while (LineParserGetLine(&scanLineParser, &scanLine))
-					{
-						Str8 trimmedScanLine = TrimWhitespace(scanLine);
-						if (StrExactStartsWith(trimmedScanLine, StrLit("#else")))
-						{
-							foundElse = true;
-							elseByteIndex = scanLineParser.lineBeginByteIndex;
-							elseContentsByteIndex = scanLineParser.byteIndex;
-						}
-						else if (StrExactStartsWith(trimmedScanLine, StrLit("#endif")))
-						{
-							foundEndif = true;
-							endifByteIndex = scanLineParser.lineBeginByteIndex;
-							break;
-						}
-					}
-					
-					if (foundEndif)
-					{
-						uxx snippetEndIndex = endifByteIndex;
-						if (foundElse) { snippetEndIndex = elseByteIndex; }
-						Str8 snippetStr = StrSlice(fileContents, snippetStartIndex, snippetEndIndex);
-						// PrintLine_D("Found %llu byte snippet in \"%.*s\" line %llu", (u64)snippetStr.length, StrPrint(sourceFileName), lineParser.lineIndex);
-						
-						Str8 sanitizedFileName = StrReplace(scratch2, sourceFileName, StrLit("."), StrLit("_"), false);
-						Str8 genFileName = PrintInArenaStr(scratch2, "%.*s_%llu.h", StrPrint(sanitizedFileName), (u64)snippetIndex);
-						FilePath genFilePath = JoinStringsInArena(scratch2, piggen->outputFolderPath, genFileName, false);
-						
-						Snippet snippet = ZEROED;
-						Result parseResult = ParseSnippet(piggen->mainArena, genFilePath, sourceFilePath, lineParser.lineIndex, snippetStr, &snippet);
-						if (parseResult != Result_Success)
-						{
-							PrintLine_E("Error parsing PIGGEN region in \"%.*s\" line %llu: %s", StrPrint(sourceFileName), (u64)lineParser.lineIndex, GetResultStr(parseResult));
-						}
-						else
-						{
-							PrintLine_D("Snippet has %llu piece%s in \"%.*s\" line %llu:", snippet.pieces.length, Plural(snippet.pieces.length, "s"), StrPrint(sourceFileName), lineParser.lineIndex);
-							VarArrayLoop(&snippet.pieces, pIndex)
-							{
-								VarArrayLoopGet(SnippetPiece, piece, &snippet.pieces, pIndex);
-								Str8 snippetNodeName = ToStr8FromMd(piece->rootNode->string);
-								PrintLine_D("\tPiece[%llu]: %.*s \"%.*s\"", (u64)pIndex, StrPrint(piece->typeStr), StrPrint(snippetNodeName));
-							}
-							
-							// +================================+
-							// | Insert Generated File #include |
-							// +================================+
-							{
-								Str8 genFileInclude = PrintInArenaStr(scratch2, "#include \"%.*s\"", StrPrint(genFileName));
-								bool needToInsertElse = !foundElse;
-								if (foundElse)
-								{
-									Str8 elseContents = TrimWhitespaceAndNewLines(StrSlice(fileContents, elseContentsByteIndex, endifByteIndex));
-									if (!StrExactEquals(elseContents, genFileInclude)) { needToInsertElse = true; }
-								}
-								if (needToInsertElse)
-								{
-									uxx replaceStartIndex = (foundElse ? elseContentsByteIndex : endifByteIndex);
-									uxx replaceEndIndex = endifByteIndex;
-									
-									Str8 spliceStr = PrintInArenaStr(scratch2, "%.*s%s%.*s%.*s\n",
-										StrPrint(foundElse ? Str8_Empty : indentationStr),
-										foundElse ? "" : "#else\n",
-										StrPrint(indentationStr),
-										StrPrint(genFileInclude)
-									);
-									fileContents = SpliceFile(scratch2, sourceFilePath, fileContents, replaceStartIndex, replaceEndIndex, spliceStr);
-									
-									if ((replaceEndIndex - replaceStartIndex) > spliceStr.length)
-									{
-										uxx numBytesRemoved = (replaceEndIndex - replaceStartIndex) - spliceStr.length;
-										scanLineParser.byteIndex -= numBytesRemoved;
-										scanLineParser.lineBeginByteIndex -= numBytesRemoved;
-									}
-									else if ((replaceEndIndex - replaceStartIndex) < spliceStr.length)
-									{
-										uxx numBytesAdded = spliceStr.length - (replaceEndIndex - replaceStartIndex);
-										scanLineParser.byteIndex += numBytesAdded;
-										scanLineParser.lineBeginByteIndex += numBytesAdded;
-									}
-									scanLineParser.inputStr = fileContents;
-								}
-							}
-							
-							Snippet* newSnippet = VarArrayAdd(Snippet, &piggen->snippets);
-							NotNull(newSnippet);
-							MyMemCopy(newSnippet, &snippet, sizeof(Snippet));
-						}
-						
-						snippetIndex++;
-						lineParser = scanLineParser;
-					}
-					else
-					{
-						PrintLine_W("WARNING: #if PIGGEN region doesn't have a closing #endif in \"%.*s\" line %llu", StrPrint(sourceFilePath), lineParser.lineIndex);
-					}
-				}
-				// +==============================+
-				// |  Handle PIGGEN_INLINE (...)  |
-				// +==============================+
-				else if (StrExactContains(trimmedLine, inlineMacroStartStr))
+				ThreadPoolWorkItem* finishedItem = GetFinishedThreadPoolWorkItem(pool);
+				if (finishedItem != nullptr)
 				{
-					uxx macroIndex = StrExactFind(trimmedLine, inlineMacroStartStr);
-					uxx closeParensIndex = FindNextCharInStrEx(trimmedLine, macroIndex + inlineMacroStartStr.length, StrLit(")"), true);
-					if (closeParensIndex < trimmedLine.length)
-					{
-						Str8 snippetStr = TrimWhitespace(StrSlice(trimmedLine, macroIndex + inlineMacroStartStr.length, closeParensIndex));
-						if (StrExactStartsWith(snippetStr, StrLit("\"")) && StrExactEndsWith(snippetStr, StrLit("\"")))
-						{
-							snippetStr = StrSlice(snippetStr, 1, snippetStr.length-1);
-							//TODO: Convert escape sequences to there equivalent characters!
-						}
-						
-						Str8 sanitizedFileName = StrReplace(scratch2, sourceFileName, StrLit("."), StrLit("_"), false);
-						Str8 genFileName = PrintInArenaStr(scratch2, "%.*s_%llu.h", StrPrint(sanitizedFileName), (u64)snippetIndex);
-						FilePath genFilePath = JoinStringsInArena(scratch2, piggen->outputFolderPath, genFileName, false);
-						
-						Snippet snippet = ZEROED;
-						Result parseResult = ParseSnippet(piggen->mainArena, genFilePath, sourceFilePath, lineParser.lineIndex, snippetStr, &snippet);
-						if (parseResult != Result_Success)
-						{
-							PrintLine_E("Error parsing PIGGEN_INLINE macro in \"%.*s\" line %llu: %s", StrPrint(sourceFileName), (u64)lineParser.lineIndex, GetResultStr(parseResult));
-						}
-						else
-						{
-							PrintLine_D("Snippet has %llu piece%s in \"%.*s\" line %llu:", snippet.pieces.length, Plural(snippet.pieces.length, "s"), StrPrint(sourceFileName), lineParser.lineIndex);
-							VarArrayLoop(&snippet.pieces, pIndex)
-							{
-								VarArrayLoopGet(SnippetPiece, piece, &snippet.pieces, pIndex);
-								Str8 snippetNodeName = ToStr8FromMd(piece->rootNode->string);
-								PrintLine_D("\tPiece[%llu]: %.*s \"%.*s\"", (u64)pIndex, StrPrint(piece->typeStr), StrPrint(snippetNodeName));
-							}
-							
-							// +================================+
-							// | Insert Generated File #include |
-							// +================================+
-							{
-								Str8 genFileInclude = PrintInArenaStr(scratch2, "#include \"%.*s\"", StrPrint(genFileName));
-								bool needToInsertInclude = true;
-								uxx replaceStartIndex = lineParser.byteIndex;
-								uxx replaceEndIndex = lineParser.byteIndex;
-								LineParser scanLineParser = lineParser;
-								Str8 nextLine = Str8_Empty;
-								if (LineParserGetLine(&scanLineParser, &nextLine))
-								{
-									nextLine = TrimWhitespace(nextLine);
-									if (StrExactStartsWith(nextLine, genFileInclude))
-									{
-										needToInsertInclude = false;
-									}
-									else if (StrExactStartsWith(nextLine, StrLit("#include")))
-									{
-										replaceEndIndex = scanLineParser.byteIndex;
-									}
-								}
-								
-								if (needToInsertInclude)
-								{
-									Str8 spliceStr = PrintInArenaStr(scratch2, "%.*s%.*s\n",
-										StrPrint(indentationStr),
-										StrPrint(genFileInclude)
-									);
-									fileContents = SpliceFile(scratch2, sourceFilePath, fileContents, replaceStartIndex, replaceEndIndex, spliceStr);
-									
-									if ((replaceEndIndex - replaceStartIndex) > spliceStr.length)
-									{
-										uxx numBytesRemoved = (replaceEndIndex - replaceStartIndex) - spliceStr.length;
-										scanLineParser.byteIndex -= numBytesRemoved;
-										scanLineParser.lineBeginByteIndex -= numBytesRemoved;
-									}
-									else if ((replaceEndIndex - replaceStartIndex) < spliceStr.length)
-									{
-										uxx numBytesAdded = spliceStr.length - (replaceEndIndex - replaceStartIndex);
-										scanLineParser.byteIndex += numBytesAdded;
-										scanLineParser.lineBeginByteIndex += numBytesAdded;
-									}
-									scanLineParser.inputStr = fileContents;
-								}
-							}
-							
-							Snippet* newSnippet = VarArrayAdd(Snippet, &piggen->snippets);
-							NotNull(newSnippet);
-							MyMemCopy(newSnippet, &snippet, sizeof(Snippet));
-						}
-					}
-					else
-					{
-						PrintLine_W("WARNING: PIGGEN_INLINE macro does not have a closing parenthesis in \"%.*s\" line %llu", StrPrint(sourceFileName), lineParser.lineIndex);
-					}
+					FreeThreadPoolWorkItem(pool, finishedItem);
+					numFinished++;
 				}
+				else { OsSleepMs(1); }
 			}
-			ArenaResetToMark(scratch2, scratchMark);
+			//NOTE: We don't FreeThreadPool here. Stopping the threads waits for each one to wake up from it's sleep
+			// which adds up to THREAD_POOL_SLEEP_INTERVAL to every run, and the process is about to exit anyway
+		}
+		else
+		#endif //TARGET_HAS_THREADING
+		{
+			for (uxx fIndex = 0; fIndex < piggen->numFiles; fIndex++) { ProcessSourceFile(&piggen->files[fIndex]); }
 		}
 		
+		uxx numFilesScanned = 0;
+		uxx numFilesUnchanged = 0;
+		for (uxx fIndex = 0; fIndex < piggen->numFiles; fIndex++)
+		{
+			PiggenFile* file = &piggen->files[fIndex];
+			if (file->readFailed) { continue; }
+			if (file->matchedCache) { numFilesUnchanged++; } else { numFilesScanned++; }
+			VarArrayLoop(&file->snippets, sIndex)
+			{
+				VarArrayLoopGet(Snippet, snippet, &file->snippets, sIndex);
+				Snippet* newSnippet = VarArrayAdd(Snippet, &piggen->snippets);
+				NotNull(newSnippet);
+				MyMemCopy(newSnippet, snippet, sizeof(Snippet));
+			}
+		}
+		PrintLine_D("Scanned %llu file%s, %llu file%s unchanged since last run (%llu thread%s)",
+			numFilesScanned, Plural(numFilesScanned, "s"),
+			numFilesUnchanged, Plural(numFilesUnchanged, "s"),
+			numThreads, Plural(numThreads, "s")
+		);
+		
 		uxx numSnippetsTotal = 0;
 		uxx numFilesWithSnippets = 0;
 		VarArrayLoop(&piggen->snippets, sIndex)
@@ -486,6 +893,25 @@ int main(int argc, char* argv[])
 		);
 	}
 	
+	// +==============================+
+	// |      Save Piggen Cache       |
+	// +==============================+
+	OsTime saveCacheStartTime = OsGetTime();
+	{
+		if (!OsDoesFolderExist(piggen->outputFolderPath)) { OsCreateFolder(piggen->outputFolderPath, true); }
+		bool wroteCache = SavePiggenCache();
+		PrintLine_D("Cache file %s", wroteCache ? "updated" : "unchanged");
+	}
+	OsTime endTime = OsGetTime();
+	
+	PrintLine_D("Timing: find %.1fms, load cache %.1fms, process %.1fms, save cache %.1fms, total %.1fms",
+		OsTimeDiffMsR32(startTime, loadCacheStartTime),
+		OsTimeDiffMsR32(loadCacheStartTime, processStartTime),
+		OsTimeDiffMsR32(processStartTime, saveCacheStartTime),
+		OsTimeDiffMsR32(saveCacheStartTime, endTime),
+		OsTimeDiffMsR32(startTime, endTime)
+	);
+	
 	// getchar(); //wait for user to press ENTER
 	PrintLine_N("DONE!");
 	
@@ -0,0 +1,29 @@
+/*
+File:   build_config.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** Like piggen/build_config.h this stands in for the build_config.h in the root directory
+	** when res_packer_main.c is compiled. It's found first by virtue of being in the same
+	** directory as the file that's including build_config.h, and it only needs the options
+	** that change the compilation of PigCore files
+*/
+
+#ifndef _BUILD_CONFIG_H
+#define _BUILD_CONFIG_H
+
+#define DEBUG_BUILD 1
+
+#define BUILD_FOR_RES_PACKER 1
+#define BUILD_WITH_RAYLIB    0
+#define BUILD_WITH_BOX2D     0
+#define BUILD_WITH_SOKOL_GFX 0
+#define BUILD_WITH_SOKOL_APP 0
+#define BUILD_WITH_SDL       0
+#define BUILD_WITH_OPENVR    0
+#define BUILD_WITH_CLAY      0
+#define BUILD_WITH_IMGUI     0
+#define BUILD_WITH_PHYSX     0
+#define BUILD_WITH_METADESK  0
+
+#endif //  _BUILD_CONFIG_H
@@ -0,0 +1,276 @@
+/*
+File:   res_packer_main.c
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** Holds the main entry point for res_packer.exe which walks a folder of resources
+	** and writes all the files it finds into a single resource pack (see file_fmt_res_pack.h)
+	** Usage: res_packer "path/to/resources" -o="resources.pack" [-align=4096] [-level=6] [-store=".ext"] [-e="path/to/exclude"] [-verify]
+	**   -o       The pack file to write (default "resources.pack")
+	**   -align   Every entry's data starts on a multiple of this (default 4096, must be a power of 2)
+	**   -level   Deflate compression level 0-10 (0 stores everything, 1 is fastest, 6 is the default)
+	**   -store   Extra file extensions to store without compression (can be given multiple times)
+	**   -e       Files or folders to leave out of the pack (can be given multiple times)
+	**   -verify  Re-open the pack after it's written and check every entry's content hash
+*/
+
+#include "build_config.h"
+#if !BUILD_FOR_RES_PACKER
+#error The wrong build_config.h was found!
+#endif
+
+#include "base/base_compiler_check.h"
+#include "base/base_defines_check.h"
+#include "std/std_includes.h"
+#include "base/base_typedefs.h"
+#include "base/base_macros.h"
+#include "base/base_assert.h"
+#include "misc/misc_result.h"
+#include "os/os_file.h"
+#include "os/os_virtual_mem.h"
+#include "std/std_memset.h"
+#include "std/std_malloc.h"
+#include "std/std_basic_math.h"
+#include "mem/mem_arena.h"
+#include "mem/mem_scratch.h"
+#include "struct/struct_string.h"
+#include "os/os_path.h"
+#include "misc/misc_parsing.h"
+#include "os/os_program_args.h"
+#include "struct/struct_var_array.h"
+#include "os/os_time.h"
+#include "os/os_threading.h"
+#include "os/os_thread_pool.h"
+#include "os/os_dir_walk.h"
+#include "misc/misc_hash.h"
+#include "misc/misc_zip.h"
+#include "file_fmt/file_fmt_res_pack.h"
+
+#include "base/base_debug_output_impl.h"
+
+#define RES_PACKER_DEFAULT_OUTPUT_PATH "resources.pack"
+
+//These formats are already compressed, deflating them again costs time at load and saves next to nothing
+const char* StoredFileExtensions[] = {
+	".png",
+	".jpg",
+	".jpeg",
+	".ogg",
+	".mp3",
+	".zip",
+	".gz",
+	".pack",
+};
+
+typedef plex ResPackerState ResPackerState;
+plex ResPackerState
+{
+	Arena* mainArena;
+	ProgramArgs args;
+	FilePath rootPath;
+	FilePath outputPath;
+	VarArray excludePaths; //FilePath
+	VarArray storeExtensions; //Str8
+};
+
+ResPackerState* packer = nullptr;
+
+static OS_DIR_WALK_EXCLUDE_FUNC_DEF(ResPackerDirWalkExclude)
+{
+	UNUSED(relativePath);
+	UNUSED(isFolder);
+	UNUSED(contextPntr);
+	VarArrayLoop(&packer->excludePaths, eIndex)
+	{
+		VarArrayLoopGetValue(FilePath, excludePath, &packer->excludePaths, eIndex);
+		if (StrAnyCaseStartsWith(fullPath, excludePath)) { return true; }
+	}
+	//Never pack the output into itself if it happens to live inside the resources folder
+	return StrAnyCaseEquals(fullPath, packer->outputPath);
+}
+
+ResPackCompression ChooseCompressionForPath(FilePath path)
+{
+	VarArrayLoop(&packer->storeExtensions, eIndex)
+	{
+		VarArrayLoopGetValue(Str8, extension, &packer->storeExtensions, eIndex);
+		if (StrAnyCaseEndsWith(path, extension)) { return ResPackCompression_Store; }
+	}
+	return ResPackCompression_Deflate;
+}
+
+int main(int argc, char* argv[])
+{
+	InitDebugOutputRouter(nullptr);
+	InitScratchArenasVirtual(Gigabytes(4));
+	ScratchBegin(scratch);
+	ScratchBegin1(scratch2, scratch);
+	
+	OsTime startTime = OsGetTime();
+	packer = AllocType(ResPackerState, scratch);
+	NotNull(packer);
+	ClearPointer(packer);
+	packer->mainArena = scratch;
+	ParseProgramArgs(scratch, (uxx)argc-1, (const char**)&argv[1], &packer->args);
+	InitVarArray(FilePath, &packer->excludePaths, packer->mainArena);
+	InitVarArray(Str8, &packer->storeExtensions, packer->mainArena);
+	for (uxx eIndex = 0; eIndex < ArrayCount(StoredFileExtensions); eIndex++) { VarArrayAddValue(Str8, &packer->storeExtensions, MakeStr8Nt(StoredFileExtensions[eIndex])); }
+	
+	Str8 rootPathArg = GetNamelessProgramArg(&packer->args, 0);
+	if (IsEmptyStr(rootPathArg))
+	{
+		PrintLine_E("Usage: res_packer \"path/to/resources\" -o=\"%s\" [-align=N] [-level=N] [-store=\".ext\"] [-e=\"path\"] [-verify]", RES_PACKER_DEFAULT_OUTPUT_PATH);
+		return 1;
+	}
+	packer->rootPath = OsGetFullPath(packer->mainArena, rootPathArg);
+	if (DoesPathHaveTrailingSlash(packer->rootPath)) { packer->rootPath.length--; }
+	packer->outputPath = OsGetFullPath(packer->mainArena, FindNamedProgramArgStr(&packer->args, StrLit("output"), StrLit("o"), StrLit(RES_PACKER_DEFAULT_OUTPUT_PATH)));
+	bool verify = FindNamedProgramArgBool(&packer->args, StrLit("verify"), false);
+	
+	u64 alignment = RES_PACK_DEFAULT_ALIGNMENT;
+	Str8 alignArgStr = FindNamedProgramArgStr(&packer->args, StrLit("align"), StrLit("a"), Str8_Empty);
+	if (!IsEmptyStr(alignArgStr) && (!TryParseU64(alignArgStr, &alignment, nullptr) || alignment == 0 || (alignment & (alignment-1)) != 0 || alignment > UINT32_MAX))
+	{
+		PrintLine_E("Invalid alignment \"%.*s\", it must be a power of 2", StrPrint(alignArgStr));
+		return 1;
+	}
+	
+	i32 compressionLevel = MZ_DEFAULT_LEVEL;
+	Str8 levelArgStr = FindNamedProgramArgStr(&packer->args, StrLit("level"), StrLit("l"), Str8_Empty);
+	if (!IsEmptyStr(levelArgStr) && (!TryParseI32(levelArgStr, &compressionLevel, nullptr) || compressionLevel < MZ_NO_COMPRESSION || compressionLevel > MZ_UBER_COMPRESSION))
+	{
+		PrintLine_E("Invalid compression level \"%.*s\", it must be between %d and %d", StrPrint(levelArgStr), MZ_NO_COMPRESSION, MZ_UBER_COMPRESSION);
+		return 1;
+	}
+	
+	for (uxx argIndex = 0; true; argIndex++)
+	{
+		Str8 argStr = FindNamedProgramArgStrEx(&packer->args, StrLit("store"), StrLit("s"), Str8_Empty, argIndex);
+		if (IsEmptyStr(argStr)) { break; }
+		VarArrayAddValue(Str8, &packer->storeExtensions, argStr);
+	}
+	for (uxx argIndex = 0; true; argIndex++)
+	{
+		Str8 argStr = FindNamedProgramArgStrEx(&packer->args, StrLit("exclude"), StrLit("e"), Str8_Empty, argIndex);
+		if (IsEmptyStr(argStr)) { break; }
+		FilePath fullExcludePath = OsGetFullPath(packer->mainArena, argStr);
+		if (DoesPathHaveTrailingSlash(fullExcludePath)) { fullExcludePath.length--; }
+		VarArrayAddValue(FilePath, &packer->excludePaths, fullExcludePath);
+	}
+	
+	// +==============================+
+	// |      Find All The Files      |
+	// +==============================+
+	OsDirWalk walk = ZEROED;
+	Result walkResult = OsWalkDirectory(scratch, packer->rootPath, 0, ResPackerDirWalkExclude, nullptr, nullptr, &walk);
+	if (walkResult != Result_Success)
+	{
+		PrintLine_E("Failed to search \"%.*s\": %s", StrPrint(packer->rootPath), GetResultStr(walkResult));
+		return 1;
+	}
+	PrintLine_I("Packing %llu file%s from \"%.*s\"", (u64)walk.numFiles, Plural(walk.numFiles, "s"), StrPrint(packer->rootPath));
+	
+	// +==============================+
+	// |   Read and Compress Files    |
+	// +==============================+
+	ResPackBuilder builder = ZEROED;
+	InitResPackBuilder(&builder, scratch, (uxx)alignment, compressionLevel);
+	bool hadErrors = false;
+	OsDirWalkLoop(&walk, entry)
+	{
+		if (entry->isFolder) { continue; }
+		uxx scratch2Mark = ArenaGetMark(scratch2);
+		FilePath fullPath = JoinStringsInArenaWithChar(scratch2, packer->rootPath, '/', entry->path, true);
+		Slice fileContents = Slice_Empty;
+		if (!OsReadBinFile(fullPath, scratch2, &fileContents))
+		{
+			PrintLine_E("Failed to read \"%.*s\"", StrPrint(fullPath));
+			hadErrors = true;
+			ArenaResetToMark(scratch2, scratch2Mark);
+			continue;
+		}
+		FilePath packPath = AllocStr8(scratch2, entry->path);
+		ChangePathSlashesTo(packPath, '/');
+		Result addResult = AddResPackBuilderFile(&builder, packPath, fileContents, ChooseCompressionForPath(packPath));
+		if (addResult != Result_Success)
+		{
+			PrintLine_E("Failed to add \"%.*s\": %s", StrPrint(packPath), GetResultStr(addResult));
+			hadErrors = true;
+		}
+		ArenaResetToMark(scratch2, scratch2Mark);
+	}
+	if (hadErrors) { return 1; }
+	
+	// +==============================+
+	// |        Write the Pack        |
+	// +==============================+
+	Result writeResult = WriteResPack(&builder, packer->outputPath);
+	if (writeResult != Result_Success)
+	{
+		PrintLine_E("Failed to write \"%.*s\": %s", StrPrint(packer->outputPath), GetResultStr(writeResult));
+		return 1;
+	}
+	PrintLine_I("Wrote \"%.*s\": %llu file%s, %llu bytes (%llu before compression)",
+		StrPrint(packer->outputPath),
+		(u64)builder.files.length, Plural(builder.files.length, "s"),
+		builder.totalStoredSize, builder.totalSize
+	);
+	
+	if (verify)
+	{
+		ResPack pack = ZEROED;
+		Result openResult = OpenResPackPath(packer->outputPath, &pack);
+		if (openResult != Result_Success) { PrintLine_E("Failed to re-open \"%.*s\": %s", StrPrint(packer->outputPath), GetResultStr(openResult)); return 1; }
+		for (uxx eIndex = 0; eIndex < pack.numEntries; eIndex++)
+		{
+			if (!VerifyResPackEntry(&pack, eIndex))
+			{
+				Str8 entryPath = GetResPackEntryPath(&pack, eIndex);
+				PrintLine_E("Entry \"%.*s\" failed verification!", StrPrint(entryPath));
+				hadErrors = true;
+			}
+		}
+		CloseResPack(&pack);
+		if (hadErrors) { return 1; }
+		PrintLine_I("Verified %llu entr%s", (u64)builder.files.length, PluralEx(builder.files.length, "y", "ies"));
+	}
+	
+	OsTime endTime = OsGetTime();
+	PrintLine_D("Took %.1fms", OsTimeDiffMsR32(startTime, endTime));
+	
+	ScratchEnd(scratch);
+	ScratchEnd(scratch2);
+	return 0;
+}
+
+// +--------------------------------------------------------------+
+// |                     Notification Routers                     |
+// +--------------------------------------------------------------+
+PEXP void NotificationRouter(const char* filePath, u32 lineNumber, const char* funcName, DbgLevel level, u64 duration, const char* message)
+{
+	UNUSED(duration);
+	if ((level == DbgLevel_Debug   && ENABLE_NOTIFICATION_LEVEL_DEBUG)   ||
+		(level == DbgLevel_Regular && ENABLE_NOTIFICATION_LEVEL_REGULAR) ||
+		(level == DbgLevel_Info    && ENABLE_NOTIFICATION_LEVEL_INFO)    ||
+		(level == DbgLevel_Notify  && ENABLE_NOTIFICATION_LEVEL_NOTIFY)  ||
+		(level == DbgLevel_Other   && ENABLE_NOTIFICATION_LEVEL_OTHER)   ||
+		(level == DbgLevel_Warning && ENABLE_NOTIFICATION_LEVEL_WARNING) ||
+		(level == DbgLevel_Error   && ENABLE_NOTIFICATION_LEVEL_ERROR)   ||
+		level == DbgLevel_None || level >= DbgLevel_Count)
+	{
+		DebugOutputRouter(filePath, lineNumber, funcName, level, true, true, message);
+	}
+}
+
+PEXP void NotificationRouterPrint(const char* filePath, u32 lineNumber, const char* funcName, DbgLevel level, u64 duration, uxx printBufferLength, char* printBuffer, const char* formatString, ...)
+{
+	UNUSED(printBufferLength);
+	UNUSED(printBuffer);
+	ScratchBegin(scratch);
+	PrintInArenaVa(scratch, messageStr, messageLength, formatString);
+	if (messageLength >= 0 && (messageStr != nullptr || messageLength == 0))
+	{
+		NotificationRouter(filePath, lineNumber, funcName, level, duration, messageStr);
+	}
+	ScratchEnd(scratch);
+}
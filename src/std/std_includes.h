@@ -44,6 +44,13 @@ typedef uint16_t char16_t;
 #if (TARGET_IS_WINDOWS || USING_CUSTOM_STDLIB)
 	#include <intrin.h>
 #endif
+#if TARGET_HAS_SSE2
+	#include <emmintrin.h>
+#elif TARGET_HAS_NEON
+	#include <arm_neon.h>
+#elif TARGET_HAS_WASM_SIMD
+	#include <wasm_simd128.h>
+#endif
 #if TARGET_IS_LINUX
     #include <dbus/dbus.h> //you may need to install `libdbus-1-dev` on your OS
 #endif
@@ -56,6 +63,15 @@ typedef uint16_t char16_t;
 	#include <dirent.h>
 	// Gives us mmap
 	#include <sys/mman.h>
+	#include <fcntl.h> //needed for open() in os_file.h
+	#if (TARGET_IS_LINUX || TARGET_IS_ANDROID)
+	#include <sys/inotify.h> //needed for OsFileWatchSet in misc_file_watch.h
+	#include <linux/falloc.h> //needed for FALLOC_FL_KEEP_SIZE in os_file.h
+	#endif
+	#if TARGET_IS_LINUX
+	#include <sys/uio.h> //needed for iovec in os_file_async.h
+	#include <linux/io_uring.h> //needed for OsAsyncReader in os_file_async.h
+	#endif
 	#include <sys/time.h>
 	#include <errno.h>
 	#include <dlfcn.h> //needed for dlopen
@@ -81,7 +97,7 @@ typedef uint16_t char16_t;
 	#include <CoreText/CoreText.h>
 	#include <CoreFoundation/CoreFoundation.h>
 #endif
-#if TARGET_IS_LINUX && !BUILD_FOR_PIGGEN
+#if TARGET_IS_LINUX && !BUILD_FOR_PIGGEN && !BUILD_FOR_RES_PACKER
 	#include <fontconfig/fontconfig.h> //You may need to install libfontconfig-dev on your OS
 #endif
 #if TARGET_HAS_ATOMICS
@@ -19,6 +19,7 @@ Description:
 #include "struct/struct_lines.h"
 #include "struct/struct_matrices.h"
 #include "struct/struct_model_data.h"
+#include "struct/struct_piece_table.h"
 #include "struct/struct_pointer_remap.h"
 #include "struct/struct_quaternion.h"
 #include "struct/struct_ranges.h"
@@ -28,6 +29,7 @@ Description:
 #include "struct/struct_stream.h"
 #include "struct/struct_string.h"
 #include "struct/struct_string_buffer.h"
+#include "struct/struct_string_builder.h"
 #include "struct/struct_string_error_list.h"
 #include "struct/struct_typed_array.h"
 #include "struct/struct_var_array.h"
@@ -0,0 +1,593 @@
+/*
+File:   struct_piece_table.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** A PieceTable holds a large editable piece of text without ever storing it in
+	** one contiguous buffer. The original text is copied once and inserted text is
+	** appended to "add chunks" that never move. The document is then described by
+	** a sequence of "pieces", each one a Str8 that points into one of those buffers.
+	** The pieces are kept in a treap (a randomized balanced binary tree) keyed by
+	** their position in the document, so inserts and removals are O(log n) rather
+	** than an O(n) memmove like InsertIntoStrBuffStr.
+	** Every node also caches the number of bytes, new-lines ('\n') and codepoints in
+	** it's subtree, which lets us answer line-start, line-index and byte<->codepoint
+	** queries in O(log n) without walking the whole document.
+	** Pieces are never longer than PIECE_TABLE_MAX_PIECE_LENGTH so that the one piece
+	** we have to scan at the bottom of any lookup is bounded.
+NOTE: The Str8 returned by GetPieceTableChunk is only valid until the next insert\remove
+NOTE: Codepoint counts follow CountUtf8Codepoints, so they are only exact for valid UTF-8
+*/
+
+#ifndef _STRUCT_PIECE_TABLE_H
+#define _STRUCT_PIECE_TABLE_H
+
+#include "base/base_defines_check.h"
+#include "base/base_typedefs.h"
+#include "base/base_macros.h"
+#include "base/base_assert.h"
+#include "base/base_unicode.h"
+#include "std/std_memset.h"
+#include "std/std_basic_math.h"
+#include "mem/mem_arena.h"
+#include "struct/struct_string.h"
+
+#define PIECE_TABLE_MAX_PIECE_LENGTH        4096 //bytes
+#define PIECE_TABLE_DEFAULT_ADD_CHUNK_SIZE  Kilobytes(64)
+
+typedef plex PieceTableNode PieceTableNode;
+plex PieceTableNode
+{
+	PieceTableNode* left; //also used as the "next" pointer when the node is in the free list
+	PieceTableNode* right;
+	u32 priority;
+	
+	Str8 piece;
+	uxx numNewLines;
+	uxx numCodepoints;
+	
+	uxx subtreeLength;
+	uxx subtreeNewLines;
+	uxx subtreeCodepoints;
+};
+
+typedef plex PieceTableChunk PieceTableChunk;
+plex PieceTableChunk
+{
+	PieceTableChunk* next;
+	uxx length;
+	uxx allocLength;
+	char* chars; //points to the memory right after this header
+};
+
+typedef plex PieceTable PieceTable;
+plex PieceTable
+{
+	Arena* arena;
+	Str8 originalText;
+	uxx addChunkSize;
+	PieceTableChunk* firstChunk;
+	PieceTableChunk* lastChunk; //the only chunk we append new text to
+	PieceTableNode* root;
+	PieceTableNode* freeNodes;
+	uxx numNodes; //includes nodes in freeNodes
+	u32 randomState;
+	uxx numEdits; //incremented on every insert\remove, useful for views to know when to re-layout
+};
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	void FreePieceTable(PieceTable* table);
+	void InitPieceTable(Arena* arena, Str8 initialText, PieceTable* tableOut);
+	PIG_CORE_INLINE bool IsPieceTableInit(const PieceTable* table);
+	PIG_CORE_INLINE uxx GetPieceTableLength(const PieceTable* table);
+	PIG_CORE_INLINE uxx GetPieceTableNumCodepoints(const PieceTable* table);
+	PIG_CORE_INLINE uxx GetPieceTableNumLines(const PieceTable* table);
+	void PieceTableInsert(PieceTable* table, uxx index, Str8 text);
+	void PieceTableRemove(PieceTable* table, uxx index, uxx numBytes);
+	PIG_CORE_INLINE void PieceTableReplace(PieceTable* table, uxx index, uxx numBytes, Str8 text);
+	Str8 GetPieceTableChunk(const PieceTable* table, uxx index, uxx* chunkStartOut);
+	uxx GetPieceTableLineStart(const PieceTable* table, uxx lineIndex);
+	PIG_CORE_INLINE uxx GetPieceTableLineEnd(const PieceTable* table, uxx lineIndex);
+	uxx GetPieceTableLineIndex(const PieceTable* table, uxx index);
+	uxx GetPieceTableCodepointIndex(const PieceTable* table, uxx index);
+	uxx GetPieceTableIndexForCodepoint(const PieceTable* table, uxx codepointIndex);
+	uxx CopyPieceTableRange(const PieceTable* table, uxx index, uxx numBytes, char* bufferOut);
+	Str8 GetPieceTableRange(Arena* arena, const PieceTable* table, uxx index, uxx numBytes);
+	PIG_CORE_INLINE Str8 GetPieceTableLine(Arena* arena, const PieceTable* table, uxx lineIndex, bool includeNewLine);
+	PIG_CORE_INLINE Str8 ToStr8FromPieceTable(Arena* arena, const PieceTable* table);
+#endif
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+static void PieceTable_FreeNodeTree(PieceTable* table, PieceTableNode* node)
+{
+	if (node == nullptr) { return; }
+	PieceTable_FreeNodeTree(table, node->left);
+	PieceTable_FreeNodeTree(table, node->right);
+	FreeType(PieceTableNode, table->arena, node);
+}
+
+PEXP void FreePieceTable(PieceTable* table)
+{
+	NotNull(table);
+	if (table->arena != nullptr)
+	{
+		PieceTable_FreeNodeTree(table, table->root);
+		PieceTableNode* freeNode = table->freeNodes;
+		while (freeNode != nullptr)
+		{
+			PieceTableNode* nextFreeNode = freeNode->left;
+			FreeType(PieceTableNode, table->arena, freeNode);
+			freeNode = nextFreeNode;
+		}
+		PieceTableChunk* chunk = table->firstChunk;
+		while (chunk != nullptr)
+		{
+			PieceTableChunk* nextChunk = chunk->next;
+			FreeMem(table->arena, chunk, sizeof(PieceTableChunk) + chunk->allocLength);
+			chunk = nextChunk;
+		}
+		if (table->originalText.chars != nullptr) { FreeMem(table->arena, table->originalText.chars, table->originalText.length); }
+	}
+	ClearPointer(table);
+}
+
+static u32 PieceTable_NextPriority(PieceTable* table)
+{
+	//xorshift32, good enough to keep the treap balanced
+	u32 value = table->randomState;
+	value ^= (value << 13);
+	value ^= (value >> 17);
+	value ^= (value << 5);
+	table->randomState = value;
+	return value;
+}
+
+static uxx PieceTable_CountNewLines(Str8 str)
+{
+	uxx result = 0;
+	uxx bIndex = FindNextByteInStr(str, 0, StrLit("\n"));
+	while (bIndex < str.length)
+	{
+		result++;
+		bIndex = FindNextByteInStr(str, bIndex+1, StrLit("\n"));
+	}
+	return result;
+}
+
+static void PieceTable_UpdatePieceCounts(PieceTableNode* node)
+{
+	node->numNewLines = PieceTable_CountNewLines(node->piece);
+	node->numCodepoints = CountUtf8Codepoints(node->piece.length, node->piece.chars);
+}
+
+static void PieceTable_UpdateSubtree(PieceTableNode* node)
+{
+	node->subtreeLength = node->piece.length;
+	node->subtreeNewLines = node->numNewLines;
+	node->subtreeCodepoints = node->numCodepoints;
+	if (node->left != nullptr)
+	{
+		node->subtreeLength += node->left->subtreeLength;
+		node->subtreeNewLines += node->left->subtreeNewLines;
+		node->subtreeCodepoints += node->left->subtreeCodepoints;
+	}
+	if (node->right != nullptr)
+	{
+		node->subtreeLength += node->right->subtreeLength;
+		node->subtreeNewLines += node->right->subtreeNewLines;
+		node->subtreeCodepoints += node->right->subtreeCodepoints;
+	}
+}
+
+static PieceTableNode* PieceTable_NewNode(PieceTable* table, Str8 piece)
+{
+	PieceTableNode* result = table->freeNodes;
+	if (result != nullptr) { table->freeNodes = result->left; }
+	else
+	{
+		result = AllocType(PieceTableNode, table->arena);
+		NotNull(result);
+		table->numNodes++;
+	}
+	ClearPointer(result);
+	result->priority = PieceTable_NextPriority(table);
+	result->piece = piece;
+	PieceTable_UpdatePieceCounts(result);
+	PieceTable_UpdateSubtree(result);
+	return result;
+}
+
+static void PieceTable_RecycleNodeTree(PieceTable* table, PieceTableNode* node)
+{
+	if (node == nullptr) { return; }
+	PieceTable_RecycleNodeTree(table, node->left);
+	PieceTable_RecycleNodeTree(table, node->right);
+	node->right = nullptr;
+	node->left = table->freeNodes;
+	table->freeNodes = node;
+}
+
+//All of left comes before all of right in the document
+static PieceTableNode* PieceTable_Merge(PieceTableNode* left, PieceTableNode* right)
+{
+	if (left == nullptr) { return right; }
+	if (right == nullptr) { return left; }
+	if (left->priority >= right->priority)
+	{
+		left->right = PieceTable_Merge(left->right, right);
+		PieceTable_UpdateSubtree(left);
+		return left;
+	}
+	else
+	{
+		right->left = PieceTable_Merge(left, right->left);
+		PieceTable_UpdateSubtree(right);
+		return right;
+	}
+}
+
+//Splits the tree so that leftOut holds the first splitIndex bytes, splitting a piece in two if needed
+static void PieceTable_Split(PieceTable* table, PieceTableNode* node, uxx splitIndex, PieceTableNode** leftOut, PieceTableNode** rightOut)
+{
+	if (node == nullptr) { *leftOut = nullptr; *rightOut = nullptr; return; }
+	uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+	if (splitIndex <= leftLength)
+	{
+		PieceTable_Split(table, node->left, splitIndex, leftOut, &node->left);
+		PieceTable_UpdateSubtree(node);
+		*rightOut = node;
+	}
+	else if (splitIndex >= leftLength + node->piece.length)
+	{
+		PieceTable_Split(table, node->right, splitIndex - (leftLength + node->piece.length), &node->right, rightOut);
+		PieceTable_UpdateSubtree(node);
+		*leftOut = node;
+	}
+	else
+	{
+		uxx innerIndex = splitIndex - leftLength;
+		PieceTableNode* secondHalf = PieceTable_NewNode(table, StrSliceFrom(node->piece, innerIndex));
+		node->piece = StrSlice(node->piece, 0, innerIndex);
+		//Rather than re-counting the first half we can subtract the counts that NewNode found for the second half
+		node->numNewLines -= secondHalf->numNewLines;
+		node->numCodepoints -= secondHalf->numCodepoints;
+		PieceTableNode* rightSubtree = node->right;
+		node->right = nullptr;
+		PieceTable_UpdateSubtree(node);
+		*leftOut = node;
+		*rightOut = PieceTable_Merge(secondHalf, rightSubtree);
+	}
+}
+
+//Builds a subtree of pieces (each at most PIECE_TABLE_MAX_PIECE_LENGTH) that cover text, text must already live in a buffer owned by the table
+static PieceTableNode* PieceTable_BuildNodes(PieceTable* table, Str8 text)
+{
+	PieceTableNode* result = nullptr;
+	uxx bIndex = 0;
+	while (bIndex < text.length)
+	{
+		uxx pieceLength = MinUXX(text.length - bIndex, PIECE_TABLE_MAX_PIECE_LENGTH);
+		result = PieceTable_Merge(result, PieceTable_NewNode(table, StrSliceLength(text, bIndex, pieceLength)));
+		bIndex += pieceLength;
+	}
+	return result;
+}
+
+PEXP void InitPieceTable(Arena* arena, Str8 initialText, PieceTable* tableOut)
+{
+	NotNull(arena);
+	NotNull(tableOut);
+	NotNullStr(initialText);
+	ClearPointer(tableOut);
+	tableOut->arena = arena;
+	tableOut->addChunkSize = PIECE_TABLE_DEFAULT_ADD_CHUNK_SIZE;
+	tableOut->randomState = 0x9E3779B9UL;
+	if (initialText.length > 0)
+	{
+		tableOut->originalText.chars = (char*)AllocMem(arena, initialText.length);
+		NotNull(tableOut->originalText.chars);
+		MyMemCopy(tableOut->originalText.chars, initialText.chars, initialText.length);
+		tableOut->originalText.length = initialText.length;
+		tableOut->root = PieceTable_BuildNodes(tableOut, tableOut->originalText);
+	}
+}
+
+PEXPI bool IsPieceTableInit(const PieceTable* table) { NotNull(table); return (table->arena != nullptr); }
+PEXPI uxx GetPieceTableLength(const PieceTable* table) { NotNull(table); return (table->root != nullptr) ? table->root->subtreeLength : 0; }
+PEXPI uxx GetPieceTableNumCodepoints(const PieceTable* table) { NotNull(table); return (table->root != nullptr) ? table->root->subtreeCodepoints : 0; }
+//There is always at least 1 line, even in an empty table
+PEXPI uxx GetPieceTableNumLines(const PieceTable* table) { NotNull(table); return 1 + ((table->root != nullptr) ? table->root->subtreeNewLines : 0); }
+
+//Copies text into the last add chunk (allocating a new one if it doesn't fit) and returns the copy
+static Str8 PieceTable_AppendToAddChunk(PieceTable* table, Str8 text)
+{
+	PieceTableChunk* chunk = table->lastChunk;
+	if (chunk == nullptr || chunk->length + text.length > chunk->allocLength)
+	{
+		uxx allocLength = MaxUXX(table->addChunkSize, text.length);
+		chunk = (PieceTableChunk*)AllocMem(table->arena, sizeof(PieceTableChunk) + allocLength);
+		NotNull(chunk);
+		ClearPointer(chunk);
+		chunk->allocLength = allocLength;
+		chunk->chars = (char*)(chunk + 1);
+		if (table->lastChunk != nullptr) { table->lastChunk->next = chunk; }
+		else { table->firstChunk = chunk; }
+		table->lastChunk = chunk;
+	}
+	Str8 result = MakeStr8(text.length, &chunk->chars[chunk->length]);
+	MyMemCopy(result.chars, text.chars, text.length);
+	chunk->length += text.length;
+	return result;
+}
+
+//When the user is typing, each insert lands right after the piece that the previous insert created.
+//If that piece also ends exactly where the add chunk ends then we can just grow the piece instead of adding a new node
+static bool PieceTable_TryExtendPiece(PieceTable* table, PieceTableNode* node, uxx index, Str8 text)
+{
+	if (node == nullptr) { return false; }
+	uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+	bool result = false;
+	if (index <= leftLength) { result = PieceTable_TryExtendPiece(table, node->left, index, text); }
+	else if (index > leftLength + node->piece.length) { result = PieceTable_TryExtendPiece(table, node->right, index - (leftLength + node->piece.length), text); }
+	else if (index == leftLength + node->piece.length)
+	{
+		PieceTableChunk* chunk = table->lastChunk;
+		if (chunk != nullptr &&
+			node->piece.chars + node->piece.length == &chunk->chars[chunk->length] &&
+			chunk->length + text.length <= chunk->allocLength &&
+			node->piece.length + text.length <= PIECE_TABLE_MAX_PIECE_LENGTH)
+		{
+			Str8 appendedText = PieceTable_AppendToAddChunk(table, text);
+			DebugAssert(appendedText.chars == node->piece.chars + node->piece.length);
+			node->piece.length += appendedText.length;
+			node->numNewLines += PieceTable_CountNewLines(appendedText);
+			node->numCodepoints += CountUtf8Codepoints(appendedText.length, appendedText.chars);
+			result = true;
+		}
+	}
+	if (result) { PieceTable_UpdateSubtree(node); }
+	return result;
+}
+
+PEXP void PieceTableInsert(PieceTable* table, uxx index, Str8 text)
+{
+	NotNull(table);
+	NotNull(table->arena);
+	NotNullStr(text);
+	Assert(index <= GetPieceTableLength(table));
+	if (text.length == 0) { return; }
+	table->numEdits++;
+	if (PieceTable_TryExtendPiece(table, table->root, index, text)) { return; }
+	
+	Str8 storedText = PieceTable_AppendToAddChunk(table, text);
+	PieceTableNode* newNodes = PieceTable_BuildNodes(table, storedText);
+	PieceTableNode* left = nullptr;
+	PieceTableNode* right = nullptr;
+	PieceTable_Split(table, table->root, index, &left, &right);
+	table->root = PieceTable_Merge(PieceTable_Merge(left, newNodes), right);
+}
+
+PEXP void PieceTableRemove(PieceTable* table, uxx index, uxx numBytes)
+{
+	NotNull(table);
+	Assert(index + numBytes <= GetPieceTableLength(table));
+	if (numBytes == 0) { return; }
+	table->numEdits++;
+	PieceTableNode* left = nullptr;
+	PieceTableNode* middleAndRight = nullptr;
+	PieceTableNode* middle = nullptr;
+	PieceTableNode* right = nullptr;
+	PieceTable_Split(table, table->root, index, &left, &middleAndRight);
+	PieceTable_Split(table, middleAndRight, numBytes, &middle, &right);
+	PieceTable_RecycleNodeTree(table, middle);
+	table->root = PieceTable_Merge(left, right);
+	//NOTE: The removed text is still in the original\add buffers, we never reclaim that space until the table is freed
+}
+
+PEXPI void PieceTableReplace(PieceTable* table, uxx index, uxx numBytes, Str8 text)
+{
+	PieceTableRemove(table, index, numBytes);
+	PieceTableInsert(table, index, text);
+}
+
+//Returns the piece that contains index (and the index where that piece starts in chunkStartOut)
+//Walking a range of the document is done by calling this repeatedly with index = chunkStart + chunk.length
+PEXP Str8 GetPieceTableChunk(const PieceTable* table, uxx index, uxx* chunkStartOut)
+{
+	NotNull(table);
+	uxx pieceStart = 0;
+	const PieceTableNode* node = table->root;
+	while (node != nullptr)
+	{
+		uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+		if (index < leftLength) { node = node->left; }
+		else if (index < leftLength + node->piece.length)
+		{
+			SetOptionalOutPntr(chunkStartOut, pieceStart + leftLength);
+			return node->piece;
+		}
+		else
+		{
+			index -= leftLength + node->piece.length;
+			pieceStart += leftLength + node->piece.length;
+			node = node->right;
+		}
+	}
+	SetOptionalOutPntr(chunkStartOut, GetPieceTableLength(table));
+	return Str8_Empty;
+}
+
+//Returns the index of the first byte on the line (the byte after the lineIndex'th '\n'), or the table length if there are not that many lines
+PEXP uxx GetPieceTableLineStart(const PieceTable* table, uxx lineIndex)
+{
+	NotNull(table);
+	if (lineIndex == 0) { return 0; }
+	uxx newLineIndex = lineIndex-1;
+	uxx result = 0;
+	const PieceTableNode* node = table->root;
+	while (node != nullptr)
+	{
+		uxx leftNewLines = (node->left != nullptr) ? node->left->subtreeNewLines : 0;
+		uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+		if (newLineIndex < leftNewLines) { node = node->left; }
+		else if (newLineIndex < leftNewLines + node->numNewLines)
+		{
+			uxx innerNewLineIndex = newLineIndex - leftNewLines;
+			uxx bIndex = FindNextByteInStr(node->piece, 0, StrLit("\n"));
+			for (uxx nIndex = 0; nIndex < innerNewLineIndex; nIndex++) { bIndex = FindNextByteInStr(node->piece, bIndex+1, StrLit("\n")); }
+			DebugAssert(bIndex < node->piece.length);
+			return result + leftLength + bIndex + 1;
+		}
+		else
+		{
+			newLineIndex -= leftNewLines + node->numNewLines;
+			result += leftLength + node->piece.length;
+			node = node->right;
+		}
+	}
+	return GetPieceTableLength(table);
+}
+//Returns the index of the '\n' that ends the line (or the table length for the last line)
+PEXPI uxx GetPieceTableLineEnd(const PieceTable* table, uxx lineIndex)
+{
+	uxx nextLineStart = GetPieceTableLineStart(table, lineIndex+1);
+	return (lineIndex+1 < GetPieceTableNumLines(table)) ? nextLineStart-1 : nextLineStart;
+}
+
+//Returns the number of '\n' characters before index
+PEXP uxx GetPieceTableLineIndex(const PieceTable* table, uxx index)
+{
+	NotNull(table);
+	Assert(index <= GetPieceTableLength(table));
+	uxx result = 0;
+	const PieceTableNode* node = table->root;
+	while (node != nullptr)
+	{
+		uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+		if (index <= leftLength) { node = node->left; }
+		else
+		{
+			result += (node->left != nullptr) ? node->left->subtreeNewLines : 0;
+			if (index < leftLength + node->piece.length)
+			{
+				return result + PieceTable_CountNewLines(StrSlice(node->piece, 0, index - leftLength));
+			}
+			result += node->numNewLines;
+			index -= leftLength + node->piece.length;
+			node = node->right;
+		}
+	}
+	return result;
+}
+
+//Returns the number of codepoints before index
+PEXP uxx GetPieceTableCodepointIndex(const PieceTable* table, uxx index)
+{
+	NotNull(table);
+	Assert(index <= GetPieceTableLength(table));
+	uxx result = 0;
+	const PieceTableNode* node = table->root;
+	while (node != nullptr)
+	{
+		uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+		if (index <= leftLength) { node = node->left; }
+		else
+		{
+			result += (node->left != nullptr) ? node->left->subtreeCodepoints : 0;
+			if (index < leftLength + node->piece.length)
+			{
+				return result + CountUtf8Codepoints(index - leftLength, node->piece.chars);
+			}
+			result += node->numCodepoints;
+			index -= leftLength + node->piece.length;
+			node = node->right;
+		}
+	}
+	return result;
+}
+
+//Returns the byte index where the codepoint at codepointIndex starts, or the table length if there are not that many codepoints
+PEXP uxx GetPieceTableIndexForCodepoint(const PieceTable* table, uxx codepointIndex)
+{
+	NotNull(table);
+	uxx result = 0;
+	const PieceTableNode* node = table->root;
+	while (node != nullptr)
+	{
+		uxx leftCodepoints = (node->left != nullptr) ? node->left->subtreeCodepoints : 0;
+		uxx leftLength = (node->left != nullptr) ? node->left->subtreeLength : 0;
+		if (codepointIndex < leftCodepoints) { node = node->left; }
+		else if (codepointIndex < leftCodepoints + node->numCodepoints)
+		{
+			return result + leftLength + GetUtf8ByteIndexForCodepointIndex(node->piece.length, node->piece.chars, codepointIndex - leftCodepoints);
+		}
+		else
+		{
+			codepointIndex -= leftCodepoints + node->numCodepoints;
+			result += leftLength + node->piece.length;
+			node = node->right;
+		}
+	}
+	return GetPieceTableLength(table);
+}
+
+//bufferOut must be at least numBytes long, returns the number of bytes copied
+PEXP uxx CopyPieceTableRange(const PieceTable* table, uxx index, uxx numBytes, char* bufferOut)
+{
+	NotNull(table);
+	Assert(index + numBytes <= GetPieceTableLength(table));
+	Assert(bufferOut != nullptr || numBytes == 0);
+	uxx numBytesCopied = 0;
+	while (numBytesCopied < numBytes)
+	{
+		uxx chunkStart = 0;
+		Str8 chunk = GetPieceTableChunk(table, index + numBytesCopied, &chunkStart);
+		Assert(chunk.length > 0);
+		uxx innerIndex = (index + numBytesCopied) - chunkStart;
+		uxx copyLength = MinUXX(chunk.length - innerIndex, numBytes - numBytesCopied);
+		MyMemCopy(&bufferOut[numBytesCopied], &chunk.chars[innerIndex], copyLength);
+		numBytesCopied += copyLength;
+	}
+	return numBytesCopied;
+}
+
+//If the range lies within a single piece we return a slice of it directly (no allocation), otherwise we copy into a new allocation from arena
+//Pass arena=nullptr to only get a result when no copy is needed
+PEXP Str8 GetPieceTableRange(Arena* arena, const PieceTable* table, uxx index, uxx numBytes)
+{
+	NotNull(table);
+	Assert(index + numBytes <= GetPieceTableLength(table));
+	if (numBytes == 0) { return Str8_Empty; }
+	uxx chunkStart = 0;
+	Str8 chunk = GetPieceTableChunk(table, index, &chunkStart);
+	if (index + numBytes <= chunkStart + chunk.length) { return StrSliceLength(chunk, index - chunkStart, numBytes); }
+	if (arena == nullptr) { return Str8_Empty; }
+	Str8 result = MakeStr8(numBytes, (char*)AllocMem(arena, numBytes));
+	NotNull(result.chars);
+	CopyPieceTableRange(table, index, numBytes, result.chars);
+	return result;
+}
+
+PEXPI Str8 GetPieceTableLine(Arena* arena, const PieceTable* table, uxx lineIndex, bool includeNewLine)
+{
+	uxx lineStart = GetPieceTableLineStart(table, lineIndex);
+	uxx lineEnd = includeNewLine ? GetPieceTableLineStart(table, lineIndex+1) : GetPieceTableLineEnd(table, lineIndex);
+	return GetPieceTableRange(arena, table, lineStart, lineEnd - lineStart);
+}
+
+PEXPI Str8 ToStr8FromPieceTable(Arena* arena, const PieceTable* table)
+{
+	NotNull(arena);
+	return GetPieceTableRange(arena, table, 0, GetPieceTableLength(table));
+}
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //  _STRUCT_PIECE_TABLE_H
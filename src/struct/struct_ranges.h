@@ -18,6 +18,7 @@ Description:
 #include "base/base_assert.h"
 #include "base/base_math.h"
 #include "std/std_basic_math.h"
+#include "std/std_math_ex.h"
 
 typedef car RangeUXX RangeUXX;
 car RangeUXX
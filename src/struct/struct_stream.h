@@ -5,6 +5,10 @@ Date:   09\06\2025
 Description:
 	** A "stream" is something that can written to and\or read from and could be backed
 	** by a buffer in memory, a file on disk, or a network socket
+	** File backed DataStreams can be given a read-ahead buffer (ToDataStreamFromFileBuffered) so lots of
+	** small reads (like the BinStreamRead macros) are served from memory and PeekDataStream\SkipDataStream
+	** work without copying. DataStreamWriter is the write side, it gathers small writes into a buffer
+	** and only hands them to the file when the buffer fills up or FlushDataStreamWriter is called
 */
 
 #ifndef _STRUCT_STREAM_H
@@ -15,8 +19,14 @@ Description:
 #include "base/base_macros.h"
 #include "base/base_assert.h"
 #include "std/std_memset.h"
+#include "std/std_basic_math.h"
 #include "struct/struct_string.h"
 #include "os/os_file.h"
+#include "mem/mem_arena.h"
+#include "mem/mem_scratch.h"
+
+#define DATA_STREAM_DEFAULT_READ_AHEAD_SIZE Kilobytes(64)
+#define DATA_STREAM_DEFAULT_WRITE_BUFFER_SIZE Kilobytes(64)
 
 typedef enum DataStreamType DataStreamType;
 enum DataStreamType
@@ -57,18 +67,57 @@ plex DataStream
 		OsFile* filePntr;
 		//TODO: Network Socket
 	};
+	
+	//Only used by File streams made with ToDataStreamFromFileBuffered. The bytes between readAheadStart and readAheadEnd
+	//have been read from the file but not consumed yet, so filePntr->cursorIndex is ahead of cursor by that much
+	Arena* readAheadArena;
+	uxx readAheadSize;
+	uxx readAheadStart;
+	uxx readAheadEnd;
+	u8* readAhead;
+};
+
+typedef plex DataStreamWriter DataStreamWriter;
+plex DataStreamWriter
+{
+	DataStreamType type;
+	Result error;
+	uxx cursor; //total number of bytes written, including any that are still sitting in the buffer
+	union
+	{
+		Slice buffer; //Buffer writers write straight into this and fail with Result_EndOfBuffer when it's full
+		OsFile* filePntr;
+	};
+	
+	//Only used by File writers
+	Arena* bufferArena;
+	uxx bufferSize;
+	uxx bufferUsed;
+	u8* bufferPntr;
 };
 
 // +--------------------------------------------------------------+
 // |                 Header Function Declarations                 |
 // +--------------------------------------------------------------+
 #if !PIG_CORE_IMPLEMENTATION
+	PIG_CORE_INLINE void FreeDataStream(DataStream* stream);
 	PIG_CORE_INLINE DataStream ToDataStreamFromBuffer(Slice buffer);
 	PIG_CORE_INLINE DataStream ToDataStreamFromFile(OsFile* osFilePntr);
+	PIG_CORE_INLINE DataStream ToDataStreamFromFileBuffered(OsFile* osFilePntr, Arena* readAheadArena, uxx readAheadSize);
 	PIG_CORE_INLINE bool IsDataStreamMemoryBacked(const DataStream* stream);
 	PIG_CORE_INLINE bool IsDataStreamFinished(const DataStream* stream);
+	u8* PeekDataStream(DataStream* stream, uxx numBytes);
 	u8* TryReadFromDataStream(DataStream* stream, uxx numBytes, Arena* dataArena);
 	PIG_CORE_INLINE u8* TryReadFromDataStreamOrZeros(DataStream* stream, uxx numBytes, Arena* dataArena);
+	bool SkipDataStream(DataStream* stream, uxx numBytes);
+	Result ReadFromDataStreamInto(DataStream* stream, uxx maxNumBytes, void* bufferOut, uxx* numBytesReadOut);
+	PIG_CORE_INLINE void FreeDataStreamWriter(DataStreamWriter* writer);
+	PIG_CORE_INLINE DataStreamWriter ToDataStreamWriterFromBuffer(Slice buffer);
+	PIG_CORE_INLINE DataStreamWriter ToDataStreamWriterFromFile(OsFile* osFilePntr, Arena* bufferArena, uxx bufferSize);
+	bool FlushDataStreamWriter(DataStreamWriter* writer);
+	u8* ReserveDataStreamWriterBytes(DataStreamWriter* writer, uxx numBytes);
+	bool WriteToDataStream(DataStreamWriter* writer, uxx numBytes, const void* bytes);
+	PIG_CORE_INLINE bool WriteStrToDataStream(DataStreamWriter* writer, Str8 str);
 #endif
 
 // +--------------------------------------------------------------+
@@ -76,6 +125,13 @@ plex DataStream
 // +--------------------------------------------------------------+
 #if PIG_CORE_IMPLEMENTATION
 
+PEXPI void FreeDataStream(DataStream* stream)
+{
+	NotNull(stream);
+	if (stream->readAhead != nullptr && CanArenaFree(stream->readAheadArena)) { FreeMem(stream->readAheadArena, stream->readAhead, stream->readAheadSize); }
+	ClearPointer(stream);
+}
+
 PEXPI DataStream ToDataStreamFromBuffer(Slice buffer)
 {
 	DataStream result = ZEROED;
@@ -99,9 +155,101 @@ PEXPI DataStream ToDataStreamFromFile(OsFile* osFilePntr)
 	return result;
 }
 
+//NOTE: Pass 0 for readAheadSize to get DATA_STREAM_DEFAULT_READ_AHEAD_SIZE. Call FreeDataStream when done to release the buffer.
+//      The stream reads ahead of its own cursor so the OsFile should not be read from directly while the stream is in use
+PEXPI DataStream ToDataStreamFromFileBuffered(OsFile* osFilePntr, Arena* readAheadArena, uxx readAheadSize)
+{
+	NotNull(readAheadArena);
+	DataStream result = ToDataStreamFromFile(osFilePntr);
+	result.readAheadArena = readAheadArena;
+	result.readAheadSize = (readAheadSize > 0) ? readAheadSize : DATA_STREAM_DEFAULT_READ_AHEAD_SIZE;
+	result.readAhead = (u8*)AllocMem(readAheadArena, result.readAheadSize);
+	if (result.readAhead == nullptr) { result.readAheadSize = 0; } //falls back to reading straight from the file
+	return result;
+}
+
 PEXPI bool IsDataStreamMemoryBacked(const DataStream* stream) { return (stream->type == DataStreamType_Buffer); }
 PEXPI bool IsDataStreamFinished(const DataStream* stream) { return (stream->type == DataStreamType_None || (stream->size != UINTXX_MAX && stream->cursor >= stream->size)); }
 
+//Updates size and cursor from the OsFile, the cursor trails the file by however many read-ahead bytes haven't been consumed yet
+static void DataStreamSyncWithFile(DataStream* stream)
+{
+	stream->size = (stream->filePntr->isKnownSize ? stream->filePntr->fileSize : UINTXX_MAX);
+	stream->cursor = stream->filePntr->cursorIndex - (stream->readAheadEnd - stream->readAheadStart);
+}
+
+//Makes sure at least numBytes are sitting in the read-ahead buffer, growing it if numBytes is bigger than the buffer.
+//Returns Result_EndOfFile if the file ran out first, or the failure from OsReadFromOpenFile (stream->error is left for the caller to set)
+static Result DataStreamFillReadAhead(DataStream* stream, uxx numBytes)
+{
+	if (stream->readAheadEnd - stream->readAheadStart >= numBytes) { return Result_Success; }
+	if (stream->readAheadStart == stream->readAheadEnd) { stream->readAheadStart = 0; stream->readAheadEnd = 0; }
+	if (stream->readAheadStart + numBytes > stream->readAheadSize)
+	{
+		//Slide the unconsumed bytes to the front, anything before readAheadStart has already been handed out
+		uxx numBytesLeft = stream->readAheadEnd - stream->readAheadStart;
+		if (numBytesLeft > 0) { MyMemMove(stream->readAhead, stream->readAhead + stream->readAheadStart, numBytesLeft); }
+		stream->readAheadStart = 0;
+		stream->readAheadEnd = numBytesLeft;
+	}
+	if (numBytes > stream->readAheadSize)
+	{
+		uxx newSize = stream->readAheadSize;
+		while (newSize < numBytes) { newSize *= 2; }
+		u8* newBuffer = (u8*)ReallocMem(stream->readAheadArena, stream->readAhead, stream->readAheadSize, newSize);
+		if (newBuffer == nullptr) { return Result_FailedToAllocateMemory; }
+		stream->readAhead = newBuffer;
+		stream->readAheadSize = newSize;
+	}
+	
+	while (stream->readAheadEnd - stream->readAheadStart < numBytes)
+	{
+		uxx numBytesRead = 0;
+		Result readResult = OsReadFromOpenFile(stream->filePntr, stream->readAheadSize - stream->readAheadEnd, false, stream->readAhead + stream->readAheadEnd, &numBytesRead);
+		if (readResult == Result_NoMoreBytes) { return Result_EndOfFile; }
+		if (readResult != Result_Success && readResult != Result_Partial) { return readResult; }
+		if (numBytesRead == 0) { return Result_EndOfFile; }
+		stream->readAheadEnd += numBytesRead;
+	}
+	return Result_Success;
+}
+
+//Returns a pointer to the next numBytes without moving the cursor. The pointer is only valid until the next read from the stream.
+//File streams need a read-ahead buffer for this (see ToDataStreamFromFileBuffered).
+//Returns nullptr if there are fewer than numBytes left (stream->error is only set if something actually went wrong)
+PEXP u8* PeekDataStream(DataStream* stream, uxx numBytes)
+{
+	NotNull(stream);
+	if (numBytes == 0) { return nullptr; }
+	u8* result = nullptr;
+	switch (stream->type)
+	{
+		case DataStreamType_Buffer:
+		{
+			if (stream->cursor + numBytes > stream->size) { return nullptr; }
+			NotNull(stream->buffer.bytes);
+			result = &stream->buffer.bytes[stream->cursor];
+		} break;
+		
+		case DataStreamType_File:
+		{
+			NotNull(stream->filePntr);
+			AssertMsg(stream->readAhead != nullptr, "PeekDataStream only works on File streams that were made with ToDataStreamFromFileBuffered");
+			if (stream->readAhead == nullptr) { return nullptr; }
+			Result fillResult = DataStreamFillReadAhead(stream, numBytes);
+			DataStreamSyncWithFile(stream);
+			if (fillResult == Result_EndOfFile) { return nullptr; }
+			if (fillResult != Result_Success) { stream->error = fillResult; return nullptr; }
+			result = &stream->readAhead[stream->readAheadStart];
+		} break;
+		
+		default: Assert(false); break;
+	}
+	return result;
+}
+
+//NOTE: Passing nullptr for dataArena gives a pointer into the stream's memory rather than a copy (only valid until the next read for File streams).
+//      File streams without a read-ahead buffer always need a dataArena
 PEXP u8* TryReadFromDataStream(DataStream* stream, uxx numBytes, Arena* dataArena)
 {
 	NotNull(stream);
@@ -126,25 +274,54 @@ PEXP u8* TryReadFromDataStream(DataStream* stream, uxx numBytes, Arena* dataAren
 		case DataStreamType_File:
 		{
 			NotNull(stream->filePntr);
+			if (stream->readAhead != nullptr && (dataArena == nullptr || numBytes <= stream->readAheadSize))
+			{
+				//Small reads (and zero-copy reads of any size) are served from the read-ahead buffer
+				Result fillResult = DataStreamFillReadAhead(stream, numBytes);
+				if (fillResult != Result_Success)
+				{
+					DataStreamSyncWithFile(stream);
+					if (fillResult == Result_EndOfFile) { stream->size = stream->filePntr->cursorIndex; }
+					stream->error = fillResult;
+					return nullptr;
+				}
+				if (dataArena != nullptr)
+				{
+					result = (u8*)AllocMem(dataArena, numBytes);
+					if (result == nullptr) { stream->error = Result_FailedToAllocateMemory; return nullptr; }
+					MyMemCopy(result, &stream->readAhead[stream->readAheadStart], numBytes);
+				}
+				else { result = &stream->readAhead[stream->readAheadStart]; }
+				stream->readAheadStart += numBytes;
+				DataStreamSyncWithFile(stream);
+				break;
+			}
+			
 			NotNull(dataArena);
-			stream->size = (stream->filePntr->isKnownSize ? stream->filePntr->fileSize : UINTXX_MAX);
-			stream->cursor = stream->filePntr->cursorIndex;
+			DataStreamSyncWithFile(stream);
 			if (stream->size != UINTXX_MAX && stream->cursor + numBytes > stream->size) { stream->error = Result_EndOfFile; return nullptr; }
 			
 			result = (u8*)AllocMem(dataArena, numBytes);
 			if (result == nullptr) { stream->error = Result_FailedToAllocateMemory; return nullptr; }
 			
+			//Big reads take whatever is already in the read-ahead buffer and then go straight from the file into the result
+			uxx numBytesBuffered = MinUXX(stream->readAheadEnd - stream->readAheadStart, numBytes);
+			if (numBytesBuffered > 0)
+			{
+				MyMemCopy(result, &stream->readAhead[stream->readAheadStart], numBytesBuffered);
+				stream->readAheadStart += numBytesBuffered;
+			}
+			
 			uxx numBytesRead = 0;
-			Result readResult = OsReadFromOpenFile(stream->filePntr, numBytes, false, result, &numBytesRead);
-			stream->size = (stream->filePntr->isKnownSize ? stream->filePntr->fileSize : UINTXX_MAX);
-			stream->cursor = stream->filePntr->cursorIndex;
+			Result readResult = OsReadFromOpenFile(stream->filePntr, numBytes - numBytesBuffered, false, result + numBytesBuffered, &numBytesRead);
+			DataStreamSyncWithFile(stream);
 			if (readResult != Result_Success)
 			{
 				if (CanArenaFree(dataArena)) { FreeMem(dataArena, result, numBytes); }
 				stream->error = readResult;
 				return nullptr;
 			}
-			else if (numBytesRead < numBytes)
+			else if (numBytesBuffered + numBytesRead < numBytes)
 			{
 				if (CanArenaFree(dataArena)) { FreeMem(dataArena, result, numBytes); }
 				stream->error = Result_EndOfFile;
@@ -158,12 +335,19 @@ PEXP u8* TryReadFromDataStream(DataStream* stream, uxx numBytes, Arena* dataAren
 	return result;
 }
 
+//NOTE: dataArena can be nullptr for reads of up to 16 bytes (like the BinStreamRead macros) on Buffer streams and buffered File streams,
+//      a failed read then gives a pointer to some static zeros rather than allocating them
 PEXPI u8* TryReadFromDataStreamOrZeros(DataStream* stream, uxx numBytes, Arena* dataArena)
 {
-	NotNull(dataArena);
+	static const u64 zeros[2] = { 0, 0 };
 	u8* result = TryReadFromDataStream(stream, numBytes, dataArena);
 	if (numBytes > 0 && result == nullptr)
 	{
+		if (dataArena == nullptr)
+		{
+			Assert(numBytes <= sizeof(zeros));
+			return (u8*)&zeros[0];
+		}
 		result = (u8*)AllocMem(dataArena, numBytes);
 		NotNull(result);
 		MyMemSet(result, 0x00, numBytes);
@@ -171,6 +355,249 @@ PEXPI u8* TryReadFromDataStreamOrZeros(DataStream* stream, uxx numBytes, Arena*
 	return result;
 }
 
+//Moves the cursor forward numBytes without handing back the bytes. File streams without a read-ahead buffer read and discard through scratch memory.
+//Returns false (and sets stream->error) if there weren't numBytes left
+PEXP bool SkipDataStream(DataStream* stream, uxx numBytes)
+{
+	NotNull(stream);
+	if (numBytes == 0) { return true; }
+	switch (stream->type)
+	{
+		case DataStreamType_Buffer:
+		{
+			if (stream->cursor + numBytes > stream->size) { stream->error = Result_EndOfBuffer; return false; }
+			stream->cursor += numBytes;
+		} break;
+		
+		case DataStreamType_File:
+		{
+			NotNull(stream->filePntr);
+			DataStreamSyncWithFile(stream);
+			if (stream->size != UINTXX_MAX && stream->cursor + numBytes > stream->size) { stream->error = Result_EndOfFile; return false; }
+			
+			uxx numBytesLeft = numBytes;
+			while (numBytesLeft > 0)
+			{
+				uxx numBytesBuffered = stream->readAheadEnd - stream->readAheadStart;
+				if (numBytesBuffered > 0)
+				{
+					uxx numBytesToSkip = MinUXX(numBytesBuffered, numBytesLeft);
+					stream->readAheadStart += numBytesToSkip;
+					numBytesLeft -= numBytesToSkip;
+					continue;
+				}
+				
+				Result readResult = Result_None;
+				if (stream->readAhead != nullptr) { readResult = DataStreamFillReadAhead(stream, 1); }
+				else
+				{
+					ScratchBegin(scratch);
+					uxx discardSize = MinUXX(numBytesLeft, Kilobytes(64));
+					u8* discardBuffer = (u8*)AllocMem(scratch, discardSize);
+					NotNull(discardBuffer);
+					uxx numBytesRead = 0;
+					readResult = OsReadFromOpenFile(stream->filePntr, discardSize, false, discardBuffer, &numBytesRead);
+					if (readResult == Result_NoMoreBytes || (readResult == Result_Partial && numBytesRead == 0)) { readResult = Result_EndOfFile; }
+					else if (readResult == Result_Partial) { readResult = Result_Success; }
+					numBytesLeft -= numBytesRead;
+					ScratchEnd(scratch);
+				}
+				if (readResult != Result_Success)
+				{
+					DataStreamSyncWithFile(stream);
+					if (readResult == Result_EndOfFile) { stream->size = stream->filePntr->cursorIndex; }
+					stream->error = readResult;
+					return false;
+				}
+			}
+			DataStreamSyncWithFile(stream);
+		} break;
+		
+		default: Assert(false); break;
+	}
+	return true;
+}
+
+//Unlike TryReadFromDataStream this reads into a caller provided buffer and is allowed to read less than maxNumBytes when the end of the stream is reached.
+//Returns Result_EndOfBuffer/Result_EndOfFile (and sets stream->error) only when there were no bytes left to read at all
+PEXP Result ReadFromDataStreamInto(DataStream* stream, uxx maxNumBytes, void* bufferOut, uxx* numBytesReadOut)
+{
+	NotNull(stream);
+	NotNull(numBytesReadOut);
+	Assert(bufferOut != nullptr || maxNumBytes == 0);
+	*numBytesReadOut = 0;
+	if (maxNumBytes == 0) { return Result_Success; }
+	switch (stream->type)
+	{
+		case DataStreamType_Buffer:
+		{
+			if (stream->cursor >= stream->size) { stream->error = Result_EndOfBuffer; return Result_EndOfBuffer; }
+			NotNull(stream->buffer.bytes);
+			uxx numBytesToRead = MinUXX(maxNumBytes, stream->size - stream->cursor);
+			MyMemCopy(bufferOut, &stream->buffer.bytes[stream->cursor], numBytesToRead);
+			stream->cursor += numBytesToRead;
+			*numBytesReadOut = numBytesToRead;
+		} break;
+		
+		case DataStreamType_File:
+		{
+			NotNull(stream->filePntr);
+			if (stream->readAhead != nullptr)
+			{
+				//Reads smaller than the buffer go through it, bigger ones only drain what's already buffered and then read straight into bufferOut
+				if (stream->readAheadStart == stream->readAheadEnd && maxNumBytes < stream->readAheadSize)
+				{
+					Result fillResult = DataStreamFillReadAhead(stream, 1);
+					if (fillResult != Result_Success && fillResult != Result_EndOfFile) { DataStreamSyncWithFile(stream); stream->error = fillResult; return fillResult; }
+				}
+				uxx numBytesBuffered = stream->readAheadEnd - stream->readAheadStart;
+				if (numBytesBuffered > 0)
+				{
+					uxx numBytesToRead = MinUXX(maxNumBytes, numBytesBuffered);
+					MyMemCopy(bufferOut, &stream->readAhead[stream->readAheadStart], numBytesToRead);
+					stream->readAheadStart += numBytesToRead;
+					DataStreamSyncWithFile(stream);
+					*numBytesReadOut = numBytesToRead;
+					break;
+				}
+			}
+			
+			DataStreamSyncWithFile(stream);
+			if (stream->size != UINTXX_MAX && stream->cursor >= stream->size) { stream->error = Result_EndOfFile; return Result_EndOfFile; }
+			
+			uxx numBytesRead = 0;
+			Result readResult = OsReadFromOpenFile(stream->filePntr, maxNumBytes, false, bufferOut, &numBytesRead);
+			DataStreamSyncWithFile(stream);
+			if (readResult == Result_NoMoreBytes) { numBytesRead = 0; }
+			else if (readResult != Result_Success && readResult != Result_Partial) { stream->error = readResult; return readResult; }
+			if (numBytesRead == 0) { stream->error = Result_EndOfFile; stream->size = stream->cursor; return Result_EndOfFile; }
+			*numBytesReadOut = numBytesRead;
+		} break;
+		
+		default: Assert(false); break;
+	}
+	return Result_Success;
+}
+
+// +--------------------------------------------------------------+
+// |                       DataStreamWriter                       |
+// +--------------------------------------------------------------+
+//NOTE: Make sure to call FlushDataStreamWriter first, anything still in the buffer is dropped
+PEXPI void FreeDataStreamWriter(DataStreamWriter* writer)
+{
+	NotNull(writer);
+	DebugAssertMsg(writer->bufferUsed == 0 || writer->error != Result_None, "FreeDataStreamWriter called with bytes that were never flushed!");
+	if (writer->bufferPntr != nullptr && CanArenaFree(writer->bufferArena)) { FreeMem(writer->bufferArena, writer->bufferPntr, writer->bufferSize); }
+	ClearPointer(writer);
+}
+
+PEXPI DataStreamWriter ToDataStreamWriterFromBuffer(Slice buffer)
+{
+	DataStreamWriter result = ZEROED;
+	result.type = DataStreamType_Buffer;
+	result.error = Result_None;
+	result.cursor = 0;
+	result.buffer = buffer;
+	return result;
+}
+
+//NOTE: Pass 0 for bufferSize to get DATA_STREAM_DEFAULT_WRITE_BUFFER_SIZE.
+//      Nothing reaches the file until the buffer fills up or FlushDataStreamWriter is called
+PEXPI DataStreamWriter ToDataStreamWriterFromFile(OsFile* osFilePntr, Arena* bufferArena, uxx bufferSize)
+{
+	Assert(osFilePntr != nullptr && osFilePntr->isOpen && osFilePntr->openedForWriting);
+	NotNull(bufferArena);
+	DataStreamWriter result = ZEROED;
+	result.type = DataStreamType_File;
+	result.error = Result_None;
+	result.cursor = 0;
+	result.filePntr = osFilePntr;
+	result.bufferArena = bufferArena;
+	result.bufferSize = (bufferSize > 0) ? bufferSize : DATA_STREAM_DEFAULT_WRITE_BUFFER_SIZE;
+	result.bufferPntr = (u8*)AllocMem(bufferArena, result.bufferSize);
+	if (result.bufferPntr == nullptr) { result.bufferSize = 0; } //falls back to writing straight to the file
+	return result;
+}
+
+//Hands everything in the buffer to the file. Returns false if this (or any earlier write) failed
+PEXP bool FlushDataStreamWriter(DataStreamWriter* writer)
+{
+	NotNull(writer);
+	if (writer->error != Result_None) { return false; }
+	if (writer->type != DataStreamType_File || writer->bufferUsed == 0) { return true; }
+	NotNull(writer->filePntr);
+	bool writeSuccess = OsWriteToOpenFile(writer->filePntr, MakeStr8(writer->bufferUsed, (const char*)writer->bufferPntr), false);
+	writer->bufferUsed = 0;
+	if (!writeSuccess) { writer->error = Result_FailedToWriteFile; return false; }
+	return true;
+}
+
+//Returns a pointer to numBytes of space for the caller to fill in directly, the bytes count as written right away.
+//For File writers numBytes can't be bigger than the buffer. Returns nullptr (and sets writer->error) on failure
+PEXP u8* ReserveDataStreamWriterBytes(DataStreamWriter* writer, uxx numBytes)
+{
+	NotNull(writer);
+	if (numBytes == 0 || writer->error != Result_None) { return nullptr; }
+	u8* result = nullptr;
+	switch (writer->type)
+	{
+		case DataStreamType_Buffer:
+		{
+			if (writer->cursor + numBytes > writer->buffer.length) { writer->error = Result_EndOfBuffer; return nullptr; }
+			result = &writer->buffer.bytes[writer->cursor];
+		} break;
+		
+		case DataStreamType_File:
+		{
+			if (numBytes > writer->bufferSize) { writer->error = Result_TooLong; return nullptr; }
+			if (writer->bufferUsed + numBytes > writer->bufferSize && !FlushDataStreamWriter(writer)) { return nullptr; }
+			result = &writer->bufferPntr[writer->bufferUsed];
+			writer->bufferUsed += numBytes;
+		} break;
+		
+		default: Assert(false); break;
+	}
+	writer->cursor += numBytes;
+	return result;
+}
+
+PEXP bool WriteToDataStream(DataStreamWriter* writer, uxx numBytes, const void* bytes)
+{
+	NotNull(writer);
+	if (writer->error != Result_None) { return false; }
+	if (numBytes == 0) { return true; }
+	NotNull(bytes);
+	switch (writer->type)
+	{
+		case DataStreamType_Buffer:
+		{
+			if (writer->cursor + numBytes > writer->buffer.length) { writer->error = Result_EndOfBuffer; return false; }
+			MyMemCopy(&writer->buffer.bytes[writer->cursor], bytes, numBytes);
+		} break;
+		
+		case DataStreamType_File:
+		{
+			if (writer->bufferUsed + numBytes > writer->bufferSize && !FlushDataStreamWriter(writer)) { return false; }
+			if (numBytes <= writer->bufferSize)
+			{
+				MyMemCopy(&writer->bufferPntr[writer->bufferUsed], bytes, numBytes);
+				writer->bufferUsed += numBytes;
+			}
+			else
+			{
+				//Writes bigger than the whole buffer skip it (it was just flushed so the order is preserved)
+				if (!OsWriteToOpenFile(writer->filePntr, MakeStr8(numBytes, (const char*)bytes), false)) { writer->error = Result_FailedToWriteFile; return false; }
+			}
+		} break;
+		
+		default: Assert(false); break;
+	}
+	writer->cursor += numBytes;
+	return true;
+}
+
+PEXPI bool WriteStrToDataStream(DataStreamWriter* writer, Str8 str) { return WriteToDataStream(writer, str.length, str.chars); }
+
 #endif //PIG_CORE_IMPLEMENTATION
 
 #endif //  _STRUCT_STREAM_H
@@ -178,3 +605,7 @@ PEXPI u8* TryReadFromDataStreamOrZeros(DataStream* stream, uxx numBytes, Arena*
 #if defined(_STRUCT_STREAM_H) && defined(_PARSE_BINARY_H)
 #include "cross/cross_stream_and_parse_binary.h"
 #endif
+
+#if defined(_STRUCT_STREAM_H) && defined(_PARSE_PROTOBUF_H)
+#include "cross/cross_stream_and_protobuf.h"
+#endif
@@ -50,6 +50,7 @@ Description:
 #include "base/base_macros.h"
 #include "base/base_assert.h"
 #include "base/base_char.h"
+#include "base/base_simd.h"
 #include "std/std_memset.h"
 #include "lib/lib_raddbg.h"
 
@@ -156,6 +157,7 @@ plex Str8Pair
 	PIG_CORE_INLINE uxx StrFind(Str8 haystack, Str8 needle, bool caseSensitive);
 	PIG_CORE_INLINE uxx StrFindAfter(Str8 haystack, uxx startIndex, Str8 needle, bool caseSensitive);
 	PIG_CORE_INLINE bool StrTryFind(Str8 haystack, Str8 needle, bool caseSensitive, uxx* indexOut);
+	uxx FindNextByteInStr(Str8 target, uxx startIndex, Str8 searchBytes);
 #endif //!PIG_CORE_IMPLEMENTATION
 
 // +--------------------------------------------------------------+
@@ -352,26 +354,40 @@ PEXPI bool StrExactEndsWith(Str8 target, Str8 suffix)
 	if (target.length < suffix.length) { return false; }
 	return StrExactEquals(StrSlice(target, target.length - suffix.length, target.length), suffix);
 }
-PEXP bool StrExactContains(Str8 haystack, Str8 needle)
-{
-	Assert(needle.length > 0);
-	if (haystack.length < needle.length) { return false; }
-	for (uxx bIndex = 0; bIndex <= haystack.length - needle.length; bIndex++)
-	{
-		if (StrExactEqualsAt(haystack, needle, bIndex)) { return true; }
-	}
-	return false;
-}
+//NOTE: The SIMD path compares the first and last byte of the needle against 16 positions in the haystack
+//      at once and only does a full compare for positions where both match
 PEXP uxx StrExactFind(Str8 haystack, Str8 needle)
 {
 	Assert(needle.length > 0);
 	if (haystack.length < needle.length) { return haystack.length; }
-	for (uxx bIndex = 0; bIndex <= haystack.length - needle.length; bIndex++)
+	uxx lastStartIndex = haystack.length - needle.length;
+	uxx bIndex = 0;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 firstByte = SimdU8x16_Splat(needle.bytes[0]);
+	SimdU8x16 lastByte = SimdU8x16_Splat(needle.bytes[needle.length-1]);
+	for (; bIndex + SIMD_U8X16_SIZE <= lastStartIndex + 1; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 firstBlock = SimdU8x16_Load(&haystack.bytes[bIndex]);
+		SimdU8x16 lastBlock = SimdU8x16_Load(&haystack.bytes[bIndex + needle.length-1]);
+		u32 candidates = SimdU8x16_Mask(SimdU8x16_And(SimdU8x16_Equal(firstBlock, firstByte), SimdU8x16_Equal(lastBlock, lastByte)));
+		while (candidates != 0)
+		{
+			uxx candidateIndex = bIndex + CountTrailingZerosU32(candidates);
+			if (needle.length <= 2 || MyMemEquals(&haystack.bytes[candidateIndex+1], &needle.bytes[1], needle.length-2)) { return candidateIndex; }
+			candidates &= (candidates - 1);
+		}
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex <= lastStartIndex; bIndex++)
 	{
 		if (StrExactEqualsAt(haystack, needle, bIndex)) { return bIndex; }
 	}
 	return haystack.length;
 }
+PEXP bool StrExactContains(Str8 haystack, Str8 needle)
+{
+	return (StrExactFind(haystack, needle) < haystack.length);
+}
 PEXPI bool StrTryExactFind(Str8 haystack, Str8 needle, uxx* indexOut)
 {
 	uxx index = StrExactFind(haystack, needle);
@@ -405,27 +421,41 @@ PEXPI bool StrAnyCaseEndsWith(Str8 target, Str8 suffix)
 	if (target.length < suffix.length) { return false; }
 	return StrAnyCaseEquals(StrSliceFrom(target, target.length - suffix.length), suffix);
 }
-PEXPI bool StrAnyCaseContains(Str8 haystack, Str8 needle)
-{
-	Assert(needle.length > 0);
-	if (StrExactContains(haystack, needle)) { return true; }
-	if (needle.length > haystack.length) { return false; }
-	for (uxx bIndex = 0; bIndex <= haystack.length - needle.length; bIndex++)
-	{
-		if (StrAnyCaseEqualsAt(haystack, needle, bIndex)) { return true; }
-	}
-	return false;
-}
+//NOTE: Like StrExactFind but the haystack is lowercased 16 bytes at a time before comparing against the lowercased first and last byte of the needle
 PEXPI uxx StrAnyCaseFind(Str8 haystack, Str8 needle)
 {
 	Assert(needle.length > 0);
 	if (needle.length > haystack.length) { return haystack.length; }
-	for (uxx bIndex = 0; bIndex <= haystack.length - needle.length; bIndex++)
+	uxx lastStartIndex = haystack.length - needle.length;
+	uxx bIndex = 0;
+	#if TARGET_HAS_SIMD
+	SimdU8x16 firstByte = SimdU8x16_Splat(ToLowerChar(needle.chars[0]));
+	SimdU8x16 lastByte = SimdU8x16_Splat(ToLowerChar(needle.chars[needle.length-1]));
+	for (; bIndex + SIMD_U8X16_SIZE <= lastStartIndex + 1; bIndex += SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 firstBlock = SimdU8x16_Load(&haystack.bytes[bIndex]);
+		SimdU8x16 lastBlock = SimdU8x16_Load(&haystack.bytes[bIndex + needle.length-1]);
+		firstBlock = SimdU8x16_ToLowerAscii(firstBlock);
+		lastBlock = SimdU8x16_ToLowerAscii(lastBlock);
+		u32 candidates = SimdU8x16_Mask(SimdU8x16_And(SimdU8x16_Equal(firstBlock, firstByte), SimdU8x16_Equal(lastBlock, lastByte)));
+		while (candidates != 0)
+		{
+			uxx candidateIndex = bIndex + CountTrailingZerosU32(candidates);
+			if (StrAnyCaseEqualsAt(haystack, needle, candidateIndex)) { return candidateIndex; }
+			candidates &= (candidates - 1);
+		}
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex <= lastStartIndex; bIndex++)
 	{
 		if (StrAnyCaseEqualsAt(haystack, needle, bIndex)) { return bIndex; }
 	}
 	return haystack.length;
 }
+PEXPI bool StrAnyCaseContains(Str8 haystack, Str8 needle)
+{
+	return (StrAnyCaseFind(haystack, needle) < haystack.length);
+}
 PEXPI bool StrTryAnyCaseFind(Str8 haystack, Str8 needle, uxx* indexOut)
 {
 	uxx index = StrAnyCaseFind(haystack, needle);
@@ -469,6 +499,39 @@ PEXPI bool StrTryFind(Str8 haystack, Str8 needle, bool caseSensitive, uxx* index
 }
 
 
+//Returns the index of the first byte at or after startIndex that matches any of the bytes in searchBytes, or target.length if none are found
+//NOTE: This treats target as raw bytes, it's only equivalent to a codepoint search if all searchBytes are ASCII (< 0x80)
+PEXP uxx FindNextByteInStr(Str8 target, uxx startIndex, Str8 searchBytes)
+{
+	NotNullStr(target);
+	NotNullStr(searchBytes);
+	Assert(startIndex <= target.length);
+	uxx bIndex = startIndex;
+	#if TARGET_HAS_SIMD
+	if (searchBytes.length > 0 && searchBytes.length <= SIMD_U8X16_SIZE)
+	{
+		SimdU8x16 searchVectors[SIMD_U8X16_SIZE];
+		for (uxx sIndex = 0; sIndex < searchBytes.length; sIndex++) { searchVectors[sIndex] = SimdU8x16_Splat(searchBytes.bytes[sIndex]); }
+		for (; bIndex + SIMD_U8X16_SIZE <= target.length; bIndex += SIMD_U8X16_SIZE)
+		{
+			SimdU8x16 block = SimdU8x16_Load(&target.bytes[bIndex]);
+			SimdU8x16 matches = SimdU8x16_Equal(block, searchVectors[0]);
+			for (uxx sIndex = 1; sIndex < searchBytes.length; sIndex++) { matches = SimdU8x16_Or(matches, SimdU8x16_Equal(block, searchVectors[sIndex])); }
+			u32 matchMask = SimdU8x16_Mask(matches);
+			if (matchMask != 0) { return bIndex + CountTrailingZerosU32(matchMask); }
+		}
+	}
+	#endif //TARGET_HAS_SIMD
+	for (; bIndex < target.length; bIndex++)
+	{
+		for (uxx sIndex = 0; sIndex < searchBytes.length; sIndex++)
+		{
+			if (target.bytes[bIndex] == searchBytes.bytes[sIndex]) { return bIndex; }
+		}
+	}
+	return target.length;
+}
+
 
 //TODO: Str8 CombineStrs(MemArena_t* memArena, Str8 str1, Str8 str2)
 //TODO: Str8 CombineStrs(MemArena_t* memArena, Str8 str1, Str8 str2, Str8 str3)
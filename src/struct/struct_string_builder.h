@@ -0,0 +1,249 @@
+/*
+File:   struct_string_builder.h
+Author: Taylor Robbins
+Date:   10\18\2026
+Description:
+	** A StringBuilder is like a StringBuffer but it can grow. It starts out either
+	** empty or pointing at a caller provided buffer (usually on the stack, see NewStrBuilder)
+	** and once the contents don't fit it moves into an allocation from the Arena.
+	** Growth is geometric and goes through ReallocMem, so for stack-like arenas where
+	** the builder is the last allocation the memory is simply extended in place.
+	** StrBuilderAppendPrint formats directly into the remaining space, so the common
+	** case only runs the formatter once (unlike PrintInArena or TwoPassPrint which always measure first).
+NOTE: Like StringBuffer, the contents are always kept null-terminated
+*/
+
+#ifndef _STRUCT_STRING_BUILDER_H
+#define _STRUCT_STRING_BUILDER_H
+
+#include "base/base_defines_check.h"
+#include "base/base_typedefs.h"
+#include "base/base_macros.h"
+#include "base/base_assert.h"
+#include "std/std_includes.h"
+#include "std/std_memset.h"
+#include "std/std_basic_math.h"
+#include "std/std_printf.h"
+#include "mem/mem_arena.h"
+#include "struct/struct_string.h"
+
+#define STRING_BUILDER_DEFAULT_BUFFER_SIZE 256 //bytes
+#define STRING_BUILDER_MIN_ALLOC_SIZE      64 //bytes
+
+typedef plex StringBuilder StringBuilder;
+plex StringBuilder
+{
+	Arena* arena;
+	bool usingInitialBuffer; //chars points to the buffer given to InitStrBuilderWithBuffer, not an allocation from arena
+	uxx allocLength; //always includes space for the null-terminator
+	car
+	{
+		Str8 str;
+		plex
+		{
+			uxx length;
+			car { char* chars; u8* bytes; void* pntr; };
+		};
+	};
+};
+
+// +--------------------------------------------------------------+
+// |                 Header Function Declarations                 |
+// +--------------------------------------------------------------+
+#if !PIG_CORE_IMPLEMENTATION
+	PIG_CORE_INLINE void FreeStrBuilder(StringBuilder* builder);
+	PIG_CORE_INLINE void InitStrBuilderWithBuffer(StringBuilder* builderOut, Arena* arena, uxx bufferSize, void* bufferPntr);
+	PIG_CORE_INLINE void InitStrBuilder(StringBuilder* builderOut, Arena* arena, uxx initialCapacity);
+	void StrBuilderReserve(StringBuilder* builder, uxx numBytes);
+	PIG_CORE_INLINE void ClearStrBuilder(StringBuilder* builder);
+	PIG_CORE_INLINE void StrBuilderAppendStr(StringBuilder* builder, Str8 str);
+	PIG_CORE_INLINE void StrBuilderAppendChar(StringBuilder* builder, char character);
+	void StrBuilderAppendPrintVa(StringBuilder* builder, const char* formatString, va_list args);
+	void StrBuilderAppendPrint(StringBuilder* builder, const char* formatString, ...);
+	PIG_CORE_INLINE void StrBuilderInsertStr(StringBuilder* builder, uxx index, Str8 str);
+	PIG_CORE_INLINE void StrBuilderRemove(StringBuilder* builder, uxx index, uxx numBytes);
+	Str8 TakeStrBuilderStr(StringBuilder* builder);
+#endif
+
+#define NewStrBuilderEx(variableName, arenaPntr, bufferSize) u8 variableName##_buffer[bufferSize]; StringBuilder variableName; do \
+{                                                                                                                                   \
+	InitStrBuilderWithBuffer(&variableName, (arenaPntr), bufferSize, &variableName##_buffer[0]);                                    \
+} while(0)
+#define NewStrBuilder(variableName, arenaPntr) NewStrBuilderEx(variableName, (arenaPntr), STRING_BUILDER_DEFAULT_BUFFER_SIZE)
+
+#define StrBuilderAppend(builderPntr, nullTermStr) StrBuilderAppendStr((builderPntr), StrLit(nullTermStr))
+#define StrBuilderInsert(builderPntr, index, nullTermStr) StrBuilderInsertStr((builderPntr), (index), StrLit(nullTermStr))
+
+// +--------------------------------------------------------------+
+// |                   Function Implementations                   |
+// +--------------------------------------------------------------+
+#if PIG_CORE_IMPLEMENTATION
+
+PEXPI void FreeStrBuilder(StringBuilder* builder)
+{
+	NotNull(builder);
+	if (builder->arena != nullptr && !builder->usingInitialBuffer && builder->chars != nullptr)
+	{
+		FreeMem(builder->arena, builder->chars, builder->allocLength);
+	}
+	ClearPointer(builder);
+}
+
+PEXPI void InitStrBuilderWithBuffer(StringBuilder* builderOut, Arena* arena, uxx bufferSize, void* bufferPntr)
+{
+	NotNull(builderOut);
+	NotNull(arena);
+	Assert(bufferPntr != nullptr || bufferSize == 0);
+	ClearPointer(builderOut);
+	builderOut->arena = arena;
+	if (bufferSize > 0)
+	{
+		builderOut->usingInitialBuffer = true;
+		builderOut->allocLength = bufferSize;
+		builderOut->pntr = bufferPntr;
+		builderOut->chars[0] = '\0';
+	}
+}
+
+//Makes sure there is space for numBytes more characters (plus the null-terminator) after the current length
+PEXP void StrBuilderReserve(StringBuilder* builder, uxx numBytes)
+{
+	NotNull(builder);
+	NotNull(builder->arena);
+	uxx neededLength = builder->length + numBytes + 1;
+	if (neededLength <= builder->allocLength) { return; }
+	
+	uxx newAllocLength = MaxUXX(builder->allocLength, STRING_BUILDER_MIN_ALLOC_SIZE);
+	while (newAllocLength < neededLength) { newAllocLength *= 2; }
+	
+	if (builder->usingInitialBuffer || builder->chars == nullptr)
+	{
+		char* newChars = (char*)AllocMem(builder->arena, newAllocLength);
+		NotNull(newChars);
+		if (builder->chars != nullptr) { MyMemCopy(newChars, builder->chars, builder->length); }
+		builder->chars = newChars;
+		builder->usingInitialBuffer = false;
+	}
+	else
+	{
+		builder->chars = (char*)ReallocMem(builder->arena, builder->chars, builder->allocLength, newAllocLength);
+		NotNull(builder->chars);
+	}
+	builder->allocLength = newAllocLength;
+	builder->chars[builder->length] = '\0';
+}
+
+PEXPI void InitStrBuilder(StringBuilder* builderOut, Arena* arena, uxx initialCapacity)
+{
+	InitStrBuilderWithBuffer(builderOut, arena, 0, nullptr);
+	if (initialCapacity > 0) { StrBuilderReserve(builderOut, initialCapacity); }
+}
+
+PEXPI void ClearStrBuilder(StringBuilder* builder)
+{
+	NotNull(builder);
+	builder->length = 0;
+	if (builder->chars != nullptr) { builder->chars[0] = '\0'; }
+}
+
+PEXPI void StrBuilderAppendStr(StringBuilder* builder, Str8 str)
+{
+	NotNull(builder);
+	NotNullStr(str);
+	if (str.length == 0) { return; }
+	StrBuilderReserve(builder, str.length);
+	MyMemCopy(&builder->chars[builder->length], str.chars, str.length);
+	builder->length += str.length;
+	builder->chars[builder->length] = '\0';
+}
+PEXPI void StrBuilderAppendChar(StringBuilder* builder, char character)
+{
+	NotNull(builder);
+	StrBuilderReserve(builder, 1);
+	builder->chars[builder->length] = character;
+	builder->length++;
+	builder->chars[builder->length] = '\0';
+}
+
+PEXP void StrBuilderAppendPrintVa(StringBuilder* builder, const char* formatString, va_list args)
+{
+	NotNull(builder);
+	NotNull(formatString);
+	//We need to keep a copy of args around in case the first attempt doesn't fit and we need to format a second time
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	uxx spaceLeft = (builder->allocLength > builder->length) ? (builder->allocLength - builder->length) : 0; //includes space for null-terminator
+	int printResult = MyVaListPrintf((spaceLeft > 0) ? &builder->chars[builder->length] : nullptr, spaceLeft, formatString, args);
+	Assert(printResult >= 0);
+	if ((uxx)printResult >= spaceLeft)
+	{
+		StrBuilderReserve(builder, (uxx)printResult);
+		int secondPrintResult = MyVaListPrintf(&builder->chars[builder->length], (uxx)printResult + 1, formatString, argsCopy);
+		Assert(secondPrintResult == printResult);
+	}
+	va_end(argsCopy);
+	builder->length += (uxx)printResult;
+	builder->chars[builder->length] = '\0';
+}
+PEXP void StrBuilderAppendPrint(StringBuilder* builder, const char* formatString, ...)
+{
+	va_list args;
+	va_start(args, formatString);
+	StrBuilderAppendPrintVa(builder, formatString, args);
+	va_end(args);
+}
+
+PEXPI void StrBuilderInsertStr(StringBuilder* builder, uxx index, Str8 str)
+{
+	NotNull(builder);
+	NotNullStr(str);
+	Assert(index <= builder->length);
+	if (str.length == 0) { return; }
+	StrBuilderReserve(builder, str.length);
+	if (index < builder->length) { MyMemMove(&builder->chars[index + str.length], &builder->chars[index], builder->length - index); }
+	MyMemCopy(&builder->chars[index], str.chars, str.length);
+	builder->length += str.length;
+	builder->chars[builder->length] = '\0';
+}
+
+PEXPI void StrBuilderRemove(StringBuilder* builder, uxx index, uxx numBytes)
+{
+	NotNull(builder);
+	Assert(index + numBytes <= builder->length);
+	if (numBytes == 0) { return; }
+	if (index + numBytes < builder->length) { MyMemMove(&builder->chars[index], &builder->chars[index + numBytes], builder->length - (index + numBytes)); }
+	builder->length -= numBytes;
+	builder->chars[builder->length] = '\0';
+}
+
+//Returns a null-terminated Str8 allocated from the builder's arena (with exactly length+1 bytes) and resets the builder to empty.
+//The result can be freed with FreeStr8WithNt
+PEXP Str8 TakeStrBuilderStr(StringBuilder* builder)
+{
+	NotNull(builder);
+	NotNull(builder->arena);
+	Str8 result = Str8_Empty;
+	if (builder->usingInitialBuffer || builder->chars == nullptr)
+	{
+		result.chars = (char*)AllocMem(builder->arena, builder->length + 1);
+		NotNull(result.chars);
+		if (builder->length > 0) { MyMemCopy(result.chars, builder->chars, builder->length); }
+		result.length = builder->length;
+		result.chars[result.length] = '\0';
+		ClearStrBuilder(builder);
+	}
+	else
+	{
+		result.length = builder->length;
+		result.chars = (char*)ReallocMem(builder->arena, builder->chars, builder->allocLength, builder->length + 1);
+		NotNull(result.chars);
+		builder->chars = nullptr;
+		builder->length = 0;
+		builder->allocLength = 0;
+	}
+	return result;
+}
+
+#endif //PIG_CORE_IMPLEMENTATION
+
+#endif //  _STRUCT_STRING_BUILDER_H
@@ -283,6 +283,96 @@ static void PrintRichStr(RichStr richStr)
 	}
 }
 
+#if TARGET_HAS_THREADING
+#define TESTS_FILE_AT_NUM_THREADS 8
+#define TESTS_FILE_AT_NUM_BLOCKS  64
+#define TESTS_FILE_AT_BLOCK_SIZE  Kilobytes(4)
+// Fills every TESTS_FILE_AT_NUM_THREADS'th block of the file (starting at subject.index) with that block's index
+static THREAD_POOL_WORK_ITEM_FUNC_DEF(TestsFileAtWorkItem)
+{
+	UNUSED(thread);
+	OsFile* file = (OsFile*)workItem->subject.pntr;
+	u8 blockBytes[TESTS_FILE_AT_BLOCK_SIZE];
+	for (uxx bIndex = workItem->subject.index; bIndex < TESTS_FILE_AT_NUM_BLOCKS; bIndex += TESTS_FILE_AT_NUM_THREADS)
+	{
+		MyMemSet(&blockBytes[0], (u8)bIndex, TESTS_FILE_AT_BLOCK_SIZE);
+		Result writeResult = OsWriteToOpenFileAt(file, (u64)(bIndex * TESTS_FILE_AT_BLOCK_SIZE), MakeSlice(TESTS_FILE_AT_BLOCK_SIZE, &blockBytes[0]));
+		if (writeResult != Result_Success) { return writeResult; }
+	}
+	return Result_Success;
+}
+#endif //TARGET_HAS_THREADING
+
+#define TESTS_STREAM_MAGIC       0x4D525453 //"STRM"
+#define TESTS_STREAM_NUM_RECORDS 40
+#define TESTS_STREAM_BIG_RECORD  20 //this one is bigger than both the write buffer and the read-ahead buffer
+static u8 GetTestsStreamByte(uxx recordIndex, uxx byteIndex) { return (u8)(recordIndex*7 + byteIndex); }
+// Reads back the records written in the "Data Stream Tests" block, taking turns between reading, skipping and reading into a buffer
+static void TestsReadDataStreamRecords(DataStream* stream, const u32* recordLengths, Arena* arena)
+{
+	bool canPeek = (IsDataStreamMemoryBacked(stream) || stream->readAhead != nullptr);
+	if (canPeek)
+	{
+		u8* peekedHeader = PeekDataStream(stream, sizeof(u32)*2);
+		Assert(peekedHeader != nullptr && stream->cursor == 0);
+		u32 peekedMagic = 0;
+		MyMemCopy(&peekedMagic, peekedHeader, sizeof(u32));
+		Assert(peekedMagic == TESTS_STREAM_MAGIC);
+	}
+	u32* header = (u32*)TryReadFromDataStream(stream, sizeof(u32)*2, arena);
+	Assert(header != nullptr && header[0] == TESTS_STREAM_MAGIC && header[1] == TESTS_STREAM_NUM_RECORDS);
+	
+	for (uxx rIndex = 0; rIndex < TESTS_STREAM_NUM_RECORDS; rIndex++)
+	{
+		uxx recordStart = stream->cursor;
+		if (canPeek)
+		{
+			u8* peekedLength = PeekDataStream(stream, sizeof(u32));
+			Assert(peekedLength != nullptr && stream->cursor == recordStart && MyMemEquals(peekedLength, &recordLengths[rIndex], sizeof(u32)));
+		}
+		u32* lengthPntr = (u32*)TryReadFromDataStream(stream, sizeof(u32), arena);
+		Assert(lengthPntr != nullptr && *lengthPntr == recordLengths[rIndex]);
+		uxx recordLength = (uxx)recordLengths[rIndex];
+		if ((rIndex % 3) == 0)
+		{
+			u8* payload = TryReadFromDataStream(stream, recordLength, arena);
+			Assert(payload != nullptr);
+			for (uxx bIndex = 0; bIndex < recordLength; bIndex++) { Assert(payload[bIndex] == GetTestsStreamByte(rIndex, bIndex)); }
+		}
+		else if ((rIndex % 3) == 1)
+		{
+			Assert(SkipDataStream(stream, recordLength));
+		}
+		else
+		{
+			u8 chunk[50];
+			uxx numBytesLeft = recordLength;
+			while (numBytesLeft > 0)
+			{
+				uxx numBytesRead = 0;
+				Assert(ReadFromDataStreamInto(stream, MinUXX(numBytesLeft, ArrayCount(chunk)), &chunk[0], &numBytesRead) == Result_Success && numBytesRead > 0);
+				for (uxx bIndex = 0; bIndex < numBytesRead; bIndex++) { Assert(chunk[bIndex] == GetTestsStreamByte(rIndex, recordLength - numBytesLeft + bIndex)); }
+				numBytesLeft -= numBytesRead;
+			}
+		}
+		Assert(stream->cursor == recordStart + sizeof(u32) + recordLength);
+	}
+	Assert(stream->error == Result_None);
+	
+	//Streams with an unknown size only find out they're finished when a read comes back empty
+	bool knewSize = (stream->size != UINTXX_MAX);
+	Assert(IsDataStreamFinished(stream) == knewSize);
+	if (canPeek) { Assert(PeekDataStream(stream, 1) == nullptr); }
+	u8 extraByte = 0;
+	uxx numExtraBytes = 0;
+	Result extraResult = ReadFromDataStreamInto(stream, 1, &extraByte, &numExtraBytes);
+	Assert((extraResult == Result_EndOfFile || extraResult == Result_EndOfBuffer) && numExtraBytes == 0);
+	Assert(IsDataStreamFinished(stream));
+}
+
+#define TESTS_PB_STREAM_NUM_MESSAGES 24
+#define TESTS_PB_STREAM_BIG_MESSAGE  9 //bigger than PB_STREAM_PACKER_FILE_BUFFER_SIZE and the PbStreamReader's starting buffer
+
 static void EarlyInit()
 {
 	static bool isEarlyInitialized = false;
@@ -791,6 +881,30 @@ int main(int argc, char* argv[])
 	}
 	#endif
 	
+	// +==============================+
+	// |     StringBuilder Tests      |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		NewStrBuilderEx(builder, scratch, 32);
+		StrBuilderAppend(&builder, "Hello StringBuilder!");
+		PrintLine_D("builder = [%llu/%llu]%s \"%.*s\"", (u64)builder.length, (u64)builder.allocLength, builder.usingInitialBuffer ? " (initial buffer)" : "", StrPrint(builder.str));
+		for (uxx lIndex = 0; lIndex < 10; lIndex++) { StrBuilderAppendPrint(&builder, " [Line %llu is %s]", (u64)lIndex, (lIndex%2) ? "odd" : "even"); }
+		StrBuilderInsert(&builder, 5, ",");
+		StrBuilderRemove(&builder, 0, 1);
+		StrBuilderInsert(&builder, 0, "h");
+		PrintLine_D("builder = [%llu/%llu]%s \"%.*s\"%s", (u64)builder.length, (u64)builder.allocLength, builder.usingInitialBuffer ? " (initial buffer)" : "", StrPrint(builder.str), builder.chars[builder.length] == '\0' ? "" : " (NOT NULL-TERMINATED!)");
+		uxx scratchMarkBefore = ArenaGetMark(scratch);
+		for (uxx lIndex = 0; lIndex < 1000; lIndex++) { StrBuilderAppendPrint(&builder, "%llu,", (u64)lIndex); }
+		PrintLine_D("After 1000 appends: length=%llu allocLength=%llu scratch grew by %llu", (u64)builder.length, (u64)builder.allocLength, (u64)(ArenaGetMark(scratch) - scratchMarkBefore));
+		Str8 result = TakeStrBuilderStr(&builder);
+		PrintLine_D("result.length=%llu builder.length=%llu", (u64)result.length, (u64)builder.length);
+		FreeStrBuilder(&builder);
+		ScratchEnd(scratch);
+	}
+	#endif
+	
 	// +==============================+
 	// |        RichStr Tests         |
 	// +==============================+
@@ -917,6 +1031,62 @@ int main(int argc, char* argv[])
 		PrintLine_D("unknownCharIndex = %llu", (u64)unknownCharIndex);
 		uxx firstChar2 = FindNextCharInStrEx(haystack, 0, StrLit("amg"), true);
 		PrintLine_D("firstChar2 = %llu", (u64)firstChar2);
+		//Invalid bytes don't count as the previous codepoint, so the backslash before \xFF still escapes the quote after it
+		Assert(FindNextCharInStrEx(StrLit("\"\\\xFF\" b\" b"), 0, StrLit("b"), true) == 8);
+		
+		Str8 mixedStr = StrLit("ASCII prefix that is long enough to vectorize \xE6\xBC\xA2\xF0\x9F\xA7\xA9 and \xC3\xA9 suffix");
+		uxx invalidIndex = 0;
+		bool isValid = IsValidUtf8Str(mixedStr, &invalidIndex);
+		uxx numCodepoints = CountUtf8CodepointsInStr(mixedStr);
+		uxx puzzleByteIndex = GetUtf8ByteIndexForCodepointIndex(mixedStr.length, mixedStr.chars, 47);
+		PrintLine_D("mixedStr: valid=%s invalidIndex=%llu numBytes=%llu numCodepoints=%llu puzzleByteIndex=%llu multibyte=%s", isValid ? "true" : "false", (u64)invalidIndex, (u64)mixedStr.length, (u64)numCodepoints, (u64)puzzleByteIndex, DoesStrContainMultibyteUtf8Chars(mixedStr) ? "true" : "false");
+		Str16 mixedStr16 = ConvertUtf8StrToUcs2(scratch, mixedStr, true);
+		Str8 mixedStrRoundTrip = ConvertUcs2StrToUtf8(scratch, mixedStr16, false);
+		PrintLine_D("mixedStr16 = %llu words, round trip %s", (u64)mixedStr16.length, StrExactEquals(mixedStr, mixedStrRoundTrip) ? "matches" : "DOES NOT MATCH!");
+		
+		//Each of these is checked on its own (scalar path) and after a long ASCII prefix (the path after FindNextNonAsciiByte)
+		Str8 strictUtf8Prefix = StrLit("an ASCII prefix long enough to take the vectorized skip ");
+		Str8 validUtf8Edges[] = {
+			StrLit("\xC2\x80"), //U+0080, smallest 2-byte
+			StrLit("\xE0\xA0\x80"), //U+0800, smallest 3-byte
+			StrLit("\xED\x9F\xBF"), //U+D7FF, just below the surrogates
+			StrLit("\xEE\x80\x80"), //U+E000, just above the surrogates
+			StrLit("\xF0\x90\x80\x80"), //U+10000, smallest 4-byte
+			StrLit("\xF4\x8F\xBF\xBF"), //U+10FFFF, UTF8_MAX_CODEPOINT
+		};
+		Str8 invalidUtf8[] = {
+			StrLit("\xC0\x80"), //overlong U+0000
+			StrLit("\xC1\xB5"), //overlong 'u'
+			StrLit("\xE0\x9F\xBF"), //overlong U+07FF
+			StrLit("\xF0\x8F\xBF\xBF"), //overlong U+FFFF
+			StrLit("\xED\xA0\x80"), //U+D800, high surrogate
+			StrLit("\xED\xBF\xBF"), //U+DFFF, low surrogate
+			StrLit("\xF4\x90\x80\x80"), //U+110000
+			StrLit("\xF7\xBB\xBA\x82"), //U+1FBE82
+		};
+		for (uxx pIndex = 0; pIndex < 2; pIndex++)
+		{
+			Str8 prefix = (pIndex == 0) ? Str8_Empty : strictUtf8Prefix;
+			for (uxx eIndex = 0; eIndex < ArrayCount(validUtf8Edges); eIndex++)
+			{
+				Str8 validStr = JoinStringsInArena(scratch, prefix, validUtf8Edges[eIndex], false);
+				uxx validInvalidIndex = 0;
+				Assert(IsValidUtf8Str(validStr, &validInvalidIndex) && validInvalidIndex == validStr.length);
+				Assert(CountUtf8CodepointsInStr(validStr) == prefix.length + 1);
+				Assert(GetUtf8ByteIndexForCodepointIndex(validStr.length, validStr.chars, prefix.length) == prefix.length);
+				Str16 validStr16 = ConvertUtf8StrToUcs2(scratch, validStr, false);
+				Assert(StrExactEquals(ConvertUcs2StrToUtf8(scratch, validStr16, false), validStr));
+			}
+			for (uxx iIndex = 0; iIndex < ArrayCount(invalidUtf8); iIndex++)
+			{
+				Str8 invalidStr = JoinStringsInArena(scratch, prefix, invalidUtf8[iIndex], false);
+				uxx invalidStrIndex = 0;
+				Assert(!IsValidUtf8Str(invalidStr, &invalidStrIndex) && invalidStrIndex == prefix.length);
+				Assert(GetCodepointForUtf8Strict(invalidUtf8[iIndex].length, invalidUtf8[iIndex].chars, nullptr) == 0);
+				uxx numWords = 0;
+				Assert(!TranscodeUtf8ToUcs2(invalidStr.length, invalidStr.chars, 0, nullptr, &numWords) && numWords == prefix.length);
+			}
+		}
 		
 		// Str8 escapedString = Str8_Empty;
 		// Str8 escapedString = StrLit("\\\\\\");
@@ -931,6 +1101,162 @@ int main(int argc, char* argv[])
 	}
 	#endif
 	
+	// +==============================+
+	// |    String Escaping Tests     |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		StringBuilder builder;
+		InitStrBuilder(&builder, scratch, 8); //small so the StrBuilderAppend functions have to grow it
+		
+		//left is raw, right is escaped with EscapeSequence_All. The long ones go through the vectorized search
+		Str8Pair cEscapes[] = {
+			MakeStr8Pair(StrLit(""), StrLit("")),
+			MakeStr8Pair(StrLit("no escapes needed here, and long enough to vectorize"), StrLit("no escapes needed here, and long enough to vectorize")),
+			MakeStr8Pair(StrLit("\\-\"-\'-\n-\r-\t-\b-\a"), StrLit("\\\\-\\\"-\\\'-\\n-\\r-\\t-\\b-\\a")),
+			MakeStr8Pair(StrLit("trailing backslash\\"), StrLit("trailing backslash\\\\")),
+			MakeStr8Pair(StrLit("a clean run of more than sixteen bytes then a quote\" and a newline\n"), StrLit("a clean run of more than sixteen bytes then a quote\\\" and a newline\\n")),
+		};
+		for (uxx cIndex = 0; cIndex < ArrayCount(cEscapes); cIndex++)
+		{
+			Str8 rawStr = cEscapes[cIndex].left;
+			Str8 escapedStr = cEscapes[cIndex].right;
+			Assert(StrExactEquals(EscapeString(scratch, rawStr), escapedStr));
+			Assert(StrExactEquals(UnescapeString(scratch, escapedStr), rawStr));
+			ClearStrBuilder(&builder);
+			StrBuilderAppend(&builder, "[");
+			StrBuilderAppendEscaped(&builder, rawStr, EscapeSequence_All);
+			StrBuilderAppendUnescaped(&builder, escapedStr, EscapeSequence_All);
+			Assert(StrExactEquals(builder.str, JoinStringsInArena3(scratch, StrLit("["), escapedStr, rawStr, false)));
+		}
+		
+		//Invalid or disabled escape sequences (including a lone trailing backslash) are left as-is when unescaping
+		Assert(StrExactEquals(UnescapeString(scratch, StrLit("ends with\\")), StrLit("ends with\\")));
+		Assert(StrExactEquals(UnescapeString(scratch, StrLit("\\g\\x41\\\\")), StrLit("\\g\\x41\\")));
+		Assert(StrExactEquals(UnescapeStringEx(scratch, StrLit("\\r\\n"), EscapeSequence_NewLine, false), StrLit("\\r\n")));
+		Assert(StrExactEquals(EscapeStringEx(scratch, StrLit("\r\n\'"), EscapeSequence_Common, true), StrLit("\r\\n\\\'")));
+		ClearStrBuilder(&builder);
+		StrBuilderAppendUnescaped(&builder, StrLit("\\"), EscapeSequence_All);
+		Assert(StrExactEquals(builder.str, StrLit("\\")));
+		
+		//There's no UnescapeXmlString yet, so entities that are already in the input just get escaped again
+		Assert(StrExactEquals(EscapeXmlString(scratch, StrLit("<a href=\"x\">Tom & Jerry's</a>"), false), StrLit("&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&apos;s&lt;/a&gt;")));
+		Assert(StrExactEquals(EscapeXmlString(scratch, StrLit("&amp; &lt;"), false), StrLit("&amp;amp; &amp;lt;")));
+		ClearStrBuilder(&builder);
+		StrBuilderAppendEscapedXml(&builder, StrLit("plain text that is longer than sixteen bytes & more"));
+		Assert(StrExactEquals(builder.str, StrLit("plain text that is longer than sixteen bytes &amp; more")));
+		
+		//Every byte outside the unreserved set is percent-encoded, including a '%' that already looks like an escape and invalid UTF-8
+		Assert(StrExactEquals(EscapeStr_FormUrlEncoding(scratch, StrLit("a b&c=d/e~f_g.h-i"), false), StrLit("a+b%26c%3Dd%2Fe~f_g.h-i")));
+		Assert(StrExactEquals(EscapeStr_FormUrlEncoding(scratch, StrLit("%41%zz%"), false), StrLit("%2541%25zz%25")));
+		Assert(StrExactEquals(EscapeStr_FormUrlEncoding(scratch, StrLit("caf\xC3\xA9 \xFF"), false), StrLit("caf%C3%A9+%FF")));
+		ClearStrBuilder(&builder);
+		StrBuilderAppendFormUrlEncoded(&builder, StrLit("name=Tom & Jerry's long enough value"));
+		Assert(StrExactEquals(builder.str, EscapeStr_FormUrlEncoding(scratch, StrLit("name=Tom & Jerry's long enough value"), false)));
+		Assert(StrExactEquals(builder.str, StrLit("name%3DTom+%26+Jerry%27s+long+enough+value")));
+		
+		PrintLine_D("All %llu escaping round trips passed", (u64)ArrayCount(cEscapes));
+		ScratchEnd(scratch);
+	}
+	#endif
+	
+	// +==============================+
+	// |     String Search Tests      |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		
+		uxx haystackLength = Megabytes(64);
+		Str8 haystack = MakeStr8(haystackLength, (char*)AllocMem(scratch, haystackLength));
+		NotNull(haystack.chars);
+		const char* fillText = "the quick brown fox jumps over the lazy dog\tTHE QUICK BROWN FOX JUMPS OVER THE LAZY DOG\n";
+		uxx fillTextLength = MyStrLength(fillText);
+		for (uxx bIndex = 0; bIndex < haystackLength; bIndex++) { haystack.chars[bIndex] = fillText[bIndex % fillTextLength]; }
+		Str8 needle = StrLit("jumps over the lazy cat");
+		MyMemCopy(&haystack.chars[haystackLength - needle.length], needle.chars, needle.length);
+		
+		OsTime naiveStartTime = OsGetTime();
+		uxx naiveIndex = haystackLength;
+		for (uxx bIndex = 0; bIndex + needle.length <= haystackLength; bIndex++)
+		{
+			if (MyMemEquals(&haystack.chars[bIndex], needle.chars, needle.length)) { naiveIndex = bIndex; break; }
+		}
+		OsTime naiveEndTime = OsGetTime();
+		uxx exactIndex = StrExactFind(haystack, needle);
+		OsTime exactEndTime = OsGetTime();
+		uxx anyCaseIndex = StrAnyCaseFind(haystack, StrLit("JUMPS OVER THE LAZY CAT"));
+		OsTime anyCaseEndTime = OsGetTime();
+		uxx byteIndex = FindNextByteInStr(haystack, 0, StrLit("!?"));
+		OsTime byteEndTime = OsGetTime();
+		
+		r32 totalMegabytes = (r32)haystackLength / (r32)Megabytes(1);
+		PrintLine_D("Naive search:      %llu in %.1fms (%.0f MB/s)", (u64)naiveIndex, OsTimeDiffMsR32(naiveStartTime, naiveEndTime), totalMegabytes / (OsTimeDiffMsR32(naiveStartTime, naiveEndTime) / 1000.0f));
+		PrintLine_D("StrExactFind:      %llu in %.1fms (%.0f MB/s)", (u64)exactIndex, OsTimeDiffMsR32(naiveEndTime, exactEndTime), totalMegabytes / (OsTimeDiffMsR32(naiveEndTime, exactEndTime) / 1000.0f));
+		PrintLine_D("StrAnyCaseFind:    %llu in %.1fms (%.0f MB/s)", (u64)anyCaseIndex, OsTimeDiffMsR32(exactEndTime, anyCaseEndTime), totalMegabytes / (OsTimeDiffMsR32(exactEndTime, anyCaseEndTime) / 1000.0f));
+		PrintLine_D("FindNextByteInStr: %llu in %.1fms (%.0f MB/s)", (u64)byteIndex, OsTimeDiffMsR32(anyCaseEndTime, byteEndTime), totalMegabytes / (OsTimeDiffMsR32(anyCaseEndTime, byteEndTime) / 1000.0f));
+		
+		ScratchEnd(scratch);
+	}
+	#endif
+	
+	// +==============================+
+	// |   C Tokenizer Throughput     |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		
+		//Concatenate all of PigCore's headers (relative to the _build folder) into one big input string
+		const char* sourceFolders[] = { "../src/base", "../src/std", "../src/os", "../src/mem", "../src/struct", "../src/misc", "../src/parse", "../src/gfx", "../src/ui", "../src/input", "../src/phys", "../src/file_fmt", "../src/cross" };
+		StringBuilder allHeaders;
+		InitStrBuilder(&allHeaders, scratch, Megabytes(8));
+		for (uxx fIndex = 0; fIndex < ArrayCount(sourceFolders); fIndex++)
+		{
+			OsFileIter fileIter = OsIterateFiles(scratch, MakeStr8Nt(sourceFolders[fIndex]), true, false);
+			FilePath headerPath = Str8_Empty;
+			while (OsIterFileStep(&fileIter, &headerPath, scratch, true))
+			{
+				if (!StrExactEndsWith(headerPath, StrLit(".h"))) { continue; }
+				Str8 headerContents = Str8_Empty;
+				if (OsReadTextFile(headerPath, scratch, &headerContents)) { StrBuilderAppendStr(&allHeaders, headerContents); }
+			}
+		}
+		
+		const uxx numRepetitions = 20;
+		r32 totalMegabytes = (r32)(allHeaders.length * numRepetitions) / (r32)Megabytes(1);
+		PrintLine_D("Tokenizing %.1fMB of headers %llu times", (r32)allHeaders.length / (r32)Megabytes(1), (u64)numRepetitions);
+		
+		uxx numArenaTokens = 0;
+		OsTime arenaStartTime = OsGetTime();
+		for (uxx rIndex = 0; rIndex < numRepetitions; rIndex++)
+		{
+			cTokenizer tokenizer = NewCTokenizer(stdHeap, allHeaders.str);
+			while (NextCToken(&tokenizer) != nullptr) { numArenaTokens++; }
+			Assert(tokenizer.error == Result_Success);
+			FreeCTokenizer(&tokenizer);
+		}
+		OsTime arenaEndTime = OsGetTime();
+		
+		uxx numStreamTokens = 0;
+		for (uxx rIndex = 0; rIndex < numRepetitions; rIndex++)
+		{
+			cTokenizer tokenizer = NewCTokenizerStream(stdHeap, allHeaders.str);
+			cToken token = ZEROED;
+			while (NextCTokenStream(&tokenizer, &token)) { numStreamTokens++; }
+			Assert(tokenizer.error == Result_Success);
+			FreeCTokenizer(&tokenizer);
+		}
+		OsTime streamEndTime = OsGetTime();
+		
+		PrintLine_D("NextCToken:       %llu tokens in %.1fms (%.0f MB/s)", (u64)numArenaTokens, OsTimeDiffMsR32(arenaStartTime, arenaEndTime), totalMegabytes / (OsTimeDiffMsR32(arenaStartTime, arenaEndTime) / 1000.0f));
+		PrintLine_D("NextCTokenStream: %llu tokens in %.1fms (%.0f MB/s)", (u64)numStreamTokens, OsTimeDiffMsR32(arenaEndTime, streamEndTime), totalMegabytes / (OsTimeDiffMsR32(arenaEndTime, streamEndTime) / 1000.0f));
+		
+		ScratchEnd(scratch);
+	}
+	#endif
+	
 	// +==============================+
 	// |      Zip Archive Tests       |
 	// +==============================+
@@ -950,6 +1276,53 @@ int main(int argc, char* argv[])
 		Str8 fileName1 = GetZipArchiveFilePath(&archive, scratch, fileIndex);
 		Slice fileContents1 = ReadZipArchiveBinFileAtIndex(&archive, scratch, fileIndex);
 		PrintLine_I("\tFile[%llu] = \"%.*s\" %llu bytes: %02X %02X %02X %02X", (u64)fileIndex, StrPrint(fileName1), (u64)fileContents1.length, fileContents1.bytes[0], fileContents1.bytes[1], fileContents1.bytes[2], fileContents1.bytes[3]);
+		{
+			ZipArchive mappedArchive = ZEROED;
+			Result mappedResult = OpenZipArchivePathMapped(scratch, zipPath, &mappedArchive);
+			Assert(mappedResult == Result_Success);
+			ZipArchiveEntry entry = ZEROED;
+			Result entryResult = OpenZipArchiveEntry(&mappedArchive, fileIndex, &entry);
+			Assert(entryResult == Result_Success);
+			u8 entryChunk[333];
+			uxx entryCursor = 0;
+			uxx numBytesRead = 0;
+			while (ReadFromZipArchiveEntry(&entry, ArrayCount(entryChunk), &entryChunk[0], &numBytesRead) == Result_Success)
+			{
+				Assert(entryCursor + numBytesRead <= fileContents1.length);
+				Assert(MyMemEquals(&entryChunk[0], &fileContents1.bytes[entryCursor], numBytesRead));
+				entryCursor += numBytesRead;
+			}
+			Assert(entry.error == Result_None && entryCursor == fileContents1.length);
+			CloseZipArchiveEntry(&entry);
+			CloseZipArchive(&mappedArchive);
+		}
+		{
+			ZipArchiveBatchFile batchFiles[2] = ZEROED;
+			batchFiles[0].fileName = fileName1;
+			batchFiles[0].fileContents = fileContents1;
+			batchFiles[1].fileName = FilePathLit("notes.txt");
+			batchFiles[1].fileContents = StrLit("first line\nsecond line\n");
+			batchFiles[1].convertNewLines = true;
+			ZipArchive newArchive = ZEROED;
+			CreateZipArchive(scratch, &newArchive);
+			Result batchResult = AddZipArchiveFiles(&newArchive, ArrayCount(batchFiles), &batchFiles[0], MZ_BEST_SPEED, nullptr);
+			Assert(batchResult == Result_Success);
+			Slice newArchiveContents = Slice_Empty;
+			Result finishResult = FinishZipArchive(&newArchive, &newArchiveContents);
+			Assert(finishResult == Result_Success);
+			CloseZipArchive(&newArchive);
+			Slice reReadContents = OpenZipArchiveAndReadBinFile(scratch, newArchiveContents, fileName1);
+			Assert(reReadContents.length == fileContents1.length && MyMemEquals(reReadContents.bytes, fileContents1.bytes, fileContents1.length));
+			Str8 reReadText = OpenZipArchiveAndReadTextFile(scratch, newArchiveContents, FilePathLit("notes.txt"));
+			Assert(StrExactEquals(reReadText, batchFiles[1].fileContents));
+			ZipArchive reReadArchive = ZEROED;
+			Result reReadResult = OpenZipArchive(scratch, newArchiveContents, &reReadArchive);
+			Assert(reReadResult == Result_Success);
+			uxx notesIndex = 0;
+			Assert(FindZipArchiveFileNamedAnyCase(&reReadArchive, FilePathLit("NOTES.TXT"), &notesIndex) && notesIndex == 1);
+			Assert(FindZipArchiveFilesInFolder(&reReadArchive, nullptr, FilePath_Empty, true, nullptr) == 2);
+			CloseZipArchive(&reReadArchive);
+		}
 		#if BUILD_WITH_RAYLIB
 		ImageData zipImageData;
 		Result loadImageResult = TryParseImageFile(fileContents1, stdHeap, &zipImageData);
@@ -971,6 +1344,192 @@ int main(int argc, char* argv[])
 	}
 	#endif
 	
+	// +==============================+
+	// |    Positioned File Tests     |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		FilePath dataPath = FilePathLit("file_at_test.bin");
+		OsFile dataFile = ZEROED;
+		bool openedFile = OsOpenFile(scratch, dataPath, OsOpenFileMode_Write, false, &dataFile); //truncate anything left from a previous run
+		Assert(openedFile);
+		OsCloseFile(&dataFile);
+		openedFile = OsOpenFile(scratch, dataPath, OsOpenFileMode_ReadWrite, false, &dataFile);
+		Assert(openedFile);
+		
+		u64 fileSize = 0;
+		Result preallocateResult = OsPreallocateOpenFile(&dataFile, TESTS_FILE_AT_NUM_BLOCKS * TESTS_FILE_AT_BLOCK_SIZE);
+		Assert(preallocateResult == Result_Success || preallocateResult == Result_NotImplemented);
+		Assert(OsGetOpenFileSize(&dataFile, &fileSize) == Result_Success && fileSize == 0);
+		
+		ThreadPool pool = ZEROED;
+		InitThreadPool(stdHeap, StrLit("FileAtPool"), false, false, 0, &pool);
+		for (uxx tIndex = 0; tIndex < TESTS_FILE_AT_NUM_THREADS; tIndex++) { AddThreadToPool(&pool); }
+		for (uxx tIndex = 0; tIndex < TESTS_FILE_AT_NUM_THREADS; tIndex++)
+		{
+			WorkSubject subject = ZEROED;
+			subject.pntr = &dataFile;
+			subject.index = tIndex;
+			AddWorkItemToThreadPool(&pool, TestsFileAtWorkItem, &subject);
+		}
+		uxx numFinishedItems = 0;
+		while (numFinishedItems < TESTS_FILE_AT_NUM_THREADS)
+		{
+			ThreadPoolWorkItem* finishedItem = GetFinishedThreadPoolWorkItem(&pool);
+			if (finishedItem == nullptr) { OsSleepMs(1); continue; }
+			Assert(finishedItem->result == Result_Success);
+			FreeThreadPoolWorkItem(&pool, finishedItem);
+			numFinishedItems++;
+		}
+		FreeThreadPool(&pool);
+		
+		Assert(OsSyncOpenFile(&dataFile) == Result_Success);
+		Assert(OsGetOpenFileSize(&dataFile, &fileSize) == Result_Success && fileSize == TESTS_FILE_AT_NUM_BLOCKS * TESTS_FILE_AT_BLOCK_SIZE);
+		u8 readBuffer[TESTS_FILE_AT_BLOCK_SIZE];
+		uxx numBytesRead = 0;
+		for (uxx bIndex = TESTS_FILE_AT_NUM_BLOCKS; bIndex > 0; bIndex--) //read back in reverse to make sure nothing depends on the file cursor
+		{
+			u64 blockOffset = (u64)((bIndex-1) * TESTS_FILE_AT_BLOCK_SIZE);
+			Assert(OsReadFromOpenFileAt(&dataFile, blockOffset, TESTS_FILE_AT_BLOCK_SIZE, &readBuffer[0], &numBytesRead) == Result_Success);
+			Assert(numBytesRead == TESTS_FILE_AT_BLOCK_SIZE && readBuffer[0] == (u8)(bIndex-1) && readBuffer[TESTS_FILE_AT_BLOCK_SIZE-1] == (u8)(bIndex-1));
+		}
+		Assert(OsReadFromOpenFileAt(&dataFile, fileSize - 10, 100, &readBuffer[0], &numBytesRead) == Result_Partial && numBytesRead == 10);
+		Assert(OsReadFromOpenFileAt(&dataFile, fileSize + 10, 100, &readBuffer[0], &numBytesRead) == Result_EndOfFile && numBytesRead == 0);
+		OsCloseFile(&dataFile);
+		PrintLine_D("Wrote %llu blocks from %llu threads to \"%.*s\"", (u64)TESTS_FILE_AT_NUM_BLOCKS, (u64)TESTS_FILE_AT_NUM_THREADS, StrPrint(dataPath));
+		
+		FilePath savePath = FilePathLit("atomic_test.txt");
+		Assert(OsWriteTextFile(savePath, StrLit("old contents")));
+		#if (TARGET_IS_LINUX || TARGET_IS_OSX)
+		FilePath savePathNt = AllocFilePath(scratch, savePath, true);
+		chmod(savePathNt.chars, 0600);
+		#endif
+		Assert(OsWriteFileAtomic(savePath, StrLit("new contents"), true) == Result_Success);
+		Str8 savedContents = OsReadTextFileScratch(savePath);
+		Assert(StrExactEquals(savedContents, StrLit("new contents")));
+		#if (TARGET_IS_LINUX || TARGET_IS_OSX)
+		plex stat saveStat = ZEROED;
+		Assert(stat(savePathNt.chars, &saveStat) == 0 && (saveStat.st_mode & 0777) == 0600);
+		#endif
+		PrintLine_D("Atomically replaced \"%.*s\"", StrPrint(savePath));
+		ScratchEnd(scratch);
+	}
+	#endif
+	
+	// +==============================+
+	// |     Resource Pack Tests      |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		FilePath packPath = FilePathLit("res_pack_test.pack");
+		Str8 textContents = StrLit("This line compresses well. This line compresses well. This line compresses well. This line compresses well.\n");
+		Slice randomContents = MakeSlice(Kilobytes(5), (u8*)AllocMem(scratch, Kilobytes(5)));
+		for (uxx bIndex = 0; bIndex < randomContents.length; bIndex++) { randomContents.bytes[bIndex] = (u8)GetRandU32Range(mainRandom, 0, 256); }
+		
+		ResPackBuilder builder = ZEROED;
+		InitResPackBuilder(&builder, stdHeap, 0, MZ_DEFAULT_LEVEL);
+		Assert(AddResPackBuilderFile(&builder, StrLit("text/notes.txt"), textContents, ResPackCompression_Deflate) == Result_Success);
+		Assert(AddResPackBuilderFile(&builder, StrLit("data/random.bin"), randomContents, ResPackCompression_Deflate) == Result_Success); //doesn't get smaller so it falls back to Store
+		Assert(AddResPackBuilderFile(&builder, StrLit("data/stored.txt"), textContents, ResPackCompression_Store) == Result_Success);
+		Assert(AddResPackBuilderFile(&builder, StrLit("empty.txt"), Str8_Empty, ResPackCompression_Deflate) == Result_Success);
+		Assert(builder.totalStoredSize < builder.totalSize);
+		Assert(WriteResPack(&builder, packPath) == Result_Success);
+		FreeResPackBuilder(&builder);
+		
+		ResPack pack = ZEROED;
+		Result openResult = OpenResPackPath(packPath, &pack);
+		Assert(openResult == Result_Success && pack.numEntries == 4);
+		Slice readContents = Slice_Empty;
+		Assert(ReadResPackFile(&pack, StrLit("text/notes.txt"), scratch, &readContents) == Result_Success);
+		Assert(StrExactEquals(readContents, textContents));
+		Assert(ReadResPackFile(&pack, StrLit("data/random.bin"), scratch, &readContents) == Result_Success);
+		Assert(readContents.length == randomContents.length && MyMemEquals(readContents.bytes, randomContents.bytes, randomContents.length));
+		Assert(IsAlignedTo(readContents.bytes, RES_PACK_DEFAULT_ALIGNMENT)); //stored entries point straight into the mapping
+		Assert(ReadResPackFile(&pack, StrLit("data/stored.txt"), nullptr, &readContents) == Result_Success);
+		Assert(StrExactEquals(readContents, textContents));
+		Assert(ReadResPackFile(&pack, StrLit("empty.txt"), scratch, &readContents) == Result_Success && readContents.length == 0);
+		Assert(ReadResPackFile(&pack, StrLit("Text/Notes.txt"), scratch, &readContents) == Result_FileNotFound);
+		for (uxx eIndex = 0; eIndex < pack.numEntries; eIndex++) { Assert(VerifyResPackEntry(&pack, eIndex)); }
+		PrintLine_D("\"%.*s\" has %llu entries, %llu bytes", StrPrint(packPath), (u64)pack.numEntries, (u64)pack.contents.length);
+		CloseResPack(&pack);
+		
+		ResPackBuilder duplicateBuilder = ZEROED;
+		InitResPackBuilder(&duplicateBuilder, stdHeap, 0, MZ_DEFAULT_LEVEL);
+		Assert(AddResPackBuilderFile(&duplicateBuilder, StrLit("empty.txt"), Str8_Empty, ResPackCompression_Store) == Result_Success);
+		Assert(AddResPackBuilderFile(&duplicateBuilder, StrLit("empty.txt"), textContents, ResPackCompression_Store) == Result_Success);
+		Assert(WriteResPack(&duplicateBuilder, FilePathLit("res_pack_duplicate.pack")) == Result_Duplicate);
+		FreeResPackBuilder(&duplicateBuilder);
+		ScratchEnd(scratch);
+	}
+	#endif
+	
+	// +==============================+
+	// |      Data Stream Tests       |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		FilePath streamPath = FilePathLit("data_stream_test.bin");
+		u32 recordLengths[TESTS_STREAM_NUM_RECORDS];
+		uxx totalSize = sizeof(u32)*2;
+		for (uxx rIndex = 0; rIndex < TESTS_STREAM_NUM_RECORDS; rIndex++)
+		{
+			recordLengths[rIndex] = (rIndex == TESTS_STREAM_BIG_RECORD) ? 2000 : GetRandU32Range(mainRandom, 1, 300);
+			totalSize += sizeof(u32) + recordLengths[rIndex];
+		}
+		
+		OsFile streamFile = ZEROED;
+		Assert(OsOpenFile(scratch, streamPath, OsOpenFileMode_Write, false, &streamFile));
+		DataStreamWriter writers[2];
+		writers[0] = ToDataStreamWriterFromBuffer(MakeSlice(totalSize, (u8*)AllocMem(scratch, totalSize)));
+		writers[1] = ToDataStreamWriterFromFile(&streamFile, stdHeap, 256);
+		for (uxx wIndex = 0; wIndex < ArrayCount(writers); wIndex++)
+		{
+			DataStreamWriter* writer = &writers[wIndex];
+			u8* headerBytes = ReserveDataStreamWriterBytes(writer, sizeof(u32)*2);
+			Assert(headerBytes != nullptr);
+			u32 header[2] = { TESTS_STREAM_MAGIC, TESTS_STREAM_NUM_RECORDS };
+			MyMemCopy(headerBytes, &header[0], sizeof(header));
+			for (uxx rIndex = 0; rIndex < TESTS_STREAM_NUM_RECORDS; rIndex++)
+			{
+				Assert(WriteToDataStream(writer, sizeof(u32), &recordLengths[rIndex]));
+				u8* payload = nullptr;
+				if ((rIndex % 2) == 0 && recordLengths[rIndex] <= 256) { payload = ReserveDataStreamWriterBytes(writer, recordLengths[rIndex]); }
+				else { payload = (u8*)AllocMem(scratch, recordLengths[rIndex]); }
+				Assert(payload != nullptr);
+				for (uxx bIndex = 0; bIndex < recordLengths[rIndex]; bIndex++) { payload[bIndex] = GetTestsStreamByte(rIndex, bIndex); }
+				if ((rIndex % 2) != 0 || recordLengths[rIndex] > 256) { Assert(WriteToDataStream(writer, recordLengths[rIndex], payload)); }
+			}
+			Assert(FlushDataStreamWriter(writer));
+			Assert(writer->cursor == totalSize && writer->error == Result_None);
+		}
+		Assert(WriteStrToDataStream(&writers[0], StrLit("!")) == false && writers[0].error == Result_EndOfBuffer);
+		Assert(ReserveDataStreamWriterBytes(&writers[0], 1) == nullptr);
+		Assert(ReserveDataStreamWriterBytes(&writers[1], 257) == nullptr && writers[1].error == Result_TooLong);
+		FreeDataStreamWriter(&writers[1]);
+		OsCloseFile(&streamFile);
+		
+		DataStream bufferStream = ToDataStreamFromBuffer(writers[0].buffer);
+		TestsReadDataStreamRecords(&bufferStream, &recordLengths[0], scratch);
+		for (uxx sIndex = 0; sIndex < 4; sIndex++)
+		{
+			bool knownSize = ((sIndex % 2) == 0);
+			bool buffered = (sIndex < 2);
+			Assert(OsOpenFile(scratch, streamPath, OsOpenFileMode_Read, knownSize, &streamFile));
+			DataStream fileStream = buffered ? ToDataStreamFromFileBuffered(&streamFile, stdHeap, 64) : ToDataStreamFromFile(&streamFile);
+			Assert((fileStream.size == totalSize) == knownSize);
+			TestsReadDataStreamRecords(&fileStream, &recordLengths[0], scratch);
+			Assert(fileStream.size == totalSize);
+			FreeDataStream(&fileStream);
+			OsCloseFile(&streamFile);
+		}
+		PrintLine_D("Read %llu records (%llu bytes) back from a buffer and 4 kinds of file stream", (u64)TESTS_STREAM_NUM_RECORDS, (u64)totalSize);
+		ScratchEnd(scratch);
+	}
+	#endif
+	
 	// +==============================+
 	// |     Simple Parsers Tests     |
 	// +==============================+
@@ -1014,7 +1573,7 @@ int main(int argc, char* argv[])
 		RegexResult result = StrRegexFind(targetStr, StrLit("([^e]+)\\s+([Worl]+)"), true);
 		if (result.result == Result_Success)
 		{
-			PrintLine_D("Regex Matches, %llu capture%s (ending at %llu)", result.numCaptures, Plural(result.numCaptures, "s"), (u64)result.matchEndIndex);
+			PrintLine_D("Regex Matches, %llu capture%s (from %llu to %llu)", result.numCaptures, Plural(result.numCaptures, "s"), (u64)result.matchBeginIndex, (u64)result.matchEndIndex);
 			for (uxx cIndex = 0; cIndex < result.numCaptures; cIndex++)
 			{
 				PrintLine_D("\tCapture[%llu]: %llu \"%.*s\" (at index %llu)", cIndex, (uxx)result.captures[cIndex].length, StrPrint(result.captures[cIndex]), (u64)result.captureIndices[cIndex]);
@@ -1024,6 +1583,21 @@ int main(int argc, char* argv[])
 		{
 			PrintLine_D("Regex did not match: %s", GetResultStr(result.result));
 		}
+		
+		Str8 logStr = StrLit("[12] opened file\n[13] ERROR code=404 in \"index.html\"\n[14] closed file\n[15] error CODE=500\n");
+		Regex regex = ZEROED;
+		Result compileResult = CompileRegex(stdHeap, StrLit("(?i)error code=(\\d+)"), true, &regex);
+		if (compileResult == Result_Success)
+		{
+			RegexFindIter iter = NewRegexFindIter(&regex, logStr);
+			RegexResult match = ZEROED;
+			while (RegexFindNext(&iter, &match))
+			{
+				PrintLine_D("Found \"%.*s\" at %llu (code %.*s)", StrPrint(match.match), (u64)match.matchBeginIndex, StrPrint(match.captures[0]));
+			}
+			FreeRegex(&regex);
+		}
+		else { PrintLine_E("Failed to compile regex: %s", GetResultStr(compileResult)); }
 	}
 	#endif
 	
@@ -1035,6 +1609,31 @@ int main(int argc, char* argv[])
 	// MTLCreateSystemDefaultDevice();
 	// #endif
 	
+	// +==============================+
+	// |       PieceTable Tests       |
+	// +==============================+
+	#if 0
+	{
+		ScratchBegin(scratch);
+		PieceTable table;
+		InitPieceTable(stdHeap, StrLit("First line\nSecond line\nThird \xE6\xBC\xA2 line"), &table);
+		PieceTableInsert(&table, 6, StrLit("(inserted) "));
+		PieceTableInsert(&table, 6 + 11, StrLit("more "));
+		PieceTableRemove(&table, 0, 6);
+		PieceTableReplace(&table, GetPieceTableLineStart(&table, 1), 6, StrLit("2nd"));
+		PrintLine_D("table = %llu bytes, %llu codepoints, %llu lines, %llu node%s", (u64)GetPieceTableLength(&table), (u64)GetPieceTableNumCodepoints(&table), (u64)GetPieceTableNumLines(&table), (u64)table.numNodes, Plural(table.numNodes, "s"));
+		for (uxx lIndex = 0; lIndex < GetPieceTableNumLines(&table); lIndex++)
+		{
+			Str8 line = GetPieceTableLine(scratch, &table, lIndex, false);
+			PrintLine_D("Line[%llu] @%llu: \"%.*s\"", (u64)lIndex, (u64)GetPieceTableLineStart(&table, lIndex), StrPrint(line));
+		}
+		uxx kanjiIndex = GetPieceTableIndexForCodepoint(&table, GetPieceTableNumCodepoints(&table) - 6);
+		PrintLine_D("kanji is at byte %llu (codepoint %llu)", (u64)kanjiIndex, (u64)GetPieceTableCodepointIndex(&table, kanjiIndex));
+		FreePieceTable(&table);
+		ScratchEnd(scratch);
+	}
+	#endif
+	
 	// +==============================+
 	// |        VarArray Tests        |
 	// +==============================+
@@ -1187,6 +1786,17 @@ int main(int argc, char* argv[])
 		}
 		PrintLine_D("There are %llu file%s in \"%.*s\"", fIndex, Plural(fIndex, "s"), StrPrint(path));
 		
+		#if TARGET_HAS_THREADING
+		OsDirWalk dirWalk = ZEROED;
+		Result walkResult = OsWalkDirectory(scratch, path, 2, nullptr, nullptr, nullptr, &dirWalk);
+		PrintLine_D("OsWalkDirectory(path, maxDepth=2): %s (%llu file%s, %llu folder%s)", GetResultStr(walkResult), dirWalk.numFiles, Plural(dirWalk.numFiles, "s"), dirWalk.numFolders, Plural(dirWalk.numFolders, "s"));
+		OsDirWalkLoop(&dirWalk, walkEntry)
+		{
+			if (!walkEntry->isFolder) { PrintLine_D("\t\"%.*s\" (%llu bytes)", StrPrint(walkEntry->path), walkEntry->size); }
+		}
+		FreeOsDirWalk(&dirWalk);
+		#endif
+		
 		Str8 fileContents = Str8_Empty;
 		if (OsReadFile(path, scratch, true, &fileContents))
 		{
@@ -1198,6 +1808,17 @@ int main(int argc, char* argv[])
 			FreeStr8WithNt(scratch, &fileContents);
 		}
 		
+		OsMappedFile mappedFile = ZEROED;
+		Result mapResult = OsMapFile(path, OsMapFileAccess_Sequential, &mappedFile);
+		PrintLine_D("OsMapFile(path): %s (%llu bytes)", GetResultStr(mapResult), mappedFile.size);
+		if (mapResult == Result_Success)
+		{
+			u64 numNewLines = 0;
+			for (uxx bIndex = 0; bIndex < mappedFile.contents.length; bIndex++) { if (mappedFile.contents.bytes[bIndex] == '\n') { numNewLines++; } }
+			PrintLine_D("Mapped file has %llu new-line%s", numNewLines, Plural(numNewLines, "s"));
+			OsUnmapFile(&mappedFile);
+		}
+		
 		// bool writeSuccess = OsWriteTextFile(path, StrLit("Hello, we have replaced the file contents with\ngarbage!\n\n:)"));
 		// PrintLine_D("OsWriteTextFile(...): %s", writeSuccess ? "Success" : "Failure");
 		
@@ -1352,8 +1973,102 @@ int main(int argc, char* argv[])
 			// PrintLine_D("Before %llu bytes -> After %llu bytes", arenaUsageBefore, arenaPntr->used);
 		}
 		
+		PbStreamPacker packer;
+		InitPbStreamPackerInArena(&packer, scratch, 0);
+		for (uxx mIndex = 0; mIndex < 3; mIndex++) { ProtobufStreamPack(proto_file_header, &packer, &fileHeader); }
+		Slice streamSlice = GetPbStreamPackerSlice(&packer);
+		PrintLine_D("Stream packed %llu messages in %llu bytes", packer.numMessages, streamSlice.length);
+		Assert(streamSlice.length == 3 * (1 + packedSlice.length)); //fileHeader packs to less than 128 bytes so each length prefix is 1 byte
+		ProtoFileHeader* aliasedHeader = ProtobufUnpackInArenaAliased(ProtoFileHeader, proto_file_header, scratch, MakeSlice(packedSlice.length, streamSlice.bytes + 1));
+		Assert(aliasedHeader != nullptr && aliasedHeader->new_field == fileHeader.new_field);
+		//NOTE: No FreePbStreamPacker here, aliasedHeader points into the packer's buffer and was allocated after it, so ScratchEnd releases both
+		
+		ScratchEnd(scratch);
+	}
+	#endif
+	
+	// +==============================+
+	// |    Protobuf Stream Tests     |
+	// +==============================+
+	#if 0
+	#if BUILD_WITH_PROTOBUF
+	{
+		ScratchBegin(scratch);
+		FilePath streamPath = FilePathLit("pb_stream_test.bin");
+		char* messageStrs[TESTS_PB_STREAM_NUM_MESSAGES];
+		for (uxx mIndex = 0; mIndex < TESTS_PB_STREAM_NUM_MESSAGES; mIndex++)
+		{
+			uxx strLength = (mIndex == TESTS_PB_STREAM_BIG_MESSAGE) ? Kilobytes(70) : 40 + ((mIndex * 37) % 200);
+			messageStrs[mIndex] = (char*)AllocMem(scratch, strLength+1);
+			for (uxx cIndex = 0; cIndex < strLength; cIndex++) { messageStrs[mIndex][cIndex] = (char)('a' + ((mIndex + cIndex) % 26)); }
+			messageStrs[mIndex][strLength] = '\0';
+		}
+		
+		OsFile streamFile = ZEROED;
+		Assert(OsOpenFile(scratch, streamPath, OsOpenFileMode_Write, false, &streamFile));
+		PbStreamPacker filePacker;
+		InitPbStreamPackerForFile(&filePacker, stdHeap, &streamFile);
+		PbStreamPacker memoryPacker;
+		InitPbStreamPackerInArena(&memoryPacker, stdHeap, 0);
+		for (uxx mIndex = 0; mIndex < TESTS_PB_STREAM_NUM_MESSAGES; mIndex++)
+		{
+			ProtoFileHeader message = PROTO_FILE_HEADER__INIT;
+			message.v_int32 = (i32)mIndex;
+			message.v_uint64 = (u64)mIndex * Billion(5);
+			message.v_string = messageStrs[mIndex];
+			Assert(ProtobufStreamPack(proto_file_header, &filePacker, &message));
+			Assert(ProtobufStreamPack(proto_file_header, &memoryPacker, &message));
+		}
+		Assert(FlushPbStreamPacker(&filePacker));
+		Assert(filePacker.totalLength == (u64)memoryPacker.length);
+		FreePbStreamPacker(&filePacker);
+		OsCloseFile(&streamFile);
+		
+		//The file is read through a 256 byte buffer so most messages straddle a refill, and the big one makes the buffer grow
+		Slice memorySlice = GetPbStreamPackerSlice(&memoryPacker);
+		for (uxx pass = 0; pass < 2; pass++)
+		{
+			bool fromFile = (pass == 0);
+			DataStream stream = ZEROED;
+			if (fromFile)
+			{
+				Assert(OsOpenFile(scratch, streamPath, OsOpenFileMode_Read, true, &streamFile));
+				stream = ToDataStreamFromFile(&streamFile);
+			}
+			else { stream = ToDataStreamFromBuffer(memorySlice); }
+			PbStreamReader reader = ZEROED;
+			InitPbStreamReader(&reader, stdHeap, &stream, scratch, 256, 0);
+			reader.aliasBytes = !fromFile;
+			ProtoFileHeader* message = nullptr;
+			uxx mIndex = 0;
+			while ((message = PbStreamReaderNext(ProtoFileHeader, proto_file_header, &reader)) != nullptr)
+			{
+				Assert(mIndex < TESTS_PB_STREAM_NUM_MESSAGES);
+				Assert(message->v_int32 == (i32)mIndex && message->v_uint64 == (u64)mIndex * Billion(5));
+				Assert(message->v_string != nullptr && MyStrCompareNt(message->v_string, messageStrs[mIndex]) == 0);
+				mIndex++;
+			}
+			Assert(reader.finished && reader.error == Result_None && mIndex == TESTS_PB_STREAM_NUM_MESSAGES && reader.numMessages == TESTS_PB_STREAM_NUM_MESSAGES);
+			if (fromFile) { Assert(reader.bufferSize > Kilobytes(70)); }
+			PrintLine_D("Read %llu messages back from %s, buffer ended up %llu bytes", (u64)reader.numMessages, fromFile ? "file" : "memory", (u64)reader.bufferSize);
+			FreePbStreamReader(&reader);
+			FreeDataStream(&stream);
+			if (fromFile) { OsCloseFile(&streamFile); }
+		}
+		
+		//A stream that's cut off partway through a message is an error, not the end of the stream
+		DataStream truncatedStream = ToDataStreamFromBuffer(MakeSlice(memorySlice.length - 5, memorySlice.bytes));
+		PbStreamReader truncatedReader = ZEROED;
+		InitPbStreamReader(&truncatedReader, stdHeap, &truncatedStream, scratch, 0, 0);
+		Slice packedMessage = Slice_Empty;
+		while (PbStreamReaderNextSlice(&truncatedReader, &packedMessage)) { }
+		Assert(!truncatedReader.finished && truncatedReader.error == Result_UnexpectedEof && truncatedReader.numMessages == TESTS_PB_STREAM_NUM_MESSAGES-1);
+		FreePbStreamReader(&truncatedReader);
+		
+		FreePbStreamPacker(&memoryPacker);
 		ScratchEnd(scratch);
 	}
+	#endif //BUILD_WITH_PROTOBUF
 	#endif
 	
 	// +==============================+
@@ -1587,7 +2302,7 @@ int LLVMFuzzerTestOneInput(const u8* inputPntr, size_t inputSize)
 	uxx arenaUsedBefore = stdHeap->used;
 	
 	if (inputSize > UINTXX_MAX) { inputSize = UINTXX_MAX; }
-	Str8 inputStr = NewStr8((uxx)inputSize, inputPntr);
+	Str8 inputStr = MakeStr8((uxx)inputSize, inputPntr);
 	
 	cTokenizer tokenizer = NewCTokenizer(stdHeap, inputStr);
 	cToken* token = NextCToken(&tokenizer);
@@ -1601,6 +2316,24 @@ int LLVMFuzzerTestOneInput(const u8* inputPntr, size_t inputSize)
 	Assert(tokenizer.outputTokenIndex == tokenizer.tokens.length);
 	Assert(tokenizer.inputByteIndex == inputStr.length || tokenizer.error == Result_InvalidUtf8);
 	
+	//The streaming mode should produce exactly the same tokens without adding anything to the tokens VarArray
+	cTokenizer streamTokenizer = NewCTokenizerStream(stdHeap, inputStr);
+	cToken streamToken = ZEROED;
+	while (NextCTokenStream(&streamTokenizer, &streamToken))
+	{
+		Assert(streamToken.index < tokenizer.tokens.length);
+		cToken* arenaToken = VarArrayGetHard(cToken, &tokenizer.tokens, streamToken.index);
+		Assert(streamToken.type == arenaToken->type);
+		Assert(streamToken.flags == arenaToken->flags);
+		Assert(StrExactEquals(streamToken.rawStr, arenaToken->rawStr));
+		Assert(StrExactEquals(streamToken.str, arenaToken->str));
+	}
+	Assert(streamTokenizer.finished);
+	Assert(streamTokenizer.error == tokenizer.error);
+	Assert(streamTokenizer.outputTokenIndex == tokenizer.tokens.length);
+	Assert(streamTokenizer.tokens.length == 0);
+	FreeCTokenizer(&streamTokenizer);
+	
 	FreeCTokenizer(&tokenizer);
 	
 	Assert(stdHeap->used == arenaUsedBefore);
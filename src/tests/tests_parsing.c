@@ -92,6 +92,12 @@ void TestParsingFunctions()
 	TRY_PARSE_R64_TEST("1000000000000000");
 	TRY_PARSE_R64_TEST("10000000000000000");
 	TRY_PARSE_R64_TEST("10000000000000000.1");
+	TRY_PARSE_R64_TEST("9007199254740993");
+	TRY_PARSE_R64_TEST("2.2250738585072011e-308");
+	TRY_PARSE_R64_TEST("4.9406564584124654e-324");
+	TRY_PARSE_R64_TEST("1.7976931348623157e308");
+	TRY_PARSE_R64_TEST("1e400");
+	TRY_PARSE_R64_TEST("1e");
 	TRY_PARSE_R64_TEST("");
 	TRY_PARSE_R64_TEST("-");
 	TRY_PARSE_R64_TEST("+");
@@ -104,6 +110,44 @@ void TestParsingFunctions()
 	TRY_PARSE_R64_TEST("nan");
 	TRY_PARSE_R64_TEST("ab");
 	
+	WriteLine_O("+==============================+");
+	WriteLine_O("|     FormatShortest Tests     |");
+	WriteLine_O("+==============================+");
+	char formatBuffer[FORMAT_R64_SHORTEST_MAX_LENGTH];
+	#define FORMAT_R64_SHORTEST_TEST(value) FormatR64Shortest((value), ArrayCount(formatBuffer), &formatBuffer[0]); PrintLine_I("%s -> \"%s\"", #value, formatBuffer)
+	#define FORMAT_R32_SHORTEST_TEST(value) FormatR32Shortest((value), ArrayCount(formatBuffer), &formatBuffer[0]); PrintLine_I("%s -> \"%s\"", #value, formatBuffer)
+	FORMAT_R64_SHORTEST_TEST(0.1);
+	FORMAT_R64_SHORTEST_TEST(0.1 + 0.2);
+	FORMAT_R64_SHORTEST_TEST(123.456);
+	FORMAT_R64_SHORTEST_TEST(-0.0);
+	FORMAT_R64_SHORTEST_TEST(1e21);
+	FORMAT_R64_SHORTEST_TEST(1e-7);
+	FORMAT_R64_SHORTEST_TEST(5e-324);
+	FORMAT_R64_SHORTEST_TEST(1.7976931348623157e308);
+	FORMAT_R64_SHORTEST_TEST(INFINITY);
+	FORMAT_R32_SHORTEST_TEST(0.1f);
+	FORMAT_R32_SHORTEST_TEST(16777217.0f);
+	FORMAT_R32_SHORTEST_TEST(3.4028235e38f);
+	
+	WriteLine_O("+==============================+");
+	WriteLine_O("|       Number List Tests      |");
+	WriteLine_O("+==============================+");
+	i32 listValuesI32[8];
+	r32 listValuesR32[8];
+	uxx numListValues = 0;
+	#define TRY_PARSE_I32_LIST_TEST(parseString, delimiter) if (!TryParseI32List(StrLit(parseString), (delimiter), ArrayCount(listValuesI32), &listValuesI32[0], &numListValues, &parseError)) { PrintLine_E("TryParseI32List(\"" parseString "\") failed on value[%llu]: %s", numListValues, GetResultStr(parseError)); } else { PrintLine_I("\"" parseString "\" -> %llu value%s, last %d", numListValues, Plural(numListValues, "s"), (numListValues > 0) ? listValuesI32[numListValues-1] : 0); }
+	#define TRY_PARSE_R32_LIST_TEST(parseString, delimiter) if (!TryParseR32List(StrLit(parseString), (delimiter), ArrayCount(listValuesR32), &listValuesR32[0], &numListValues, &parseError)) { PrintLine_E("TryParseR32List(\"" parseString "\") failed on value[%llu]: %s", numListValues, GetResultStr(parseError)); } else { PrintLine_I("\"" parseString "\" -> %llu value%s, last %f", numListValues, Plural(numListValues, "s"), (numListValues > 0) ? listValuesR32[numListValues-1] : 0.0f); }
+	TRY_PARSE_I32_LIST_TEST("1, 2, 3", ',');
+	TRY_PARSE_I32_LIST_TEST("1,2,3,", ',');
+	TRY_PARSE_I32_LIST_TEST("10 20\n30\t-40", '\0');
+	TRY_PARSE_I32_LIST_TEST("0x10, 0b11, -7", ',');
+	TRY_PARSE_I32_LIST_TEST("1,,2", ',');
+	TRY_PARSE_I32_LIST_TEST("1, 2x, 3", ',');
+	TRY_PARSE_I32_LIST_TEST("2147483648", ',');
+	TRY_PARSE_I32_LIST_TEST("1 2 3 4 5 6 7 8 9", ' ');
+	TRY_PARSE_R32_LIST_TEST("1.5f, 2, .25f", ',');
+	TRY_PARSE_R32_LIST_TEST("1e3; 2e-3; inf", ';');
+	
 	WriteLine_O("+==============================+");
 	WriteLine_O("|          U64 Tests           |");
 	WriteLine_O("+==============================+");
@@ -128,10 +172,10 @@ void TestParsingFunctions()
 	TRY_PARSE_U64_TEST("0xFFFFFFFFFFFFFFFE");
 	TRY_PARSE_U64_TEST("0xFFFFFFFFFFFFFFFF");
 	TRY_PARSE_U64_TEST("18446744073709551615");
-	TRY_PARSE_U64_TEST("18446744073709551616"); //TODO: Incorrectly Succeed
-	TRY_PARSE_U64_TEST("18446744073709551617"); //TODO: Incorrectly Succeed
-	TRY_PARSE_U64_TEST("18446744073709551618"); //TODO: Incorrectly Succeed
-	TRY_PARSE_U64_TEST("18446744073709551619"); //TODO: Incorrectly Succeed
+	TRY_PARSE_U64_TEST("18446744073709551616");
+	TRY_PARSE_U64_TEST("18446744073709551617");
+	TRY_PARSE_U64_TEST("18446744073709551618");
+	TRY_PARSE_U64_TEST("18446744073709551619");
 	TRY_PARSE_U64_TEST("18446744073709551620");
 	TRY_PARSE_U64_TEST("18446744073709551621");
 	TRY_PARSE_U64_TEST("18446744073709551622");
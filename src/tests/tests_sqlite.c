@@ -40,8 +40,7 @@ int Sqlite_FileOpen(sqlite3_vfs* fileSystem, sqlite3_filename filePathPntr, sqli
 	AssertMsg(!IsFlagSet(flags, SQLITE_OPEN_CREATE) || IsFlagSet(flags, SQLITE_OPEN_READWRITE), "if CREATE is set, then READWRITE must also be set");
 	AssertMsg(!IsFlagSet(flags, SQLITE_OPEN_EXCLUSIVE) || IsFlagSet(flags, SQLITE_OPEN_CREATE), "if EXCLUSIVE is set, then CREATE must also be set");
 	AssertMsg(!IsFlagSet(flags, SQLITE_OPEN_DELETEONCLOSE) || IsFlagSet(flags, SQLITE_OPEN_CREATE), "if DELETEONCLOSE is set, then CREATE must also be set");
-	OsOpenFileMode openMode = IsFlagSet(flags, SQLITE_OPEN_READONLY) ? OsOpenFileMode_Read : OsOpenFileMode_Append;
-	if (IsFlagSet(flags, SQLITE_OPEN_CREATE)) { openMode = OsOpenFileMode_Write; }
+	OsOpenFileMode openMode = IsFlagSet(flags, SQLITE_OPEN_READONLY) ? OsOpenFileMode_Read : OsOpenFileMode_ReadWrite;
 	//TODO: Add support for SQLITE_OPEN_EXCLUSIVE. OsOpenFile needs to have this option
 	SqliteFileHandle result = ZEROED;
 	bool openResult = OsOpenFile(stdHeap, filePath, openMode, true, &result.file);
@@ -74,17 +73,16 @@ int Sqlite_FileRead(sqlite3_file* filePntr, void* bufferPntr, int numBytes, sqli
 	Assert(bufferPntr != nullptr || numBytes == 0);
 	PrintLine_D("Sqlite_FileRead(%p, %p, %d, %lld)", filePntr, bufferPntr, numBytes, (i64)offset);
 	
-	if (offset != 0)
+	uxx numBytesRead = 0;
+	Result readResult = OsReadFromOpenFileAt(&fileHandle->file, (u64)offset, (uxx)numBytes, bufferPntr, &numBytesRead);
+	if (readResult == Result_FailedToReadFile) { return SQLITE_IOERR_READ; }
+	if (numBytesRead < (uxx)numBytes)
 	{
-		//TODO: Implement OsMoveFileCursor and handle offset
-		AssertMsg(offset == 0, "We don't handle offsets in Sqlite_FileRead yet!");
+		//NOTE: SQLite requires the rest of the buffer to be zeroed on a short read
+		MyMemSet((u8*)bufferPntr + numBytesRead, 0x00, (uxx)numBytes - numBytesRead);
+		return SQLITE_IOERR_SHORT_READ;
 	}
 	
-	uxx numBytesRead = 0;
-	bool readResult = OsReadFromOpenFile(&fileHandle->file, (uxx)numBytes, false, bufferPntr, &numBytesRead);
-	if (readResult == false) { return SQLITE_IOERR; }
-	if (numBytesRead < (uxx)numBytes) { return SQLITE_ERROR; }
-	
 	return SQLITE_OK;
 }
 
@@ -97,16 +95,10 @@ int Sqlite_FileWrite(sqlite3_file* filePntr, const void* bytesPntr, int numBytes
 	Assert(bytesPntr != nullptr || numBytes == 0);
 	PrintLine_D("Sqlite_FileWrite(%p, %p, %d, %lld)", filePntr, bytesPntr, numBytes, (i64)offset);
 	
-	if (offset != 0)
-	{
-		//TODO: Implement OsMoveFileCursor and handle offset
-		AssertMsg(offset == 0, "We don't handle offsets in Sqlite_FileWrite yet!");
-	}
-	
 	if (numBytes == 0) { return SQLITE_OK; }
 	
-	bool writeResult = OsWriteToOpenFile(&fileHandle->file, NewStr8(numBytes, bytesPntr), false);
-	if (writeResult == false) { return SQLITE_IOERR; }
+	Result writeResult = OsWriteToOpenFileAt(&fileHandle->file, (u64)offset, NewStr8(numBytes, bytesPntr));
+	if (writeResult != Result_Success) { return SQLITE_IOERR_WRITE; }
 	
 	return SQLITE_OK;
 }
@@ -128,9 +120,9 @@ int Sqlite_FileSync(sqlite3_file* filePntr, int flags)
 	NotNull(fileHandle);
 	Assert(fileHandle->file.isOpen);
 	PrintLine_D("Sqlite_FileSync(%p, %d)", filePntr, flags);
-	AssertMsg(false, "Sqlite_FileSync is not implemented yet!");
-	//TODO: Implement me!
-	return SQLITE_ERROR;
+	Result syncResult = OsSyncOpenFile(&fileHandle->file);
+	if (syncResult != Result_Success) { return SQLITE_IOERR_FSYNC; }
+	return SQLITE_OK;
 }
 
 int Sqlite_FileSize(sqlite3_file* filePntr, sqlite3_int64* sizeOut)
@@ -138,9 +130,11 @@ int Sqlite_FileSize(sqlite3_file* filePntr, sqlite3_int64* sizeOut)
 	SqliteFileHandle* fileHandle = (SqliteFileHandle*)filePntr;
 	NotNull(fileHandle);
 	Assert(fileHandle->file.isOpen);
-	Assert(fileHandle->file.isKnownSize);
 	PrintLine_D("Sqlite_FileSize(%p, %p)", filePntr, sizeOut);
-	SetOptionalOutPntr(sizeOut, (i64)fileHandle->file.fileSize);
+	u64 fileSize = 0;
+	Result sizeResult = OsGetOpenFileSize(&fileHandle->file, &fileSize);
+	if (sizeResult != Result_Success) { return SQLITE_IOERR_FSTAT; }
+	SetOptionalOutPntr(sizeOut, (i64)fileSize);
 	return SQLITE_OK;
 }
 
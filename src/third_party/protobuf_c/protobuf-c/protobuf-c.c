@@ -176,6 +176,14 @@ do_free(ProtobufCAllocator *allocator, void *data)
 		allocator->free(allocator->allocator_data, data);
 }
 
+/*
+ * Embedding code can define this to point bytes fields directly into the
+ * packed buffer instead of copying them. Evaluates to NULL to copy as usual.
+ */
+#ifndef PROTOBUF_C_ALIAS_BYTES
+#define PROTOBUF_C_ALIAS_BYTES(allocator, data, len) NULL
+#endif
+
 /*
  * This allocator uses the system's malloc() and free(). It is the default
  * allocator used if NULL is passed as the ProtobufCAllocator to an exported
@@ -2588,10 +2596,13 @@ parse_required_member(ScannedMember *scanned_member,
 			do_free(allocator, bd->data);
 		}
 		if (len > pref_len) {
-			bd->data = do_alloc(allocator, len - pref_len);
-			if (bd->data == NULL)
-				return FALSE;
-			memcpy(bd->data, data + pref_len, len - pref_len);
+			bd->data = (uint8_t *) PROTOBUF_C_ALIAS_BYTES(allocator, data + pref_len, len - pref_len);
+			if (bd->data == NULL) {
+				bd->data = do_alloc(allocator, len - pref_len);
+				if (bd->data == NULL)
+					return FALSE;
+				memcpy(bd->data, data + pref_len, len - pref_len);
+			}
 		} else {
 			bd->data = NULL;
 		}